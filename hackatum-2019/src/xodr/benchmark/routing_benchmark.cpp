@@ -0,0 +1,124 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+#include "lane_router.h"
+
+using namespace aid::xodr;
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * @brief Gets the number of milliseconds since the given time point.
+ */
+static double millisecondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+/**
+ * @brief Benchmarks the routing algorithms on random origin-destination pairs
+ * of drivable lanes of a map.
+ *
+ * Usage: xodr_routing_benchmark <map.xodr> [numQueries] [travelTime]
+ */
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <map.xodr> [numQueries] [travelTime]" << std::endl;
+        return 1;
+    }
+
+    const int numQueries = argc > 2 ? std::stoi(argv[2]) : 10000;
+    const RouteCost cost = argc > 3 && std::stoi(argv[3]) ? RouteCost::TRAVEL_TIME : RouteCost::LENGTH;
+
+    Clock::time_point start = Clock::now();
+    XodrMap map = std::move(XodrMap::fromFile(argv[1]).value());
+    std::cout << "Loaded the map in " << millisecondsSince(start) << " ms." << std::endl;
+
+    start = Clock::now();
+    LaneGraph graph(map);
+    std::cout << "Built the lane graph in " << millisecondsSince(start) << " ms: " << graph.numNodes()
+              << " nodes, " << graph.numEdges() << " edges." << std::endl;
+
+    start = Clock::now();
+    ContractionHierarchy hierarchy(graph, cost);
+    std::cout << "Built the contraction hierarchy in " << millisecondsSince(start) << " ms: "
+              << hierarchy.numShortcuts() << " shortcuts." << std::endl;
+
+    std::stringstream stream;
+    hierarchy.write(stream);
+    start = Clock::now();
+    ContractionHierarchy loadedHierarchy = ContractionHierarchy::read(stream);
+    std::cout << "Read the serialized contraction hierarchy (" << stream.str().size() << " bytes) in "
+              << millisecondsSince(start) << " ms." << std::endl;
+
+    std::vector<int> drivableNodes;
+    for (int node = 0; node < graph.numNodes(); node++)
+    {
+        if (graph.drivable(node))
+        {
+            drivableNodes.push_back(node);
+        }
+    }
+    if (drivableNodes.empty())
+    {
+        std::cerr << "The map has no drivable lanes." << std::endl;
+        return 1;
+    }
+
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> dist(0, static_cast<int>(drivableNodes.size()) - 1);
+    std::vector<std::pair<int, int>> queries(numQueries);
+    for (std::pair<int, int>& query : queries)
+    {
+        query = std::make_pair(drivableNodes[dist(rng)], drivableNodes[dist(rng)]);
+    }
+
+    LaneRouter router(graph, loadedHierarchy);
+
+    std::vector<double> expectedCosts(numQueries);
+    const std::pair<RoutingAlgorithm, const char*> algorithms[] = {
+        {RoutingAlgorithm::DIJKSTRA, "Dijkstra"},
+        {RoutingAlgorithm::A_STAR, "A*"},
+        {RoutingAlgorithm::BIDIRECTIONAL_DIJKSTRA, "Bidirectional Dijkstra"},
+        {RoutingAlgorithm::CONTRACTION_HIERARCHY, "Contraction hierarchy"},
+    };
+
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto& algorithm : algorithms)
+    {
+        long long numSettled = 0;
+        int numFound = 0;
+        int numMismatches = 0;
+
+        start = Clock::now();
+        for (int i = 0; i < numQueries; i++)
+        {
+            Route route = router.route(queries[i].first, queries[i].second, algorithm.first);
+            numSettled += router.numSettled();
+            numFound += route.found();
+
+            if (algorithm.first == RoutingAlgorithm::DIJKSTRA)
+            {
+                expectedCosts[i] = route.cost_;
+            }
+            else if (route.found() != (expectedCosts[i] < std::numeric_limits<double>::infinity()) ||
+                     (route.found() && std::abs(route.cost_ - expectedCosts[i]) > 1e-6 * (1 + expectedCosts[i])))
+            {
+                numMismatches++;
+            }
+        }
+        const double elapsed = millisecondsSince(start);
+
+        std::cout << std::setw(24) << std::left << algorithm.second << std::right << std::setw(10)
+                  << 1000 * elapsed / numQueries << " us/query" << std::setw(12)
+                  << static_cast<double>(numSettled) / numQueries << " settled/query" << std::setw(8) << numFound
+                  << " found" << std::setw(6) << numMismatches << " mismatches" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,548 @@
+#include "contraction_hierarchy.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <sstream>
+#include <stdexcept>
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief The first bytes of a serialized contraction hierarchy.
+ */
+static const char FILE_MAGIC[4] = {'X', 'C', 'H', '\0'};
+
+/**
+ * @brief The version of the serialization format.
+ */
+static constexpr std::uint32_t FILE_VERSION = 1;
+
+/**
+ * @brief The maximum number of nodes a witness search settles before it gives
+ * up, in which case a (possibly unnecessary) shortcut is added.
+ */
+static constexpr int MAX_WITNESS_SETTLED = 500;
+
+const std::vector<double>& laneGraphEdgeCosts(const LaneGraph& graph, RouteCost cost)
+{
+    return cost == RouteCost::TRAVEL_TIME ? graph.edgeTravelTimes() : graph.edgeLengths();
+}
+
+/**
+ * @brief Computes a checksum of the edges of a lane graph and their costs.
+ *
+ * @param graph             The lane graph.
+ * @param cost              The cost type.
+ * @returns                 The checksum.
+ */
+static long long edgeChecksum(const LaneGraph& graph, RouteCost cost)
+{
+    const std::vector<double>& costs = laneGraphEdgeCosts(graph, cost);
+
+    std::uint64_t ret = 14695981039346656037ull;
+    auto mix = [&](std::uint64_t v) { ret = (ret ^ v) * 1099511628211ull; };
+    for (int e = 0; e < graph.numEdges(); e++)
+    {
+        mix(static_cast<std::uint64_t>(graph.edgeSources()[e]));
+        mix(static_cast<std::uint64_t>(graph.edgeTargets()[e]));
+        mix(static_cast<std::uint64_t>(std::llround(costs[e] * 1000)));
+    }
+    return static_cast<long long>(ret);
+}
+
+/**
+ * @brief An edge of the graph which remains while the nodes are contracted.
+ */
+struct WorkEdge
+{
+    int node_;
+    double cost_;
+    int middle_;
+};
+
+/**
+ * @brief Adds an edge to an adjacency list, or lowers the cost of the existing
+ * edge to the same node.
+ *
+ * @param edges             The adjacency list.
+ * @param node              The node at the other end of the edge.
+ * @param cost              The cost of the edge.
+ * @param middle            The middle node of the edge, or -1.
+ */
+static void addOrImprove(std::vector<WorkEdge>& edges, int node, double cost, int middle)
+{
+    for (WorkEdge& edge : edges)
+    {
+        if (edge.node_ == node)
+        {
+            if (cost < edge.cost_)
+            {
+                edge.cost_ = cost;
+                edge.middle_ = middle;
+            }
+            return;
+        }
+    }
+    edges.push_back({node, cost, middle});
+}
+
+/**
+ * @brief Removes the edges to a node from an adjacency list.
+ *
+ * @param edges             The adjacency list.
+ * @param node              The node.
+ */
+static void removeEdgesTo(std::vector<WorkEdge>& edges, int node)
+{
+    edges.erase(std::remove_if(edges.begin(), edges.end(), [&](const WorkEdge& e) { return e.node_ == node; }),
+                edges.end());
+}
+
+/**
+ * @brief The state of the contraction of a graph.
+ */
+class Contraction
+{
+  public:
+    /**
+     * @brief A shortcut which replaces the path from_ -> middle_ -> to_.
+     */
+    struct Shortcut
+    {
+        int from_;
+        int to_;
+        double cost_;
+        int middle_;
+    };
+
+    Contraction(const LaneGraph& graph, RouteCost cost)
+        : out_(graph.numNodes()), in_(graph.numNodes()), contractedNeighbors_(graph.numNodes(), 0),
+          witnessDist_(graph.numNodes()), witnessStamp_(graph.numNodes(), 0)
+    {
+        const std::vector<double>& costs = laneGraphEdgeCosts(graph, cost);
+        for (int e = 0; e < graph.numEdges(); e++)
+        {
+            const int from = graph.edgeSources()[e];
+            const int to = graph.edgeTargets()[e];
+            if (from != to)
+            {
+                addOrImprove(out_[from], to, costs[e], -1);
+                addOrImprove(in_[to], from, costs[e], -1);
+            }
+        }
+    }
+
+    /**
+     * @brief Finds the shortcuts which are needed when a node is contracted.
+     *
+     * @param node          The node.
+     * @param shortcuts     The vector to which the shortcuts are appended.
+     */
+    void findShortcuts(int node, std::vector<Shortcut>& shortcuts)
+    {
+        double maxOutCost = 0;
+        for (const WorkEdge& out : out_[node])
+        {
+            maxOutCost = std::max(maxOutCost, out.cost_);
+        }
+
+        for (const WorkEdge& in : in_[node])
+        {
+            witnessSearch(in.node_, node, in.cost_ + maxOutCost);
+            for (const WorkEdge& out : out_[node])
+            {
+                const double viaCost = in.cost_ + out.cost_;
+                if (out.node_ != in.node_ && witnessDist(out.node_) > viaCost)
+                {
+                    shortcuts.push_back({in.node_, out.node_, viaCost, node});
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Computes the priority of a node, lower priorities are contracted
+     * first.
+     *
+     * This is the edge difference, i.e. the number of shortcuts minus the
+     * number of removed edges, plus the number of contracted neighbors, which
+     * spreads the contraction evenly over the graph.
+     */
+    int priority(int node)
+    {
+        shortcuts_.clear();
+        findShortcuts(node, shortcuts_);
+        return static_cast<int>(shortcuts_.size()) - static_cast<int>(out_[node].size() + in_[node].size()) +
+               contractedNeighbors_[node];
+    }
+
+    /**
+     * @brief Contracts a node.
+     *
+     * @param node          The node.
+     * @param up            Receives the edges from the node to the remaining nodes.
+     * @param down          Receives the edges from the remaining nodes to the node.
+     */
+    void contract(int node, std::vector<WorkEdge>& up, std::vector<WorkEdge>& down)
+    {
+        shortcuts_.clear();
+        findShortcuts(node, shortcuts_);
+
+        up = out_[node];
+        down = in_[node];
+
+        for (const WorkEdge& out : up)
+        {
+            removeEdgesTo(in_[out.node_], node);
+            contractedNeighbors_[out.node_]++;
+        }
+        for (const WorkEdge& in : down)
+        {
+            removeEdgesTo(out_[in.node_], node);
+            contractedNeighbors_[in.node_]++;
+        }
+
+        for (const Shortcut& shortcut : shortcuts_)
+        {
+            addOrImprove(out_[shortcut.from_], shortcut.to_, shortcut.cost_, shortcut.middle_);
+            addOrImprove(in_[shortcut.to_], shortcut.from_, shortcut.cost_, shortcut.middle_);
+        }
+
+        out_[node].clear();
+        in_[node].clear();
+    }
+
+  private:
+    /**
+     * @brief Runs a Dijkstra search on the remaining graph, which avoids the
+     * node which is being contracted.
+     */
+    void witnessSearch(int from, int avoid, double maxCost)
+    {
+        witnessCurrentStamp_++;
+
+        typedef std::pair<double, int> Entry;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+
+        setWitnessDist(from, 0);
+        queue.push(Entry(0, from));
+
+        int numSettled = 0;
+        while (!queue.empty() && numSettled < MAX_WITNESS_SETTLED)
+        {
+            Entry entry = queue.top();
+            queue.pop();
+            if (entry.first > witnessDist(entry.second))
+            {
+                continue;
+            }
+            if (entry.first > maxCost)
+            {
+                break;
+            }
+            numSettled++;
+
+            for (const WorkEdge& out : out_[entry.second])
+            {
+                const double dist = entry.first + out.cost_;
+                if (out.node_ != avoid && dist < witnessDist(out.node_))
+                {
+                    setWitnessDist(out.node_, dist);
+                    queue.push(Entry(dist, out.node_));
+                }
+            }
+        }
+    }
+
+    double witnessDist(int node) const
+    {
+        return witnessStamp_[node] == witnessCurrentStamp_ ? witnessDist_[node]
+                                                           : std::numeric_limits<double>::infinity();
+    }
+
+    void setWitnessDist(int node, double dist)
+    {
+        witnessStamp_[node] = witnessCurrentStamp_;
+        witnessDist_[node] = dist;
+    }
+
+    std::vector<std::vector<WorkEdge>> out_;
+    std::vector<std::vector<WorkEdge>> in_;
+    std::vector<int> contractedNeighbors_;
+    std::vector<Shortcut> shortcuts_;
+
+    std::vector<double> witnessDist_;
+    std::vector<unsigned> witnessStamp_;
+    unsigned witnessCurrentStamp_ = 0;
+};
+
+ContractionHierarchy::ContractionHierarchy(const LaneGraph& graph, RouteCost cost)
+    : cost_(cost), graphNumEdges_(graph.numEdges()), graphEdgeChecksum_(edgeChecksum(graph, cost))
+{
+    const int numNodes = graph.numNodes();
+    rank_.assign(numNodes, -1);
+
+    Contraction contraction(graph, cost);
+
+    typedef std::pair<int, int> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    for (int node = 0; node < numNodes; node++)
+    {
+        queue.push(Entry(contraction.priority(node), node));
+    }
+
+    std::vector<std::vector<WorkEdge>> up(numNodes);
+    std::vector<std::vector<WorkEdge>> down(numNodes);
+
+    int nextRank = 0;
+    while (!queue.empty())
+    {
+        const int node = queue.top().second;
+        queue.pop();
+
+        // The priorities in the queue are outdated when neighbors were
+        // contracted, so recompute it, and requeue the node if it's no longer
+        // the minimum.
+        const int priority = contraction.priority(node);
+        if (!queue.empty() && priority > queue.top().first)
+        {
+            queue.push(Entry(priority, node));
+            continue;
+        }
+
+        contraction.contract(node, up[node], down[node]);
+        rank_[node] = nextRank++;
+    }
+
+    upOffsets_.assign(numNodes + 1, 0);
+    downOffsets_.assign(numNodes + 1, 0);
+    for (int node = 0; node < numNodes; node++)
+    {
+        upOffsets_[node + 1] = upOffsets_[node] + static_cast<int>(up[node].size());
+        downOffsets_[node + 1] = downOffsets_[node] + static_cast<int>(down[node].size());
+
+        for (const WorkEdge& edge : up[node])
+        {
+            upTargets_.push_back(edge.node_);
+            upCosts_.push_back(edge.cost_);
+            upMiddles_.push_back(edge.middle_);
+        }
+        for (const WorkEdge& edge : down[node])
+        {
+            downSources_.push_back(edge.node_);
+            downCosts_.push_back(edge.cost_);
+            downMiddles_.push_back(edge.middle_);
+        }
+    }
+}
+
+/**
+ * @brief Writes a vector to a binary stream, preceded by its size.
+ */
+template <class T>
+static void writeVector(std::ostream& out, const std::vector<T>& v)
+{
+    std::int32_t size = static_cast<std::int32_t>(v.size());
+    out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    out.write(reinterpret_cast<const char*>(v.data()), sizeof(T) * v.size());
+}
+
+/**
+ * @brief Reads a value from a binary stream, and throws an exception if the
+ * stream ends too early.
+ */
+template <class T>
+static void readValue(std::istream& in, T& value)
+{
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    if (!in)
+    {
+        throw std::runtime_error("Invalid contraction hierarchy: Unexpected end of stream.");
+    }
+}
+
+/**
+ * @brief Reads a vector which was written with writeVector(), and checks its size.
+ */
+template <class T>
+static void readVector(std::istream& in, std::vector<T>& v, std::int32_t expectedSize)
+{
+    std::int32_t size;
+    readValue(in, size);
+    if (size != expectedSize)
+    {
+        std::stringstream err;
+        err << "Invalid contraction hierarchy: Expected an array of size " << expectedSize << ", got " << size << ".";
+        throw std::runtime_error(err.str());
+    }
+
+    v.resize(size);
+    in.read(reinterpret_cast<char*>(v.data()), sizeof(T) * v.size());
+    if (!in)
+    {
+        throw std::runtime_error("Invalid contraction hierarchy: Unexpected end of stream.");
+    }
+}
+
+void ContractionHierarchy::write(std::ostream& out) const
+{
+    out.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+
+    std::uint32_t version = FILE_VERSION;
+    std::int32_t cost = static_cast<std::int32_t>(cost_);
+    std::int32_t numNodes = this->numNodes();
+    std::int32_t numUpEdges = static_cast<std::int32_t>(upTargets_.size());
+    std::int32_t numDownEdges = static_cast<std::int32_t>(downSources_.size());
+    std::int32_t graphNumEdges = graphNumEdges_;
+    std::int64_t graphEdgeChecksum = graphEdgeChecksum_;
+    out.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    out.write(reinterpret_cast<const char*>(&cost), sizeof(cost));
+    out.write(reinterpret_cast<const char*>(&numNodes), sizeof(numNodes));
+    out.write(reinterpret_cast<const char*>(&numUpEdges), sizeof(numUpEdges));
+    out.write(reinterpret_cast<const char*>(&numDownEdges), sizeof(numDownEdges));
+    out.write(reinterpret_cast<const char*>(&graphNumEdges), sizeof(graphNumEdges));
+    out.write(reinterpret_cast<const char*>(&graphEdgeChecksum), sizeof(graphEdgeChecksum));
+
+    writeVector(out, rank_);
+    writeVector(out, upOffsets_);
+    writeVector(out, upTargets_);
+    writeVector(out, upCosts_);
+    writeVector(out, upMiddles_);
+    writeVector(out, downOffsets_);
+    writeVector(out, downSources_);
+    writeVector(out, downCosts_);
+    writeVector(out, downMiddles_);
+}
+
+ContractionHierarchy ContractionHierarchy::read(std::istream& in)
+{
+    char magic[sizeof(FILE_MAGIC)];
+    in.read(magic, sizeof(magic));
+    if (!in || std::memcmp(magic, FILE_MAGIC, sizeof(magic)) != 0)
+    {
+        throw std::runtime_error("Invalid contraction hierarchy: Wrong file type.");
+    }
+
+    std::uint32_t version;
+    readValue(in, version);
+    if (version != FILE_VERSION)
+    {
+        std::stringstream err;
+        err << "Invalid contraction hierarchy: Unsupported version " << version << ".";
+        throw std::runtime_error(err.str());
+    }
+
+    std::int32_t cost, numNodes, numUpEdges, numDownEdges, graphNumEdges;
+    std::int64_t graphEdgeChecksum;
+    readValue(in, cost);
+    readValue(in, numNodes);
+    readValue(in, numUpEdges);
+    readValue(in, numDownEdges);
+    readValue(in, graphNumEdges);
+    readValue(in, graphEdgeChecksum);
+    if (cost != static_cast<std::int32_t>(RouteCost::LENGTH) &&
+        cost != static_cast<std::int32_t>(RouteCost::TRAVEL_TIME))
+    {
+        throw std::runtime_error("Invalid contraction hierarchy: Unknown cost type.");
+    }
+    if (numNodes < 0 || numUpEdges < 0 || numDownEdges < 0)
+    {
+        throw std::runtime_error("Invalid contraction hierarchy: Negative size.");
+    }
+
+    ContractionHierarchy ret;
+    ret.cost_ = static_cast<RouteCost>(cost);
+    ret.graphNumEdges_ = graphNumEdges;
+    ret.graphEdgeChecksum_ = graphEdgeChecksum;
+
+    readVector(in, ret.rank_, numNodes);
+    readVector(in, ret.upOffsets_, numNodes + 1);
+    readVector(in, ret.upTargets_, numUpEdges);
+    readVector(in, ret.upCosts_, numUpEdges);
+    readVector(in, ret.upMiddles_, numUpEdges);
+    readVector(in, ret.downOffsets_, numNodes + 1);
+    readVector(in, ret.downSources_, numDownEdges);
+    readVector(in, ret.downCosts_, numDownEdges);
+    readVector(in, ret.downMiddles_, numDownEdges);
+
+    // Check the indices, so that queries on a corrupt hierarchy can't access
+    // memory out of bounds.
+    auto checkOffsets = [&](const std::vector<int>& offsets, int numEdges) {
+        for (int node = 0; node < numNodes; node++)
+        {
+            if (offsets[node] < 0 || offsets[node] > offsets[node + 1])
+            {
+                throw std::runtime_error("Invalid contraction hierarchy: Invalid edge offsets.");
+            }
+        }
+        if (offsets[0] != 0 || offsets[numNodes] != numEdges)
+        {
+            throw std::runtime_error("Invalid contraction hierarchy: Invalid edge offsets.");
+        }
+    };
+    auto checkNodes = [&](const std::vector<int>& nodes, int minNode) {
+        for (int node : nodes)
+        {
+            if (node < minNode || node >= numNodes)
+            {
+                throw std::runtime_error("Invalid contraction hierarchy: Node index out of range.");
+            }
+        }
+    };
+    checkOffsets(ret.upOffsets_, numUpEdges);
+    checkOffsets(ret.downOffsets_, numDownEdges);
+    checkNodes(ret.upTargets_, 0);
+    checkNodes(ret.downSources_, 0);
+    checkNodes(ret.upMiddles_, -1);
+    checkNodes(ret.downMiddles_, -1);
+
+    return ret;
+}
+
+bool ContractionHierarchy::matches(const LaneGraph& graph) const
+{
+    return graph.numNodes() == numNodes() && graph.numEdges() == graphNumEdges_ &&
+           edgeChecksum(graph, cost_) == graphEdgeChecksum_;
+}
+
+int ContractionHierarchy::numShortcuts() const
+{
+    return static_cast<int>(std::count_if(upMiddles_.begin(), upMiddles_.end(), [](int m) { return m >= 0; }) +
+                            std::count_if(downMiddles_.begin(), downMiddles_.end(), [](int m) { return m >= 0; }));
+}
+
+void ContractionHierarchy::unpackEdge(int from, int to, int middle, std::vector<int>& nodes) const
+{
+    if (middle < 0)
+    {
+        nodes.push_back(to);
+        return;
+    }
+
+    // The middle node was contracted before both ends of the shortcut, so the
+    // edge from 'from' to the middle node is a downward edge into the middle
+    // node, and the edge from the middle node to 'to' is an upward edge.
+    for (int e = downOffsets_[middle]; e < downOffsets_[middle + 1]; e++)
+    {
+        if (downSources_[e] == from)
+        {
+            unpackEdge(from, middle, downMiddles_[e], nodes);
+            break;
+        }
+    }
+    for (int e = upOffsets_[middle]; e < upOffsets_[middle + 1]; e++)
+    {
+        if (upTargets_[e] == to)
+        {
+            unpackEdge(middle, to, upMiddles_[e], nodes);
+            break;
+        }
+    }
+}
+
+}}  // namespace aid::xodr
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include "lane_graph.h"
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief The cost which is minimized by routing on a LaneGraph.
+ */
+enum class RouteCost : int
+{
+    /**
+     * @brief The length of the route, see LaneGraph::edgeLengths().
+     */
+    LENGTH,
+
+    /**
+     * @brief The travel time of the route, see LaneGraph::edgeTravelTimes().
+     */
+    TRAVEL_TIME
+};
+
+/**
+ * @brief Gets the edge costs of a LaneGraph for the given cost type.
+ *
+ * @param graph             The lane graph.
+ * @param cost              The cost type.
+ * @returns                 The cost of each edge.
+ */
+const std::vector<double>& laneGraphEdgeCosts(const LaneGraph& graph, RouteCost cost);
+
+/**
+ * @brief A contraction hierarchy of a LaneGraph, which speeds up shortest path
+ * queries by preprocessing the graph.
+ *
+ * The nodes are contracted one by one, in the order of their rank. Contracting
+ * a node adds shortcut edges between its remaining neighbors wherever the
+ * shortest path between them runs through the node. A query then only needs
+ * to search upwards in rank from both ends of the route, which settles a small
+ * fraction of the nodes. See LaneRouter for the queries.
+ *
+ * The edges of the hierarchy are stored in two compressed sparse row arrays:
+ * The upward edges of node n, which go from n to a node of higher rank, and the
+ * downward edges into node n, which come from a node of higher rank. Each edge
+ * is either an edge of the lane graph, or a shortcut which replaces the two
+ * edges via its middle node.
+ *
+ * A hierarchy can be written to and read from a binary stream, so that the
+ * preprocessing only has to be done once per map.
+ */
+class ContractionHierarchy
+{
+  public:
+    /**
+     * @brief Builds the contraction hierarchy of a lane graph.
+     *
+     * @param graph         The lane graph.
+     * @param cost          The cost which is minimized by the queries.
+     */
+    ContractionHierarchy(const LaneGraph& graph, RouteCost cost);
+
+    /**
+     * @brief Reads a contraction hierarchy which was written with write().
+     *
+     * An exception is thrown if the stream doesn't contain a valid hierarchy.
+     *
+     * @param in            The input stream, which should be opened in binary mode.
+     * @returns             The contraction hierarchy.
+     */
+    static ContractionHierarchy read(std::istream& in);
+
+    /**
+     * @brief Writes this contraction hierarchy to a binary stream.
+     *
+     * @param out           The output stream, which should be opened in binary mode.
+     */
+    void write(std::ostream& out) const;
+
+    /**
+     * @brief Checks whether this hierarchy was built from the given graph.
+     *
+     * This compares the number of nodes and edges, and the edges themselves,
+     * so a hierarchy which was read from a file for a different map (or a
+     * different version of the same map) is rejected.
+     *
+     * @param graph         The lane graph.
+     * @returns             True if the hierarchy matches the graph.
+     */
+    bool matches(const LaneGraph& graph) const;
+
+    /**
+     * @brief Gets the cost which is minimized by the queries.
+     */
+    RouteCost cost() const { return cost_; }
+
+    /**
+     * @brief Gets the number of nodes.
+     */
+    int numNodes() const { return static_cast<int>(rank_.size()); }
+
+    /**
+     * @brief Gets the number of shortcut edges.
+     */
+    int numShortcuts() const;
+
+    /**
+     * @brief Gets the rank of each node, which is the position of the node in
+     * the contraction order.
+     */
+    const std::vector<int>& rank() const { return rank_; }
+
+    /**
+     * @brief The upward edges of node n are [upOffsets()[n], upOffsets()[n + 1]).
+     */
+    const std::vector<int>& upOffsets() const { return upOffsets_; }
+
+    /**
+     * @brief The target node of each upward edge.
+     */
+    const std::vector<int>& upTargets() const { return upTargets_; }
+
+    /**
+     * @brief The cost of each upward edge.
+     */
+    const std::vector<double>& upCosts() const { return upCosts_; }
+
+    /**
+     * @brief The middle node of each upward edge, or -1 if it's an edge of the
+     * lane graph.
+     */
+    const std::vector<int>& upMiddles() const { return upMiddles_; }
+
+    /**
+     * @brief The downward edges into node n are [downOffsets()[n], downOffsets()[n + 1]).
+     */
+    const std::vector<int>& downOffsets() const { return downOffsets_; }
+
+    /**
+     * @brief The source node of each downward edge.
+     */
+    const std::vector<int>& downSources() const { return downSources_; }
+
+    /**
+     * @brief The cost of each downward edge.
+     */
+    const std::vector<double>& downCosts() const { return downCosts_; }
+
+    /**
+     * @brief The middle node of each downward edge, or -1 if it's an edge of
+     * the lane graph.
+     */
+    const std::vector<int>& downMiddles() const { return downMiddles_; }
+
+    /**
+     * @brief Replaces an edge of the hierarchy by the path of lane graph
+     * edges which it represents.
+     *
+     * @param from          The source node of the edge.
+     * @param to            The target node of the edge.
+     * @param middle        The middle node of the edge, or -1.
+     * @param nodes         The vector to which the nodes of the path are
+     *                      appended, excluding 'from' but including 'to'.
+     */
+    void unpackEdge(int from, int to, int middle, std::vector<int>& nodes) const;
+
+  private:
+    ContractionHierarchy() = default;
+
+    RouteCost cost_;
+
+    int graphNumEdges_;
+    long long graphEdgeChecksum_;
+
+    std::vector<int> rank_;
+
+    std::vector<int> upOffsets_;
+    std::vector<int> upTargets_;
+    std::vector<double> upCosts_;
+    std::vector<int> upMiddles_;
+
+    std::vector<int> downOffsets_;
+    std::vector<int> downSources_;
+    std::vector<double> downCosts_;
+    std::vector<int> downMiddles_;
+};
+
+}}  // namespace aid::xodr
@@ -2,6 +2,9 @@
 #include "xml/xml_attribute_parsers.h"
 #include "xml/xml_child_element_parsers.h"
 
+#include <algorithm>
+#include <cassert>
+
 namespace aid { namespace xodr {
 
 class ElevationProfile::ChildElemParsers : public XmlChildElementParsers<XodrReader, XodrParseResult<ElevationProfile>>
@@ -25,6 +28,48 @@ XodrParseResult<ElevationProfile> ElevationProfile::parseXml(XodrReader& xml)
     return ret;
 }
 
+double ElevationProfile::eval(double s) const
+{
+    assert(!elevations_.empty());
+
+    // Find the last segment starting at or before s.
+    auto it = std::upper_bound(elevations_.begin(), elevations_.end(), s,
+                               [](double s, const Elevation& elevation) { return s < elevation.sCoord(); });
+    if (it != elevations_.begin())
+    {
+        --it;
+    }
+
+    return it->poly3().eval(s - it->sCoord());
+}
+
+std::vector<double> ElevationProfile::evalTessellation(const ReferenceLine::Tessellation& tessellation) const
+{
+    assert(!elevations_.empty());
+
+    std::vector<double> ret;
+    ret.reserve(tessellation.size());
+
+    int segmentIdx = 0;
+    const int numSegments = static_cast<int>(elevations_.size());
+
+    for (const ReferenceLine::Vertex& vertex : tessellation)
+    {
+        double s = vertex.sCoord_;
+        assert(ret.empty() || s >= tessellation[ret.size() - 1].sCoord_);
+
+        while (segmentIdx + 1 < numSegments && elevations_[segmentIdx + 1].sCoord() <= s)
+        {
+            segmentIdx++;
+        }
+
+        const Elevation& segment = elevations_[segmentIdx];
+        ret.push_back(segment.poly3().eval(s - segment.sCoord()));
+    }
+
+    return ret;
+}
+
 ElevationProfile::Elevation::Elevation(double sCoord, const Poly3& poly3) : sCoord_(sCoord), poly3_(poly3) {}
 
 class ElevationProfile::Elevation::AttribParsers
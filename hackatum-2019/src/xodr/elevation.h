@@ -1,6 +1,7 @@
 #pragma once
 
 #include "poly3.h"
+#include "reference_line.h"
 
 #include "xml/xml_parse_result.h"
 #include "xodr_reader.h"
@@ -104,6 +105,30 @@ class ElevationProfile
      */
     const std::vector<Elevation>& elevations() const { return elevations_; }
 
+    /**
+     * @brief Evaluates the elevation at the given s-coordinate.
+     *
+     * The segment containing @p s is found using a binary search. To evaluate
+     * the elevation at many increasing s-coordinates, use evalTessellation().
+     *
+     * @param s         The s-coordinate.
+     * @returns         The elevation.
+     */
+    double eval(double s) const;
+
+    /**
+     * @brief Evaluates the elevation at each vertex of the given reference
+     * line tessellation.
+     *
+     * Since the vertices of a tessellation are ordered by increasing
+     * s-coordinate, the segments are found by advancing a cursor over the
+     * elevation segments rather than by searching for each vertex.
+     *
+     * @param tessellation  The reference line tessellation.
+     * @returns             The elevations, one per vertex of @p tessellation.
+     */
+    std::vector<double> evalTessellation(const ReferenceLine::Tessellation& tessellation) const;
+
   private:
     class ChildElemParsers;
 
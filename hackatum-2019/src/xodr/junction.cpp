@@ -1,23 +1,45 @@
 #include "junction.h"
 
+#include <algorithm>
 #include <climits>
+#include <numeric>
+#include <tuple>
 
 namespace aid { namespace xodr {
 
-bool Junction::hasConnection(int incomingRoadIdx, int connectingRoadIdx, ContactPoint contactPoint) const
+/**
+ * @brief Gets the key by which Junction::connectionsByRoads_ is sorted.
+ */
+static std::tuple<int, int, ContactPoint> roadsKey(const Junction::Connection& conn)
 {
-    assert(contactPoint != ContactPoint::NOT_SPECIFIED);
+    return std::make_tuple(conn.incomingRoad().index(), conn.connectingRoad().index(), conn.contactPoint());
+}
 
-    for (const Connection& conn : connections_)
-    {
-        if (conn.incomingRoad().index() == incomingRoadIdx && conn.connectingRoad().index() == connectingRoadIdx &&
-            conn.contactPoint() == contactPoint)
-        {
-            return true;
-        }
-    }
+/**
+ * @brief Gets the key by which Junction::connectionsByConnectingRoad_ is sorted.
+ */
+static std::pair<int, ContactPoint> connectingRoadKey(const Junction::Connection& conn)
+{
+    return std::make_pair(conn.connectingRoad().index(), conn.contactPoint());
+}
 
-    return false;
+void Junction::buildConnectionIndices()
+{
+    connectionsByRoads_.resize(connections_.size());
+    std::iota(connectionsByRoads_.begin(), connectionsByRoads_.end(), 0);
+    std::stable_sort(connectionsByRoads_.begin(), connectionsByRoads_.end(),
+                     [this](int a, int b) { return roadsKey(connections_[a]) < roadsKey(connections_[b]); });
+
+    connectionsByConnectingRoad_.resize(connections_.size());
+    std::iota(connectionsByConnectingRoad_.begin(), connectionsByConnectingRoad_.end(), 0);
+    std::stable_sort(connectionsByConnectingRoad_.begin(), connectionsByConnectingRoad_.end(), [this](int a, int b) {
+        return connectingRoadKey(connections_[a]) < connectingRoadKey(connections_[b]);
+    });
+}
+
+bool Junction::hasConnection(int incomingRoadIdx, int connectingRoadIdx, ContactPoint contactPoint) const
+{
+    return findConnection(incomingRoadIdx, connectingRoadIdx, contactPoint) != nullptr;
 }
 
 const Junction::Connection* Junction::findConnection(int incomingRoadIdx, int connectingRoadIdx,
@@ -25,13 +47,14 @@ const Junction::Connection* Junction::findConnection(int incomingRoadIdx, int co
 {
     assert(contactPoint != ContactPoint::NOT_SPECIFIED);
 
-    for (const Connection& conn : connections_)
+    const std::tuple<int, int, ContactPoint> key = std::make_tuple(incomingRoadIdx, connectingRoadIdx, contactPoint);
+    auto it = std::lower_bound(
+        connectionsByRoads_.begin(), connectionsByRoads_.end(), key,
+        [this](int idx, const std::tuple<int, int, ContactPoint>& k) { return roadsKey(connections_[idx]) < k; });
+
+    if (it != connectionsByRoads_.end() && roadsKey(connections_[*it]) == key)
     {
-        if (conn.incomingRoad().index() == incomingRoadIdx && conn.connectingRoad().index() == connectingRoadIdx &&
-            conn.contactPoint() == contactPoint)
-        {
-            return &conn;
-        }
+        return &connections_[*it];
     }
 
     return nullptr;
@@ -41,17 +64,12 @@ bool Junction::hasOutgoingConnection(int connectingRoadIdx, ContactPoint contact
 {
     assert(contactPoint != ContactPoint::NOT_SPECIFIED);
 
-    ContactPoint incomingContactPoint = oppositeContactPoint(contactPoint);
-
-    for (const Connection& conn : connections_)
-    {
-        if (conn.connectingRoad().index() == connectingRoadIdx && conn.contactPoint() == incomingContactPoint)
-        {
-            return true;
-        }
-    }
+    const std::pair<int, ContactPoint> key = std::make_pair(connectingRoadIdx, oppositeContactPoint(contactPoint));
+    auto it = std::lower_bound(
+        connectionsByConnectingRoad_.begin(), connectionsByConnectingRoad_.end(), key,
+        [this](int idx, const std::pair<int, ContactPoint>& k) { return connectingRoadKey(connections_[idx]) < k; });
 
-    return false;
+    return it != connectionsByConnectingRoad_.end() && connectingRoadKey(connections_[*it]) == key;
 }
 
 Junction::Connection* Junction::test_connectionById(const std::string& id)
@@ -67,14 +85,21 @@ Junction::Connection* Junction::test_connectionById(const std::string& id)
     return nullptr;
 }
 
+void Junction::Connection::buildLaneLinkIndex()
+{
+    sortedLaneLinks_ = laneLinks_;
+    std::stable_sort(sortedLaneLinks_.begin(), sortedLaneLinks_.end(),
+                     [](const LaneLink& a, const LaneLink& b) { return a.from() < b.from(); });
+}
+
 LaneIDOpt Junction::Connection::findLaneLinkTarget(LaneID fromLane) const
 {
-    for (const LaneLink& laneLink : laneLinks_)
+    auto it = std::lower_bound(sortedLaneLinks_.begin(), sortedLaneLinks_.end(), fromLane,
+                               [](const LaneLink& laneLink, LaneID from) { return laneLink.from() < from; });
+
+    if (it != sortedLaneLinks_.end() && it->from() == fromLane)
     {
-        if (laneLink.from() == fromLane)
-        {
-            return laneLink.to();
-        }
+        return it->to();
     }
 
     return LaneIDOpt::null();
@@ -95,6 +120,7 @@ void Junction::Connection::test_setLaneLinkTarget(LaneID fromLaneId, LaneIDOpt t
             {
                 laneLinks_.erase(laneLinks_.begin() + i);
             }
+            buildLaneLinkIndex();
             return;
         }
     }
@@ -102,6 +128,7 @@ void Junction::Connection::test_setLaneLinkTarget(LaneID fromLaneId, LaneIDOpt t
     if (toLaneId)
     {
         laneLinks_.push_back(LaneLink(fromLaneId, *toLaneId));
+        buildLaneLinkIndex();
     }
 }
 
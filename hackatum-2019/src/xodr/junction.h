@@ -78,6 +78,10 @@ class Junction
          * equals the given 'fromLane', and returns the 'to' lane of that link.
          *
          * If no link with the given from lane is found, LaneID::null() is returned.
+         * If there are several links from the lane, the first one is used.
+         *
+         * This is a binary search in a table of the lane links sorted by
+         * their 'from' lanes.
          *
          * @param fromLane  The lane id of the from lane.
          * @return          The lane id of the target lane, or LaneID::null() if
@@ -114,11 +118,21 @@ class Junction
         class AttribParsers;
         class ChildElemParsers;
 
+        /**
+         * @brief Rebuilds sortedLaneLinks_ from laneLinks_.
+         */
+        void buildLaneLinkIndex();
+
         std::string id_;
         XodrObjectReference incomingRoad_;
         XodrObjectReference connectingRoad_;
         ContactPoint contactPoint_;
         std::vector<LaneLink> laneLinks_;
+
+        /**
+         * @brief The lane links, stably sorted by their 'from' lanes.
+         */
+        std::vector<LaneLink> sortedLaneLinks_;
     };
 
     /**
@@ -184,6 +198,10 @@ class Junction
      *
      * See XodrObjectReference::resolve() for more details.
      *
+     * This also builds the indices which are used by hasConnection(),
+     * findConnection() and hasOutgoingConnection(), so these only find
+     * connections after the references were resolved.
+     *
      * @param idToIndexMaps   The mappings from identifiers to indices.
      */
     void resolveReferences(const IdToIndexMaps& idToIndexMaps);
@@ -230,9 +248,27 @@ class Junction
     class AttribParsers;
     class ChildElemParsers;
 
+    /**
+     * @brief Builds connectionsByRoads_ and connectionsByConnectingRoad_ from
+     * the resolved connections.
+     */
+    void buildConnectionIndices();
+
     std::string name_;
     std::string id_;
     std::vector<Connection> connections_;
+
+    /**
+     * @brief The indices of the connections, sorted by incoming road,
+     * connecting road and contact point.
+     */
+    std::vector<int> connectionsByRoads_;
+
+    /**
+     * @brief The indices of the connections, sorted by connecting road and
+     * contact point.
+     */
+    std::vector<int> connectionsByConnectingRoad_;
 };
 
 }}  // namespace aid::xodr
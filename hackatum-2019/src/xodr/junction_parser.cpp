@@ -46,6 +46,8 @@ void Junction::resolveReferences(const IdToIndexMaps& idToIndexMaps)
     {
         connection.resolveReferences(idToIndexMaps);
     }
+
+    buildConnectionIndices();
 }
 
 class Junction::Connection::AttribParsers : public XmlAttributeParsers<XodrParseResult<Connection>>
@@ -82,6 +84,8 @@ XodrParseResult<Junction::Connection> Junction::Connection::parseXml(XodrReader&
     static const ChildElemParsers childElemParsers;
     childElemParsers.parse(xml, ret);
 
+    ret.value().buildLaneLinkIndex();
+
     return ret;
 }
 
@@ -79,6 +79,23 @@ XodrParseResult<LaneSpeedLimit> LaneSpeedLimit::parseXml(XodrReader& xml)
     return ret;
 }
 
+double LaneSpeedLimit::maxSpeedMetersPerSecond() const
+{
+    switch (unit_)
+    {
+        default:
+        case SpeedUnit::NOT_SPECIFIED:
+        case SpeedUnit::METERS_PER_SECOND:
+            return maxSpeed_;
+
+        case SpeedUnit::MILES_PER_HOUR:
+            return maxSpeed_ * 0.44704;
+
+        case SpeedUnit::KILOMETERS_PER_HOUR:
+            return maxSpeed_ / 3.6;
+    }
+}
+
 class LaneAccess::AttribParsers : public XmlAttributeParsers<XodrParseResult<LaneAccess>>
 {
   public:
@@ -169,6 +169,13 @@ class LaneSpeedLimit
      */
     SpeedUnit unit() const { return unit_; }
 
+    /**
+     * @brief Returns the speed limit, converted to meters per second.
+     *
+     * @returns The speed limit in meters per second.
+     */
+    double maxSpeedMetersPerSecond() const;
+
   private:
     class AttribParsers;
 
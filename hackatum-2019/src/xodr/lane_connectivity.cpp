@@ -0,0 +1,164 @@
+#include "lane_connectivity.h"
+
+#include <algorithm>
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief A node whose outgoing edges are being visited by Tarjan's algorithm,
+ * which replaces a frame of the recursive version.
+ */
+struct TarjanFrame
+{
+    int node_;
+    int nextEdge_;
+};
+
+LaneConnectivity::LaneConnectivity(const LaneGraph& graph) : graph_(graph)
+{
+    computeComponents();
+
+    markReachable(true, reachableFromLargest_);
+    markReachable(false, reachesLargest_);
+
+    for (int node = 0; node < graph_.numNodes(); node++)
+    {
+        if (deadEnd(node))
+        {
+            deadEnds_.push_back(node);
+        }
+        if (unreachable(node))
+        {
+            unreachableNodes_.push_back(node);
+        }
+        if (stranding(node))
+        {
+            strandingNodes_.push_back(node);
+        }
+        if (spawnCandidate(node))
+        {
+            spawnCandidates_.push_back(node);
+        }
+    }
+}
+
+void LaneConnectivity::computeComponents()
+{
+    const int numNodes = graph_.numNodes();
+    const std::vector<int>& successorOffsets = graph_.successorOffsets();
+    const std::vector<int>& edgeTargets = graph_.edgeTargets();
+
+    components_.assign(numNodes, -1);
+
+    // The discovery index and the lowest discovery index reachable through the
+    // DFS subtree of each node, or -1 if the node wasn't discovered yet.
+    std::vector<int> indices(numNodes, -1);
+    std::vector<int> lowLinks(numNodes, -1);
+    std::vector<std::uint8_t> onStack(numNodes, 0);
+    std::vector<int> stack;
+    std::vector<TarjanFrame> frames;
+    int nextIndex = 0;
+
+    auto discover = [&](int node) {
+        indices[node] = lowLinks[node] = nextIndex++;
+        stack.push_back(node);
+        onStack[node] = 1;
+        frames.push_back(TarjanFrame{node, successorOffsets[node]});
+    };
+
+    for (int root = 0; root < numNodes; root++)
+    {
+        if (!graph_.drivable(root) || indices[root] >= 0)
+        {
+            continue;
+        }
+
+        discover(root);
+        while (!frames.empty())
+        {
+            const int node = frames.back().node_;
+            const int edge = frames.back().nextEdge_;
+            if (edge < successorOffsets[node + 1])
+            {
+                frames.back().nextEdge_++;
+                const int target = edgeTargets[edge];
+                if (indices[target] < 0)
+                {
+                    discover(target);
+                }
+                else if (onStack[target])
+                {
+                    lowLinks[node] = std::min(lowLinks[node], indices[target]);
+                }
+                continue;
+            }
+
+            // All edges of the node are visited, so it's the root of a
+            // component if nothing below it reaches a node above it.
+            frames.pop_back();
+            if (lowLinks[node] == indices[node])
+            {
+                const int component = static_cast<int>(componentSizes_.size());
+                int size = 0;
+                int member;
+                do
+                {
+                    member = stack.back();
+                    stack.pop_back();
+                    onStack[member] = 0;
+                    components_[member] = component;
+                    size++;
+                } while (member != node);
+                componentSizes_.push_back(size);
+
+                if (largestComponent_ < 0 || size > componentSizes_[largestComponent_])
+                {
+                    largestComponent_ = component;
+                }
+            }
+
+            if (!frames.empty())
+            {
+                const int parent = frames.back().node_;
+                lowLinks[parent] = std::min(lowLinks[parent], lowLinks[node]);
+            }
+        }
+    }
+}
+
+void LaneConnectivity::markReachable(bool forward, std::vector<std::uint8_t>& reached) const
+{
+    reached.assign(graph_.numNodes(), 0);
+    if (largestComponent_ < 0)
+    {
+        return;
+    }
+
+    std::vector<int> queue;
+    for (int node = 0; node < graph_.numNodes(); node++)
+    {
+        if (components_[node] == largestComponent_)
+        {
+            reached[node] = 1;
+            queue.push_back(node);
+        }
+    }
+
+    const std::vector<int>& offsets = forward ? graph_.successorOffsets() : graph_.predecessorOffsets();
+    for (int i = 0; i < static_cast<int>(queue.size()); i++)
+    {
+        const int node = queue[i];
+        for (int j = offsets[node]; j < offsets[node + 1]; j++)
+        {
+            const int next =
+                forward ? graph_.edgeTargets()[j] : graph_.edgeSources()[graph_.predecessorEdges()[j]];
+            if (!reached[next])
+            {
+                reached[next] = 1;
+                queue.push_back(next);
+            }
+        }
+    }
+}
+
+}}  // namespace aid::xodr
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "lane_graph.h"
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief The connectivity analysis of a LaneGraph.
+ *
+ * Computes the strongly connected components of the graph, i.e. the maximal
+ * sets of lanes in which every lane can be reached from every other lane, and
+ * classifies the drivable lanes relative to the largest component, which is
+ * taken as the main road network:
+ *
+ *  - Dead ends are lanes without any outgoing edges, so traffic on them is
+ *    stuck at the end of the lane.
+ *  - Unreachable lanes can't be reached from the main network, so traffic
+ *    never enters them unless it's spawned there.
+ *  - Stranding lanes can't reach the main network, so traffic which enters
+ *    them never gets back. These include the dead ends.
+ *
+ * Traffic which is spawned on a lane of the main network can drive forever
+ * without getting stuck, so these lanes are the spawn candidates.
+ *
+ * The components are computed with an iterative version of Tarjan's
+ * algorithm, so deep graphs don't overflow the stack, and the whole analysis
+ * runs in linear time in the number of nodes and edges. Lanes which aren't
+ * drivable (see LaneGraph::isDrivable()) have no edges and aren't part of any
+ * component.
+ */
+class LaneConnectivity
+{
+  public:
+    /**
+     * @brief Analyzes the given lane graph.
+     *
+     * The graph must outlive the analysis.
+     *
+     * @param graph         The lane graph.
+     */
+    explicit LaneConnectivity(const LaneGraph& graph);
+
+    /**
+     * @brief Gets the graph.
+     */
+    const LaneGraph& graph() const { return graph_; }
+
+    /**
+     * @brief Gets the number of strongly connected components.
+     */
+    int numComponents() const { return static_cast<int>(componentSizes_.size()); }
+
+    /**
+     * @brief Gets the component of a node, or -1 if its lane isn't drivable.
+     *
+     * The components are numbered in reverse topological order: Every edge
+     * between two different components leads from the higher to the lower
+     * component index.
+     */
+    int component(int node) const { return components_[node]; }
+
+    /**
+     * @brief Gets the number of nodes in a component.
+     */
+    int componentSize(int component) const { return componentSizes_[component]; }
+
+    /**
+     * @brief Gets the largest component, i.e. the main road network, or -1 if
+     * there are no drivable lanes.
+     *
+     * Of several components with the same size, the one with the lowest index
+     * is used.
+     */
+    int largestComponent() const { return largestComponent_; }
+
+    /**
+     * @brief Checks whether the lane of a node is a dead end, i.e. a drivable
+     * lane without outgoing edges.
+     */
+    bool deadEnd(int node) const { return components_[node] >= 0 && graph_.numSuccessors(node) == 0; }
+
+    /**
+     * @brief Checks whether the lane of a node is drivable, but can't be
+     * reached from the largest component.
+     */
+    bool unreachable(int node) const { return components_[node] >= 0 && !reachableFromLargest_[node]; }
+
+    /**
+     * @brief Checks whether the lane of a node is drivable, but the largest
+     * component can't be reached from it.
+     */
+    bool stranding(int node) const { return components_[node] >= 0 && !reachesLargest_[node]; }
+
+    /**
+     * @brief Checks whether the lane of a node is a spawn candidate, i.e. it's
+     * part of the largest component.
+     */
+    bool spawnCandidate(int node) const { return components_[node] >= 0 && components_[node] == largestComponent_; }
+
+    /**
+     * @brief Gets all dead end nodes, in increasing order.
+     */
+    const std::vector<int>& deadEnds() const { return deadEnds_; }
+
+    /**
+     * @brief Gets all unreachable nodes, in increasing order.
+     */
+    const std::vector<int>& unreachableNodes() const { return unreachableNodes_; }
+
+    /**
+     * @brief Gets all stranding nodes, in increasing order.
+     */
+    const std::vector<int>& strandingNodes() const { return strandingNodes_; }
+
+    /**
+     * @brief Gets all spawn candidate nodes, in increasing order.
+     */
+    const std::vector<int>& spawnCandidates() const { return spawnCandidates_; }
+
+  private:
+    /**
+     * @brief Computes components_ and componentSizes_.
+     */
+    void computeComponents();
+
+    /**
+     * @brief Marks the nodes which can be reached from the largest component,
+     * following either the outgoing or the incoming edges.
+     *
+     * @param forward       True to follow the outgoing edges.
+     * @param reached       Is set to 1 for the reached nodes, 0 otherwise.
+     */
+    void markReachable(bool forward, std::vector<std::uint8_t>& reached) const;
+
+    const LaneGraph& graph_;
+
+    std::vector<int> components_;
+    std::vector<int> componentSizes_;
+    int largestComponent_ = -1;
+
+    std::vector<std::uint8_t> reachableFromLargest_;
+    std::vector<std::uint8_t> reachesLargest_;
+
+    std::vector<int> deadEnds_;
+    std::vector<int> unreachableNodes_;
+    std::vector<int> strandingNodes_;
+    std::vector<int> spawnCandidates_;
+};
+
+}}  // namespace aid::xodr
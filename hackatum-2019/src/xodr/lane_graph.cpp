@@ -0,0 +1,382 @@
+#include "lane_graph.h"
+
+#include <algorithm>
+#include <tuple>
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief An edge of a LaneGraph while it's being built.
+ */
+struct PendingEdge
+{
+    int from_;
+    int to_;
+    LaneGraph::EdgeType type_;
+};
+
+/**
+ * @brief Computes the time to drive along a lane at its speed limits.
+ *
+ * @param lane              The lane.
+ * @param length            The length of the lane section.
+ * @param defaultSpeed      The speed where no speed limit applies.
+ * @returns                 The travel time in seconds.
+ */
+static double travelTime(const LaneSection::Lane& lane, double length, double defaultSpeed)
+{
+    double ret = 0;
+    double s = 0;
+    double speed = defaultSpeed;
+    for (const LaneSpeedLimit& speedLimit : lane.speedLimits())
+    {
+        double end = std::min(length, std::max(s, speedLimit.sOffset()));
+        ret += (end - s) / speed;
+        s = end;
+
+        double limit = speedLimit.maxSpeedMetersPerSecond();
+        speed = limit > 0 ? limit : defaultSpeed;
+    }
+    return ret + (length - s) / speed;
+}
+
+/**
+ * @brief Checks whether a lane is left at the given contact point of its lane
+ * section when driving along it.
+ *
+ * @param laneId            The id of the lane.
+ * @param contactPoint      The contact point.
+ * @returns                 True if the lane ends at the contact point in its
+ *                          driving direction.
+ */
+static bool exitsAt(LaneID laneId, ContactPoint contactPoint)
+{
+    return laneId < LaneID(0) ? contactPoint == ContactPoint::END : contactPoint == ContactPoint::START;
+}
+
+/**
+ * @brief Gets the global index of the lane with the given id, or -1 if the
+ * lane section has no such lane.
+ *
+ * @param laneSection       The lane section.
+ * @param laneId            The lane id.
+ * @returns                 The global lane index, or -1.
+ */
+static int globalLaneIndex(const LaneSection& laneSection, LaneID laneId)
+{
+    if (laneId == LaneID(0) || laneId > LaneID(laneSection.numLeftLanes()) ||
+        laneId < LaneID(-laneSection.numRightLanes()))
+    {
+        return -1;
+    }
+    return laneSection.laneById(laneId).globalIndex();
+}
+
+/**
+ * @brief Adds the edge between two linked lanes, in the direction in which
+ * they're driven.
+ *
+ * Nothing is added if the lanes are driven in opposite directions, since the
+ * link is invalid then. See validateLinks() to find such links.
+ *
+ * @param edges             The vector to which the edge is appended.
+ * @param aSection          The lane section of lane A.
+ * @param aContactPoint     The contact point on aSection at which the lanes are linked.
+ * @param aLaneId           The id of lane A.
+ * @param bSection          The lane section of lane B.
+ * @param bContactPoint     The contact point on bSection at which the lanes are linked.
+ * @param bLaneId           The id of lane B.
+ */
+static void addLinkEdge(std::vector<PendingEdge>& edges, const LaneSection& aSection, ContactPoint aContactPoint,
+                        LaneID aLaneId, const LaneSection& bSection, ContactPoint bContactPoint, LaneID bLaneId)
+{
+    int a = globalLaneIndex(aSection, aLaneId);
+    int b = globalLaneIndex(bSection, bLaneId);
+    if (a < 0 || b < 0)
+    {
+        return;
+    }
+
+    bool aExits = exitsAt(aLaneId, aContactPoint);
+    bool bExits = exitsAt(bLaneId, bContactPoint);
+    if (aExits && !bExits)
+    {
+        edges.push_back({a, b, LaneGraph::EdgeType::SUCCESSOR});
+    }
+    else if (bExits && !aExits)
+    {
+        edges.push_back({b, a, LaneGraph::EdgeType::SUCCESSOR});
+    }
+}
+
+/**
+ * @brief Adds the edges for the lane links of a lane section to a lane
+ * section of another road, or to the next lane section of the same road.
+ *
+ * @param edges             The vector to which the edges are appended.
+ * @param fromSection       The lane section whose lane links are used.
+ * @param fromContactPoint  The contact point on fromSection.
+ * @param toSection         The lane section to which the lanes link.
+ * @param toContactPoint    The contact point on toSection.
+ */
+static void addLaneLinkEdges(std::vector<PendingEdge>& edges, const LaneSection& fromSection,
+                             ContactPoint fromContactPoint, const LaneSection& toSection, ContactPoint toContactPoint)
+{
+    RoadLinkType linkType = linkTypeForContactPoint(fromContactPoint);
+
+    const auto& lanes = fromSection.lanes();
+    for (int i = 0; i < static_cast<int>(lanes.size()); i++)
+    {
+        if (lanes[i].hasLink(linkType))
+        {
+            addLinkEdge(edges, fromSection, fromContactPoint, fromSection.laneIndexToId(i), toSection, toContactPoint,
+                        lanes[i].link(linkType));
+        }
+    }
+}
+
+/**
+ * @brief Finds the contact point on the incoming road of a junction connection.
+ *
+ * @param map               The map.
+ * @param junctionIdx       The index of the junction.
+ * @param connection        The connection.
+ * @param contactPoint      Set to the contact point if it's found.
+ * @returns                 True if the contact point is found.
+ */
+static bool findIncomingContactPoint(const XodrMap& map, int junctionIdx, const Junction::Connection& connection,
+                                     ContactPoint& contactPoint)
+{
+    const int incomingRoadIdx = connection.incomingRoad().index();
+    const Road& connectingRoad = map.roads()[connection.connectingRoad().index()];
+    const Road& incomingRoad = map.roads()[incomingRoadIdx];
+
+    // The connecting road links back to the incoming road, which gives the
+    // contact point directly.
+    const RoadLink& backLink = connectingRoad.roadLink(linkTypeForContactPoint(connection.contactPoint()));
+    if (backLink.elementType() == RoadLink::ElementType::ROAD && backLink.elementRef().index() == incomingRoadIdx)
+    {
+        contactPoint = backLink.contactPoint();
+        return true;
+    }
+
+    // Otherwise, it's the end of the incoming road which links to the junction.
+    for (const RoadLinkType linkType : {RoadLinkType::PREDECESSOR, RoadLinkType::SUCCESSOR})
+    {
+        const RoadLink& roadLink = incomingRoad.roadLink(linkType);
+        if (roadLink.elementType() == RoadLink::ElementType::JUNCTION && roadLink.elementRef().index() == junctionIdx)
+        {
+            contactPoint = contactPointForLinkType(linkType);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+LaneGraph::LaneGraph(const XodrMap& map, const LaneGraphOptions& options) : map_(map)
+{
+    const int numLanes = map.totalNumLanes();
+    laneKeys_.resize(numLanes, LaneKey(-1, -1, -1));
+    drivable_.resize(numLanes, 0);
+    laneLengths_.resize(numLanes, 0);
+    laneTravelTimes_.resize(numLanes, 0);
+
+    std::vector<PendingEdge> edges;
+
+    const auto& roads = map.roads();
+    for (int roadIdx = 0; roadIdx < static_cast<int>(roads.size()); roadIdx++)
+    {
+        const Road& road = roads[roadIdx];
+        const auto& laneSections = road.laneSections();
+        for (int laneSectionIdx = 0; laneSectionIdx < static_cast<int>(laneSections.size()); laneSectionIdx++)
+        {
+            const LaneSection& laneSection = laneSections[laneSectionIdx];
+            const double length = laneSection.endS() - laneSection.startS();
+
+            const auto& lanes = laneSection.lanes();
+            for (int laneIdx = 0; laneIdx < static_cast<int>(lanes.size()); laneIdx++)
+            {
+                const int node = lanes[laneIdx].globalIndex();
+                laneKeys_[node] = LaneKey(roadIdx, laneSectionIdx, laneIdx);
+                drivable_[node] = isDrivable(lanes[laneIdx].type());
+                laneLengths_[node] = length;
+                laneTravelTimes_[node] = travelTime(lanes[laneIdx], length, options.defaultSpeed_);
+            }
+
+            // Lane changes between neighboring lanes on the same side of the
+            // reference line. Going to a lower lane index is going to the left
+            // in the direction of the reference line, which is the driving
+            // direction of the right lanes.
+            for (int laneIdx = 0; laneIdx + 1 < static_cast<int>(lanes.size()); laneIdx++)
+            {
+                if (laneIdx + 1 == laneSection.numLeftLanes())
+                {
+                    continue;
+                }
+
+                const bool rightSide = laneIdx >= laneSection.numLeftLanes();
+                const int a = lanes[laneIdx].globalIndex();
+                const int b = lanes[laneIdx + 1].globalIndex();
+                edges.push_back({a, b, rightSide ? EdgeType::LANE_CHANGE_RIGHT : EdgeType::LANE_CHANGE_LEFT});
+                edges.push_back({b, a, rightSide ? EdgeType::LANE_CHANGE_LEFT : EdgeType::LANE_CHANGE_RIGHT});
+            }
+
+            // Links to the next lane section of the same road. Both directions
+            // are used, so that a link which is only specified on one side
+            // still results in an edge.
+            if (laneSectionIdx + 1 < static_cast<int>(laneSections.size()))
+            {
+                const LaneSection& next = laneSections[laneSectionIdx + 1];
+                addLaneLinkEdges(edges, laneSection, ContactPoint::END, next, ContactPoint::START);
+                addLaneLinkEdges(edges, next, ContactPoint::START, laneSection, ContactPoint::END);
+            }
+        }
+
+        if (laneSections.empty())
+        {
+            continue;
+        }
+
+        // Links to other roads. Lane links of roads which link to a junction
+        // are ambiguous, the junction lane links are used for these instead.
+        for (const RoadLinkType linkType : {RoadLinkType::PREDECESSOR, RoadLinkType::SUCCESSOR})
+        {
+            const RoadLink& roadLink = road.roadLink(linkType);
+            if (roadLink.elementType() == RoadLink::ElementType::ROAD)
+            {
+                const Road& otherRoad = roads[roadLink.elementRef().index()];
+                if (!otherRoad.laneSections().empty())
+                {
+                    addLaneLinkEdges(edges, road.laneSectionForExternalLinkType(linkType),
+                                     contactPointForLinkType(linkType),
+                                     otherRoad.laneSectionForContactPoint(roadLink.contactPoint()),
+                                     roadLink.contactPoint());
+                }
+            }
+        }
+    }
+
+    const auto& junctions = map.junctions();
+    for (int junctionIdx = 0; junctionIdx < static_cast<int>(junctions.size()); junctionIdx++)
+    {
+        for (const Junction::Connection& connection : junctions[junctionIdx].connections())
+        {
+            const Road& incomingRoad = roads[connection.incomingRoad().index()];
+            const Road& connectingRoad = roads[connection.connectingRoad().index()];
+
+            ContactPoint incomingContactPoint;
+            if (incomingRoad.laneSections().empty() || connectingRoad.laneSections().empty() ||
+                !findIncomingContactPoint(map, junctionIdx, connection, incomingContactPoint))
+            {
+                continue;
+            }
+
+            const LaneSection& incomingSection = incomingRoad.laneSectionForContactPoint(incomingContactPoint);
+            const LaneSection& connectingSection = connectingRoad.laneSectionForContactPoint(connection.contactPoint());
+            for (const Junction::LaneLink& laneLink : connection.laneLinks())
+            {
+                addLinkEdge(edges, incomingSection, incomingContactPoint, laneLink.from(), connectingSection,
+                            connection.contactPoint(), laneLink.to());
+            }
+        }
+    }
+
+    // Drop the edges of lanes which aren't drivable, and the duplicates which
+    // result from links which are specified in both directions.
+    edges.erase(std::remove_if(edges.begin(), edges.end(),
+                               [&](const PendingEdge& e) { return !drivable_[e.from_] || !drivable_[e.to_]; }),
+                edges.end());
+    std::sort(edges.begin(), edges.end(), [](const PendingEdge& a, const PendingEdge& b) {
+        return std::tie(a.from_, a.to_) < std::tie(b.from_, b.to_);
+    });
+    edges.erase(std::unique(edges.begin(), edges.end(),
+                            [](const PendingEdge& a, const PendingEdge& b) {
+                                return a.from_ == b.from_ && a.to_ == b.to_;
+                            }),
+                edges.end());
+
+    const int numEdges = static_cast<int>(edges.size());
+    successorOffsets_.assign(numLanes + 1, 0);
+    predecessorOffsets_.assign(numLanes + 1, 0);
+    edgeSources_.resize(numEdges);
+    edgeTargets_.resize(numEdges);
+    edgeTypes_.resize(numEdges);
+    edgeLengths_.resize(numEdges);
+    edgeTravelTimes_.resize(numEdges);
+
+    for (int i = 0; i < numEdges; i++)
+    {
+        const PendingEdge& e = edges[i];
+        edgeSources_[i] = e.from_;
+        edgeTargets_[i] = e.to_;
+        edgeTypes_[i] = e.type_;
+
+        if (e.type_ == EdgeType::SUCCESSOR)
+        {
+            edgeLengths_[i] = laneLengths_[e.from_];
+            edgeTravelTimes_[i] = laneTravelTimes_[e.from_];
+        }
+        else
+        {
+            // A lane change is charged at the average speed of the source lane.
+            edgeLengths_[i] = options.laneChangeLength_;
+            edgeTravelTimes_[i] = laneTravelTimes_[e.from_] > 0
+                                      ? options.laneChangeLength_ * laneTravelTimes_[e.from_] / laneLengths_[e.from_]
+                                      : options.laneChangeLength_ / options.defaultSpeed_;
+        }
+
+        successorOffsets_[e.from_ + 1]++;
+        predecessorOffsets_[e.to_ + 1]++;
+    }
+
+    for (int node = 0; node < numLanes; node++)
+    {
+        successorOffsets_[node + 1] += successorOffsets_[node];
+        predecessorOffsets_[node + 1] += predecessorOffsets_[node];
+    }
+
+    // The edges are sorted by their source, so filling the incoming edges in
+    // edge order keeps them sorted by their source as well.
+    predecessorEdges_.resize(numEdges);
+    std::vector<int> fill(predecessorOffsets_.begin(), predecessorOffsets_.end() - 1);
+    for (int i = 0; i < numEdges; i++)
+    {
+        predecessorEdges_[fill[edgeTargets_[i]]++] = i;
+    }
+}
+
+bool LaneGraph::isDrivable(LaneType type)
+{
+    switch (type)
+    {
+        case LaneType::DRIVING:
+        case LaneType::BIDIRECTIONAL:
+        case LaneType::ENTRY:
+        case LaneType::EXIT:
+        case LaneType::OFF_RAMP:
+        case LaneType::ON_RAMP:
+        case LaneType::CONNECTING_RAMP:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+int LaneGraph::node(LaneKey key) const
+{
+    const LaneSection& laneSection = laneSectionByKey(map_, LaneSectionKey(key.roadIdx_, key.laneSectionIdx_));
+    return laneSection.lanes()[key.laneIdx_].globalIndex();
+}
+
+int LaneGraph::findEdge(int from, int to) const
+{
+    // The outgoing edges of a node are sorted by their target.
+    auto begin = edgeTargets_.begin() + successorOffsets_[from];
+    auto end = edgeTargets_.begin() + successorOffsets_[from + 1];
+    auto it = std::lower_bound(begin, end, to);
+    return it != end && *it == to ? static_cast<int>(it - edgeTargets_.begin()) : -1;
+}
+
+}}  // namespace aid::xodr
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "xodr_map.h"
+#include "xodr_map_keys.h"
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief The options which control how a LaneGraph is built.
+ */
+struct LaneGraphOptions
+{
+    /**
+     * @brief The speed, in meters per second, which is assumed for lanes
+     * without a speed limit.
+     */
+    double defaultSpeed_ = 50 / 3.6;
+
+    /**
+     * @brief The length, in meters, which is charged for a lane change.
+     */
+    double laneChangeLength_ = 20;
+};
+
+/**
+ * @brief A lane level routing graph of an XodrMap.
+ *
+ * The nodes of the graph are the lanes of the map, and the index of a node is
+ * the global index of its lane (see LaneSection::Lane::globalIndex()). An edge
+ * from lane A to lane B means that a vehicle driving on lane A can continue on
+ * lane B, either because B is a successor of A in the driving direction, or
+ * because B is a neighbor of A into which it can change lanes.
+ *
+ * Lanes with a positive id are driven in the direction of decreasing
+ * s-coordinates, lanes with a negative id in the direction of increasing
+ * s-coordinates (right hand traffic). Only lanes of a drivable type (see
+ * isDrivable()) have edges.
+ *
+ * The edges are built once from the road links, the lane links and the
+ * junction lane links of the map, and are stored in compressed sparse row
+ * form: The outgoing edges of node n are the edges with indices
+ * [successorOffsets()[n], successorOffsets()[n + 1]), so iterating over the
+ * successors of a lane is a contiguous scan. The incoming edges are stored in
+ * the same way, as indices into the edge arrays.
+ */
+class LaneGraph
+{
+  public:
+    /**
+     * @brief The type of an edge.
+     */
+    enum class EdgeType : std::uint8_t
+    {
+        /**
+         * @brief The target lane is the successor of the source lane in the
+         * driving direction.
+         */
+        SUCCESSOR,
+
+        /**
+         * @brief The target lane is to the left of the source lane, in the
+         * driving direction.
+         */
+        LANE_CHANGE_LEFT,
+
+        /**
+         * @brief The target lane is to the right of the source lane, in the
+         * driving direction.
+         */
+        LANE_CHANGE_RIGHT
+    };
+
+    /**
+     * @brief Builds the lane graph of the given map.
+     *
+     * The map must outlive the graph.
+     *
+     * @param map           The map.
+     * @param options       The options.
+     */
+    explicit LaneGraph(const XodrMap& map, const LaneGraphOptions& options = LaneGraphOptions());
+
+    LaneGraph(const LaneGraph&) = delete;
+    LaneGraph& operator=(const LaneGraph&) = delete;
+
+    /**
+     * @brief Checks whether vehicles can be routed over lanes of the given type.
+     *
+     * @param type          The lane type.
+     * @returns             True for driving lanes and the other lane types
+     *                      which are part of the road network (ramps, entries,
+     *                      exits and bidirectional lanes).
+     */
+    static bool isDrivable(LaneType type);
+
+    /**
+     * @brief Gets the map.
+     */
+    const XodrMap& map() const { return map_; }
+
+    /**
+     * @brief Gets the number of nodes, which equals XodrMap::totalNumLanes().
+     */
+    int numNodes() const { return static_cast<int>(laneKeys_.size()); }
+
+    /**
+     * @brief Gets the number of edges.
+     */
+    int numEdges() const { return static_cast<int>(edgeTargets_.size()); }
+
+    /**
+     * @brief Gets the node of a lane.
+     *
+     * @param key           The key of the lane.
+     * @returns             The node index.
+     */
+    int node(LaneKey key) const;
+
+    /**
+     * @brief Gets the key of the lane of a node.
+     */
+    LaneKey laneKey(int node) const { return laneKeys_[node]; }
+
+    /**
+     * @brief Checks whether the lane of a node is drivable.
+     */
+    bool drivable(int node) const { return drivable_[node] != 0; }
+
+    /**
+     * @brief Gets the length of the lane of a node, which is measured along
+     * the reference line.
+     */
+    double laneLength(int node) const { return laneLengths_[node]; }
+
+    /**
+     * @brief Gets the time, in seconds, to drive along the lane of a node at
+     * its speed limit.
+     */
+    double laneTravelTime(int node) const { return laneTravelTimes_[node]; }
+
+    /**
+     * @brief The outgoing edges of node n are [successorOffsets()[n],
+     * successorOffsets()[n + 1]). This vector has numNodes() + 1 elements.
+     */
+    const std::vector<int>& successorOffsets() const { return successorOffsets_; }
+
+    /**
+     * @brief The incoming edges of node n are predecessorEdges()[i] for i in
+     * [predecessorOffsets()[n], predecessorOffsets()[n + 1]). This vector has
+     * numNodes() + 1 elements.
+     */
+    const std::vector<int>& predecessorOffsets() const { return predecessorOffsets_; }
+
+    /**
+     * @brief The indices of the incoming edges of all nodes, see predecessorOffsets().
+     */
+    const std::vector<int>& predecessorEdges() const { return predecessorEdges_; }
+
+    /**
+     * @brief The source node of each edge.
+     */
+    const std::vector<int>& edgeSources() const { return edgeSources_; }
+
+    /**
+     * @brief The target node of each edge.
+     */
+    const std::vector<int>& edgeTargets() const { return edgeTargets_; }
+
+    /**
+     * @brief The type of each edge.
+     */
+    const std::vector<EdgeType>& edgeTypes() const { return edgeTypes_; }
+
+    /**
+     * @brief The length cost of each edge, in meters.
+     *
+     * The cost of a SUCCESSOR edge is the length of its source lane, the cost
+     * of a lane change is LaneGraphOptions::laneChangeLength_. The cost of a
+     * path is therefore the distance driven up to the start of its last lane.
+     */
+    const std::vector<double>& edgeLengths() const { return edgeLengths_; }
+
+    /**
+     * @brief The travel time cost of each edge, in seconds.
+     *
+     * This is the time to drive the length cost of the edge at the speed
+     * limits of the source lane.
+     */
+    const std::vector<double>& edgeTravelTimes() const { return edgeTravelTimes_; }
+
+    /**
+     * @brief Gets the number of outgoing edges of a node.
+     */
+    int numSuccessors(int node) const { return successorOffsets_[node + 1] - successorOffsets_[node]; }
+
+    /**
+     * @brief Gets the number of incoming edges of a node.
+     */
+    int numPredecessors(int node) const { return predecessorOffsets_[node + 1] - predecessorOffsets_[node]; }
+
+    /**
+     * @brief Finds the edge from one node to another.
+     *
+     * @param from          The source node.
+     * @param to            The target node.
+     * @returns             The edge index, or -1 if there's no such edge.
+     */
+    int findEdge(int from, int to) const;
+
+  private:
+    const XodrMap& map_;
+
+    std::vector<LaneKey> laneKeys_;
+    std::vector<std::uint8_t> drivable_;
+    std::vector<double> laneLengths_;
+    std::vector<double> laneTravelTimes_;
+
+    std::vector<int> successorOffsets_;
+    std::vector<int> edgeSources_;
+    std::vector<int> edgeTargets_;
+    std::vector<EdgeType> edgeTypes_;
+    std::vector<double> edgeLengths_;
+    std::vector<double> edgeTravelTimes_;
+
+    std::vector<int> predecessorOffsets_;
+    std::vector<int> predecessorEdges_;
+};
+
+}}  // namespace aid::xodr
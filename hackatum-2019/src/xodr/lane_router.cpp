@@ -0,0 +1,383 @@
+#include "lane_router.h"
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief Computes the points where the lanes of a lane graph are entered in
+ * their driving direction, on the reference line.
+ *
+ * @param graph             The lane graph.
+ * @returns                 The entry point of each node.
+ */
+static std::vector<Eigen::Vector2d> laneEntryPoints(const LaneGraph& graph)
+{
+    std::vector<Eigen::Vector2d> ret(graph.numNodes(), Eigen::Vector2d::Zero());
+    for (int node = 0; node < graph.numNodes(); node++)
+    {
+        if (!graph.drivable(node))
+        {
+            continue;
+        }
+
+        const LaneKey key = graph.laneKey(node);
+        const Road& road = graph.map().roads()[key.roadIdx_];
+        const LaneSection& laneSection = road.laneSections()[key.laneSectionIdx_];
+
+        // Left lanes are driven against the direction of the reference line.
+        const bool leftLane = key.laneIdx_ < laneSection.numLeftLanes();
+        const double s = leftLane ? laneSection.endS() : laneSection.startS();
+        ret[node] = road.referenceLine().eval(std::min(s, road.length())).point_;
+    }
+    return ret;
+}
+
+/**
+ * @brief Computes the factor which converts a straight line distance into a
+ * lower bound of the cost to travel it.
+ *
+ * @param graph             The lane graph.
+ * @param cost              The cost type.
+ * @returns                 The factor.
+ */
+static double heuristicScale(const LaneGraph& graph, RouteCost cost)
+{
+    if (cost == RouteCost::LENGTH)
+    {
+        return 1;
+    }
+
+    // The travel time over a distance is at least the distance divided by the
+    // highest speed in the graph.
+    double maxSpeed = 0;
+    for (int e = 0; e < graph.numEdges(); e++)
+    {
+        if (graph.edgeTypes()[e] == LaneGraph::EdgeType::SUCCESSOR && graph.edgeTravelTimes()[e] > 0)
+        {
+            maxSpeed = std::max(maxSpeed, graph.edgeLengths()[e] / graph.edgeTravelTimes()[e]);
+        }
+    }
+    return maxSpeed > 0 ? 1 / maxSpeed : 0;
+}
+
+LaneRouter::LaneRouter(const LaneGraph& graph, RouteCost cost)
+    : graph_(graph), hierarchy_(nullptr), cost_(cost), edgeCosts_(laneGraphEdgeCosts(graph, cost)),
+      entryPoints_(laneEntryPoints(graph)), heuristicScale_(heuristicScale(graph, cost))
+{
+    for (Search* search : {&forward_, &backward_})
+    {
+        search->dist_.resize(graph.numNodes());
+        search->parent_.resize(graph.numNodes());
+        search->parentMiddle_.resize(graph.numNodes());
+        search->stamp_.resize(graph.numNodes(), 0);
+    }
+}
+
+LaneRouter::LaneRouter(const LaneGraph& graph, const ContractionHierarchy& hierarchy)
+    : LaneRouter(graph, hierarchy.cost())
+{
+    if (!hierarchy.matches(graph))
+    {
+        throw std::runtime_error("The contraction hierarchy wasn't built from the given lane graph.");
+    }
+    hierarchy_ = &hierarchy;
+}
+
+Route LaneRouter::route(int from, int to, RoutingAlgorithm algorithm)
+{
+    startQuery();
+
+    if (from == to)
+    {
+        Route ret;
+        ret.nodes_.push_back(from);
+        ret.cost_ = 0;
+        return ret;
+    }
+
+    switch (algorithm)
+    {
+        default:
+        case RoutingAlgorithm::DIJKSTRA:
+            return dijkstra(from, to, false);
+
+        case RoutingAlgorithm::A_STAR:
+            return dijkstra(from, to, true);
+
+        case RoutingAlgorithm::BIDIRECTIONAL_DIJKSTRA:
+            return bidirectionalDijkstra(from, to);
+
+        case RoutingAlgorithm::CONTRACTION_HIERARCHY:
+            if (!hierarchy_)
+            {
+                throw std::runtime_error("The router doesn't have a contraction hierarchy.");
+            }
+            return contractionHierarchyQuery(from, to);
+    }
+}
+
+Route LaneRouter::route(int from, int to)
+{
+    return route(from, to, hierarchy_ ? RoutingAlgorithm::CONTRACTION_HIERARCHY : RoutingAlgorithm::A_STAR);
+}
+
+void LaneRouter::startQuery()
+{
+    // When the stamp wraps around, old stamps could be mistaken for current
+    // ones, so they're cleared.
+    if (++currentStamp_ == 0)
+    {
+        for (Search* search : {&forward_, &backward_})
+        {
+            std::fill(search->stamp_.begin(), search->stamp_.end(), 0);
+        }
+        currentStamp_ = 1;
+    }
+
+    forward_.queue_.clear();
+    backward_.queue_.clear();
+    numSettled_ = 0;
+}
+
+double LaneRouter::dist(const Search& search, int node) const
+{
+    return search.stamp_[node] == currentStamp_ ? search.dist_[node] : std::numeric_limits<double>::infinity();
+}
+
+void LaneRouter::relax(Search& search, int node, double dist, double key, int parent, int parentMiddle)
+{
+    if (dist < this->dist(search, node))
+    {
+        search.stamp_[node] = currentStamp_;
+        search.dist_[node] = dist;
+        search.parent_[node] = parent;
+        search.parentMiddle_[node] = parentMiddle;
+
+        search.queue_.push_back({key, node});
+        std::push_heap(search.queue_.begin(), search.queue_.end(), std::greater<QueueEntry>());
+    }
+}
+
+double LaneRouter::heuristic(int node, int to) const
+{
+    return (entryPoints_[node] - entryPoints_[to]).norm() * heuristicScale_;
+}
+
+/**
+ * @brief Removes the entries from the top of a queue which were superseded by
+ * an entry with a lower key.
+ *
+ * @param queue             The queue.
+ * @param isStale           Returns whether an entry is stale.
+ * @returns                 True if the queue isn't empty.
+ */
+template <class Entry, class F>
+static bool popStaleEntries(std::vector<Entry>& queue, F&& isStale)
+{
+    while (!queue.empty() && isStale(queue.front()))
+    {
+        std::pop_heap(queue.begin(), queue.end(), std::greater<Entry>());
+        queue.pop_back();
+    }
+    return !queue.empty();
+}
+
+Route LaneRouter::dijkstra(int from, int to, bool useHeuristic)
+{
+    auto h = [&](int node) { return useHeuristic ? heuristic(node, to) : 0.0; };
+    auto isStale = [&](const QueueEntry& entry) { return entry.key_ > dist(forward_, entry.node_) + h(entry.node_); };
+
+    relax(forward_, from, 0, h(from), -1, -1);
+    relax(backward_, to, 0, 0, -1, -1);
+
+    const std::vector<int>& offsets = graph_.successorOffsets();
+    const std::vector<int>& targets = graph_.edgeTargets();
+    while (popStaleEntries(forward_.queue_, isStale))
+    {
+        const int node = forward_.queue_.front().node_;
+        std::pop_heap(forward_.queue_.begin(), forward_.queue_.end(), std::greater<QueueEntry>());
+        forward_.queue_.pop_back();
+        numSettled_++;
+
+        if (node == to)
+        {
+            return buildRoute(from, to, to, false);
+        }
+
+        const double nodeDist = dist(forward_, node);
+        for (int e = offsets[node]; e < offsets[node + 1]; e++)
+        {
+            const int target = targets[e];
+            const double targetDist = nodeDist + edgeCosts_[e];
+            relax(forward_, target, targetDist, targetDist + h(target), node, -1);
+        }
+    }
+
+    return Route();
+}
+
+Route LaneRouter::bidirectionalDijkstra(int from, int to)
+{
+    relax(forward_, from, 0, 0, -1, -1);
+    relax(backward_, to, 0, 0, -1, -1);
+
+    double best = std::numeric_limits<double>::infinity();
+    int meet = -1;
+
+    auto forwardStale = [&](const QueueEntry& entry) { return entry.key_ > dist(forward_, entry.node_); };
+    auto backwardStale = [&](const QueueEntry& entry) { return entry.key_ > dist(backward_, entry.node_); };
+
+    while (popStaleEntries(forward_.queue_, forwardStale) && popStaleEntries(backward_.queue_, backwardStale))
+    {
+        // No path through an unsettled node can be shorter than the sum of
+        // the smallest keys.
+        const double forwardKey = forward_.queue_.front().key_;
+        const double backwardKey = backward_.queue_.front().key_;
+        if (forwardKey + backwardKey >= best)
+        {
+            break;
+        }
+
+        const bool forward = forwardKey <= backwardKey;
+        Search& search = forward ? forward_ : backward_;
+        Search& other = forward ? backward_ : forward_;
+
+        const int node = search.queue_.front().node_;
+        std::pop_heap(search.queue_.begin(), search.queue_.end(), std::greater<QueueEntry>());
+        search.queue_.pop_back();
+        numSettled_++;
+
+        const double nodeDist = dist(search, node);
+        const std::vector<int>& offsets = forward ? graph_.successorOffsets() : graph_.predecessorOffsets();
+        for (int i = offsets[node]; i < offsets[node + 1]; i++)
+        {
+            const int e = forward ? i : graph_.predecessorEdges()[i];
+            const int neighbor = forward ? graph_.edgeTargets()[e] : graph_.edgeSources()[e];
+            const double neighborDist = nodeDist + edgeCosts_[e];
+            relax(search, neighbor, neighborDist, neighborDist, node, -1);
+
+            const double total = dist(search, neighbor) + dist(other, neighbor);
+            if (total < best)
+            {
+                best = total;
+                meet = neighbor;
+            }
+        }
+    }
+
+    return meet >= 0 ? buildRoute(from, meet, to, false) : Route();
+}
+
+Route LaneRouter::contractionHierarchyQuery(int from, int to)
+{
+    const ContractionHierarchy& ch = *hierarchy_;
+
+    relax(forward_, from, 0, 0, -1, -1);
+    relax(backward_, to, 0, 0, -1, -1);
+
+    double best = std::numeric_limits<double>::infinity();
+    int meet = -1;
+
+    auto forwardStale = [&](const QueueEntry& entry) { return entry.key_ > dist(forward_, entry.node_); };
+    auto backwardStale = [&](const QueueEntry& entry) { return entry.key_ > dist(backward_, entry.node_); };
+
+    // Both searches only go up in rank, so they can't stop when they meet.
+    // Each one continues until its smallest key exceeds the best route.
+    while (true)
+    {
+        const bool hasForward = popStaleEntries(forward_.queue_, forwardStale) && forward_.queue_.front().key_ < best;
+        const bool hasBackward =
+            popStaleEntries(backward_.queue_, backwardStale) && backward_.queue_.front().key_ < best;
+        if (!hasForward && !hasBackward)
+        {
+            break;
+        }
+
+        const bool forward =
+            hasForward && (!hasBackward || forward_.queue_.front().key_ <= backward_.queue_.front().key_);
+        Search& search = forward ? forward_ : backward_;
+        Search& other = forward ? backward_ : forward_;
+
+        const int node = search.queue_.front().node_;
+        std::pop_heap(search.queue_.begin(), search.queue_.end(), std::greater<QueueEntry>());
+        search.queue_.pop_back();
+        numSettled_++;
+
+        const double nodeDist = dist(search, node);
+        const double total = nodeDist + dist(other, node);
+        if (total < best)
+        {
+            best = total;
+            meet = node;
+        }
+
+        const std::vector<int>& offsets = forward ? ch.upOffsets() : ch.downOffsets();
+        const std::vector<int>& neighbors = forward ? ch.upTargets() : ch.downSources();
+        const std::vector<double>& costs = forward ? ch.upCosts() : ch.downCosts();
+        const std::vector<int>& middles = forward ? ch.upMiddles() : ch.downMiddles();
+        for (int e = offsets[node]; e < offsets[node + 1]; e++)
+        {
+            const double neighborDist = nodeDist + costs[e];
+            relax(search, neighbors[e], neighborDist, neighborDist, node, middles[e]);
+        }
+    }
+
+    return meet >= 0 ? buildRoute(from, meet, to, true) : Route();
+}
+
+Route LaneRouter::buildRoute(int from, int meet, int to, bool unpack) const
+{
+    Route ret;
+    ret.cost_ = dist(forward_, meet) + dist(backward_, meet);
+
+    // The forward search tree, from the meeting node back to the origin.
+    std::vector<int> forwardNodes;
+    for (int node = meet; node != from; node = forward_.parent_[node])
+    {
+        forwardNodes.push_back(node);
+    }
+    forwardNodes.push_back(from);
+    std::reverse(forwardNodes.begin(), forwardNodes.end());
+
+    // The backward search tree, from the meeting node to the destination.
+    std::vector<int> backwardNodes;
+    for (int node = meet; node != to; node = backward_.parent_[node])
+    {
+        backwardNodes.push_back(backward_.parent_[node]);
+    }
+
+    ret.nodes_.push_back(from);
+    for (int i = 1; i < static_cast<int>(forwardNodes.size()); i++)
+    {
+        const int node = forwardNodes[i];
+        if (unpack)
+        {
+            hierarchy_->unpackEdge(forwardNodes[i - 1], node, forward_.parentMiddle_[node], ret.nodes_);
+        }
+        else
+        {
+            ret.nodes_.push_back(node);
+        }
+    }
+
+    int prev = meet;
+    for (int node : backwardNodes)
+    {
+        if (unpack)
+        {
+            hierarchy_->unpackEdge(prev, node, backward_.parentMiddle_[prev], ret.nodes_);
+        }
+        else
+        {
+            ret.nodes_.push_back(node);
+        }
+        prev = node;
+    }
+
+    return ret;
+}
+
+}}  // namespace aid::xodr
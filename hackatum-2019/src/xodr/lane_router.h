@@ -0,0 +1,203 @@
+#pragma once
+
+#include <Eigen/Dense>
+#include <limits>
+#include <vector>
+
+#include "contraction_hierarchy.h"
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief The shortest path algorithm which is used by LaneRouter::route().
+ */
+enum class RoutingAlgorithm
+{
+    /**
+     * @brief Plain Dijkstra, mainly as a reference for the other algorithms.
+     */
+    DIJKSTRA,
+
+    /**
+     * @brief A* with the straight line distance to the destination as the
+     * heuristic.
+     */
+    A_STAR,
+
+    /**
+     * @brief Dijkstra from both ends of the route at the same time.
+     */
+    BIDIRECTIONAL_DIJKSTRA,
+
+    /**
+     * @brief A query on a ContractionHierarchy, which requires the router to
+     * be constructed with one.
+     */
+    CONTRACTION_HIERARCHY
+};
+
+/**
+ * @brief A route on a LaneGraph.
+ */
+struct Route
+{
+    /**
+     * @brief The nodes (lanes) of the route, from the origin to the
+     * destination, or empty if there's no route.
+     */
+    std::vector<int> nodes_;
+
+    /**
+     * @brief The cost of the route, which is the sum of the costs of its
+     * edges, or infinity if there's no route.
+     */
+    double cost_ = std::numeric_limits<double>::infinity();
+
+    /**
+     * @brief Checks whether a route was found.
+     */
+    bool found() const { return !nodes_.empty(); }
+};
+
+/**
+ * @brief Finds shortest routes between lanes on a LaneGraph.
+ *
+ * A router holds the per query working memory, which is reused between
+ * queries. Routers are cheap to construct, and aren't thread safe, so each
+ * thread should have its own router. The graph and the hierarchy can be
+ * shared between the routers of all threads.
+ *
+ * The A* heuristic is the straight line distance between the points where the
+ * lanes are entered, on the reference line. It's admissible as long as the
+ * reference lines of linked roads meet at their contact points, which holds for
+ * maps which pass the geometric validation up to its tolerance.
+ */
+class LaneRouter
+{
+  public:
+    /**
+     * @brief Constructs a router without a contraction hierarchy.
+     *
+     * The graph must outlive the router.
+     *
+     * @param graph         The lane graph.
+     * @param cost          The cost to minimize.
+     */
+    explicit LaneRouter(const LaneGraph& graph, RouteCost cost = RouteCost::LENGTH);
+
+    /**
+     * @brief Constructs a router which can use a contraction hierarchy.
+     *
+     * The cost to minimize is the cost of the hierarchy. The graph and the
+     * hierarchy must outlive the router. An exception is thrown if the
+     * hierarchy wasn't built from the graph.
+     *
+     * @param graph         The lane graph.
+     * @param hierarchy     The contraction hierarchy of the graph.
+     */
+    LaneRouter(const LaneGraph& graph, const ContractionHierarchy& hierarchy);
+
+    /**
+     * @brief Finds the shortest route between two lanes.
+     *
+     * The route starts at the beginning of the origin lane and ends at the
+     * beginning of the destination lane (in the driving direction), see
+     * LaneGraph::edgeLengths().
+     *
+     * @param from          The node of the origin lane.
+     * @param to            The node of the destination lane.
+     * @param algorithm     The algorithm to use.
+     * @returns             The route.
+     */
+    Route route(int from, int to, RoutingAlgorithm algorithm);
+
+    /**
+     * @brief Finds the shortest route between two lanes with the fastest
+     * available algorithm.
+     *
+     * This is a contraction hierarchy query if the router has a hierarchy,
+     * and A* otherwise.
+     */
+    Route route(int from, int to);
+
+    /**
+     * @brief Gets the cost to minimize.
+     */
+    RouteCost cost() const { return cost_; }
+
+    /**
+     * @brief Gets the number of nodes which were settled by the last query.
+     */
+    int numSettled() const { return numSettled_; }
+
+  private:
+    /**
+     * @brief A node in the queue of a search, ordered by its key.
+     */
+    struct QueueEntry
+    {
+        double key_;
+        int node_;
+
+        bool operator>(const QueueEntry& b) const { return key_ > b.key_; }
+    };
+
+    /**
+     * @brief The state of one search direction.
+     */
+    struct Search
+    {
+        std::vector<double> dist_;
+        std::vector<int> parent_;
+        std::vector<int> parentMiddle_;
+        std::vector<unsigned> stamp_;
+        std::vector<QueueEntry> queue_;
+    };
+
+    Route dijkstra(int from, int to, bool useHeuristic);
+    Route bidirectionalDijkstra(int from, int to);
+    Route contractionHierarchyQuery(int from, int to);
+
+    /**
+     * @brief Starts a new query, which invalidates the state of all searches.
+     */
+    void startQuery();
+
+    /**
+     * @brief Gets the distance of a node in a search, which is infinity if it
+     * wasn't reached in the current query.
+     */
+    double dist(const Search& search, int node) const;
+
+    /**
+     * @brief Updates the distance and parent of a node in a search if the
+     * given distance is smaller, and queues it with the given key.
+     */
+    void relax(Search& search, int node, double dist, double key, int parent, int parentMiddle);
+
+    /**
+     * @brief Gets the A* heuristic of a node for the given destination.
+     */
+    double heuristic(int node, int to) const;
+
+    /**
+     * @brief Builds a route from the parents of the forward and backward
+     * searches, which meet at the given node.
+     */
+    Route buildRoute(int from, int meet, int to, bool unpack) const;
+
+    const LaneGraph& graph_;
+    const ContractionHierarchy* hierarchy_;
+    RouteCost cost_;
+    const std::vector<double>& edgeCosts_;
+
+    std::vector<Eigen::Vector2d> entryPoints_;
+    double heuristicScale_;
+
+    Search forward_;
+    Search backward_;
+    unsigned currentStamp_ = 0;
+    int numSettled_ = 0;
+};
+
+}}  // namespace aid::xodr
@@ -0,0 +1,139 @@
+#include "lane_table.h"
+
+#include <limits>
+#include <unordered_map>
+
+namespace aid { namespace xodr {
+
+constexpr int LaneTable::NO_LANE;
+
+/**
+ * @brief Gets the global index of the lane with the given id, or
+ * LaneTable::NO_LANE if the lane section has no such lane.
+ *
+ * @param laneSection       The lane section.
+ * @param laneId            The lane id.
+ * @returns                 The global lane index, or LaneTable::NO_LANE.
+ */
+static int globalLaneIndex(const LaneSection& laneSection, LaneID laneId)
+{
+    if (laneId == LaneID(0) || laneId > LaneID(laneSection.numLeftLanes()) ||
+        laneId < LaneID(-laneSection.numRightLanes()))
+    {
+        return LaneTable::NO_LANE;
+    }
+    return laneSection.laneById(laneId).globalIndex();
+}
+
+/**
+ * @brief Gets the global index of the lane which a lane is linked to.
+ *
+ * @param map               The map.
+ * @param laneSectionKey    The lane section of the lane.
+ * @param lane              The lane.
+ * @param linkType          The type of the link.
+ * @returns                 The global lane index, or LaneTable::NO_LANE if the
+ *                          lane has no such link, or the linked lane can't be
+ *                          determined without a junction.
+ */
+static int linkedGlobalLaneIndex(const XodrMap& map, LaneSectionKey laneSectionKey, const LaneSection::Lane& lane,
+                                 RoadLinkType linkType)
+{
+    if (!lane.hasLink(linkType))
+    {
+        return LaneTable::NO_LANE;
+    }
+
+    const Road& road = map.roads()[laneSectionKey.roadIdx_];
+    const int linkedSectionIdx = laneSectionKey.laneSectionIdx_ + (linkType == RoadLinkType::SUCCESSOR ? 1 : -1);
+    if (linkedSectionIdx >= 0 && linkedSectionIdx < static_cast<int>(road.laneSections().size()))
+    {
+        return globalLaneIndex(road.laneSections()[linkedSectionIdx], lane.link(linkType));
+    }
+
+    const RoadLink& roadLink = road.roadLink(linkType);
+    if (roadLink.elementType() != RoadLink::ElementType::ROAD)
+    {
+        return LaneTable::NO_LANE;
+    }
+
+    const Road& linkedRoad = map.roads()[roadLink.elementRef().index()];
+    if (linkedRoad.laneSections().empty())
+    {
+        return LaneTable::NO_LANE;
+    }
+    return globalLaneIndex(linkedRoad.laneSectionForContactPoint(roadLink.contactPoint()), lane.link(linkType));
+}
+
+LaneTable::LaneTable(const XodrMap& map)
+{
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const int numLanes = map.totalNumLanes();
+    laneKeys_.resize(numLanes, LaneKey(-1, -1, -1));
+    types_.resize(numLanes, LaneType::NONE);
+    lengths_.resize(numLanes, 0);
+    predecessors_.resize(numLanes, NO_LANE);
+    successors_.resize(numLanes, NO_LANE);
+    speedLimits_.resize(numLanes, nan);
+    materialSurfaces_.resize(numLanes, -1);
+    materialFrictions_.resize(numLanes, nan);
+    materialRoughnesses_.resize(numLanes, nan);
+
+    std::vector<const LaneSection::Lane*> lanesByIndex(numLanes, nullptr);
+    std::unordered_map<std::string, int> surfaceIndices;
+
+    const auto& roads = map.roads();
+    for (int roadIdx = 0; roadIdx < static_cast<int>(roads.size()); roadIdx++)
+    {
+        const auto& laneSections = roads[roadIdx].laneSections();
+        for (int laneSectionIdx = 0; laneSectionIdx < static_cast<int>(laneSections.size()); laneSectionIdx++)
+        {
+            const LaneSection& laneSection = laneSections[laneSectionIdx];
+            const LaneSectionKey laneSectionKey(roadIdx, laneSectionIdx);
+            const double length = laneSection.endS() - laneSection.startS();
+
+            const auto& lanes = laneSection.lanes();
+            for (int laneIdx = 0; laneIdx < static_cast<int>(lanes.size()); laneIdx++)
+            {
+                const LaneSection::Lane& lane = lanes[laneIdx];
+                const int i = lane.globalIndex();
+                laneKeys_[i] = LaneKey(laneSectionKey, laneIdx);
+                lanesByIndex[i] = &lane;
+                types_[i] = lane.type();
+                lengths_[i] = length;
+                predecessors_[i] = linkedGlobalLaneIndex(map, laneSectionKey, lane, RoadLinkType::PREDECESSOR);
+                successors_[i] = linkedGlobalLaneIndex(map, laneSectionKey, lane, RoadLinkType::SUCCESSOR);
+
+                if (!lane.speedLimits().empty())
+                {
+                    speedLimits_[i] = lane.speedLimits().front().maxSpeedMetersPerSecond();
+                }
+
+                if (!lane.materials().empty())
+                {
+                    const LaneMaterial& material = lane.materials().front();
+                    auto insertRes =
+                        surfaceIndices.insert(std::make_pair(material.surface(), static_cast<int>(surfaces_.size())));
+                    if (insertRes.second)
+                    {
+                        surfaces_.push_back(material.surface());
+                    }
+
+                    materialSurfaces_[i] = insertRes.first->second;
+                    materialFrictions_[i] = material.friction();
+                    materialRoughnesses_[i] = material.roughness();
+                }
+            }
+        }
+    }
+
+    // LaneID has no copy assignment, so the ids are appended in global index
+    // order instead of being assigned in the loop above.
+    ids_.reserve(numLanes);
+    for (const LaneSection::Lane* lane : lanesByIndex)
+    {
+        ids_.push_back(lane ? lane->id() : LaneID(0));
+    }
+}
+
+}}  // namespace aid::xodr
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "lane_id.h"
+#include "xodr_map.h"
+#include "xodr_map_keys.h"
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief A table with the most commonly used attributes of all lanes of an
+ * XodrMap, stored as one contiguous array per attribute.
+ *
+ * The arrays are indexed by the global lane index (see
+ * LaneSection::Lane::globalIndex()) and have XodrMap::totalNumLanes()
+ * elements. Since the lanes of a road form a consecutive range of global
+ * indices (see Road::globalLaneIndicesBegin()), the lanes of each road and
+ * lane section are also consecutive in the arrays, in the order of
+ * LaneSection::lanes().
+ *
+ * Scanning a single attribute of all lanes therefore reads one array from
+ * front to back, instead of visiting the lanes in the nested road, lane
+ * section and lane vectors, and disjoint index ranges can be processed in
+ * parallel.
+ *
+ * The table is built once, and isn't updated if the map changes.
+ */
+class LaneTable
+{
+  public:
+    /**
+     * @brief The global index of a missing lane, e.g. the successor of a lane
+     * without successor.
+     */
+    static constexpr int NO_LANE = -1;
+
+    /**
+     * @brief Builds the lane table of the given map.
+     *
+     * @param map           The map.
+     */
+    explicit LaneTable(const XodrMap& map);
+
+    /**
+     * @brief Gets the number of lanes, which equals XodrMap::totalNumLanes().
+     */
+    int numLanes() const { return static_cast<int>(laneKeys_.size()); }
+
+    /**
+     * @brief The key of each lane.
+     */
+    const std::vector<LaneKey>& laneKeys() const { return laneKeys_; }
+
+    /**
+     * @brief The id of each lane.
+     */
+    const std::vector<LaneID>& ids() const { return ids_; }
+
+    /**
+     * @brief The type of each lane.
+     */
+    const std::vector<LaneType>& types() const { return types_; }
+
+    /**
+     * @brief The length of each lane, which is the length of its lane section
+     * along the reference line.
+     */
+    const std::vector<double>& lengths() const { return lengths_; }
+
+    /**
+     * @brief The global index of the predecessor of each lane, or NO_LANE.
+     *
+     * Like the lane links it's derived from, this is the predecessor in the
+     * direction of the reference line, not in the driving direction. For the
+     * lanes of the first lane section of a road, the predecessor is in the
+     * road which is the predecessor of the road. It's NO_LANE if that's a
+     * junction, since the lane links are specified in the junction then, or
+     * if the linked lane doesn't exist.
+     */
+    const std::vector<int>& predecessors() const { return predecessors_; }
+
+    /**
+     * @brief The global index of the successor of each lane, or NO_LANE.
+     *
+     * See predecessors() for the details.
+     */
+    const std::vector<int>& successors() const { return successors_; }
+
+    /**
+     * @brief The first speed limit of each lane, in meters per second, or NaN
+     * if the lane has no speed limit.
+     */
+    const std::vector<double>& speedLimits() const { return speedLimits_; }
+
+    /**
+     * @brief The index into surfaces() of the surface of the first material of
+     * each lane, or -1 if the lane has no material.
+     */
+    const std::vector<int>& materialSurfaces() const { return materialSurfaces_; }
+
+    /**
+     * @brief The friction of the first material of each lane, or NaN if the
+     * lane has no material.
+     */
+    const std::vector<double>& materialFrictions() const { return materialFrictions_; }
+
+    /**
+     * @brief The roughness of the first material of each lane, or NaN if the
+     * lane has no material.
+     */
+    const std::vector<double>& materialRoughnesses() const { return materialRoughnesses_; }
+
+    /**
+     * @brief The distinct material surface names, see materialSurfaces().
+     */
+    const std::vector<std::string>& surfaces() const { return surfaces_; }
+
+  private:
+    std::vector<LaneKey> laneKeys_;
+    std::vector<LaneID> ids_;
+    std::vector<LaneType> types_;
+    std::vector<double> lengths_;
+    std::vector<int> predecessors_;
+    std::vector<int> successors_;
+    std::vector<double> speedLimits_;
+    std::vector<int> materialSurfaces_;
+    std::vector<double> materialFrictions_;
+    std::vector<double> materialRoughnesses_;
+
+    std::vector<std::string> surfaces_;
+};
+
+}}  // namespace aid::xodr
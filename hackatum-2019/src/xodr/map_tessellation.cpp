@@ -0,0 +1,233 @@
+#include "map_tessellation.h"
+
+#include "parallel.h"
+
+#include <cmath>
+#include <map>
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief A unit of work of tessellateMap(): a range of lane sections of a road.
+ */
+struct TessellationTask
+{
+    int roadIdx_;
+    int laneSectionBegin_;
+    int laneSectionEnd_;
+};
+
+template <class Scalar>
+size_t BasicMapTessellation<Scalar>::memoryUsage() const
+{
+    return sizeof(*this) + origins_.capacity() * sizeof(Eigen::Vector2d) +
+           (refLineS_.capacity() + refLineX_.capacity() + refLineY_.capacity() + refLineHeading_.capacity() +
+            boundaryX_.capacity() + boundaryY_.capacity()) *
+               sizeof(Scalar) +
+           (boundaryOffsets_.capacity() + roadOffsets_.capacity()) * sizeof(int) +
+           laneSections_.capacity() * sizeof(LaneSectionRange);
+}
+
+/**
+ * @brief Splits the lane sections of the given map into tasks.
+ *
+ * @param map               The map.
+ * @param maxTaskLength     Roads longer than this get one task per lane section.
+ * @returns                 The tasks, in map order.
+ */
+static std::vector<TessellationTask> makeTasks(const XodrMap& map, double maxTaskLength)
+{
+    std::vector<TessellationTask> ret;
+    for (int roadIdx = 0; roadIdx < static_cast<int>(map.roads().size()); roadIdx++)
+    {
+        const Road& road = map.roads()[roadIdx];
+        const int numLaneSections = static_cast<int>(road.laneSections().size());
+        if (road.length() > maxTaskLength)
+        {
+            for (int i = 0; i < numLaneSections; i++)
+            {
+                ret.push_back({roadIdx, i, i + 1});
+            }
+        }
+        else if (numLaneSections > 0)
+        {
+            ret.push_back({roadIdx, 0, numLaneSections});
+        }
+    }
+    return ret;
+}
+
+/**
+ * @brief Selects the origins of the lane sections of a tessellation.
+ *
+ * @param tessellations     The tessellations of all lane sections, in map order.
+ * @param roadOffsets       The index of the first lane section of each road,
+ *                          followed by the number of lane sections.
+ * @param options           The options.
+ * @param origins           Output: the origins.
+ * @param originIndices     Output: the index of the origin of each lane section.
+ */
+static void selectOrigins(const std::vector<LaneSectionTessellation>& tessellations,
+                          const std::vector<int>& roadOffsets, const MapTessellationOptions& options,
+                          std::vector<Eigen::Vector2d>& origins, std::vector<int>& originIndices)
+{
+    auto startOf = [&](int i) {
+        const ReferenceLine::Tessellation& refLine = tessellations[i].referenceLine_;
+        return refLine.empty() ? Eigen::Vector2d(0, 0) : refLine.front().position_;
+    };
+
+    originIndices.assign(tessellations.size(), 0);
+
+    switch (options.origin_)
+    {
+        case TessellationOrigin::NONE:
+            origins.push_back(Eigen::Vector2d(0, 0));
+            break;
+
+        case TessellationOrigin::ROAD:
+            for (int roadIdx = 0; roadIdx + 1 < static_cast<int>(roadOffsets.size()); roadIdx++)
+            {
+                if (roadOffsets[roadIdx] == roadOffsets[roadIdx + 1])
+                {
+                    continue;
+                }
+
+                origins.push_back(startOf(roadOffsets[roadIdx]));
+                for (int i = roadOffsets[roadIdx]; i < roadOffsets[roadIdx + 1]; i++)
+                {
+                    originIndices[i] = static_cast<int>(origins.size()) - 1;
+                }
+            }
+            break;
+
+        case TessellationOrigin::TILE:
+        {
+            std::map<std::pair<long long, long long>, int> tileOrigins;
+            for (int i = 0; i < static_cast<int>(tessellations.size()); i++)
+            {
+                Eigen::Vector2d start = startOf(i);
+                std::pair<long long, long long> tile(static_cast<long long>(std::floor(start.x() / options.tileSize_)),
+                                                     static_cast<long long>(std::floor(start.y() / options.tileSize_)));
+
+                auto it = tileOrigins.find(tile);
+                if (it == tileOrigins.end())
+                {
+                    it = tileOrigins.emplace(tile, static_cast<int>(origins.size())).first;
+                    origins.push_back(Eigen::Vector2d(tile.first * options.tileSize_, tile.second * options.tileSize_));
+                }
+                originIndices[i] = it->second;
+            }
+            break;
+        }
+    }
+}
+
+template <class Scalar>
+BasicMapTessellation<Scalar> tessellateMap(const XodrMap& map, const MapTessellationOptions& options)
+{
+    using LaneSectionRange = typename BasicMapTessellation<Scalar>::LaneSectionRange;
+
+    const std::vector<Road>& roads = map.roads();
+
+    BasicMapTessellation<Scalar> ret;
+    ret.roadOffsets_.resize(roads.size() + 1, 0);
+    for (int roadIdx = 0; roadIdx < static_cast<int>(roads.size()); roadIdx++)
+    {
+        ret.roadOffsets_[roadIdx + 1] =
+            ret.roadOffsets_[roadIdx] + static_cast<int>(roads[roadIdx].laneSections().size());
+    }
+
+    // Tessellate every lane section into its own slot. The slots of different
+    // tasks are disjoint, so no synchronization is needed.
+    std::vector<LaneSectionTessellation> tessellations(ret.roadOffsets_.back());
+    const std::vector<TessellationTask> tasks = makeTasks(map, options.maxTaskLength_);
+    parallelFor(static_cast<int>(tasks.size()), options.numThreads_, [&](int taskIdx) {
+        const TessellationTask& task = tasks[taskIdx];
+        const Road& road = roads[task.roadIdx_];
+        for (int i = task.laneSectionBegin_; i < task.laneSectionEnd_; i++)
+        {
+            tessellations[ret.roadOffsets_[task.roadIdx_] + i] =
+                tessellateLaneSection(road, road.laneSections()[i], options.settings_);
+        }
+    });
+
+    // Lay out the flat arrays.
+    std::vector<int> originIndices;
+    selectOrigins(tessellations, ret.roadOffsets_, options, ret.origins_, originIndices);
+
+    ret.laneSections_.resize(tessellations.size());
+    ret.boundaryOffsets_.push_back(0);
+    int numRefLineVertices = 0;
+    for (int roadIdx = 0; roadIdx < static_cast<int>(roads.size()); roadIdx++)
+    {
+        for (int i = ret.roadOffsets_[roadIdx]; i < ret.roadOffsets_[roadIdx + 1]; i++)
+        {
+            const LaneSectionTessellation& tessellation = tessellations[i];
+            LaneSectionRange& range = ret.laneSections_[i];
+            range.key_ = LaneSectionKey(roadIdx, i - ret.roadOffsets_[roadIdx]);
+            range.originIdx_ = originIndices[i];
+
+            range.refLineBegin_ = numRefLineVertices;
+            numRefLineVertices += static_cast<int>(tessellation.referenceLine_.size());
+            range.refLineEnd_ = numRefLineVertices;
+
+            range.boundaryBegin_ = ret.numBoundaries();
+            for (const LaneSection::BoundaryCurveTessellation& boundary : tessellation.boundaries_)
+            {
+                ret.boundaryOffsets_.push_back(ret.boundaryOffsets_.back() +
+                                               static_cast<int>(boundary.vertices_.size()));
+            }
+            range.boundaryEnd_ = ret.numBoundaries();
+        }
+    }
+
+    ret.refLineS_.resize(numRefLineVertices);
+    ret.refLineX_.resize(numRefLineVertices);
+    ret.refLineY_.resize(numRefLineVertices);
+    ret.refLineHeading_.resize(numRefLineVertices);
+    ret.boundaryX_.resize(ret.boundaryOffsets_.back());
+    ret.boundaryY_.resize(ret.boundaryOffsets_.back());
+
+    // Copy the vertices into the flat arrays, releasing the per lane section
+    // tessellations as soon as they're copied.
+    parallelFor(static_cast<int>(tessellations.size()), options.numThreads_, [&](int i) {
+        LaneSectionTessellation& tessellation = tessellations[i];
+        const LaneSectionRange& range = ret.laneSections_[i];
+        const Eigen::Vector2d origin = ret.origins_[range.originIdx_];
+
+        // The positions are made relative in double precision before they're
+        // converted to Scalar.
+        int idx = range.refLineBegin_;
+        for (const ReferenceLine::Vertex& vertex : tessellation.referenceLine_)
+        {
+            ret.refLineS_[idx] = static_cast<Scalar>(vertex.sCoord_);
+            ret.refLineX_[idx] = static_cast<Scalar>(vertex.position_.x() - origin.x());
+            ret.refLineY_[idx] = static_cast<Scalar>(vertex.position_.y() - origin.y());
+            ret.refLineHeading_[idx] = static_cast<Scalar>(vertex.heading_);
+            idx++;
+        }
+
+        for (int b = range.boundaryBegin_; b < range.boundaryEnd_; b++)
+        {
+            idx = ret.boundaryOffsets_[b];
+            for (const Eigen::Vector2d& vertex : tessellation.boundaries_[b - range.boundaryBegin_].vertices_)
+            {
+                ret.boundaryX_[idx] = static_cast<Scalar>(vertex.x() - origin.x());
+                ret.boundaryY_[idx] = static_cast<Scalar>(vertex.y() - origin.y());
+                idx++;
+            }
+        }
+
+        tessellation = LaneSectionTessellation();
+    });
+
+    return ret;
+}
+
+template struct BasicMapTessellation<double>;
+template struct BasicMapTessellation<float>;
+
+template MapTessellation tessellateMap<double>(const XodrMap& map, const MapTessellationOptions& options);
+template CompactMapTessellation tessellateMap<float>(const XodrMap& map, const MapTessellationOptions& options);
+
+}}  // namespace aid::xodr
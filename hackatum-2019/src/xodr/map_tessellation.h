@@ -0,0 +1,248 @@
+#pragma once
+
+#include "tessellation_cache.h"
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief The origins relative to which the vertex positions of a
+ * BasicMapTessellation are stored.
+ */
+enum class TessellationOrigin
+{
+    /**
+     * @brief All positions are absolute.
+     */
+    NONE,
+
+    /**
+     * @brief Positions are relative to the start of the reference line of
+     * their road.
+     */
+    ROAD,
+
+    /**
+     * @brief Positions are relative to the corner of the square tile which
+     * contains the start of their lane section.
+     */
+    TILE
+};
+
+/**
+ * @brief The options of tessellateMap().
+ */
+struct MapTessellationOptions
+{
+    /**
+     * @brief The default value of maxTaskLength_, in meters.
+     */
+    static constexpr double DEFAULT_MAX_TASK_LENGTH = 100;
+
+    /**
+     * @brief The default value of tileSize_, in meters.
+     */
+    static constexpr double DEFAULT_TILE_SIZE = 1000;
+
+    /**
+     * @brief The tessellation settings.
+     */
+    TessellationSettings settings_;
+
+    /**
+     * @brief The number of threads, or 0 to use the number of hardware threads.
+     */
+    int numThreads_ = 0;
+
+    /**
+     * @brief Roads longer than this are split into one task per lane section,
+     * so a few long roads don't keep a single thread busy.
+     */
+    double maxTaskLength_ = DEFAULT_MAX_TASK_LENGTH;
+
+    /**
+     * @brief The origins relative to which vertex positions are stored.
+     */
+    TessellationOrigin origin_ = TessellationOrigin::NONE;
+
+    /**
+     * @brief The edge length of the tiles for TessellationOrigin::TILE, in meters.
+     */
+    double tileSize_ = DEFAULT_TILE_SIZE;
+};
+
+/**
+ * @brief The tessellation of all lane sections of an XodrMap, in a flat
+ * struct-of-arrays layout.
+ *
+ * The reference line vertices of all lane sections are stored in one set of
+ * arrays, as are the vertices of all lane boundaries. Each lane section
+ * refers to its vertices by offset ranges. Lane sections are stored in map
+ * order, i.e. ordered by road index, then by lane section index.
+ *
+ * Vertex positions are stored relative to the origin of their lane section,
+ * which is kept in double precision. With float as Scalar and local origins
+ * (see TessellationOrigin), this halves the memory of the tessellation while
+ * keeping millimeter precision within several kilometers of each origin, even
+ * on maps with large (e.g. UTM) coordinates.
+ *
+ * @tparam Scalar           The type of the vertex coordinates, double or float.
+ */
+template <class Scalar>
+struct BasicMapTessellation
+{
+    /**
+     * @brief The ranges of a lane section within the arrays of the tessellation.
+     */
+    struct LaneSectionRange
+    {
+        /**
+         * @brief The key of the lane section.
+         */
+        LaneSectionKey key_;
+
+        /**
+         * @brief The reference line vertices of the lane section are
+         * [refLineBegin_, refLineEnd_).
+         */
+        int refLineBegin_ = 0;
+        int refLineEnd_ = 0;
+
+        /**
+         * @brief The lane boundaries of the lane section are
+         * [boundaryBegin_, boundaryEnd_), ordered as in
+         * LaneSection::tessellateLaneBoundaryCurves().
+         */
+        int boundaryBegin_ = 0;
+        int boundaryEnd_ = 0;
+
+        /**
+         * @brief The index of the origin of the lane section's vertex
+         * positions in origins_.
+         */
+        int originIdx_ = 0;
+    };
+
+    /**
+     * @brief The origins of the vertex positions.
+     */
+    std::vector<Eigen::Vector2d> origins_;
+
+    /**
+     * @brief The s-coordinates of the reference line vertices.
+     */
+    std::vector<Scalar> refLineS_;
+
+    /**
+     * @brief The x-coordinates of the reference line vertices, relative to
+     * the origins of their lane sections.
+     */
+    std::vector<Scalar> refLineX_;
+
+    /**
+     * @brief The y-coordinates of the reference line vertices, relative to
+     * the origins of their lane sections.
+     */
+    std::vector<Scalar> refLineY_;
+
+    /**
+     * @brief The headings of the reference line vertices.
+     */
+    std::vector<Scalar> refLineHeading_;
+
+    /**
+     * @brief The x-coordinates of the lane boundary vertices, relative to
+     * the origins of their lane sections.
+     */
+    std::vector<Scalar> boundaryX_;
+
+    /**
+     * @brief The y-coordinates of the lane boundary vertices, relative to
+     * the origins of their lane sections.
+     */
+    std::vector<Scalar> boundaryY_;
+
+    /**
+     * @brief The vertices of boundary b are [boundaryOffsets_[b], boundaryOffsets_[b + 1]).
+     */
+    std::vector<int> boundaryOffsets_;
+
+    /**
+     * @brief The ranges of all lane sections, in map order.
+     */
+    std::vector<LaneSectionRange> laneSections_;
+
+    /**
+     * @brief The lane sections of road r are [roadOffsets_[r], roadOffsets_[r + 1])
+     * in laneSections_.
+     */
+    std::vector<int> roadOffsets_;
+
+    /**
+     * @brief Gets the index of a lane section in laneSections_.
+     */
+    int laneSectionIndex(LaneSectionKey key) const { return roadOffsets_[key.roadIdx_] + key.laneSectionIdx_; }
+
+    /**
+     * @brief Gets the range of a lane section.
+     */
+    const LaneSectionRange& laneSection(LaneSectionKey key) const { return laneSections_[laneSectionIndex(key)]; }
+
+    /**
+     * @brief Gets the total number of lane boundaries.
+     */
+    int numBoundaries() const { return static_cast<int>(boundaryOffsets_.size()) - 1; }
+
+    /**
+     * @brief Gets the absolute position of a reference line vertex of the
+     * given lane section.
+     */
+    Eigen::Vector2d refLineVertex(const LaneSectionRange& range, int idx) const
+    {
+        return origins_[range.originIdx_] + Eigen::Vector2d(refLineX_[idx], refLineY_[idx]);
+    }
+
+    /**
+     * @brief Gets the absolute position of a lane boundary vertex of the
+     * given lane section.
+     */
+    Eigen::Vector2d boundaryVertex(const LaneSectionRange& range, int idx) const
+    {
+        return origins_[range.originIdx_] + Eigen::Vector2d(boundaryX_[idx], boundaryY_[idx]);
+    }
+
+    /**
+     * @brief Gets the approximate number of bytes used by this tessellation.
+     */
+    size_t memoryUsage() const;
+};
+
+/**
+ * @brief A tessellation with double precision coordinates.
+ */
+using MapTessellation = BasicMapTessellation<double>;
+
+/**
+ * @brief A tessellation with single precision coordinates, for rendering and
+ * transfer. It should be used with local origins.
+ */
+using CompactMapTessellation = BasicMapTessellation<float>;
+
+/**
+ * @brief Tessellates the reference lines and lane boundaries of all lane
+ * sections of an XodrMap in parallel.
+ *
+ * The roads are distributed over a work stealing thread pool, see
+ * parallelFor(). The vertices of each lane section are those of
+ * tessellateLaneSection(), stored relative to the origins selected by the
+ * options.
+ *
+ * @tparam Scalar           The type of the vertex coordinates, double or float.
+ * @param map               The map.
+ * @param options           The options.
+ * @returns                 The tessellation.
+ */
+template <class Scalar = double>
+BasicMapTessellation<Scalar> tessellateMap(const XodrMap& map,
+                                           const MapTessellationOptions& options = MapTessellationOptions());
+
+}}  // namespace aid::xodr
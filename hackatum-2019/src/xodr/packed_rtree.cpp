@@ -0,0 +1,88 @@
+#include "packed_rtree.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace aid { namespace xodr {
+
+PackedRTree::PackedRTree(const std::vector<Eigen::AlignedBox2d>& boxes)
+    : numItems_(static_cast<int>(boxes.size())), itemBoxes_(boxes)
+{
+    if (numItems_ == 0)
+    {
+        return;
+    }
+
+    // Sort the items into vertical slices of whole leaves, and each slice
+    // from bottom to top.
+    sortedItems_.resize(numItems_);
+    for (int i = 0; i < numItems_; i++)
+    {
+        sortedItems_[i] = i;
+    }
+
+    auto centerX = [&](int item) { return itemBoxes_[item].min().x() + itemBoxes_[item].max().x(); };
+    auto centerY = [&](int item) { return itemBoxes_[item].min().y() + itemBoxes_[item].max().y(); };
+
+    const int numLeaves = (numItems_ + NODE_SIZE - 1) / NODE_SIZE;
+    const int numSlices = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(numLeaves))));
+    const int sliceSize = NODE_SIZE * ((numLeaves + numSlices - 1) / numSlices);
+
+    std::sort(sortedItems_.begin(), sortedItems_.end(), [&](int a, int b) { return centerX(a) < centerX(b); });
+    for (int sliceBegin = 0; sliceBegin < numItems_; sliceBegin += sliceSize)
+    {
+        int sliceEnd = std::min(numItems_, sliceBegin + sliceSize);
+        std::sort(sortedItems_.begin() + sliceBegin, sortedItems_.begin() + sliceEnd,
+                  [&](int a, int b) { return centerY(a) < centerY(b); });
+    }
+
+    // Build the leaves, then group each level into the next one.
+    levelOffsets_.push_back(0);
+    for (int i = 0; i < numItems_; i += NODE_SIZE)
+    {
+        Eigen::AlignedBox2d box;
+        for (int j = i; j < std::min(numItems_, i + NODE_SIZE); j++)
+        {
+            box.extend(itemBoxes_[sortedItems_[j]]);
+        }
+        nodeBoxes_.push_back(box);
+        nodeLevels_.push_back(0);
+    }
+    levelOffsets_.push_back(static_cast<int>(nodeBoxes_.size()));
+
+    while (levelOffsets_.back() - levelOffsets_[levelOffsets_.size() - 2] > 1)
+    {
+        const int level = static_cast<int>(levelOffsets_.size()) - 1;
+        const int childBegin = levelOffsets_[level - 1];
+        const int childEnd = levelOffsets_[level];
+        for (int i = childBegin; i < childEnd; i += NODE_SIZE)
+        {
+            Eigen::AlignedBox2d box;
+            for (int j = i; j < std::min(childEnd, i + NODE_SIZE); j++)
+            {
+                box.extend(nodeBoxes_[j]);
+            }
+            nodeBoxes_.push_back(box);
+            nodeLevels_.push_back(level);
+        }
+        levelOffsets_.push_back(static_cast<int>(nodeBoxes_.size()));
+    }
+}
+
+void PackedRTree::children(int node, int& begin, int& end) const
+{
+    const int level = nodeLevels_[node];
+    const int idx = node - levelOffsets_[level];
+    if (level == 0)
+    {
+        begin = idx * NODE_SIZE;
+        end = std::min(numItems_, begin + NODE_SIZE);
+    }
+    else
+    {
+        begin = levelOffsets_[level - 1] + idx * NODE_SIZE;
+        end = std::min(levelOffsets_[level], begin + NODE_SIZE);
+    }
+}
+
+}}  // namespace aid::xodr
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <Eigen/Geometry>
+
+#include <vector>
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief A static R-tree over axis aligned boxes, bulk loaded once and stored
+ * in flat arrays.
+ *
+ * The tree is built with the Sort-Tile-Recursive algorithm: the boxes are
+ * sorted into vertical slices by the x-coordinate of their centers, and each
+ * slice by the y-coordinate. Consecutive runs of NODE_SIZE boxes then form
+ * the leaf nodes, and consecutive runs of NODE_SIZE nodes form the nodes of
+ * the next level, up to a single root.
+ *
+ * The nodes of all levels are stored in one array, leaves first, so the
+ * children of a node are found by index arithmetic instead of pointers.
+ */
+class PackedRTree
+{
+  public:
+    /**
+     * @brief The maximum number of children of a node.
+     */
+    static constexpr int NODE_SIZE = 16;
+
+    /**
+     * @brief Constructs an empty tree.
+     */
+    PackedRTree() = default;
+
+    /**
+     * @brief Bulk loads a tree with the given boxes.
+     *
+     * The items of the tree are identified by their index in @p boxes.
+     *
+     * @param boxes         The boxes of the items.
+     */
+    explicit PackedRTree(const std::vector<Eigen::AlignedBox2d>& boxes);
+
+    /**
+     * @brief Gets the number of items in the tree.
+     */
+    int numItems() const { return numItems_; }
+
+    /**
+     * @brief Gets the box of an item.
+     */
+    const Eigen::AlignedBox2d& itemBox(int item) const { return itemBoxes_[item]; }
+
+    /**
+     * @brief Gets the bounding box of all items, which is empty if there are
+     * no items.
+     */
+    Eigen::AlignedBox2d bounds() const { return nodeBoxes_.empty() ? Eigen::AlignedBox2d() : nodeBoxes_.back(); }
+
+    /**
+     * @brief Calls f(item) for each item whose box intersects the given box.
+     *
+     * The function object must be of the type
+     *
+     *   void f(int item);
+     *
+     * @param box           The query box.
+     * @param f             The function object.
+     */
+    template <class F>
+    void search(const Eigen::AlignedBox2d& box, F&& f) const;
+
+    /**
+     * @brief Calls f(item, distance) for the items in order of increasing
+     * distance of their box to the given point, until f returns false.
+     *
+     * The distance of a box which contains the point is 0. Because the box
+     * distance is a lower bound of the distance to anything inside the box,
+     * this can be used for exact nearest neighbor queries: once the box
+     * distance exceeds the distance of the best result so far, no later item
+     * can be closer.
+     *
+     * The function object must be of the type
+     *
+     *   bool f(int item, double boxDistance);
+     *
+     * @param pt            The query point.
+     * @param f             The function object.
+     */
+    template <class F>
+    void forEachByDistance(const Eigen::Vector2d& pt, F&& f) const;
+
+  private:
+    /**
+     * @brief Gets the range of the children of a node in nodeBoxes_, or in
+     * the sorted items if the node is a leaf.
+     */
+    void children(int node, int& begin, int& end) const;
+
+    int numItems_ = 0;
+
+    /**
+     * @brief The boxes of the items, indexed by item.
+     */
+    std::vector<Eigen::AlignedBox2d> itemBoxes_;
+
+    /**
+     * @brief The items, in leaf order.
+     */
+    std::vector<int> sortedItems_;
+
+    /**
+     * @brief The boxes of all nodes, level by level starting at the leaves.
+     * The last node is the root.
+     */
+    std::vector<Eigen::AlignedBox2d> nodeBoxes_;
+
+    /**
+     * @brief The nodes of level l are [levelOffsets_[l], levelOffsets_[l + 1])
+     * in nodeBoxes_. Level 0 are the leaves.
+     */
+    std::vector<int> levelOffsets_;
+
+    /**
+     * @brief The level of each node.
+     */
+    std::vector<int> nodeLevels_;
+};
+
+}}  // namespace aid::xodr
+
+#include "packed_rtree_impl.h"
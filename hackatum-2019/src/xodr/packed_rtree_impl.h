@@ -0,0 +1,101 @@
+#pragma once
+
+#include <functional>
+#include <queue>
+#include <utility>
+
+namespace aid { namespace xodr {
+
+template <class F>
+void PackedRTree::search(const Eigen::AlignedBox2d& box, F&& f) const
+{
+    if (nodeBoxes_.empty())
+    {
+        return;
+    }
+
+    std::vector<int> stack;
+    stack.push_back(static_cast<int>(nodeBoxes_.size()) - 1);
+    while (!stack.empty())
+    {
+        int node = stack.back();
+        stack.pop_back();
+        if (!box.intersects(nodeBoxes_[node]))
+        {
+            continue;
+        }
+
+        int begin;
+        int end;
+        children(node, begin, end);
+        if (nodeLevels_[node] == 0)
+        {
+            for (int i = begin; i < end; i++)
+            {
+                if (box.intersects(itemBoxes_[sortedItems_[i]]))
+                {
+                    f(sortedItems_[i]);
+                }
+            }
+        }
+        else
+        {
+            for (int child = begin; child < end; child++)
+            {
+                stack.push_back(child);
+            }
+        }
+    }
+}
+
+template <class F>
+void PackedRTree::forEachByDistance(const Eigen::Vector2d& pt, F&& f) const
+{
+    if (nodeBoxes_.empty())
+    {
+        return;
+    }
+
+    // The queue holds nodes as their index, and items as -(item + 1).
+    using QueueEntry = std::pair<double, int>;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+
+    const int root = static_cast<int>(nodeBoxes_.size()) - 1;
+    queue.emplace(nodeBoxes_[root].exteriorDistance(pt), root);
+    while (!queue.empty())
+    {
+        QueueEntry entry = queue.top();
+        queue.pop();
+
+        if (entry.second < 0)
+        {
+            if (!f(-entry.second - 1, entry.first))
+            {
+                return;
+            }
+            continue;
+        }
+
+        const int node = entry.second;
+        int begin;
+        int end;
+        children(node, begin, end);
+        if (nodeLevels_[node] == 0)
+        {
+            for (int i = begin; i < end; i++)
+            {
+                const int item = sortedItems_[i];
+                queue.emplace(itemBoxes_[item].exteriorDistance(pt), -item - 1);
+            }
+        }
+        else
+        {
+            for (int child = begin; child < end; child++)
+            {
+                queue.emplace(nodeBoxes_[child].exteriorDistance(pt), child);
+            }
+        }
+    }
+}
+
+}}  // namespace aid::xodr
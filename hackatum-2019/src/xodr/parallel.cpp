@@ -0,0 +1,331 @@
+#include "parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief The range of tasks which are still to be run by a worker thread.
+ *
+ * The owning thread takes tasks from the front, other threads steal from the
+ * back.
+ */
+struct TaskRange
+{
+    std::mutex mutex_;
+    int begin_ = 0;
+    int end_ = 0;
+};
+
+/**
+ * @brief A parallelFor() call which the workers of the WorkerPool can help
+ * with.
+ *
+ * The calling thread runs slot 0 itself, and each idle worker claims one of
+ * the remaining slots.
+ */
+struct PoolJob
+{
+    /**
+     * @brief Runs the worker loop of parallelFor() for a slot.
+     */
+    std::function<void(int slot)> work_;
+
+    std::mutex mutex_;
+    std::condition_variable done_;
+
+    /**
+     * @brief The number of slots, and the next one to be claimed.
+     */
+    int numSlots_ = 0;
+    int nextSlot_ = 1;
+
+    /**
+     * @brief The number of workers which are running a slot.
+     */
+    int numActive_ = 0;
+
+    /**
+     * @brief Set by the calling thread once all tasks are done, after which
+     * no more slots are claimed.
+     */
+    bool closed_ = false;
+};
+
+/**
+ * @brief The process-wide pool of worker threads of parallelFor().
+ *
+ * The workers are started on demand and live until the end of the process,
+ * so repeated parallelFor() calls don't pay for creating threads. Jobs are
+ * taken from a queue in order. Since the calling thread of a job can run all
+ * of its tasks itself, a job never waits for a worker, and parallelFor() can
+ * be called from several threads at once and from within its own tasks.
+ */
+class WorkerPool
+{
+  public:
+    /**
+     * @brief Gets the pool.
+     */
+    static WorkerPool& instance()
+    {
+        static WorkerPool pool;
+        return pool;
+    }
+
+    ~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopped_ = true;
+        }
+        wakeUp_.notify_all();
+        for (std::thread& worker : workers_)
+        {
+            worker.join();
+        }
+    }
+
+    /**
+     * @brief Offers the slots of a job to the workers, starting workers until
+     * there is one per helper slot.
+     *
+     * @param job           The job.
+     */
+    void submit(const std::shared_ptr<PoolJob>& job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            while (static_cast<int>(workers_.size()) < job->numSlots_ - 1)
+            {
+                workers_.emplace_back([this]() { runWorker(); });
+            }
+            jobs_.push_back(job);
+        }
+        wakeUp_.notify_all();
+    }
+
+  private:
+    WorkerPool() = default;
+
+    /**
+     * @brief The loop of a worker thread.
+     */
+    void runWorker()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true)
+        {
+            wakeUp_.wait(lock, [this]() { return stopped_ || !jobs_.empty(); });
+            if (stopped_)
+            {
+                return;
+            }
+
+            const std::shared_ptr<PoolJob> job = jobs_.front();
+            int slot;
+            {
+                // Claiming a slot and becoming active happen atomically, so
+                // the calling thread can't return while a slot is starting.
+                std::lock_guard<std::mutex> jobLock(job->mutex_);
+                if (job->closed_ || job->nextSlot_ >= job->numSlots_)
+                {
+                    jobs_.pop_front();
+                    continue;
+                }
+                slot = job->nextSlot_++;
+                job->numActive_++;
+            }
+
+            lock.unlock();
+            job->work_(slot);
+            {
+                std::lock_guard<std::mutex> jobLock(job->mutex_);
+                job->numActive_--;
+            }
+            job->done_.notify_all();
+            lock.lock();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable wakeUp_;
+    std::deque<std::shared_ptr<PoolJob>> jobs_;
+    std::vector<std::thread> workers_;
+    bool stopped_ = false;
+};
+
+int resolveNumThreads(int numThreads)
+{
+    if (numThreads <= 0)
+    {
+        numThreads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    return std::max(1, numThreads);
+}
+
+/**
+ * @brief Takes the next task from the front of the given range.
+ *
+ * @param range             The range.
+ * @returns                 The task index, or -1 if the range is empty.
+ */
+static int popTask(TaskRange& range)
+{
+    std::lock_guard<std::mutex> lock(range.mutex_);
+    if (range.begin_ >= range.end_)
+    {
+        return -1;
+    }
+    return range.begin_++;
+}
+
+/**
+ * @brief Moves the back half of the largest range of another thread to the
+ * range of the given thread.
+ *
+ * @param ranges            The ranges of all threads.
+ * @param threadIdx         The index of the stealing thread, whose range must
+ *                          be empty.
+ * @returns                 Whether any tasks were stolen.
+ */
+static bool stealTasks(std::vector<std::unique_ptr<TaskRange>>& ranges, int threadIdx)
+{
+    while (true)
+    {
+        // The sizes may change before the victim is locked again below.
+        int victimIdx = -1;
+        int victimSize = 0;
+        for (int i = 0; i < static_cast<int>(ranges.size()); i++)
+        {
+            if (i == threadIdx)
+            {
+                continue;
+            }
+
+            std::lock_guard<std::mutex> lock(ranges[i]->mutex_);
+            int size = ranges[i]->end_ - ranges[i]->begin_;
+            if (size > victimSize)
+            {
+                victimIdx = i;
+                victimSize = size;
+            }
+        }
+
+        if (victimIdx < 0)
+        {
+            return false;
+        }
+
+        int stolenBegin;
+        int stolenEnd;
+        {
+            TaskRange& victim = *ranges[victimIdx];
+            std::lock_guard<std::mutex> lock(victim.mutex_);
+            int size = victim.end_ - victim.begin_;
+            if (size <= 0)
+            {
+                // The victim ran out of tasks in the meantime; look again.
+                continue;
+            }
+
+            stolenEnd = victim.end_;
+            stolenBegin = victim.end_ - (size + 1) / 2;
+            victim.end_ = stolenBegin;
+        }
+
+        TaskRange& own = *ranges[threadIdx];
+        std::lock_guard<std::mutex> lock(own.mutex_);
+        own.begin_ = stolenBegin;
+        own.end_ = stolenEnd;
+        return true;
+    }
+}
+
+void parallelFor(int numTasks, int numThreads, const std::function<void(int taskIdx)>& task)
+{
+    if (numTasks <= 0)
+    {
+        return;
+    }
+
+    numThreads = std::min(resolveNumThreads(numThreads), numTasks);
+    if (numThreads == 1)
+    {
+        for (int i = 0; i < numTasks; i++)
+        {
+            task(i);
+        }
+        return;
+    }
+
+    std::vector<std::unique_ptr<TaskRange>> ranges;
+    for (int t = 0; t < numThreads; t++)
+    {
+        ranges.emplace_back(new TaskRange());
+        ranges.back()->begin_ = static_cast<int>(static_cast<long>(numTasks) * t / numThreads);
+        ranges.back()->end_ = static_cast<int>(static_cast<long>(numTasks) * (t + 1) / numThreads);
+    }
+
+    std::atomic<bool> failed(false);
+    std::exception_ptr exception;
+    std::mutex exceptionMutex;
+
+    auto work = [&](int threadIdx) {
+        while (!failed)
+        {
+            int taskIdx = popTask(*ranges[threadIdx]);
+            if (taskIdx < 0)
+            {
+                if (!stealTasks(ranges, threadIdx))
+                {
+                    return;
+                }
+                continue;
+            }
+
+            try
+            {
+                task(taskIdx);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(exceptionMutex);
+                if (!exception)
+                {
+                    exception = std::current_exception();
+                }
+                failed = true;
+            }
+        }
+    };
+
+    // The calling thread runs slot 0, and steals the tasks of any slots which
+    // no worker claims because all workers are busy.
+    std::shared_ptr<PoolJob> job = std::make_shared<PoolJob>();
+    job->work_ = work;
+    job->numSlots_ = numThreads;
+    WorkerPool::instance().submit(job);
+    work(0);
+
+    {
+        std::unique_lock<std::mutex> lock(job->mutex_);
+        job->closed_ = true;
+        job->done_.wait(lock, [&job]() { return job->numActive_ == 0; });
+    }
+
+    if (exception)
+    {
+        std::rethrow_exception(exception);
+    }
+}
+
+}}  // namespace aid::xodr
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <functional>
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief Gets the number of threads to use for a requested number of threads.
+ *
+ * @param numThreads        The requested number of threads, or 0 or less to
+ *                          use the number of hardware threads.
+ * @returns                 The number of threads, at least 1.
+ */
+int resolveNumThreads(int numThreads);
+
+/**
+ * @brief Calls task(taskIdx) for all taskIdx in [0, numTasks) on a pool of
+ * worker threads with work stealing.
+ *
+ * The worker threads are shared by all calls and kept alive until the end of
+ * the process, so a call doesn't create threads unless the pool has fewer
+ * than numThreads - 1 workers. Workers which are busy with other calls don't
+ * block a call, since the calling thread takes over their share of the
+ * tasks. parallelFor() may therefore be called concurrently and from within
+ * its own tasks.
+ *
+ * The tasks are initially split into one contiguous block per thread. Each
+ * thread takes tasks from the front of its own block, and when the block is
+ * exhausted it steals the back half of the largest remaining block of
+ * another thread. This keeps the threads busy when the tasks differ widely in
+ * cost, while tasks with adjacent indices mostly run on the same thread.
+ *
+ * The calling thread participates as one of the workers. If a task throws,
+ * the remaining tasks are skipped and the first exception is rethrown after
+ * all workers have finished their current tasks.
+ *
+ * @param numTasks          The number of tasks.
+ * @param numThreads        The number of threads, see resolveNumThreads().
+ * @param task              The function which runs a task, called concurrently.
+ */
+void parallelFor(int numTasks, int numThreads, const std::function<void(int taskIdx)>& task);
+
+}}  // namespace aid::xodr
@@ -14,48 +14,51 @@ double extremeValueInInterval(const Poly3& poly, double startT, double endT)
 {
     assert(startT <= endT);
 
-    constexpr double EPSILON = 1e-6;
-
     constexpr TCompare compare;
 
     double extreme = std::max(poly.eval(startT), poly.eval(endT), compare);
 
-    // If this is actually a quadratic function
-    if (std::abs(poly.d_) < EPSILON)
+    // The roots of the derivative qa * t^2 + qb * t + qc are computed in a
+    // numerically stable way, so tiny cubic or quadratic coefficients, which
+    // are common in width polynomials, are handled exactly instead of being
+    // dropped.
+    const double qa = 3 * poly.d_;
+    const double qb = 2 * poly.c_;
+    const double qc = poly.b_;
+
+    double roots[2];
+    int numRoots = 0;
+    if (qa == 0)
     {
-        // If this is actually a linear function
-        if (std::abs(poly.c_) < EPSILON)
+        if (qb != 0)
         {
-            return extreme;
+            roots[numRoots++] = -qc / qb;
         }
-        double root = -poly.b_ / (2 * poly.c_);
-        if (root < startT || root > endT)
+    }
+    else
+    {
+        double discriminant = qb * qb - 4 * qa * qc;
+        if (discriminant >= 0)
         {
-            return extreme;
+            double q = -0.5 * (qb + std::copysign(std::sqrt(discriminant), qb));
+            if (q != 0)
+            {
+                roots[numRoots++] = q / qa;
+                roots[numRoots++] = qc / q;
+            }
+            else
+            {
+                roots[numRoots++] = 0;
+            }
         }
-        return std::max(extreme, poly.eval(root), compare);
     }
 
-    double derivDiscSq = 4 * poly.c_ * poly.c_ - 12 * poly.d_ * poly.b_;
-    if (derivDiscSq > 0)
+    for (int i = 0; i < numRoots; i++)
     {
-        double derivativeDiscriminant = std::sqrt(derivDiscSq);
-        double rootA = (derivativeDiscriminant - 2 * poly.c_) / (6 * poly.d_);
-        double rootB = (-derivativeDiscriminant - 2 * poly.c_) / (6 * poly.d_);
-        if (rootA > startT && rootA < endT)
+        if (roots[i] > startT && roots[i] < endT)
         {
-            extreme = std::max(extreme, poly.eval(rootA), compare);
+            extreme = std::max(extreme, poly.eval(roots[i]), compare);
         }
-        if (rootB > startT && rootB < endT)
-        {
-            extreme = std::max(extreme, poly.eval(rootB), compare);
-        }
-        return extreme;
-    }
-    else if (derivDiscSq > -EPSILON)
-    {
-        double root = poly.c_ / (-3 * poly.d_);
-        return std::max(extreme, poly.eval(root), compare);
     }
     return extreme;
 }
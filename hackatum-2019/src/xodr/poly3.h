@@ -147,7 +147,7 @@ class Poly3
     double minValueInInterval(double startT, double endT) const;
 
     /**
-     * @brief Computes a Poly3 p, such that for any t, p.eval(t) == eval(t + offset) (barring any error introduced by
+     * @brief Computes a Poly3 p, such that for any t, p.eval(t + offset) == eval(t) (barring any error introduced by
      * floating point math).
      *
      * @param offset        The translation offset
@@ -1,6 +1,8 @@
 #include "reference_line.h"
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
 
 extern "C" {
 #include "odrSpiral/odrSpiral.h"
@@ -8,7 +10,53 @@ extern "C" {
 
 namespace aid { namespace xodr {
 
-static const double NUM_VERTICES_PER_METER = 1;
+/**
+ * @brief Computes the range of x^2 for x in [lo, hi].
+ */
+static void squareBounds(double lo, double hi, double& sqLo, double& sqHi)
+{
+    sqLo = lo <= 0 && hi >= 0 ? 0 : std::min(lo * lo, hi * hi);
+    sqHi = std::max(lo * lo, hi * hi);
+}
+
+/**
+ * @brief Computes bounds of the curvature n / d^1.5 from bounds of the
+ * numerator n and of the (non-negative) squared speed d.
+ *
+ * Where the speed can be zero, e.g. at the cusp of a ParamPoly3, the
+ * curvature is unbounded on each side which the numerator can reach.
+ *
+ * @param nLo, nHi          The bounds of the numerator.
+ * @param dLo, dHi          The bounds of the squared speed, which are clamped
+ *                          to zero, since rounding can make them negative.
+ * @param minCurvature      Is set to the lower bound of the curvature.
+ * @param maxCurvature      Is set to the upper bound of the curvature.
+ */
+static void curvatureQuotientBounds(double nLo, double nHi, double dLo, double dHi, double& minCurvature,
+                                    double& maxCurvature)
+{
+    const double infinity = std::numeric_limits<double>::infinity();
+    const double denomLo = std::pow(std::max(dLo, 0.0), 1.5);
+    const double denomHi = std::pow(std::max(dHi, 0.0), 1.5);
+
+    if (nLo >= 0)
+    {
+        minCurvature = denomHi > 0 ? nLo / denomHi : 0;
+    }
+    else
+    {
+        minCurvature = denomLo > 0 ? nLo / denomLo : -infinity;
+    }
+
+    if (nHi <= 0)
+    {
+        maxCurvature = denomHi > 0 ? nHi / denomHi : 0;
+    }
+    else
+    {
+        maxCurvature = denomLo > 0 ? nHi / denomLo : infinity;
+    }
+}
 
 ReferenceLine::ReferenceLine(const ReferenceLine& referenceLine) : endVertex_(referenceLine.endVertex_)
 {
@@ -63,7 +111,7 @@ double ReferenceLine::evalCurvature(double s) const
     return geometryContaining(s).evalCurvature(s);
 }
 
-ReferenceLine::Tessellation ReferenceLine::tessellate(double startS, double endS) const
+ReferenceLine::Tessellation ReferenceLine::tessellate(double startS, double endS, double verticesPerMeter) const
 {
     assert(!geometries_.empty());
     assert(startS >= geometries_[0]->startVertex().sCoord_);
@@ -91,7 +139,7 @@ ReferenceLine::Tessellation ReferenceLine::tessellate(double startS, double endS
         double clampedEndS = std::min(endS, geomEndS);
         if (clampedStartS < clampedEndS)
         {
-            geom.tessellate(ret, clampedStartS, clampedEndS, clampedEndS == endS);
+            geom.tessellate(ret, clampedStartS, clampedEndS, clampedEndS == endS, verticesPerMeter);
         }
     }
 
@@ -108,6 +156,46 @@ bool ReferenceLine::Geometry::inSRange(double s) const
     return localS >= -.00001 && localS < length_ + .00001;
 }
 
+double ReferenceLine::Geometry::project(const Eigen::Vector2d& pt, double startS, double endS, double initialS) const
+{
+    assert(startS <= endS);
+
+    const int maxIterations = 20;
+    const double tolerance = 1e-9;
+
+    // The step of the central difference used for the derivative.
+    const double h = std::min(1e-4, (endS - startS) / 2);
+
+    // The signed length of the projection of the offset to the point onto the
+    // tangent, which is zero at the closest point.
+    auto tangentOffset = [&](double s) {
+        PointAndTangentDir p = eval(s);
+        return (pt - p.point_).dot(p.tangentDir_);
+    };
+
+    double s = std::min(endS, std::max(startS, initialS));
+    for (int i = 0; i < maxIterations && h > 0; i++)
+    {
+        double lo = std::max(startS, s - h);
+        double hi = std::min(endS, s + h);
+        double derivative = (tangentOffset(hi) - tangentOffset(lo)) / (hi - lo);
+        if (derivative >= 0)
+        {
+            // Not near a minimum of the distance; step along the gradient.
+            derivative = -1;
+        }
+
+        double nextS = std::min(endS, std::max(startS, s - tangentOffset(s) / derivative));
+        bool converged = std::abs(nextS - s) < tolerance;
+        s = nextS;
+        if (converged)
+        {
+            break;
+        }
+    }
+    return s;
+}
+
 ReferenceLine::Line::Line(double startS, const Eigen::Vector2d& from, const Eigen::Vector2d& to)
 {
     assert(!from.isApprox(to));
@@ -148,7 +236,14 @@ double ReferenceLine::Line::evalCurvature(double s) const
     return 0;
 }
 
-void ReferenceLine::Line::tessellate(Tessellation& tessellation, double startS, double endS, bool includeEndPt) const
+void ReferenceLine::Line::evalCurvatureBounds(double, double, double& minCurvature, double& maxCurvature) const
+{
+    minCurvature = 0;
+    maxCurvature = 0;
+}
+
+void ReferenceLine::Line::tessellate(Tessellation& tessellation, double startS, double endS, bool includeEndPt,
+                                     double verticesPerMeter) const
 {
     const Vertex& startVert = startVertex();
 
@@ -160,7 +255,7 @@ void ReferenceLine::Line::tessellate(Tessellation& tessellation, double startS,
 
     double startT = startS - startVert.sCoord_;
 
-    int num = static_cast<int>(std::ceil((endS - startS) * NUM_VERTICES_PER_METER));
+    int num = static_cast<int>(std::ceil((endS - startS) * verticesPerMeter));
     double stepSize = (endS - startS) / num;
 
     if (includeEndPt)
@@ -180,6 +275,15 @@ void ReferenceLine::Line::tessellate(Tessellation& tessellation, double startS,
     }
 }
 
+double ReferenceLine::Line::project(const Eigen::Vector2d& pt, double startS, double endS, double initialS) const
+{
+    (void)initialS;
+
+    const Vertex& startVert = startVertex();
+    Eigen::Vector2d forward(std::cos(startVert.heading_), std::sin(startVert.heading_));
+    return std::min(endS, std::max(startS, startVert.sCoord_ + (pt - startVert.position_).dot(forward)));
+}
+
 ReferenceLine::Vertex ReferenceLine::Line::endVertex() const
 {
     const Vertex& startVert = startVertex();
@@ -246,7 +350,17 @@ double ReferenceLine::Spiral::evalCurvature(double s) const
     return startCurvature_ + (s - startVertex().sCoord_) * curvatureRateOfChange();
 }
 
-void ReferenceLine::Spiral::tessellate(Tessellation& tessellation, double startS, double endS, bool includeEndPt) const
+void ReferenceLine::Spiral::evalCurvatureBounds(double startS, double endS, double& minCurvature,
+                                                 double& maxCurvature) const
+{
+    const double startCurvature = startCurvature_ + (startS - startVertex().sCoord_) * curvatureRateOfChange();
+    const double endCurvature = startCurvature_ + (endS - startVertex().sCoord_) * curvatureRateOfChange();
+    minCurvature = std::min(startCurvature, endCurvature);
+    maxCurvature = std::max(startCurvature, endCurvature);
+}
+
+void ReferenceLine::Spiral::tessellate(Tessellation& tessellation, double startS, double endS, bool includeEndPt,
+                                       double verticesPerMeter) const
 {
     const Vertex& startVert = startVertex();
 
@@ -259,7 +373,7 @@ void ReferenceLine::Spiral::tessellate(Tessellation& tessellation, double startS
 
     Eigen::Matrix2d rotation = Eigen::Rotation2Dd(startVert.heading_ - curveStartHeading).toRotationMatrix();
 
-    int num = static_cast<int>(std::ceil((endS - startS) * NUM_VERTICES_PER_METER));
+    int num = static_cast<int>(std::ceil((endS - startS) * verticesPerMeter));
     double stepSize = (endS - startS) / num;
 
     if (includeEndPt)
@@ -377,7 +491,14 @@ double ReferenceLine::Arc::evalCurvature(double s) const
     return curvature_;
 }
 
-void ReferenceLine::Arc::tessellate(Tessellation& tessellation, double startS, double endS, bool includeEndPt) const
+void ReferenceLine::Arc::evalCurvatureBounds(double, double, double& minCurvature, double& maxCurvature) const
+{
+    minCurvature = curvature_;
+    maxCurvature = curvature_;
+}
+
+void ReferenceLine::Arc::tessellate(Tessellation& tessellation, double startS, double endS, bool includeEndPt,
+                                    double verticesPerMeter) const
 {
     const Vertex& startVert = startVertex();
 
@@ -386,7 +507,7 @@ void ReferenceLine::Arc::tessellate(Tessellation& tessellation, double startS, d
     Eigen::Vector2d toCenter(-std::sin(startVert.heading_), std::cos(startVert.heading_));
     Eigen::Vector2d center = startVert.position_ + toCenter * radius;
 
-    int num = static_cast<int>(std::ceil((endS - startS) * NUM_VERTICES_PER_METER));
+    int num = static_cast<int>(std::ceil((endS - startS) * verticesPerMeter));
     double stepSize = (endS - startS) / num;
 
     if (includeEndPt)
@@ -409,6 +530,35 @@ void ReferenceLine::Arc::tessellate(Tessellation& tessellation, double startS, d
     }
 }
 
+double ReferenceLine::Arc::project(const Eigen::Vector2d& pt, double startS, double endS, double initialS) const
+{
+    (void)initialS;
+
+    const Vertex& startVert = startVertex();
+
+    double radius = 1 / curvature_;
+    Eigen::Vector2d startNormal(-std::sin(startVert.heading_), std::cos(startVert.heading_));
+    Eigen::Vector2d center = startVert.position_ + startNormal * radius;
+
+    // The point on the arc with heading h is center + (sin(h), -cos(h)) * radius,
+    // so the heading of the closest point on the full circle follows from the
+    // direction from the center to pt.
+    Eigen::Vector2d dir = (pt - center) / radius;
+    double heading = std::atan2(dir.x(), -dir.y());
+
+    // Of the s-coordinates with that heading, take the first one after startS.
+    double period = 2 * M_PI / std::abs(curvature_);
+    double s = startVert.sCoord_ + (heading - startVert.heading_) / curvature_;
+    s = startS + std::fmod(std::fmod(s - startS, period) + period, period);
+    if (s <= endS)
+    {
+        return s;
+    }
+
+    // The closest point of the section is one of its ends.
+    return (eval(startS).point_ - pt).squaredNorm() <= (eval(endS).point_ - pt).squaredNorm() ? startS : endS;
+}
+
 ReferenceLine::Vertex ReferenceLine::Arc::endVertex() const
 {
     const Vertex& startVert = startVertex();
@@ -474,8 +624,26 @@ double ReferenceLine::Poly3Geom::evalCurvature(double s) const
     return poly_.eval2ndDerivative(u) / std::pow(1 + derivative * derivative, 1.5);
 }
 
+void ReferenceLine::Poly3Geom::evalCurvatureBounds(double startS, double endS, double& minCurvature,
+                                                    double& maxCurvature) const
+{
+    const double startU = startS - startVertex().sCoord_;
+    const double endU = endS - startVertex().sCoord_;
+
+    const Poly3 derivative(poly_.b_, 2 * poly_.c_, 3 * poly_.d_, 0);
+    const Poly3 secondDerivative(2 * poly_.c_, 6 * poly_.d_, 0, 0);
+
+    double sqLo;
+    double sqHi;
+    squareBounds(derivative.minValueInInterval(startU, endU), derivative.maxValueInInterval(startU, endU), sqLo,
+                 sqHi);
+    curvatureQuotientBounds(secondDerivative.minValueInInterval(startU, endU),
+                            secondDerivative.maxValueInInterval(startU, endU), 1 + sqLo, 1 + sqHi, minCurvature,
+                            maxCurvature);
+}
+
 void ReferenceLine::Poly3Geom::tessellate(Tessellation& tessellation, double startS, double endS,
-                                          bool includeEndPt) const
+                                          bool includeEndPt, double verticesPerMeter) const
 {
     const Vertex& startVert = startVertex();
 
@@ -488,7 +656,7 @@ void ReferenceLine::Poly3Geom::tessellate(Tessellation& tessellation, double sta
 
     double startU = startS - startVert.sCoord_;
 
-    int num = static_cast<int>(std::ceil((endS - startS) * NUM_VERTICES_PER_METER));
+    int num = static_cast<int>(std::ceil((endS - startS) * verticesPerMeter));
     double stepSize = (endS - startS) / num;
 
     if (includeEndPt)
@@ -606,8 +774,40 @@ double ReferenceLine::ParamPoly3::evalCurvature(double s) const
     return numerator / denominator;
 }
 
+void ReferenceLine::ParamPoly3::evalCurvatureBounds(double startS, double endS, double& minCurvature,
+                                                     double& maxCurvature) const
+{
+    double startParam = startS - startVertex().sCoord_;
+    double endParam = endS - startVertex().sCoord_;
+    if (pRange_ == PRange::NORMALIZED)
+    {
+        startParam /= length();
+        endParam /= length();
+    }
+
+    const Poly3 derivativeU(uPoly_.b_, 2 * uPoly_.c_, 3 * uPoly_.d_, 0);
+    const Poly3 derivativeV(vPoly_.b_, 2 * vPoly_.c_, 3 * vPoly_.d_, 0);
+
+    // u'v'' - v'u'', whose cubic terms cancel.
+    const Poly3 numerator(2 * (uPoly_.b_ * vPoly_.c_ - vPoly_.b_ * uPoly_.c_),
+                          6 * (uPoly_.b_ * vPoly_.d_ - vPoly_.b_ * uPoly_.d_),
+                          6 * (uPoly_.c_ * vPoly_.d_ - vPoly_.c_ * uPoly_.d_), 0);
+
+    double sqLoU;
+    double sqHiU;
+    squareBounds(derivativeU.minValueInInterval(startParam, endParam),
+                 derivativeU.maxValueInInterval(startParam, endParam), sqLoU, sqHiU);
+    double sqLoV;
+    double sqHiV;
+    squareBounds(derivativeV.minValueInInterval(startParam, endParam),
+                 derivativeV.maxValueInInterval(startParam, endParam), sqLoV, sqHiV);
+    curvatureQuotientBounds(numerator.minValueInInterval(startParam, endParam),
+                            numerator.maxValueInInterval(startParam, endParam), sqLoU + sqLoV, sqHiU + sqHiV,
+                            minCurvature, maxCurvature);
+}
+
 void ReferenceLine::ParamPoly3::tessellate(Tessellation& tessellation, double startS, double endS,
-                                           bool includeEndPt) const
+                                           bool includeEndPt, double verticesPerMeter) const
 {
     const Vertex& startVert = startVertex();
 
@@ -620,7 +820,7 @@ void ReferenceLine::ParamPoly3::tessellate(Tessellation& tessellation, double st
 
     double startParam = startS - startVert.sCoord_;
 
-    int num = static_cast<int>(std::ceil((endS - startS) * NUM_VERTICES_PER_METER));
+    int num = static_cast<int>(std::ceil((endS - startS) * verticesPerMeter));
 
     double stepSize = (endS - startS) / num;
     double paramStepSize = stepSize;
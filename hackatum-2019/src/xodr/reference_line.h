@@ -24,6 +24,11 @@ class ReferenceLine
     friend class TestFactory;
 
   public:
+    /**
+     * @brief The default density of tessellations, in vertices per meter.
+     */
+    static constexpr double DEFAULT_VERTICES_PER_METER = 1;
+
     struct Vertex
     {
         /**
@@ -250,6 +255,24 @@ class ReferenceLine
          */
         virtual double evalCurvature(double s) const = 0;
 
+        /**
+         * @brief Computes bounds of the (signed) curvature on the section
+         * [startS, endS] of this geometry.
+         *
+         * [startS, endS] must be a subset of the full range of this geometry.
+         * The bounds are exact for lines, arcs and spirals. For the polynomial
+         * geometries they are computed with interval arithmetic on the
+         * polynomial derivatives, which is conservative, and tight for short
+         * sections.
+         *
+         * @param startS            The start of the section.
+         * @param endS              The end of the section.
+         * @param minCurvature      Is set to a lower bound of the curvature.
+         * @param maxCurvature      Is set to an upper bound of the curvature.
+         */
+        virtual void evalCurvatureBounds(double startS, double endS, double& minCurvature,
+                                         double& maxCurvature) const = 0;
+
         /**
          * Tessellates the section of this geometry which falls in the
          * [startS, endS] range. [startS, endS] must be a subset of the full
@@ -261,8 +284,33 @@ class ReferenceLine
          * If @p includeEndPt is true, then the end point of the last line
          * segment of this geometry's tessellation should be appended, if
          * @p includeEndPt is false, then it should be omitted.
+         *
+         * The vertices are spaced evenly in s, with at least
+         * @p verticesPerMeter vertices per meter.
+         */
+        virtual void tessellate(Tessellation& tessellation, double startS, double endS, bool includeEndPt,
+                                double verticesPerMeter = DEFAULT_VERTICES_PER_METER) const = 0;
+
+        /**
+         * @brief Finds the s-coordinate of the point on the section
+         * [startS, endS] of this geometry which is closest to the given point.
+         *
+         * [startS, endS] must be a subset of the full range of this geometry.
+         *
+         * The default implementation refines @p initialS with Newton's method
+         * on the condition that the offset from the curve to the point is
+         * perpendicular to the tangent. It converges to the closest point if
+         * @p initialS is close to it, e.g. when it's taken from a tessellation.
+         * Geometries with a closed-form solution override this and ignore
+         * @p initialS.
+         *
+         * @param pt        The point.
+         * @param startS    The start of the section.
+         * @param endS      The end of the section.
+         * @param initialS  An estimate of the result.
+         * @returns         The s-coordinate of the closest point.
          */
-        virtual void tessellate(Tessellation& tessellation, double startS, double endS, bool includeEndPt) const = 0;
+        virtual double project(const Eigen::Vector2d& pt, double startS, double endS, double initialS) const;
 
         /**
          * @brief Gets the start vertex of this geometry.
@@ -378,13 +426,30 @@ class ReferenceLine
          */
         virtual double evalCurvature(double s) const override;
 
+        /**
+         * @brief The Line implementation of the evalCurvatureBounds() function.
+         *
+         * See Geometry::evalCurvatureBounds() for more details.
+         */
+        virtual void evalCurvatureBounds(double startS, double endS, double& minCurvature,
+                                         double& maxCurvature) const override;
+
         /**
          * @brief The Line implementation of the tessellate function.
          *
          * See Geometry::tessellate() for more details.
          */
-        virtual void tessellate(Tessellation& tessellation, double startS, double endS,
-                                bool includeEndPt) const override;
+        virtual void tessellate(Tessellation& tessellation, double startS, double endS, bool includeEndPt,
+                                double verticesPerMeter = DEFAULT_VERTICES_PER_METER) const override;
+
+        /**
+         * @brief The Line implementation of the project() function, which
+         * computes the closest point in closed form.
+         *
+         * See Geometry::project() for more details.
+         */
+        virtual double project(const Eigen::Vector2d& pt, double startS, double endS,
+                               double initialS) const override;
 
         /**
          * @brief The Line implementation of the endVertex function.
@@ -461,13 +526,21 @@ class ReferenceLine
          */
         virtual double evalCurvature(double s) const override;
 
+        /**
+         * @brief The Spiral implementation of the evalCurvatureBounds() function.
+         *
+         * See Geometry::evalCurvatureBounds() for more details.
+         */
+        virtual void evalCurvatureBounds(double startS, double endS, double& minCurvature,
+                                         double& maxCurvature) const override;
+
         /**
          * @brief The Spiral implementation of the tessellate function.
          *
          * See @ref Geometry::Tessellate for more details.
          */
-        virtual void tessellate(Tessellation& tessellation, double startS, double endS,
-                                bool includeEndPt) const override;
+        virtual void tessellate(Tessellation& tessellation, double startS, double endS, bool includeEndPt,
+                                double verticesPerMeter = DEFAULT_VERTICES_PER_METER) const override;
 
         /**
          * @brief The Spiral implementation of the endVertex function.
@@ -561,13 +634,30 @@ class ReferenceLine
          */
         virtual double evalCurvature(double s) const override;
 
+        /**
+         * @brief The Arc implementation of the evalCurvatureBounds() function.
+         *
+         * See Geometry::evalCurvatureBounds() for more details.
+         */
+        virtual void evalCurvatureBounds(double startS, double endS, double& minCurvature,
+                                         double& maxCurvature) const override;
+
         /**
          * @brief The Arc implementation of the tessellate function.
          *
          * See @ref Geometry::Tessellate for more details.
          */
-        virtual void tessellate(Tessellation& tessellation, double startS, double endS,
-                                bool includeEndPt) const override;
+        virtual void tessellate(Tessellation& tessellation, double startS, double endS, bool includeEndPt,
+                                double verticesPerMeter = DEFAULT_VERTICES_PER_METER) const override;
+
+        /**
+         * @brief The Arc implementation of the project() function, which
+         * computes the closest point in closed form.
+         *
+         * See Geometry::project() for more details.
+         */
+        virtual double project(const Eigen::Vector2d& pt, double startS, double endS,
+                               double initialS) const override;
 
         /**
          * @brief The Arc implementation of the endVertex function.
@@ -652,13 +742,21 @@ class ReferenceLine
          */
         virtual double evalCurvature(double s) const override;
 
+        /**
+         * @brief The Poly3Geom implementation of the evalCurvatureBounds() function.
+         *
+         * See Geometry::evalCurvatureBounds() for more details.
+         */
+        virtual void evalCurvatureBounds(double startS, double endS, double& minCurvature,
+                                         double& maxCurvature) const override;
+
         /**
          * @brief The Poly3Geom implementation of the tessellate function.
          *
          * See @ref Geometry::Tessellate for more details.
          */
-        virtual void tessellate(Tessellation& tessellation, double startS, double endS,
-                                bool includeEndPt) const override;
+        virtual void tessellate(Tessellation& tessellation, double startS, double endS, bool includeEndPt,
+                                double verticesPerMeter = DEFAULT_VERTICES_PER_METER) const override;
 
         /**
          * @brief The Poly3Geom implementation of the endVertex function.
@@ -775,13 +873,21 @@ class ReferenceLine
          */
         virtual double evalCurvature(double s) const override;
 
+        /**
+         * @brief The ParamPoly3 implementation of the evalCurvatureBounds() function.
+         *
+         * See Geometry::evalCurvatureBounds() for more details.
+         */
+        virtual void evalCurvatureBounds(double startS, double endS, double& minCurvature,
+                                         double& maxCurvature) const override;
+
         /**
          * @brief The ParamPoly3 implementation of the tessellate function.
          *
          * See @ref Geometry::Tessellate for more details.
          */
-        virtual void tessellate(Tessellation& tessellation, double startS, double endS,
-                                bool includeEndPt) const override;
+        virtual void tessellate(Tessellation& tessellation, double startS, double endS, bool includeEndPt,
+                                double verticesPerMeter = DEFAULT_VERTICES_PER_METER) const override;
 
         /**
          * @brief The Line implementation of the endVertex function.
@@ -888,9 +994,11 @@ class ReferenceLine
 
     /**
      * Returns a piecewise linear approximation of the section of this chord
-     * line with s values in the interval [startS, endS].
+     * line with s values in the interval [startS, endS], with at least
+     * verticesPerMeter vertices per meter.
      */
-    Tessellation tessellate(double startS, double endS) const;
+    Tessellation tessellate(double startS, double endS,
+                            double verticesPerMeter = DEFAULT_VERTICES_PER_METER) const;
 
     /**
      * Returns the end s coordinate of this chord line.
@@ -0,0 +1,186 @@
+#include "road_projection.h"
+
+#include "parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief The number of points of projectBatch() which are projected by one task.
+ */
+static constexpr int BATCH_CHUNK_SIZE = 256;
+
+/**
+ * @brief Longitudinal offsets below this are considered to be rounding errors
+ * of a projection in the interior of a geometry.
+ */
+static constexpr double LONGITUDINAL_TOLERANCE = 1e-6;
+
+/**
+ * @brief Gets the width of a lane, which is 0 if the lane has no width entries.
+ *
+ * @param lane              The lane.
+ * @param ds                The s-coordinate relative to the start of the lane section.
+ * @returns                 The width.
+ */
+static double laneWidth(const LaneSection::Lane& lane, double ds)
+{
+    return lane.widthPoly3s().empty() ? 0 : lane.widthAtSCoord(ds);
+}
+
+RoadPosition RoadProjector::project(const Eigen::Vector2d& pt, double maxDistance) const
+{
+    RoadPosition ret;
+    bool retContains = false;
+
+    index_.pieceTree().forEachByDistance(pt, [&](int pieceIdx, double boxDistance) {
+        // The boxes cover the lanes, so no later piece contains the point once
+        // the box distance is positive, and no later piece is closer than the
+        // box distance.
+        if (boxDistance > maxDistance ||
+            (ret.valid() && boxDistance > 0 && (retContains || boxDistance >= ret.distance_)))
+        {
+            return false;
+        }
+
+        RoadPosition candidate = projectOnPiece(pieceIdx, pt);
+        if (candidate.distance_ > maxDistance)
+        {
+            return true;
+        }
+
+        const bool contains = candidate.distance_ == 0;
+        bool better;
+        if (contains)
+        {
+            better = !retContains || std::abs(candidate.tCoord_) < std::abs(ret.tCoord_);
+        }
+        else
+        {
+            better = !retContains && (!ret.valid() || candidate.distance_ < ret.distance_);
+        }
+
+        if (better)
+        {
+            ret = candidate;
+            retContains = contains;
+        }
+        return true;
+    });
+
+    return ret;
+}
+
+std::vector<RoadPosition> RoadProjector::projectBatch(const std::vector<Eigen::Vector2d>& pts, double maxDistance,
+                                                      int numThreads) const
+{
+    std::vector<RoadPosition> ret(pts.size());
+
+    const int numPts = static_cast<int>(pts.size());
+    const int numChunks = (numPts + BATCH_CHUNK_SIZE - 1) / BATCH_CHUNK_SIZE;
+    parallelFor(numChunks, numThreads, [&](int chunkIdx) {
+        const int end = std::min(numPts, (chunkIdx + 1) * BATCH_CHUNK_SIZE);
+        for (int i = chunkIdx * BATCH_CHUNK_SIZE; i < end; i++)
+        {
+            ret[i] = project(pts[i], maxDistance);
+        }
+    });
+
+    return ret;
+}
+
+RoadPosition RoadProjector::projectOnPiece(int pieceIdx, const Eigen::Vector2d& pt) const
+{
+    const SpatialIndex::Piece& piece = index_.pieces()[pieceIdx];
+    const MapTessellation& tessellation = index_.tessellation();
+    const MapTessellation::LaneSectionRange& range = tessellation.laneSection(piece.laneSection_);
+
+    const Road& road = index_.map().roads()[piece.laneSection_.roadIdx_];
+    const LaneSection& laneSection = road.laneSections()[piece.laneSection_.laneSectionIdx_];
+    const ReferenceLine::Geometry& geometry = road.referenceLine().geometry(piece.geometryIdx_);
+
+    // Start at the closest point of the tessellation.
+    double initialS = tessellation.refLineS_[piece.refLineBegin_];
+    double minDistance = std::numeric_limits<double>::infinity();
+    for (int j = piece.refLineBegin_; j < piece.refLineEnd_; j++)
+    {
+        Eigen::Vector2d a = tessellation.refLineVertex(range, j);
+        Eigen::Vector2d ab = tessellation.refLineVertex(range, j + 1) - a;
+        double lengthSquared = ab.squaredNorm();
+        double u = lengthSquared > 0 ? std::min(1.0, std::max(0.0, (pt - a).dot(ab) / lengthSquared)) : 0;
+        double distance = (a + u * ab - pt).norm();
+        if (distance < minDistance)
+        {
+            minDistance = distance;
+            initialS = tessellation.refLineS_[j] + u * (tessellation.refLineS_[j + 1] - tessellation.refLineS_[j]);
+        }
+    }
+
+    const double geometryStartS = geometry.startVertex().sCoord_;
+    const double startS = std::max(geometryStartS, tessellation.refLineS_[piece.refLineBegin_]);
+    const double endS =
+        std::max(startS, std::min(geometryStartS + geometry.length(), tessellation.refLineS_[piece.refLineEnd_]));
+
+    RoadPosition ret;
+    ret.sCoord_ = geometry.project(pt, startS, endS, initialS);
+
+    ReferenceLine::PointAndTangentDir refPt = geometry.eval(ret.sCoord_);
+    Eigen::Vector2d offset = pt - refPt.point_;
+    ret.tCoord_ = offset.dot(refPt.sideDir());
+    double longitudinal = offset.dot(refPt.tangentDir_);
+    if (std::abs(longitudinal) < LONGITUDINAL_TOLERANCE)
+    {
+        longitudinal = 0;
+    }
+
+    // The lateral positions of the lane boundaries, from left to right. Lane i
+    // lies between boundaries i and i + 1.
+    const std::vector<LaneSection::Lane>& lanes = laneSection.lanes();
+    const int numLanes = static_cast<int>(lanes.size());
+    const int numLeftLanes = laneSection.numLeftLanes();
+    const double ds = ret.sCoord_ - laneSection.startS();
+
+    std::vector<double> boundaries(numLanes + 1, 0);
+    for (int i = numLeftLanes - 1; i >= 0; i--)
+    {
+        boundaries[i] = boundaries[i + 1] + laneWidth(lanes[i], ds);
+    }
+    for (int i = numLeftLanes; i < numLanes; i++)
+    {
+        boundaries[i + 1] = boundaries[i] - laneWidth(lanes[i], ds);
+    }
+
+    int laneIdx = -1;
+    double lateral = std::abs(ret.tCoord_);
+    if (numLanes > 0)
+    {
+        if (ret.tCoord_ > boundaries[0])
+        {
+            laneIdx = 0;
+            lateral = ret.tCoord_ - boundaries[0];
+        }
+        else if (ret.tCoord_ < boundaries[numLanes])
+        {
+            laneIdx = numLanes - 1;
+            lateral = boundaries[numLanes] - ret.tCoord_;
+        }
+        else
+        {
+            laneIdx = 0;
+            while (laneIdx < numLanes - 1 && ret.tCoord_ < boundaries[laneIdx + 1])
+            {
+                laneIdx++;
+            }
+            lateral = 0;
+        }
+    }
+
+    ret.lane_ = LaneKey(piece.laneSection_, laneIdx);
+    ret.distance_ = std::sqrt(lateral * lateral + longitudinal * longitudinal);
+    return ret;
+}
+
+}}  // namespace aid::xodr
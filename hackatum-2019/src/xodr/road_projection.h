@@ -0,0 +1,104 @@
+#pragma once
+
+#include "spatial_index.h"
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief The position of a point relative to the roads of an XodrMap.
+ */
+struct RoadPosition
+{
+    /**
+     * @brief The lane. Its road index is -1 if no road was found, and its lane
+     * index is -1 if the lane section has no lanes.
+     */
+    LaneKey lane_ = LaneKey(-1, -1, -1);
+
+    /**
+     * @brief The s-coordinate of the point on the reference line of the road
+     * which is closest to the point.
+     */
+    double sCoord_ = 0;
+
+    /**
+     * @brief The t-coordinate, i.e. the signed lateral offset of the point
+     * from the reference line, positive to the left.
+     */
+    double tCoord_ = 0;
+
+    /**
+     * @brief The distance of the point to the lane, which is 0 if the point
+     * lies inside the lane.
+     */
+    double distance_ = 0;
+
+    /**
+     * @brief Checks whether a road was found.
+     */
+    bool valid() const { return lane_.roadIdx_ >= 0; }
+};
+
+/**
+ * @brief Projects world coordinates onto the roads of an XodrMap, resulting in
+ * (road, s, t, lane) coordinates.
+ *
+ * The candidate road pieces are taken from a SpatialIndex in order of their
+ * distance. For each candidate, the closest point on its reference line
+ * geometry is found with ReferenceLine::Geometry::project(), starting from the
+ * closest point on the tessellation. The lane then follows from the lane
+ * widths at that s-coordinate.
+ *
+ * If several roads contain the point, as in junctions, the one with the
+ * smallest absolute t-coordinate is chosen. If no road contains the point,
+ * the closest lane within the maximum distance is returned.
+ */
+class RoadProjector
+{
+  public:
+    /**
+     * @brief The default maximum distance of a point to the lanes of a road,
+     * in meters.
+     */
+    static constexpr double DEFAULT_MAX_DISTANCE = 10;
+
+    /**
+     * @brief Constructs a projector, which uses the given spatial index.
+     *
+     * The index must outlive the projector.
+     *
+     * @param index         The spatial index.
+     */
+    explicit RoadProjector(const SpatialIndex& index) : index_(index) {}
+
+    /**
+     * @brief Projects a point onto the roads.
+     *
+     * @param pt            The point.
+     * @param maxDistance   The maximum distance of the point to a lane.
+     * @returns             The road position, which is invalid if there's no
+     *                      lane within the maximum distance.
+     */
+    RoadPosition project(const Eigen::Vector2d& pt, double maxDistance = DEFAULT_MAX_DISTANCE) const;
+
+    /**
+     * @brief Projects many points onto the roads in parallel.
+     *
+     * @param pts           The points.
+     * @param maxDistance   The maximum distance of a point to a lane.
+     * @param numThreads    The number of threads, see resolveNumThreads().
+     * @returns             The road position of each point, see project().
+     */
+    std::vector<RoadPosition> projectBatch(const std::vector<Eigen::Vector2d>& pts,
+                                           double maxDistance = DEFAULT_MAX_DISTANCE, int numThreads = 0) const;
+
+  private:
+    /**
+     * @brief Projects a point onto a piece of the spatial index.
+     */
+    RoadPosition projectOnPiece(int pieceIdx, const Eigen::Vector2d& pt) const;
+
+    const SpatialIndex& index_;
+};
+
+}}  // namespace aid::xodr
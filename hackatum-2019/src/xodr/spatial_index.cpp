@@ -0,0 +1,256 @@
+#include "spatial_index.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief Computes the distance of a point to a line segment.
+ *
+ * @param pt                The point.
+ * @param a                 The start of the segment.
+ * @param b                 The end of the segment.
+ * @returns                 The distance.
+ */
+static double segmentDistance(const Eigen::Vector2d& pt, const Eigen::Vector2d& a, const Eigen::Vector2d& b)
+{
+    Eigen::Vector2d ab = b - a;
+    double lengthSquared = ab.squaredNorm();
+    double t = lengthSquared > 0 ? std::min(1.0, std::max(0.0, (pt - a).dot(ab) / lengthSquared)) : 0;
+    return (a + t * ab - pt).norm();
+}
+
+/**
+ * @brief Finds the index of the geometry of a reference line which contains
+ * the given s-coordinate.
+ *
+ * @param referenceLine     The reference line.
+ * @param s                 The s-coordinate.
+ * @returns                 The geometry index.
+ */
+static int geometryIndexAt(const ReferenceLine& referenceLine, double s)
+{
+    // The vertices at the start of a geometry have exactly its start
+    // s-coordinate, so a binary search on the start s-coordinates suffices.
+    int lo = 0;
+    int hi = referenceLine.numGeometries() - 1;
+    while (lo < hi)
+    {
+        int mid = (lo + hi + 1) / 2;
+        if (referenceLine.geometry(mid).startVertex().sCoord_ <= s)
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid - 1;
+        }
+    }
+    return lo;
+}
+
+/**
+ * @brief Gets the options for the tessellation of a SpatialIndex, which is
+ * always stored with absolute positions.
+ */
+static MapTessellationOptions absoluteOptions(MapTessellationOptions options)
+{
+    options.origin_ = TessellationOrigin::NONE;
+    return options;
+}
+
+SpatialIndex::SpatialIndex(const XodrMap& map, const MapTessellationOptions& options)
+    : map_(map), tessellation_(tessellateMap(map, absoluteOptions(options)))
+{
+    const MapTessellation& t = tessellation_;
+
+    std::vector<Eigen::AlignedBox2d> pieceBoxes;
+    std::vector<Eigen::AlignedBox2d> laneSectionBoxes(t.laneSections_.size());
+
+    for (int i = 0; i < static_cast<int>(t.laneSections_.size()); i++)
+    {
+        const MapTessellation::LaneSectionRange& range = t.laneSections_[i];
+        const ReferenceLine& referenceLine = map.roads()[range.key_.roadIdx_].referenceLine();
+        const int last = range.refLineEnd_ - 1;
+        if (last < range.refLineBegin_)
+        {
+            continue;
+        }
+
+        // Split the lane section where the geometry changes, and where the
+        // piece gets too long.
+        int begin = range.refLineBegin_;
+        do
+        {
+            const int geometryIdx = geometryIndexAt(referenceLine, t.refLineS_[begin]);
+            int end = std::min(begin + 1, last);
+            while (end < last && end - begin < MAX_PIECE_SEGMENTS &&
+                   geometryIndexAt(referenceLine, t.refLineS_[end]) == geometryIdx)
+            {
+                end++;
+            }
+
+            Eigen::AlignedBox2d box;
+            for (int j = begin; j <= end; j++)
+            {
+                box.extend(t.refLineVertex(range, j));
+                for (int b = range.boundaryBegin_; b < range.boundaryEnd_; b++)
+                {
+                    box.extend(t.boundaryVertex(range, t.boundaryOffsets_[b] + j - range.refLineBegin_));
+                }
+            }
+
+            pieces_.push_back({range.key_, geometryIdx, begin, end});
+            pieceBoxes.push_back(box);
+            laneSectionBoxes[i].extend(box);
+            begin = end;
+        } while (begin < last);
+    }
+
+    pieceTree_ = PackedRTree(pieceBoxes);
+    laneSectionTree_ = PackedRTree(laneSectionBoxes);
+}
+
+std::vector<int> SpatialIndex::roadsIntersecting(const Eigen::AlignedBox2d& box) const
+{
+    std::vector<int> ret;
+    pieceTree_.search(box, [&](int pieceIdx) { ret.push_back(pieces_[pieceIdx].laneSection_.roadIdx_); });
+
+    std::sort(ret.begin(), ret.end());
+    ret.erase(std::unique(ret.begin(), ret.end()), ret.end());
+    return ret;
+}
+
+std::vector<SpatialIndex::RoadDistance> SpatialIndex::nearestRoads(const Eigen::Vector2d& pt, int k) const
+{
+    std::vector<RoadDistance> ret;
+    if (k <= 0)
+    {
+        return ret;
+    }
+
+    pieceTree_.forEachByDistance(pt, [&](int pieceIdx, double boxDistance) {
+        // The distance of a road can't decrease below the box distance of any
+        // later piece, so the roads which are at most boxDistance away are final.
+        int numFinal = 0;
+        for (const RoadDistance& road : ret)
+        {
+            numFinal += road.distance_ <= boxDistance;
+        }
+        if (numFinal >= k)
+        {
+            return false;
+        }
+
+        const int roadIdx = pieces_[pieceIdx].laneSection_.roadIdx_;
+        const double distance = pieceDistance(pieceIdx, pt);
+        auto it = std::find_if(ret.begin(), ret.end(),
+                               [&](const RoadDistance& road) { return road.roadIdx_ == roadIdx; });
+        if (it == ret.end())
+        {
+            ret.push_back({roadIdx, distance});
+        }
+        else
+        {
+            it->distance_ = std::min(it->distance_, distance);
+        }
+        return true;
+    });
+
+    std::sort(ret.begin(), ret.end(),
+              [](const RoadDistance& a, const RoadDistance& b) { return a.distance_ < b.distance_; });
+    if (static_cast<int>(ret.size()) > k)
+    {
+        ret.resize(k);
+    }
+    return ret;
+}
+
+std::vector<LaneSectionKey> SpatialIndex::laneSectionsWithinRadius(const Eigen::Vector2d& pt, double radius) const
+{
+    std::vector<int> indices;
+    const Eigen::Vector2d extent(radius, radius);
+    laneSectionTree_.search(Eigen::AlignedBox2d(pt - extent, pt + extent), [&](int laneSectionIdx) {
+        if (laneSectionDistance(laneSectionIdx, pt) <= radius)
+        {
+            indices.push_back(laneSectionIdx);
+        }
+    });
+
+    std::sort(indices.begin(), indices.end());
+
+    std::vector<LaneSectionKey> ret;
+    for (int idx : indices)
+    {
+        ret.push_back(tessellation_.laneSections_[idx].key_);
+    }
+    return ret;
+}
+
+double SpatialIndex::pieceDistance(int pieceIdx, const Eigen::Vector2d& pt) const
+{
+    const Piece& piece = pieces_[pieceIdx];
+    const MapTessellation::LaneSectionRange& range = tessellation_.laneSection(piece.laneSection_);
+
+    double ret = (tessellation_.refLineVertex(range, piece.refLineBegin_) - pt).norm();
+    for (int j = piece.refLineBegin_; j < piece.refLineEnd_; j++)
+    {
+        ret = std::min(ret, segmentDistance(pt, tessellation_.refLineVertex(range, j),
+                                            tessellation_.refLineVertex(range, j + 1)));
+    }
+    return ret;
+}
+
+double SpatialIndex::laneSectionDistance(int laneSectionIdx, const Eigen::Vector2d& pt) const
+{
+    const MapTessellation& t = tessellation_;
+    const MapTessellation::LaneSectionRange& range = t.laneSections_[laneSectionIdx];
+    const int numVertices = range.refLineEnd_ - range.refLineBegin_;
+    if (numVertices == 0)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    // The outline of the lane section: along the left-most boundary, and back
+    // along the right-most one. Without lanes, it's the reference line.
+    std::vector<Eigen::Vector2d> outline;
+    if (range.boundaryEnd_ > range.boundaryBegin_)
+    {
+        for (int j = 0; j < numVertices; j++)
+        {
+            outline.push_back(t.boundaryVertex(range, t.boundaryOffsets_[range.boundaryBegin_] + j));
+        }
+        for (int j = numVertices - 1; j >= 0; j--)
+        {
+            outline.push_back(t.boundaryVertex(range, t.boundaryOffsets_[range.boundaryEnd_ - 1] + j));
+        }
+    }
+    else
+    {
+        for (int j = range.refLineBegin_; j < range.refLineEnd_; j++)
+        {
+            outline.push_back(t.refLineVertex(range, j));
+        }
+    }
+
+    double ret = (outline.front() - pt).norm();
+    bool inside = false;
+    for (int i = 0; i < static_cast<int>(outline.size()); i++)
+    {
+        const Eigen::Vector2d& a = outline[i];
+        const Eigen::Vector2d& b = outline[(i + 1) % outline.size()];
+        ret = std::min(ret, segmentDistance(pt, a, b));
+
+        // Count the crossings of a ray in +x direction with the outline.
+        if ((a.y() > pt.y()) != (b.y() > pt.y()) &&
+            pt.x() < a.x() + (pt.y() - a.y()) / (b.y() - a.y()) * (b.x() - a.x()))
+        {
+            inside = !inside;
+        }
+    }
+
+    return inside ? 0 : ret;
+}
+
+}}  // namespace aid::xodr
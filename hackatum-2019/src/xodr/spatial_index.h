@@ -0,0 +1,162 @@
+#pragma once
+
+#include "map_tessellation.h"
+#include "packed_rtree.h"
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief A spatial index over the roads and lane sections of an XodrMap.
+ *
+ * The index is built once from a tessellation of the map, and holds two
+ * packed R-trees:
+ *
+ *  - one over pieces of the roads, where each piece is the part of a lane
+ *    section which lies on one reference line geometry, split further so
+ *    that long geometries don't produce huge boxes, and
+ *  - one over whole lane sections.
+ *
+ * The boxes cover the reference line and all lane boundaries. All distances
+ * and tests are with respect to the tessellation, so they're exact up to the
+ * tessellation error.
+ */
+class SpatialIndex
+{
+  public:
+    /**
+     * @brief The maximum number of reference line segments in a piece.
+     */
+    static constexpr int MAX_PIECE_SEGMENTS = 16;
+
+    /**
+     * @brief A piece of a road which is an item of the spatial index.
+     */
+    struct Piece
+    {
+        /**
+         * @brief The lane section which contains the piece.
+         */
+        LaneSectionKey laneSection_;
+
+        /**
+         * @brief The index of the reference line geometry which contains the
+         * piece.
+         */
+        int geometryIdx_;
+
+        /**
+         * @brief The reference line vertices of the piece are
+         * [refLineBegin_, refLineEnd_] (both inclusive) in the tessellation.
+         */
+        int refLineBegin_;
+        int refLineEnd_;
+    };
+
+    /**
+     * @brief A road and its distance to a point.
+     */
+    struct RoadDistance
+    {
+        int roadIdx_;
+        double distance_;
+    };
+
+    /**
+     * @brief Builds the spatial index of the given map.
+     *
+     * The map must outlive the index. Positions are stored in double
+     * precision, so options.origin_ has no effect on the results.
+     *
+     * @param map           The map.
+     * @param options       The options for the tessellation of the map.
+     */
+    explicit SpatialIndex(const XodrMap& map, const MapTessellationOptions& options = MapTessellationOptions());
+
+    SpatialIndex(const SpatialIndex&) = delete;
+    SpatialIndex& operator=(const SpatialIndex&) = delete;
+
+    /**
+     * @brief Gets the map.
+     */
+    const XodrMap& map() const { return map_; }
+
+    /**
+     * @brief Gets the tessellation of the map on which the index is built.
+     */
+    const MapTessellation& tessellation() const { return tessellation_; }
+
+    /**
+     * @brief Gets the pieces of the roads, which are the items of pieceTree().
+     */
+    const std::vector<Piece>& pieces() const { return pieces_; }
+
+    /**
+     * @brief Gets the R-tree over the pieces.
+     */
+    const PackedRTree& pieceTree() const { return pieceTree_; }
+
+    /**
+     * @brief Gets the R-tree over the lane sections, whose items are the
+     * indices into tessellation().laneSections_.
+     */
+    const PackedRTree& laneSectionTree() const { return laneSectionTree_; }
+
+    /**
+     * @brief Gets the bounding box of the map.
+     */
+    Eigen::AlignedBox2d bounds() const { return pieceTree_.bounds(); }
+
+    /**
+     * @brief Finds the roads with a piece whose bounding box intersects the
+     * given box.
+     *
+     * @param box           The box.
+     * @returns             The road indices, in increasing order.
+     */
+    std::vector<int> roadsIntersecting(const Eigen::AlignedBox2d& box) const;
+
+    /**
+     * @brief Finds the k roads whose reference lines are nearest to the given
+     * point.
+     *
+     * @param pt            The point.
+     * @param k             The maximum number of roads to find.
+     * @returns             The roads and the distances of their reference
+     *                      lines to the point, nearest first.
+     */
+    std::vector<RoadDistance> nearestRoads(const Eigen::Vector2d& pt, int k) const;
+
+    /**
+     * @brief Finds the lane sections whose area, between their left-most and
+     * right-most lane boundary, lies within the given radius of a point.
+     *
+     * @param pt            The point.
+     * @param radius        The radius.
+     * @returns             The lane sections, in map order.
+     */
+    std::vector<LaneSectionKey> laneSectionsWithinRadius(const Eigen::Vector2d& pt, double radius) const;
+
+    /**
+     * @brief Computes the distance of a point to the reference line of a piece.
+     *
+     * @param pieceIdx      The index of the piece.
+     * @param pt            The point.
+     * @returns             The distance.
+     */
+    double pieceDistance(int pieceIdx, const Eigen::Vector2d& pt) const;
+
+  private:
+    /**
+     * @brief Computes the distance of a point to the area of a lane section,
+     * which is 0 if the point is inside.
+     */
+    double laneSectionDistance(int laneSectionIdx, const Eigen::Vector2d& pt) const;
+
+    const XodrMap& map_;
+    MapTessellation tessellation_;
+    std::vector<Piece> pieces_;
+    PackedRTree pieceTree_;
+    PackedRTree laneSectionTree_;
+};
+
+}}  // namespace aid::xodr
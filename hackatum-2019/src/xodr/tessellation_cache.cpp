@@ -0,0 +1,166 @@
+#include "tessellation_cache.h"
+
+#include <functional>
+
+namespace aid { namespace xodr {
+
+size_t LaneSectionTessellation::memoryUsage() const
+{
+    size_t ret = sizeof(*this) + referenceLine_.capacity() * sizeof(ReferenceLine::Vertex) +
+                 boundaries_.capacity() * sizeof(LaneSection::BoundaryCurveTessellation);
+    for (const LaneSection::BoundaryCurveTessellation& boundary : boundaries_)
+    {
+        ret += boundary.vertices_.capacity() * sizeof(Eigen::Vector2d);
+    }
+    return ret;
+}
+
+LaneSectionTessellation tessellateLaneSection(const Road& road, const LaneSection& laneSection,
+                                              const TessellationSettings& settings)
+{
+    LaneSectionTessellation ret;
+    ret.referenceLine_ =
+        road.referenceLine().tessellate(laneSection.startS(), laneSection.endS(), settings.verticesPerMeter_);
+    ret.boundaries_ = laneSection.tessellateLaneBoundaryCurves(ret.referenceLine_);
+    return ret;
+}
+
+size_t TessellationCache::KeyHash::operator()(const Key& key) const
+{
+    size_t ret = std::hash<int>()(key.laneSection_.roadIdx_);
+    ret = ret * 31 + std::hash<int>()(key.laneSection_.laneSectionIdx_);
+    ret = ret * 31 + std::hash<double>()(key.settings_.verticesPerMeter_);
+    return ret;
+}
+
+TessellationCache::TessellationCache(const XodrMap& map, size_t memoryBudget)
+    : map_(map), memoryBudget_(memoryBudget)
+{
+}
+
+std::shared_ptr<const LaneSectionTessellation> TessellationCache::get(LaneSectionKey key,
+                                                                      const TessellationSettings& settings)
+{
+    const Key entryKey{key, settings};
+
+    std::promise<std::shared_ptr<const LaneSectionTessellation>> promise;
+    std::shared_future<std::shared_ptr<const LaneSectionTessellation>> cached;
+    long id = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto it = entries_.find(entryKey);
+        if (it != entries_.end())
+        {
+            numHits_++;
+            lru_.splice(lru_.begin(), lru_, it->second.lruIt_);
+            cached = it->second.value_;
+        }
+        else
+        {
+            numMisses_++;
+            id = nextId_++;
+
+            lru_.push_front(entryKey);
+            Entry& entry = entries_[entryKey];
+            entry.value_ = promise.get_future().share();
+            entry.lruIt_ = lru_.begin();
+            entry.id_ = id;
+        }
+    }
+
+    if (cached.valid())
+    {
+        // This waits if another thread is still computing the tessellation.
+        return cached.get();
+    }
+
+    std::shared_ptr<const LaneSectionTessellation> ret;
+    try
+    {
+        const Road& road = map_.roads()[key.roadIdx_];
+        ret = std::make_shared<const LaneSectionTessellation>(
+            tessellateLaneSection(road, road.laneSections()[key.laneSectionIdx_], settings));
+    }
+    catch (...)
+    {
+        promise.set_exception(std::current_exception());
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(entryKey);
+        if (it != entries_.end() && it->second.id_ == id)
+        {
+            lru_.erase(it->second.lruIt_);
+            entries_.erase(it);
+        }
+        throw;
+    }
+
+    promise.set_value(ret);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(entryKey);
+    if (it != entries_.end() && it->second.id_ == id)
+    {
+        it->second.memoryUsage_ = ret->memoryUsage();
+        memoryUsage_ += it->second.memoryUsage_;
+        evict();
+    }
+
+    return ret;
+}
+
+void TessellationCache::evict()
+{
+    auto it = lru_.end();
+    while (memoryUsage_ > memoryBudget_ && it != lru_.begin())
+    {
+        --it;
+
+        auto entryIt = entries_.find(*it);
+        if (entryIt->second.memoryUsage_ == 0)
+        {
+            // still being computed
+            continue;
+        }
+
+        memoryUsage_ -= entryIt->second.memoryUsage_;
+        entries_.erase(entryIt);
+        it = lru_.erase(it);
+    }
+}
+
+void TessellationCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Keep pending entries, their computations will account for them.
+    for (auto it = lru_.begin(); it != lru_.end();)
+    {
+        auto entryIt = entries_.find(*it);
+        if (entryIt->second.memoryUsage_ == 0)
+        {
+            ++it;
+            continue;
+        }
+
+        memoryUsage_ -= entryIt->second.memoryUsage_;
+        entries_.erase(entryIt);
+        it = lru_.erase(it);
+    }
+}
+
+size_t TessellationCache::memoryUsage() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return memoryUsage_;
+}
+
+int TessellationCache::numEntries() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<int>(entries_.size());
+}
+
+}}  // namespace aid::xodr
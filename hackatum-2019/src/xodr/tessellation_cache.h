@@ -0,0 +1,205 @@
+#pragma once
+
+#include "xodr_map.h"
+#include "xodr_map_keys.h"
+
+#include <atomic>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief The settings which determine the tessellation of a lane section.
+ */
+struct TessellationSettings
+{
+    /**
+     * @brief The minimum number of reference line vertices per meter.
+     */
+    double verticesPerMeter_ = ReferenceLine::DEFAULT_VERTICES_PER_METER;
+
+    /**
+     * @brief Compares two TessellationSettings for equality.
+     */
+    bool operator==(const TessellationSettings& b) const { return verticesPerMeter_ == b.verticesPerMeter_; }
+};
+
+/**
+ * @brief The tessellation of a lane section.
+ */
+struct LaneSectionTessellation
+{
+    /**
+     * @brief The tessellation of the lane section's part of the reference line.
+     */
+    ReferenceLine::Tessellation referenceLine_;
+
+    /**
+     * @brief The lane boundaries, see LaneSection::tessellateLaneBoundaryCurves().
+     */
+    std::vector<LaneSection::BoundaryCurveTessellation> boundaries_;
+
+    /**
+     * @brief Gets the approximate number of bytes used by this tessellation.
+     */
+    size_t memoryUsage() const;
+};
+
+/**
+ * @brief Tessellates the reference line and the lane boundaries of a lane
+ * section.
+ *
+ * @param road              The road which contains the lane section.
+ * @param laneSection       The lane section.
+ * @param settings          The tessellation settings.
+ * @returns                 The tessellation.
+ */
+LaneSectionTessellation tessellateLaneSection(const Road& road, const LaneSection& laneSection,
+                                              const TessellationSettings& settings = TessellationSettings());
+
+/**
+ * @brief A cache of lane section tessellations of an XodrMap.
+ *
+ * Tessellations are computed lazily on the first request for a lane section
+ * and settings, and are shared as immutable objects afterwards.
+ *
+ * All functions are thread-safe. Concurrent requests for a tessellation which
+ * is being computed wait for that computation instead of repeating it.
+ *
+ * The cache evicts the least recently used tessellations when its memory
+ * usage exceeds the memory budget. Evicted tessellations stay valid as long
+ * as they're referenced, but are no longer counted.
+ */
+class TessellationCache
+{
+  public:
+    /**
+     * @brief The default memory budget, in bytes.
+     */
+    static constexpr size_t DEFAULT_MEMORY_BUDGET = 256 * 1024 * 1024;
+
+    /**
+     * @brief Constructs an empty cache for the given map.
+     *
+     * The map must outlive the cache.
+     *
+     * @param map           The map.
+     * @param memoryBudget  The memory budget, in bytes.
+     */
+    explicit TessellationCache(const XodrMap& map, size_t memoryBudget = DEFAULT_MEMORY_BUDGET);
+
+    TessellationCache(const TessellationCache&) = delete;
+    TessellationCache& operator=(const TessellationCache&) = delete;
+
+    /**
+     * @brief Gets the tessellation of the given lane section, computing it if
+     * it isn't cached.
+     *
+     * @param key           The key of the lane section.
+     * @param settings      The tessellation settings.
+     * @returns             The tessellation.
+     */
+    std::shared_ptr<const LaneSectionTessellation> get(LaneSectionKey key,
+                                                       const TessellationSettings& settings = TessellationSettings());
+
+    /**
+     * @brief Removes all tessellations from the cache.
+     */
+    void clear();
+
+    /**
+     * @brief Gets the map this cache belongs to.
+     */
+    const XodrMap& map() const { return map_; }
+
+    /**
+     * @brief Gets the approximate number of bytes used by the cached tessellations.
+     */
+    size_t memoryUsage() const;
+
+    /**
+     * @brief Gets the memory budget, in bytes.
+     */
+    size_t memoryBudget() const { return memoryBudget_; }
+
+    /**
+     * @brief Gets the number of cached tessellations, including those being computed.
+     */
+    int numEntries() const;
+
+    /**
+     * @brief Gets the number of requests which were served from the cache.
+     */
+    long numHits() const { return numHits_; }
+
+    /**
+     * @brief Gets the number of requests which computed a tessellation.
+     */
+    long numMisses() const { return numMisses_; }
+
+  private:
+    struct Key
+    {
+        LaneSectionKey laneSection_;
+        TessellationSettings settings_;
+
+        bool operator==(const Key& b) const { return laneSection_ == b.laneSection_ && settings_ == b.settings_; }
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const;
+    };
+
+    struct Entry
+    {
+        std::shared_future<std::shared_ptr<const LaneSectionTessellation>> value_;
+
+        /**
+         * @brief The position of the entry in lru_.
+         */
+        std::list<Key>::iterator lruIt_;
+
+        /**
+         * @brief The memory usage of the tessellation, or 0 while it's being
+         * computed.
+         */
+        size_t memoryUsage_ = 0;
+
+        /**
+         * @brief Identifies the computation which created this entry.
+         */
+        long id_ = 0;
+    };
+
+    /**
+     * @brief Evicts the least recently used computed entries until the memory
+     * usage is within the budget.
+     *
+     * The mutex must be locked.
+     */
+    void evict();
+
+    const XodrMap& map_;
+    const size_t memoryBudget_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<Key, Entry, KeyHash> entries_;
+
+    /**
+     * @brief The keys of all entries, most recently used first.
+     */
+    std::list<Key> lru_;
+
+    size_t memoryUsage_ = 0;
+    long nextId_ = 1;
+
+    std::atomic<long> numHits_{0};
+    std::atomic<long> numMisses_{0};
+};
+
+}}  // namespace aid::xodr
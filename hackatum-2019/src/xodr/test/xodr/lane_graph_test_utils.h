@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+
+#include "lane_graph.h"
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief Gets the node of the lane with the given id in the given lane section
+ * of the road with the given id.
+ */
+inline int laneNode(const LaneGraph& graph, const std::string& roadId, int laneId, int laneSectionIdx = 0)
+{
+    const XodrMap& map = graph.map();
+    int roadIdx = map.roadIndexById(roadId);
+    const LaneSection& laneSection = map.roads()[roadIdx].laneSections()[laneSectionIdx];
+    return graph.node(LaneKey(roadIdx, laneSectionIdx, laneSection.laneIdToIndex(LaneID(laneId))));
+}
+
+}}  // namespace aid::xodr
@@ -0,0 +1,72 @@
+#include "elevation.h"
+
+#include <gtest/gtest.h>
+
+namespace aid { namespace xodr {
+
+static ElevationProfile parseElevationProfile(const char* text)
+{
+    XodrReader xml = XodrReader::fromText(text);
+    xml.readStartElement("elevationProfile");
+    return ElevationProfile::parseXml(xml).value();
+}
+
+static ReferenceLine::Tessellation tessellationWithSCoords(const std::vector<double>& sCoords)
+{
+    ReferenceLine::Tessellation ret;
+    for (double s : sCoords)
+    {
+        ret.push_back(ReferenceLine::Vertex{s, Eigen::Vector2d(s, 0), 0});
+    }
+
+    return ret;
+}
+
+TEST(ElevationProfileTest, testEval)
+{
+    ElevationProfile elevationProfile = parseElevationProfile(
+        "<elevationProfile>"
+        "  <elevation s='0' a='100' b='1' c='0' d='0'/>"
+        "  <elevation s='10' a='110' b='0' c='1' d='0'/>"
+        "  <elevation s='20' a='210' b='0' c='0' d='0'/>"
+        "</elevationProfile>");
+
+    EXPECT_DOUBLE_EQ(elevationProfile.eval(0), 100);
+    EXPECT_DOUBLE_EQ(elevationProfile.eval(5), 105);
+    EXPECT_DOUBLE_EQ(elevationProfile.eval(10), 110);
+    EXPECT_DOUBLE_EQ(elevationProfile.eval(15), 135);
+    EXPECT_DOUBLE_EQ(elevationProfile.eval(20), 210);
+    EXPECT_DOUBLE_EQ(elevationProfile.eval(30), 210);
+}
+
+TEST(ElevationProfileTest, testEvalTessellation)
+{
+    ElevationProfile elevationProfile = parseElevationProfile(
+        "<elevationProfile>"
+        "  <elevation s='0' a='100' b='1' c='0' d='0'/>"
+        "  <elevation s='10' a='110' b='0' c='1' d='0'/>"
+        "  <elevation s='12' a='114' b='0' c='0' d='0'/>"
+        "  <elevation s='20' a='210' b='0' c='0' d='-1'/>"
+        "</elevationProfile>");
+
+    std::vector<double> sCoords = {0, 2.5, 9.9, 10, 11, 21, 23.5};
+    std::vector<double> elevations = elevationProfile.evalTessellation(tessellationWithSCoords(sCoords));
+
+    ASSERT_EQ(elevations.size(), sCoords.size());
+    for (int i = 0; i < static_cast<int>(sCoords.size()); i++)
+    {
+        EXPECT_DOUBLE_EQ(elevations[i], elevationProfile.eval(sCoords[i]));
+    }
+}
+
+TEST(ElevationProfileTest, testEvalTessellationEmpty)
+{
+    ElevationProfile elevationProfile = parseElevationProfile(
+        "<elevationProfile>"
+        "  <elevation s='0' a='100' b='1' c='0' d='0'/>"
+        "</elevationProfile>");
+
+    EXPECT_TRUE(elevationProfile.evalTessellation(ReferenceLine::Tessellation()).empty());
+}
+
+}}  // namespace aid::xodr
@@ -24,6 +24,53 @@ TEST(JunctionTest, testConnectionFindLinkTarget)
     EXPECT_EQ(connection.findLaneLinkTarget(LaneID(-1)), LaneID(-5));
     EXPECT_EQ(connection.findLaneLinkTarget(LaneID(-2)), LaneID(-6));
     EXPECT_EQ(connection.findLaneLinkTarget(LaneID(-1000)), LaneIDOpt::null());
+
+    connection.test_setLaneLinkTarget(LaneID(1), LaneID(4));
+    connection.test_setLaneLinkTarget(LaneID(-1), LaneIDOpt::null());
+    connection.test_setLaneLinkTarget(LaneID(2), LaneID(7));
+    EXPECT_EQ(connection.findLaneLinkTarget(LaneID(1)), LaneID(4));
+    EXPECT_EQ(connection.findLaneLinkTarget(LaneID(-1)), LaneIDOpt::null());
+    EXPECT_EQ(connection.findLaneLinkTarget(LaneID(2)), LaneID(7));
+    EXPECT_EQ(connection.findLaneLinkTarget(LaneID(-2)), LaneID(-6));
+}
+
+TEST(JunctionTest, testConnectionLookup)
+{
+    XodrReader xml =
+        XodrReader::fromFile(std::string(TEST_DATA_PATH_PREFIX) + "xodr/test_for_each_roadlink/junction_links.xodr");
+
+    xml.readStartElement("OpenDRIVE");
+    XodrMap xodrMap = std::move(XodrMap::parseXml(xml).value());
+    const Junction& junction = xodrMap.junctions()[xodrMap.junctionIndexById("100")];
+
+    int west = xodrMap.roadIndexById("west");
+    int east = xodrMap.roadIndexById("east");
+    int north = xodrMap.roadIndexById("north");
+    int westEast = xodrMap.roadIndexById("junction_westEast");
+    int northWest = xodrMap.roadIndexById("junction_northWest");
+
+    const Junction::Connection* connection = junction.findConnection(west, westEast, ContactPoint::START);
+    ASSERT_NE(connection, nullptr);
+    EXPECT_EQ(connection->incomingRoad().index(), west);
+    EXPECT_EQ(connection->connectingRoad().index(), westEast);
+    EXPECT_EQ(connection->findLaneLinkTarget(LaneID(-1)), LaneID(-1));
+
+    connection = junction.findConnection(north, northWest, ContactPoint::END);
+    ASSERT_NE(connection, nullptr);
+    EXPECT_EQ(connection->incomingRoad().index(), north);
+    EXPECT_EQ(connection->connectingRoad().index(), northWest);
+
+    EXPECT_EQ(junction.findConnection(west, westEast, ContactPoint::END), nullptr);
+    EXPECT_EQ(junction.findConnection(east, westEast, ContactPoint::START), nullptr);
+    EXPECT_TRUE(junction.hasConnection(west, westEast, ContactPoint::START));
+    EXPECT_FALSE(junction.hasConnection(north, westEast, ContactPoint::START));
+
+    // The connections leave the connecting roads at the opposite contact point.
+    EXPECT_TRUE(junction.hasOutgoingConnection(westEast, ContactPoint::END));
+    EXPECT_FALSE(junction.hasOutgoingConnection(westEast, ContactPoint::START));
+    EXPECT_TRUE(junction.hasOutgoingConnection(northWest, ContactPoint::START));
+    EXPECT_FALSE(junction.hasOutgoingConnection(northWest, ContactPoint::END));
+    EXPECT_FALSE(junction.hasOutgoingConnection(west, ContactPoint::END));
 }
 
 }}  // namespace aid::xodr
@@ -0,0 +1,222 @@
+#include "lane_connectivity.h"
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <sstream>
+
+#include "../test_config.h"
+#include "lane_graph_test_utils.h"
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief Computes which nodes can be reached from a node, by a simple
+ * traversal of the outgoing edges.
+ */
+static std::vector<bool> reachableFrom(const LaneGraph& graph, int node)
+{
+    std::vector<bool> ret(graph.numNodes(), false);
+    std::vector<int> stack{node};
+    ret[node] = true;
+    while (!stack.empty())
+    {
+        int n = stack.back();
+        stack.pop_back();
+        for (int e = graph.successorOffsets()[n]; e < graph.successorOffsets()[n + 1]; e++)
+        {
+            if (!ret[graph.edgeTargets()[e]])
+            {
+                ret[graph.edgeTargets()[e]] = true;
+                stack.push_back(graph.edgeTargets()[e]);
+            }
+        }
+    }
+    return ret;
+}
+
+/**
+ * @brief Checks the analysis against the definitions of the components and
+ * lane classes, using the reachability between all pairs of nodes.
+ */
+static void expectConsistentAnalysis(const LaneConnectivity& connectivity)
+{
+    const LaneGraph& graph = connectivity.graph();
+    std::vector<std::vector<bool>> reachable;
+    for (int node = 0; node < graph.numNodes(); node++)
+    {
+        reachable.push_back(reachableFrom(graph, node));
+    }
+
+    int numDrivable = 0;
+    for (int a = 0; a < graph.numNodes(); a++)
+    {
+        if (!graph.drivable(a))
+        {
+            EXPECT_EQ(-1, connectivity.component(a));
+            continue;
+        }
+
+        numDrivable++;
+        for (int b = 0; b < graph.numNodes(); b++)
+        {
+            if (graph.drivable(b))
+            {
+                EXPECT_EQ(reachable[a][b] && reachable[b][a],
+                          connectivity.component(a) == connectivity.component(b));
+            }
+        }
+
+        for (int e = graph.successorOffsets()[a]; e < graph.successorOffsets()[a + 1]; e++)
+        {
+            EXPECT_GE(connectivity.component(a), connectivity.component(graph.edgeTargets()[e]));
+        }
+    }
+
+    int sizeSum = 0;
+    for (int c = 0; c < connectivity.numComponents(); c++)
+    {
+        sizeSum += connectivity.componentSize(c);
+        EXPECT_LE(connectivity.componentSize(c), connectivity.componentSize(connectivity.largestComponent()));
+    }
+    EXPECT_EQ(numDrivable, sizeSum);
+
+    // The largest component is represented by any of its nodes.
+    ASSERT_FALSE(connectivity.spawnCandidates().empty());
+    const int main = connectivity.spawnCandidates().front();
+    for (int node = 0; node < graph.numNodes(); node++)
+    {
+        const bool drivable = graph.drivable(node);
+        EXPECT_EQ(drivable && graph.numSuccessors(node) == 0, connectivity.deadEnd(node));
+        EXPECT_EQ(drivable && !reachable[main][node], connectivity.unreachable(node));
+        EXPECT_EQ(drivable && !reachable[node][main], connectivity.stranding(node));
+        EXPECT_EQ(drivable && reachable[main][node] && reachable[node][main], connectivity.spawnCandidate(node));
+    }
+}
+
+TEST(LaneConnectivityTest, testJunction)
+{
+    XodrMap xodrMap =
+        XodrMap::fromFile(std::string(TEST_DATA_PATH_PREFIX) + "xodr/test_for_each_roadlink/junction_links.xodr")
+            .extract_value();
+    LaneGraph graph(xodrMap);
+    LaneConnectivity connectivity(graph);
+    expectConsistentAnalysis(connectivity);
+
+    // The roads of the junction end at the border of the map, so traffic
+    // leaving the junction is stuck.
+    int westIn = laneNode(graph, "west", -1);
+    int westOut = laneNode(graph, "west", 1);
+    EXPECT_TRUE(connectivity.deadEnd(westOut));
+    EXPECT_FALSE(connectivity.deadEnd(westIn));
+    EXPECT_NE(connectivity.component(westIn), connectivity.component(westOut));
+    EXPECT_GT(connectivity.component(westIn), connectivity.component(westOut));
+}
+
+TEST(LaneConnectivityTest, testLoop)
+{
+    // Roads a and b form a loop with two lanes in the direction of the
+    // reference line and one lane against it. Road c is isolated.
+    auto road = [](const std::string& id, const std::string& links, int numRightLanes) {
+        std::stringstream ret;
+        ret << "<road name='' length='50' id='" << id << "' junction='-1'>" << links << "  <planView>"
+            << "    <geometry s='0' x='0' y='0' hdg='0' length='50'><line/></geometry>"
+            << "  </planView>"
+            << "  <lanes><laneSection s='0'>"
+            << "    <left>"
+            << "      <lane id='1' type='driving' level='false'>"
+            << "        <link><predecessor id='1'/><successor id='1'/></link>"
+            << "        <width sOffset='0' a='3' b='0' c='0' d='0'/>"
+            << "      </lane>"
+            << "    </left>"
+            << "    <center/>"
+            << "    <right>";
+        for (int i = 1; i <= numRightLanes; i++)
+        {
+            ret << "      <lane id='-" << i << "' type='driving' level='false'>"
+                << "        <link><predecessor id='-" << i << "'/><successor id='-" << i << "'/></link>"
+                << "        <width sOffset='0' a='3' b='0' c='0' d='0'/>"
+                << "      </lane>";
+        }
+        ret << "    </right>"
+            << "  </laneSection></lanes>"
+            << "</road>";
+        return ret.str();
+    };
+
+    std::string text = "<OpenDRIVE><header/>" +
+                       road("a",
+                            "<link><predecessor elementType='road' elementId='b' contactPoint='end'/>"
+                            "<successor elementType='road' elementId='b' contactPoint='start'/></link>",
+                            2) +
+                       road("b",
+                            "<link><predecessor elementType='road' elementId='a' contactPoint='end'/>"
+                            "<successor elementType='road' elementId='a' contactPoint='start'/></link>",
+                            2) +
+                       road("c", "", 1) + "</OpenDRIVE>";
+
+    XodrMap xodrMap = XodrMap::fromText(text).extract_value();
+    LaneGraph graph(xodrMap);
+    LaneConnectivity connectivity(graph);
+    expectConsistentAnalysis(connectivity);
+
+    // The right lanes of the loop form the main network.
+    EXPECT_EQ(4, connectivity.componentSize(connectivity.largestComponent()));
+    std::vector<int> spawnCandidates{laneNode(graph, "a", -1), laneNode(graph, "a", -2), laneNode(graph, "b", -1),
+                                     laneNode(graph, "b", -2)};
+    std::sort(spawnCandidates.begin(), spawnCandidates.end());
+    EXPECT_EQ(spawnCandidates, connectivity.spawnCandidates());
+
+    // The left lanes of the loop can't be reached from the main network, and
+    // don't lead back to it, but they aren't dead ends.
+    int aLeft = laneNode(graph, "a", 1);
+    int bLeft = laneNode(graph, "b", 1);
+    EXPECT_EQ(connectivity.component(aLeft), connectivity.component(bLeft));
+    EXPECT_TRUE(connectivity.unreachable(aLeft));
+    EXPECT_TRUE(connectivity.stranding(aLeft));
+    EXPECT_FALSE(connectivity.deadEnd(aLeft));
+
+    // The lanes of road c are isolated dead ends.
+    std::vector<int> deadEnds{laneNode(graph, "c", 1), laneNode(graph, "c", -1)};
+    std::sort(deadEnds.begin(), deadEnds.end());
+    EXPECT_EQ(deadEnds, connectivity.deadEnds());
+    EXPECT_EQ(4, static_cast<int>(connectivity.unreachableNodes().size()));
+    EXPECT_EQ(connectivity.unreachableNodes(), connectivity.strandingNodes());
+}
+
+TEST(LaneConnectivityTest, testLongChain)
+{
+    // A single lane through many lane sections, which is visited as one long
+    // depth first path.
+    const int numLaneSections = 500;
+    std::stringstream text;
+    text << "<OpenDRIVE><header/>"
+         << "<road name='' length='" << numLaneSections << "' id='1' junction='-1'>"
+         << "  <planView>"
+         << "    <geometry s='0' x='0' y='0' hdg='0' length='" << numLaneSections << "'><line/></geometry>"
+         << "  </planView>"
+         << "  <lanes>";
+    for (int i = 0; i < numLaneSections; i++)
+    {
+        text << "<laneSection s='" << i << "'><center/><right>"
+             << "<lane id='-1' type='driving' level='false'>"
+             << "<link><predecessor id='-1'/><successor id='-1'/></link>"
+             << "<width sOffset='0' a='3' b='0' c='0' d='0'/>"
+             << "</lane></right></laneSection>";
+    }
+    text << "  </lanes></road></OpenDRIVE>";
+
+    XodrMap xodrMap = XodrMap::fromText(text.str()).extract_value();
+    LaneGraph graph(xodrMap);
+    LaneConnectivity connectivity(graph);
+
+    // Every lane is its own component, numbered from the end of the chain.
+    ASSERT_EQ(numLaneSections, connectivity.numComponents());
+    for (int i = 0; i < numLaneSections; i++)
+    {
+        ASSERT_EQ(numLaneSections - 1 - i, connectivity.component(laneNode(graph, "1", -1, i)));
+    }
+
+    EXPECT_EQ(std::vector<int>({laneNode(graph, "1", -1, numLaneSections - 1)}), connectivity.deadEnds());
+}
+
+}}  // namespace aid::xodr
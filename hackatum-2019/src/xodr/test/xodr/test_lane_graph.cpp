@@ -0,0 +1,225 @@
+#include "lane_graph.h"
+
+#include <gtest/gtest.h>
+#include <set>
+
+#include "../test_config.h"
+#include "lane_graph_test_utils.h"
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief Gets the targets of the outgoing edges of a node.
+ */
+static std::set<int> successorSet(const LaneGraph& graph, int node)
+{
+    std::set<int> ret;
+    for (int e = graph.successorOffsets()[node]; e < graph.successorOffsets()[node + 1]; e++)
+    {
+        ret.insert(graph.edgeTargets()[e]);
+    }
+    return ret;
+}
+
+/**
+ * @brief Gets the sources of the incoming edges of a node.
+ */
+static std::set<int> predecessorSet(const LaneGraph& graph, int node)
+{
+    std::set<int> ret;
+    for (int i = graph.predecessorOffsets()[node]; i < graph.predecessorOffsets()[node + 1]; i++)
+    {
+        ret.insert(graph.edgeSources()[graph.predecessorEdges()[i]]);
+    }
+    return ret;
+}
+
+/**
+ * @brief Checks that the outgoing and incoming edges of a graph are consistent.
+ */
+static void expectConsistentEdges(const LaneGraph& graph)
+{
+    ASSERT_EQ(graph.numNodes() + 1, static_cast<int>(graph.successorOffsets().size()));
+    ASSERT_EQ(graph.numNodes() + 1, static_cast<int>(graph.predecessorOffsets().size()));
+    EXPECT_EQ(graph.numEdges(), graph.successorOffsets().back());
+    EXPECT_EQ(graph.numEdges(), graph.predecessorOffsets().back());
+
+    for (int node = 0; node < graph.numNodes(); node++)
+    {
+        for (int e = graph.successorOffsets()[node]; e < graph.successorOffsets()[node + 1]; e++)
+        {
+            EXPECT_EQ(node, graph.edgeSources()[e]);
+            EXPECT_EQ(e, graph.findEdge(node, graph.edgeTargets()[e]));
+            EXPECT_EQ(1u, predecessorSet(graph, graph.edgeTargets()[e]).count(node));
+        }
+        for (int i = graph.predecessorOffsets()[node]; i < graph.predecessorOffsets()[node + 1]; i++)
+        {
+            EXPECT_EQ(node, graph.edgeTargets()[graph.predecessorEdges()[i]]);
+        }
+        EXPECT_EQ(node, graph.node(graph.laneKey(node)));
+    }
+}
+
+TEST(LaneGraphTest, testJunction)
+{
+    XodrReader xml =
+        XodrReader::fromFile(std::string(TEST_DATA_PATH_PREFIX) + "xodr/test_for_each_roadlink/junction_links.xodr");
+
+    xml.readStartElement("OpenDRIVE");
+    XodrMap xodrMap = std::move(XodrMap::parseXml(xml).value());
+
+    LaneGraph graph(xodrMap);
+    ASSERT_EQ(xodrMap.totalNumLanes(), graph.numNodes());
+    expectConsistentEdges(graph);
+
+    int westIn = laneNode(graph, "west", -1);
+    int westOut = laneNode(graph, "west", 1);
+    int eastIn = laneNode(graph, "east", 1);
+    int eastOut = laneNode(graph, "east", -1);
+    int northIn = laneNode(graph, "north", 1);
+    int northOut = laneNode(graph, "north", -1);
+    int westEast = laneNode(graph, "junction_westEast", -1);
+    int eastWest = laneNode(graph, "junction_eastWest", -1);
+    int westNorth = laneNode(graph, "junction_westNorth", -1);
+    int northWest = laneNode(graph, "junction_northWest", 1);
+    int eastNorth = laneNode(graph, "junction_eastNorth", -1);
+
+    // The edges into the junction come from the junction lane links, the
+    // edges out of it from the lane links of the connecting roads.
+    EXPECT_EQ(std::set<int>({westEast, westNorth}), successorSet(graph, westIn));
+    EXPECT_EQ(std::set<int>({eastWest, eastNorth}), successorSet(graph, eastIn));
+    EXPECT_EQ(std::set<int>({eastOut}), successorSet(graph, westEast));
+    EXPECT_EQ(std::set<int>({westOut}), successorSet(graph, eastWest));
+    EXPECT_EQ(std::set<int>({northOut}), successorSet(graph, westNorth));
+    EXPECT_EQ(std::set<int>({northOut}), successorSet(graph, eastNorth));
+    EXPECT_EQ(std::set<int>({westOut}), successorSet(graph, northWest));
+    EXPECT_EQ(1u, successorSet(graph, northIn).count(northWest));
+
+    EXPECT_EQ(std::set<int>({eastWest, northWest}), predecessorSet(graph, westOut));
+    EXPECT_EQ(std::set<int>({westNorth, eastNorth}), predecessorSet(graph, northOut));
+    EXPECT_EQ(0, graph.numSuccessors(westOut));
+    EXPECT_EQ(0, graph.numPredecessors(westIn));
+
+    // There are no lane changes between lanes of opposite directions.
+    EXPECT_EQ(-1, graph.findEdge(westIn, westOut));
+    EXPECT_EQ(-1, graph.findEdge(westOut, westIn));
+
+    int e = graph.findEdge(westIn, westEast);
+    ASSERT_GE(e, 0);
+    EXPECT_EQ(LaneGraph::EdgeType::SUCCESSOR, graph.edgeTypes()[e]);
+    EXPECT_DOUBLE_EQ(40, graph.edgeLengths()[e]);
+    EXPECT_DOUBLE_EQ(40 / LaneGraphOptions().defaultSpeed_, graph.edgeTravelTimes()[e]);
+}
+
+TEST(LaneGraphTest, testLaneSectionsAndLaneChanges)
+{
+    std::string text =
+        "<OpenDRIVE><header/>"
+        "<road name='' length='100' id='1' junction='-1'>"
+        "  <planView>"
+        "    <geometry s='0' x='0' y='0' hdg='0' length='100'><line/></geometry>"
+        "  </planView>"
+        "  <lanes>"
+        "    <laneSection s='0'>"
+        "      <left>"
+        "        <lane id='2' type='sidewalk' level='false'>"
+        "          <link><successor id='2'/></link>"
+        "          <width sOffset='0' a='2' b='0' c='0' d='0'/>"
+        "        </lane>"
+        "        <lane id='1' type='driving' level='false'>"
+        "          <width sOffset='0' a='3' b='0' c='0' d='0'/>"
+        "        </lane>"
+        "      </left>"
+        "      <center/>"
+        "      <right>"
+        "        <lane id='-1' type='driving' level='false'>"
+        "          <link><successor id='-1'/></link>"
+        "          <width sOffset='0' a='3' b='0' c='0' d='0'/>"
+        "          <speed sOffset='0' max='36' unit='km/h'/>"
+        "        </lane>"
+        "        <lane id='-2' type='driving' level='false'>"
+        "          <link><successor id='-2'/></link>"
+        "          <width sOffset='0' a='3' b='0' c='0' d='0'/>"
+        "          <speed sOffset='20' max='20' unit='m/s'/>"
+        "        </lane>"
+        "      </right>"
+        "    </laneSection>"
+        "    <laneSection s='40'>"
+        "      <left>"
+        "        <lane id='2' type='sidewalk' level='false'>"
+        "          <link><predecessor id='2'/></link>"
+        "          <width sOffset='0' a='2' b='0' c='0' d='0'/>"
+        "        </lane>"
+        "        <lane id='1' type='driving' level='false'>"
+        "          <link><predecessor id='1'/></link>"
+        "          <width sOffset='0' a='3' b='0' c='0' d='0'/>"
+        "        </lane>"
+        "      </left>"
+        "      <center/>"
+        "      <right>"
+        "        <lane id='-1' type='driving' level='false'>"
+        "          <link><predecessor id='-1'/></link>"
+        "          <width sOffset='0' a='3' b='0' c='0' d='0'/>"
+        "        </lane>"
+        "      </right>"
+        "    </laneSection>"
+        "  </lanes>"
+        "</road>"
+        "</OpenDRIVE>";
+
+    XodrReader xml = XodrReader::fromText(text);
+    xml.readStartElement("OpenDRIVE");
+    XodrMap xodrMap = std::move(XodrMap::parseXml(xml).value());
+
+    LaneGraphOptions options;
+    options.defaultSpeed_ = 10;
+    options.laneChangeLength_ = 20;
+    LaneGraph graph(xodrMap, options);
+    expectConsistentEdges(graph);
+
+    int sidewalk0 = laneNode(graph, "1", 2, 0);
+    int sidewalk1 = laneNode(graph, "1", 2, 1);
+    int left0 = laneNode(graph, "1", 1, 0);
+    int left1 = laneNode(graph, "1", 1, 1);
+    int right0 = laneNode(graph, "1", -1, 0);
+    int outer0 = laneNode(graph, "1", -2, 0);
+    int right1 = laneNode(graph, "1", -1, 1);
+
+    // Sidewalks aren't part of the routing graph.
+    EXPECT_FALSE(graph.drivable(sidewalk0));
+    EXPECT_EQ(0, graph.numSuccessors(sidewalk0));
+    EXPECT_EQ(0, graph.numPredecessors(sidewalk1));
+
+    // The left lane is driven against the reference line, and the link which
+    // is only specified in the second lane section still results in an edge.
+    EXPECT_EQ(std::set<int>({left0}), successorSet(graph, left1));
+    EXPECT_EQ(0, graph.numSuccessors(left0));
+
+    EXPECT_EQ(std::set<int>({right1, outer0}), successorSet(graph, right0));
+    EXPECT_EQ(std::set<int>({right0}), successorSet(graph, outer0));
+
+    // The speed limit of the inner right lane is 10 m/s. The outer one is
+    // driven at the default speed for 20 m, then at 20 m/s.
+    EXPECT_DOUBLE_EQ(4, graph.laneTravelTime(right0));
+    EXPECT_DOUBLE_EQ(3, graph.laneTravelTime(outer0));
+    EXPECT_DOUBLE_EQ(60 / 10.0, graph.laneTravelTime(right1));
+
+    int e = graph.findEdge(right0, right1);
+    ASSERT_GE(e, 0);
+    EXPECT_EQ(LaneGraph::EdgeType::SUCCESSOR, graph.edgeTypes()[e]);
+    EXPECT_DOUBLE_EQ(40, graph.edgeLengths()[e]);
+    EXPECT_DOUBLE_EQ(4, graph.edgeTravelTimes()[e]);
+
+    e = graph.findEdge(right0, outer0);
+    ASSERT_GE(e, 0);
+    EXPECT_EQ(LaneGraph::EdgeType::LANE_CHANGE_RIGHT, graph.edgeTypes()[e]);
+    EXPECT_DOUBLE_EQ(20, graph.edgeLengths()[e]);
+    EXPECT_DOUBLE_EQ(2, graph.edgeTravelTimes()[e]);
+
+    e = graph.findEdge(outer0, right0);
+    ASSERT_GE(e, 0);
+    EXPECT_EQ(LaneGraph::EdgeType::LANE_CHANGE_LEFT, graph.edgeTypes()[e]);
+    EXPECT_DOUBLE_EQ(20 * 3 / 40.0, graph.edgeTravelTimes()[e]);
+}
+
+}}  // namespace aid::xodr
@@ -0,0 +1,239 @@
+#include "lane_router.h"
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <sstream>
+
+#include "../test_config.h"
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief Creates the lanes of one side of a lane section, with the given link
+ * element on every lane.
+ */
+static std::string ringLanes(const char* side, int sign, const std::string& linkElement, int roadIdx)
+{
+    std::string ret = std::string("<") + side + ">";
+    for (int i = 3; i >= 1; i--)
+    {
+        const int id = sign > 0 ? i : -(4 - i);
+        const int speed = 8 + (roadIdx * 3 + std::abs(id) * 5) % 11;
+        ret += "<lane id='" + std::to_string(id) + "' type='driving' level='false'>"
+               "  <link>" + linkElement + " id='" + std::to_string(id) + "'/></link>"
+               "  <width sOffset='0' a='3' b='0' c='0' d='0'/>"
+               "  <speed sOffset='0' max='" + std::to_string(speed) + "' unit='m/s'/>"
+               "</lane>";
+    }
+    return ret + "</" + side + ">";
+}
+
+/**
+ * @brief Creates a map with six roads which form a closed hexagon. Each road
+ * has two lane sections with three lanes on each side, and the lanes of
+ * consecutive roads are linked.
+ */
+static XodrMap ringMap()
+{
+    const int numRoads = 6;
+    const double length = 50;
+
+    std::ostringstream text;
+    text.precision(17);
+    text << "<OpenDRIVE><header/>";
+
+    double x = 0;
+    double y = 0;
+    for (int i = 0; i < numRoads; i++)
+    {
+        const double hdg = i * 2 * M_PI / numRoads;
+        const double split = 10 + 5 * i;
+        text << "<road name='' length='" << length << "' id='" << i << "' junction='-1'>"
+             << "<link>"
+             << "<predecessor elementType='road' elementId='" << (i + numRoads - 1) % numRoads
+             << "' contactPoint='end'/>"
+             << "<successor elementType='road' elementId='" << (i + 1) % numRoads << "' contactPoint='start'/>"
+             << "</link>"
+             << "<planView><geometry s='0' x='" << x << "' y='" << y << "' hdg='" << hdg << "' length='" << length
+             << "'><line/></geometry></planView>"
+             << "<lanes>"
+             << "<laneSection s='0'>" << ringLanes("left", 1, "<successor", i) << "<center/>"
+             << ringLanes("right", -1, "<successor", i) << "</laneSection>"
+             << "<laneSection s='" << split << "'>" << ringLanes("left", 1, "<predecessor", i) << "<center/>"
+             << ringLanes("right", -1, "<predecessor", i) << "</laneSection>"
+             << "</lanes>"
+             << "</road>";
+
+        x += length * std::cos(hdg);
+        y += length * std::sin(hdg);
+    }
+    text << "</OpenDRIVE>";
+
+    XodrReader xml = XodrReader::fromText(text.str());
+    xml.readStartElement("OpenDRIVE");
+    return std::move(XodrMap::parseXml(xml).value());
+}
+
+/**
+ * @brief Checks that the nodes of a route are connected by edges whose costs
+ * add up to the cost of the route.
+ */
+static void expectValidRoute(const LaneGraph& graph, RouteCost cost, const Route& route, int from, int to)
+{
+    ASSERT_TRUE(route.found());
+    EXPECT_EQ(from, route.nodes_.front());
+    EXPECT_EQ(to, route.nodes_.back());
+
+    const std::vector<double>& costs = laneGraphEdgeCosts(graph, cost);
+    double sum = 0;
+    for (int i = 0; i + 1 < static_cast<int>(route.nodes_.size()); i++)
+    {
+        int e = graph.findEdge(route.nodes_[i], route.nodes_[i + 1]);
+        ASSERT_GE(e, 0);
+        sum += costs[e];
+    }
+    EXPECT_NEAR(route.cost_, sum, 1e-9);
+}
+
+/**
+ * @brief Checks that all algorithms find routes of the same cost as Dijkstra
+ * between all pairs of nodes.
+ */
+static void expectAllAlgorithmsAgree(const LaneGraph& graph, RouteCost cost)
+{
+    ContractionHierarchy hierarchy(graph, cost);
+    LaneRouter router(graph, hierarchy);
+
+    for (int from = 0; from < graph.numNodes(); from++)
+    {
+        for (int to = 0; to < graph.numNodes(); to++)
+        {
+            Route expected = router.route(from, to, RoutingAlgorithm::DIJKSTRA);
+            for (RoutingAlgorithm algorithm : {RoutingAlgorithm::A_STAR, RoutingAlgorithm::BIDIRECTIONAL_DIJKSTRA,
+                                               RoutingAlgorithm::CONTRACTION_HIERARCHY})
+            {
+                Route route = router.route(from, to, algorithm);
+                ASSERT_EQ(expected.found(), route.found()) << from << " -> " << to;
+                if (expected.found())
+                {
+                    EXPECT_NEAR(expected.cost_, route.cost_, 1e-9) << from << " -> " << to;
+                    expectValidRoute(graph, cost, route, from, to);
+                }
+            }
+        }
+    }
+}
+
+TEST(LaneRouterTest, testRingLength)
+{
+    XodrMap xodrMap = ringMap();
+    LaneGraph graph(xodrMap);
+    expectAllAlgorithmsAgree(graph, RouteCost::LENGTH);
+}
+
+TEST(LaneRouterTest, testRingTravelTime)
+{
+    XodrMap xodrMap = ringMap();
+    LaneGraph graph(xodrMap);
+    expectAllAlgorithmsAgree(graph, RouteCost::TRAVEL_TIME);
+}
+
+TEST(LaneRouterTest, testJunction)
+{
+    XodrReader xml =
+        XodrReader::fromFile(std::string(TEST_DATA_PATH_PREFIX) + "xodr/test_for_each_roadlink/junction_links.xodr");
+
+    xml.readStartElement("OpenDRIVE");
+    XodrMap xodrMap = std::move(XodrMap::parseXml(xml).value());
+
+    LaneGraph graph(xodrMap);
+    expectAllAlgorithmsAgree(graph, RouteCost::LENGTH);
+
+    // From the west road to the east road, through the junction.
+    int westIdx = xodrMap.roadIndexById("west");
+    int eastIdx = xodrMap.roadIndexById("east");
+    int junctionIdx = xodrMap.roadIndexById("junction_westEast");
+    int from = graph.node(LaneKey(westIdx, 0, 1));
+    int via = graph.node(LaneKey(junctionIdx, 0, 0));
+    int to = graph.node(LaneKey(eastIdx, 0, 1));
+
+    LaneRouter router(graph);
+    Route route = router.route(from, to);
+    EXPECT_EQ(std::vector<int>({from, via, to}), route.nodes_);
+    EXPECT_DOUBLE_EQ(80, route.cost_);
+
+    // There's no way back on the same lane.
+    EXPECT_FALSE(router.route(to, from).found());
+}
+
+TEST(LaneRouterTest, testRouteToSelf)
+{
+    XodrMap xodrMap = ringMap();
+    LaneGraph graph(xodrMap);
+    LaneRouter router(graph);
+
+    Route route = router.route(3, 3);
+    EXPECT_EQ(std::vector<int>({3}), route.nodes_);
+    EXPECT_EQ(0, route.cost_);
+}
+
+TEST(ContractionHierarchyTest, testSerialization)
+{
+    XodrMap xodrMap = ringMap();
+    LaneGraph graph(xodrMap);
+    ContractionHierarchy hierarchy(graph, RouteCost::TRAVEL_TIME);
+    EXPECT_TRUE(hierarchy.matches(graph));
+
+    std::stringstream stream;
+    hierarchy.write(stream);
+    ContractionHierarchy copy = ContractionHierarchy::read(stream);
+
+    EXPECT_EQ(RouteCost::TRAVEL_TIME, copy.cost());
+    EXPECT_EQ(hierarchy.rank(), copy.rank());
+    EXPECT_EQ(hierarchy.upTargets(), copy.upTargets());
+    EXPECT_EQ(hierarchy.downSources(), copy.downSources());
+    EXPECT_EQ(hierarchy.numShortcuts(), copy.numShortcuts());
+    EXPECT_TRUE(copy.matches(graph));
+
+    LaneRouter router(graph, hierarchy);
+    LaneRouter copyRouter(graph, copy);
+    for (int from = 0; from < graph.numNodes(); from += 7)
+    {
+        for (int to = 0; to < graph.numNodes(); to += 5)
+        {
+            Route expected = router.route(from, to);
+            Route route = copyRouter.route(from, to);
+            EXPECT_EQ(expected.nodes_, route.nodes_);
+        }
+    }
+
+    // The hierarchy of one map can't be used with the graph of another.
+    XodrReader xml =
+        XodrReader::fromFile(std::string(TEST_DATA_PATH_PREFIX) + "xodr/test_for_each_roadlink/junction_links.xodr");
+    xml.readStartElement("OpenDRIVE");
+    XodrMap otherMap = std::move(XodrMap::parseXml(xml).value());
+    LaneGraph otherGraph(otherMap);
+    EXPECT_FALSE(copy.matches(otherGraph));
+    EXPECT_THROW(LaneRouter(otherGraph, copy), std::runtime_error);
+}
+
+TEST(ContractionHierarchyTest, testReadInvalid)
+{
+    XodrMap xodrMap = ringMap();
+    LaneGraph graph(xodrMap);
+    ContractionHierarchy hierarchy(graph, RouteCost::LENGTH);
+
+    std::stringstream stream;
+    hierarchy.write(stream);
+    std::string data = stream.str();
+
+    std::stringstream truncated(data.substr(0, data.size() / 2));
+    EXPECT_THROW(ContractionHierarchy::read(truncated), std::runtime_error);
+
+    std::string wrongMagic = data;
+    wrongMagic[0] = 'Y';
+    std::stringstream wrongMagicStream(wrongMagic);
+    EXPECT_THROW(ContractionHierarchy::read(wrongMagicStream), std::runtime_error);
+}
+
+}}  // namespace aid::xodr
@@ -0,0 +1,157 @@
+#include "lane_table.h"
+
+#include <cmath>
+#include <gtest/gtest.h>
+
+#include "../test_config.h"
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief Gets the global index of the lane with the given id in the given
+ * lane section of the road with the given id.
+ */
+static int globalIndex(const XodrMap& map, const std::string& roadId, int laneId, int laneSectionIdx = 0)
+{
+    const Road& road = *map.roadById(roadId);
+    return road.laneSections()[laneSectionIdx].laneById(LaneID(laneId)).globalIndex();
+}
+
+TEST(LaneTableTest, testMatchesLanes)
+{
+    XodrMap map =
+        XodrMap::fromFile(std::string(TEST_DATA_PATH_PREFIX) + "xodr/test_for_each_roadlink/junction_links.xodr")
+            .extract_value();
+    LaneTable table(map);
+    ASSERT_EQ(map.totalNumLanes(), table.numLanes());
+
+    for (int roadIdx = 0; roadIdx < static_cast<int>(map.roads().size()); roadIdx++)
+    {
+        const auto& laneSections = map.roads()[roadIdx].laneSections();
+        for (int laneSectionIdx = 0; laneSectionIdx < static_cast<int>(laneSections.size()); laneSectionIdx++)
+        {
+            const LaneSection& laneSection = laneSections[laneSectionIdx];
+            for (int laneIdx = 0; laneIdx < static_cast<int>(laneSection.lanes().size()); laneIdx++)
+            {
+                const LaneSection::Lane& lane = laneSection.lanes()[laneIdx];
+                const int i = lane.globalIndex();
+                EXPECT_EQ(LaneKey(roadIdx, laneSectionIdx, laneIdx), table.laneKeys()[i]);
+                EXPECT_EQ(lane.id(), table.ids()[i]);
+                EXPECT_EQ(lane.type(), table.types()[i]);
+                EXPECT_DOUBLE_EQ(laneSection.endS() - laneSection.startS(), table.lengths()[i]);
+            }
+        }
+    }
+
+    // The lanes of the connecting roads link to the incoming and outgoing
+    // roads directly, while the links of the incoming and outgoing roads are
+    // specified in the junction.
+    const int westIn = globalIndex(map, "west", -1);
+    const int westEast = globalIndex(map, "junction_westEast", -1);
+    const int eastOut = globalIndex(map, "east", -1);
+    EXPECT_EQ(westIn, table.predecessors()[westEast]);
+    EXPECT_EQ(eastOut, table.successors()[westEast]);
+    EXPECT_EQ(LaneTable::NO_LANE, table.successors()[westIn]);
+    EXPECT_EQ(LaneTable::NO_LANE, table.predecessors()[eastOut]);
+}
+
+TEST(LaneTableTest, testLinksAndAttributes)
+{
+    std::string text =
+        "<OpenDRIVE><header/>"
+        "<road name='' length='100' id='1' junction='-1'>"
+        "  <link><successor elementType='road' elementId='2' contactPoint='end'/></link>"
+        "  <planView>"
+        "    <geometry s='0' x='0' y='0' hdg='0' length='100'><line/></geometry>"
+        "  </planView>"
+        "  <lanes>"
+        "    <laneSection s='0'>"
+        "      <center/>"
+        "      <right>"
+        "        <lane id='-1' type='driving' level='false'>"
+        "          <link><successor id='-1'/></link>"
+        "          <width sOffset='0' a='3' b='0' c='0' d='0'/>"
+        "          <material sOffset='0' surface='asphalt' friction='0.8' roughness='0.1'/>"
+        "          <material sOffset='10' surface='gravel' friction='0.6' roughness='0.4'/>"
+        "          <speed sOffset='0' max='36' unit='km/h'/>"
+        "          <speed sOffset='20' max='20' unit='m/s'/>"
+        "        </lane>"
+        "        <lane id='-2' type='sidewalk' level='false'>"
+        "          <width sOffset='0' a='2' b='0' c='0' d='0'/>"
+        "          <material sOffset='0' surface='concrete' friction='0.7' roughness='0.2'/>"
+        "        </lane>"
+        "      </right>"
+        "    </laneSection>"
+        "    <laneSection s='40'>"
+        "      <center/>"
+        "      <right>"
+        "        <lane id='-1' type='driving' level='false'>"
+        "          <link><predecessor id='-1'/><successor id='1'/></link>"
+        "          <width sOffset='0' a='3' b='0' c='0' d='0'/>"
+        "          <material sOffset='0' surface='asphalt' friction='0.9' roughness='0.1'/>"
+        "        </lane>"
+        "      </right>"
+        "    </laneSection>"
+        "  </lanes>"
+        "</road>"
+        "<road name='' length='50' id='2' junction='-1'>"
+        "  <link><successor elementType='road' elementId='1' contactPoint='end'/></link>"
+        "  <planView>"
+        "    <geometry s='0' x='150' y='0' hdg='3.141592653589793' length='50'><line/></geometry>"
+        "  </planView>"
+        "  <lanes>"
+        "    <laneSection s='0'>"
+        "      <left>"
+        "        <lane id='1' type='driving' level='false'>"
+        "          <link><successor id='-1'/></link>"
+        "          <width sOffset='0' a='3' b='0' c='0' d='0'/>"
+        "          <speed sOffset='0' max='50' unit='mps'/>"
+        "        </lane>"
+        "      </left>"
+        "      <center/>"
+        "    </laneSection>"
+        "  </lanes>"
+        "</road>"
+        "</OpenDRIVE>";
+
+    XodrMap map = XodrMap::fromText(text).extract_value();
+    LaneTable table(map);
+    ASSERT_EQ(map.totalNumLanes(), table.numLanes());
+
+    const int a0 = globalIndex(map, "1", -1, 0);
+    const int sidewalk = globalIndex(map, "1", -2, 0);
+    const int a1 = globalIndex(map, "1", -1, 1);
+    const int b = globalIndex(map, "2", 1, 0);
+
+    // Links within a road, and to the lane section at the contact point of
+    // the linked road.
+    EXPECT_EQ(a1, table.successors()[a0]);
+    EXPECT_EQ(LaneTable::NO_LANE, table.predecessors()[a0]);
+    EXPECT_EQ(a0, table.predecessors()[a1]);
+    EXPECT_EQ(b, table.successors()[a1]);
+    EXPECT_EQ(a1, table.successors()[b]);
+    EXPECT_EQ(LaneTable::NO_LANE, table.successors()[sidewalk]);
+
+    EXPECT_DOUBLE_EQ(40, table.lengths()[a0]);
+    EXPECT_DOUBLE_EQ(60, table.lengths()[a1]);
+    EXPECT_EQ(LaneType::SIDEWALK, table.types()[sidewalk]);
+
+    // Only the first speed limit is stored, in meters per second.
+    EXPECT_DOUBLE_EQ(10, table.speedLimits()[a0]);
+    EXPECT_TRUE(std::isnan(table.speedLimits()[a1]));
+    EXPECT_DOUBLE_EQ(50 * 0.44704, table.speedLimits()[b]);
+
+    // Only the first material is stored, and the surfaces are shared.
+    ASSERT_EQ(std::vector<std::string>({"asphalt", "concrete"}), table.surfaces());
+    EXPECT_EQ(0, table.materialSurfaces()[a0]);
+    EXPECT_DOUBLE_EQ(0.8, table.materialFrictions()[a0]);
+    EXPECT_DOUBLE_EQ(0.1, table.materialRoughnesses()[a0]);
+    EXPECT_EQ(1, table.materialSurfaces()[sidewalk]);
+    EXPECT_EQ(0, table.materialSurfaces()[a1]);
+    EXPECT_DOUBLE_EQ(0.9, table.materialFrictions()[a1]);
+    EXPECT_EQ(-1, table.materialSurfaces()[b]);
+    EXPECT_TRUE(std::isnan(table.materialFrictions()[b]));
+    EXPECT_TRUE(std::isnan(table.materialRoughnesses()[b]));
+}
+
+}}  // namespace aid::xodr
@@ -0,0 +1,145 @@
+#include "map_tessellation.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "../test_config.h"
+
+namespace aid { namespace xodr {
+
+static void expectEqualTessellations(const XodrMap& xodrMap, const MapTessellation& tessellation,
+                                     const TessellationSettings& settings)
+{
+    ASSERT_EQ(tessellation.roadOffsets_.size(), xodrMap.roads().size() + 1);
+
+    int numBoundaries = 0;
+    for (int roadIdx = 0; roadIdx < static_cast<int>(xodrMap.roads().size()); roadIdx++)
+    {
+        const Road& road = xodrMap.roads()[roadIdx];
+        for (int i = 0; i < static_cast<int>(road.laneSections().size()); i++)
+        {
+            LaneSectionTessellation expected = tessellateLaneSection(road, road.laneSections()[i], settings);
+            const MapTessellation::LaneSectionRange& range = tessellation.laneSection(LaneSectionKey(roadIdx, i));
+
+            EXPECT_EQ(range.key_, LaneSectionKey(roadIdx, i));
+            ASSERT_EQ(range.refLineEnd_ - range.refLineBegin_, static_cast<int>(expected.referenceLine_.size()));
+            for (int v = 0; v < static_cast<int>(expected.referenceLine_.size()); v++)
+            {
+                const ReferenceLine::Vertex& vertex = expected.referenceLine_[v];
+                EXPECT_EQ(tessellation.refLineS_[range.refLineBegin_ + v], vertex.sCoord_);
+                EXPECT_EQ(tessellation.refLineVertex(range, range.refLineBegin_ + v), vertex.position_);
+                EXPECT_EQ(tessellation.refLineHeading_[range.refLineBegin_ + v], vertex.heading_);
+            }
+
+            ASSERT_EQ(range.boundaryEnd_ - range.boundaryBegin_, static_cast<int>(expected.boundaries_.size()));
+            for (int b = 0; b < static_cast<int>(expected.boundaries_.size()); b++)
+            {
+                const std::vector<Eigen::Vector2d>& vertices = expected.boundaries_[b].vertices_;
+                const int offset = tessellation.boundaryOffsets_[range.boundaryBegin_ + b];
+                ASSERT_EQ(tessellation.boundaryOffsets_[range.boundaryBegin_ + b + 1] - offset,
+                          static_cast<int>(vertices.size()));
+                for (int v = 0; v < static_cast<int>(vertices.size()); v++)
+                {
+                    EXPECT_EQ(tessellation.boundaryVertex(range, offset + v), vertices[v]);
+                }
+            }
+            numBoundaries += static_cast<int>(expected.boundaries_.size());
+        }
+    }
+
+    EXPECT_EQ(tessellation.numBoundaries(), numBoundaries);
+    EXPECT_EQ(tessellation.boundaryOffsets_.back(), static_cast<int>(tessellation.boundaryX_.size()));
+    EXPECT_EQ(tessellation.refLineS_.size(), tessellation.refLineX_.size());
+}
+
+TEST(MapTessellationTest, testTessellateMap)
+{
+    XodrReader xml =
+        XodrReader::fromFile(std::string(TEST_DATA_PATH_PREFIX) + "xodr/test_for_each_roadlink/junction_links.xodr");
+    xml.readStartElement("OpenDRIVE");
+    XodrMap xodrMap = std::move(XodrMap::parseXml(xml).value());
+
+    MapTessellationOptions options;
+    options.numThreads_ = 1;
+    expectEqualTessellations(xodrMap, tessellateMap(xodrMap, options), options.settings_);
+
+    // Split every road into lane section tasks, and run more threads than cores.
+    options.numThreads_ = 4;
+    options.maxTaskLength_ = 0;
+    options.settings_.verticesPerMeter_ = 3;
+    expectEqualTessellations(xodrMap, tessellateMap(xodrMap, options), options.settings_);
+}
+
+TEST(MapTessellationTest, testCompactTessellation)
+{
+    // A road with UTM-like coordinates, where float coordinates would be off
+    // by decimeters without a local origin.
+    XodrReader xml = XodrReader::fromText(
+        "<OpenDRIVE>"
+        "  <header/>"
+        "  <road name='road' length='3000' id='1' junction='-1'>"
+        "    <planView>"
+        "      <geometry s='0' x='691234.567' y='5334567.891' hdg='0.3' length='3000'>"
+        "        <arc curvature='0.0005'/>"
+        "      </geometry>"
+        "    </planView>"
+        "    <lanes>"
+        "      <laneSection s='0'>"
+        "        <left>"
+        "          <lane id='1' type='driving' level='false'>"
+        "            <width sOffset='0' a='3.5' b='0' c='0' d='0'/>"
+        "          </lane>"
+        "        </left>"
+        "        <center/>"
+        "      </laneSection>"
+        "      <laneSection s='1500'>"
+        "        <center/>"
+        "        <right>"
+        "          <lane id='-1' type='driving' level='false'>"
+        "            <width sOffset='0' a='3.5' b='0' c='0' d='0'/>"
+        "          </lane>"
+        "        </right>"
+        "      </laneSection>"
+        "    </lanes>"
+        "  </road>"
+        "</OpenDRIVE>");
+    xml.readStartElement("OpenDRIVE");
+    XodrMap xodrMap = std::move(XodrMap::parseXml(xml).value());
+
+    MapTessellationOptions options;
+    options.numThreads_ = 2;
+    MapTessellation exact = tessellateMap(xodrMap, options);
+
+    for (TessellationOrigin origin : {TessellationOrigin::ROAD, TessellationOrigin::TILE})
+    {
+        options.origin_ = origin;
+        CompactMapTessellation compact = tessellateMap<float>(xodrMap, options);
+
+        EXPECT_EQ(compact.origins_.size(), origin == TessellationOrigin::ROAD ? 1u : 2u);
+        ASSERT_EQ(compact.laneSections_.size(), exact.laneSections_.size());
+        ASSERT_EQ(compact.boundaryX_.size(), exact.boundaryX_.size());
+        EXPECT_LT(compact.memoryUsage(), exact.memoryUsage() * 6 / 10);
+
+        double maxError = 0;
+        for (int i = 0; i < static_cast<int>(exact.laneSections_.size()); i++)
+        {
+            const MapTessellation::LaneSectionRange& exactRange = exact.laneSections_[i];
+            const CompactMapTessellation::LaneSectionRange& compactRange = compact.laneSections_[i];
+            for (int v = exactRange.refLineBegin_; v < exactRange.refLineEnd_; v++)
+            {
+                maxError = std::max(maxError, (compact.refLineVertex(compactRange, v) -
+                                               exact.refLineVertex(exactRange, v)).norm());
+            }
+            for (int v = exact.boundaryOffsets_[exactRange.boundaryBegin_];
+                 v < exact.boundaryOffsets_[exactRange.boundaryEnd_]; v++)
+            {
+                maxError = std::max(maxError, (compact.boundaryVertex(compactRange, v) -
+                                               exact.boundaryVertex(exactRange, v)).norm());
+            }
+        }
+        EXPECT_LT(maxError, 1e-3);
+    }
+}
+
+}}  // namespace aid::xodr
@@ -0,0 +1,78 @@
+#include "packed_rtree.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+
+namespace aid { namespace xodr {
+
+static std::vector<Eigen::AlignedBox2d> randomBoxes(int numBoxes)
+{
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> position(-1000, 1000);
+    std::uniform_real_distribution<double> size(0, 50);
+
+    std::vector<Eigen::AlignedBox2d> ret;
+    for (int i = 0; i < numBoxes; i++)
+    {
+        Eigen::Vector2d min(position(rng), position(rng));
+        ret.emplace_back(min, min + Eigen::Vector2d(size(rng), size(rng)));
+    }
+    return ret;
+}
+
+TEST(PackedRTreeTest, testSearch)
+{
+    for (int numBoxes : {0, 1, 15, 16, 17, 1000})
+    {
+        std::vector<Eigen::AlignedBox2d> boxes = randomBoxes(numBoxes);
+        PackedRTree tree(boxes);
+        EXPECT_EQ(tree.numItems(), numBoxes);
+
+        for (const Eigen::AlignedBox2d& query : randomBoxes(20))
+        {
+            std::vector<int> found;
+            tree.search(query, [&](int item) { found.push_back(item); });
+            std::sort(found.begin(), found.end());
+
+            std::vector<int> expected;
+            for (int i = 0; i < numBoxes; i++)
+            {
+                if (query.intersects(boxes[i]))
+                {
+                    expected.push_back(i);
+                }
+            }
+            EXPECT_EQ(found, expected);
+        }
+    }
+}
+
+TEST(PackedRTreeTest, testForEachByDistance)
+{
+    std::vector<Eigen::AlignedBox2d> boxes = randomBoxes(1000);
+    PackedRTree tree(boxes);
+
+    const Eigen::Vector2d pt(12, -34);
+    std::vector<int> visited;
+    double lastDistance = 0;
+    tree.forEachByDistance(pt, [&](int item, double distance) {
+        EXPECT_GE(distance, lastDistance);
+        EXPECT_DOUBLE_EQ(distance, boxes[item].exteriorDistance(pt));
+        lastDistance = distance;
+        visited.push_back(item);
+        return visited.size() < 10;
+    });
+    ASSERT_EQ(visited.size(), 10u);
+
+    std::vector<double> distances;
+    for (const Eigen::AlignedBox2d& box : boxes)
+    {
+        distances.push_back(box.exteriorDistance(pt));
+    }
+    std::sort(distances.begin(), distances.end());
+    EXPECT_DOUBLE_EQ(lastDistance, distances[9]);
+}
+
+}}  // namespace aid::xodr
@@ -0,0 +1,85 @@
+#include "parallel.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace aid { namespace xodr {
+
+TEST(ParallelTest, testParallelFor)
+{
+    for (int numThreads : {1, 3, 8})
+    {
+        const int numTasks = 1000;
+        std::vector<std::atomic<int>> counts(numTasks);
+        for (std::atomic<int>& count : counts)
+        {
+            count = 0;
+        }
+
+        parallelFor(numTasks, numThreads, [&](int taskIdx) {
+            // Make the first tasks expensive, so the other threads steal.
+            volatile double sum = 0;
+            for (int i = 0; i < (taskIdx < 10 ? 100000 : 10); i++)
+            {
+                sum = sum + i;
+            }
+            counts[taskIdx]++;
+        });
+
+        for (int i = 0; i < numTasks; i++)
+        {
+            EXPECT_EQ(counts[i], 1) << "task " << i << ", " << numThreads << " threads";
+        }
+    }
+
+    parallelFor(0, 4, [](int) { FAIL(); });
+}
+
+TEST(ParallelTest, testParallelForException)
+{
+    std::atomic<int> numRun(0);
+    EXPECT_THROW(parallelFor(100, 4,
+                             [&](int taskIdx) {
+                                 numRun++;
+                                 if (taskIdx == 0)
+                                 {
+                                     throw std::runtime_error("task failed");
+                                 }
+                             }),
+                 std::runtime_error);
+    EXPECT_GE(numRun, 1);
+}
+
+TEST(ParallelTest, testNestedAndConcurrentParallelFor)
+{
+    // Tasks which call parallelFor() themselves, from two threads at once,
+    // so the calls compete for the workers of the pool.
+    const int numOuter = 20;
+    const int numInner = 50;
+    std::vector<std::atomic<int>> counts(2 * numOuter * numInner);
+    for (std::atomic<int>& count : counts)
+    {
+        count = 0;
+    }
+
+    auto run = [&](int offset) {
+        parallelFor(numOuter, 4, [&](int outer) {
+            parallelFor(numInner, 4, [&](int inner) { counts[offset + outer * numInner + inner]++; });
+        });
+    };
+
+    std::thread other(run, numOuter * numInner);
+    run(0);
+    other.join();
+
+    for (int i = 0; i < static_cast<int>(counts.size()); i++)
+    {
+        EXPECT_EQ(counts[i], 1) << "task " << i;
+    }
+}
+
+}}  // namespace aid::xodr
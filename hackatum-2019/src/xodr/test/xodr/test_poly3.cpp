@@ -141,6 +141,9 @@ TEST(Poly3Test, testMaxValueInInterval)
     EXPECT_NEAR(testPoly.maxValueInInterval(0, 1), 8.2462, 0.0001);
     EXPECT_NEAR(testPoly.maxValueInInterval(0, 0.5), 8.20388, 0.0001);
     EXPECT_NEAR(testPoly.maxValueInInterval(1, 4), 13.4066, 0.0001);
+
+    // A tiny cubic coefficient matters over long intervals.
+    EXPECT_NEAR(Poly3(0.0, 0.0, 1e-4, -1e-7).maxValueInInterval(0, 1000), 400.0 / 27, 1e-9);
 }
 
 TEST(Poly3Test, testMinValueInInterval)
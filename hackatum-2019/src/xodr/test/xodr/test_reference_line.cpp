@@ -2,6 +2,8 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
 namespace aid { namespace xodr {
 
 class TestFactory
@@ -464,4 +466,49 @@ TEST(ReferenceLineTest, testEvalParamPoly3NormalizedCurvature)
     EXPECT_NEAR(paramPoly3.evalCurvature(25), -0.82875, 0.0001);
 }
 
-}}  // namespace aid::xodr
\ No newline at end of file
+/**
+ * @brief Checks that points at several lateral offsets from a geometry are
+ * projected back onto the s-coordinate they were created from.
+ */
+static void expectProjectionRoundTrip(const ReferenceLine::Geometry& geometry)
+{
+    const double startS = geometry.startVertex().sCoord_;
+    for (double localS = 1; localS < geometry.length(); localS += geometry.length() / 7)
+    {
+        const double s = startS + localS;
+        for (double t : {-3.0, -0.5, 0.0, 2.0})
+        {
+            Eigen::Vector2d pt = geometry.eval(s).pointWithTCoord(t);
+            double initialS = std::min(startS + geometry.length(), s + 0.4);
+            EXPECT_NEAR(geometry.project(pt, startS, startS + geometry.length(), initialS), s, 1e-6)
+                << "s = " << s << ", t = " << t;
+        }
+    }
+
+    // Points beyond the ends of the section project onto its ends.
+    ReferenceLine::PointAndTangentDir start = geometry.eval(startS);
+    EXPECT_NEAR(geometry.project(start.point_ - start.tangentDir_, startS, startS + 2, startS + 1), startS, 1e-6);
+
+    const double endS = startS + geometry.length();
+    ReferenceLine::PointAndTangentDir end = geometry.eval(endS);
+    EXPECT_NEAR(geometry.project(end.point_ + end.tangentDir_, endS - 2, endS, endS - 1), endS, 1e-6);
+}
+
+TEST(ReferenceLineTest, testProject)
+{
+    ReferenceLine::GeometryAttribs geomAttribs;
+    geomAttribs.startVertex_.sCoord_ = 2;
+    geomAttribs.startVertex_.position_ = Eigen::Vector2d(10, 20);
+    geomAttribs.startVertex_.heading_ = 1;
+    geomAttribs.length_ = 40;
+
+    expectProjectionRoundTrip(ReferenceLine::Line(geomAttribs.startVertex_, geomAttribs.length_));
+    expectProjectionRoundTrip(ReferenceLine::Arc(geomAttribs.startVertex_, geomAttribs.length_, 1.0 / 20));
+    expectProjectionRoundTrip(ReferenceLine::Arc(geomAttribs.startVertex_, geomAttribs.length_, -1.0 / 30));
+    expectProjectionRoundTrip(ReferenceLine::Spiral(geomAttribs, 1.0 / 100, 1.0 / 20));
+    expectProjectionRoundTrip(ReferenceLine::Poly3Geom(geomAttribs, Poly3(0, 0.1, 0.002, -0.0001)));
+    expectProjectionRoundTrip(ReferenceLine::ParamPoly3(geomAttribs, Poly3(0, 40, 0, 0), Poly3(0, 0, 8, -2),
+                                                        ReferenceLine::PRange::NORMALIZED));
+}
+
+}}  // namespace aid::xodr
@@ -0,0 +1,119 @@
+#include "road_projection.h"
+
+#include <gtest/gtest.h>
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief Creates a map with one road per geometry type, 100 m apart, each with
+ * two left lanes and one right lane.
+ */
+static XodrMap roadProjectionTestMap()
+{
+    const char* geometries[] = {
+        "<line/>",
+        "<arc curvature='0.02'/>",
+        "<spiral curvStart='-0.01' curvEnd='0.03'/>",
+        "<poly3 a='0' b='0.1' c='0.002' d='-0.0001'/>",
+        "<paramPoly3 aU='0' bU='50' cU='0' dU='0' aV='0' bV='0' cV='8' dV='-2' pRange='normalized'/>",
+    };
+
+    std::string text = "<OpenDRIVE><header/>";
+    for (int i = 0; i < 5; i++)
+    {
+        text += "<road name='' length='50' id='" + std::to_string(i + 1) + "' junction='-1'>"
+                "  <planView>"
+                "    <geometry s='0' x='1000' y='" + std::to_string(100 * i) + "' hdg='0.5' length='50'>" +
+                geometries[i] +
+                "    </geometry>"
+                "  </planView>"
+                "  <lanes>"
+                "    <laneSection s='0'>"
+                "      <left>"
+                "        <lane id='2' type='sidewalk' level='false'>"
+                "          <width sOffset='0' a='2' b='0' c='0' d='0'/>"
+                "        </lane>"
+                "        <lane id='1' type='driving' level='false'>"
+                "          <width sOffset='0' a='3' b='0.02' c='0' d='0'/>"
+                "        </lane>"
+                "      </left>"
+                "      <center/>"
+                "      <right>"
+                "        <lane id='-1' type='driving' level='false'>"
+                "          <width sOffset='0' a='3.5' b='0' c='0' d='0'/>"
+                "        </lane>"
+                "      </right>"
+                "    </laneSection>"
+                "  </lanes>"
+                "</road>";
+    }
+    text += "</OpenDRIVE>";
+
+    XodrReader xml = XodrReader::fromText(text);
+    xml.readStartElement("OpenDRIVE");
+    return std::move(XodrMap::parseXml(xml).value());
+}
+
+TEST(RoadProjectionTest, testProject)
+{
+    XodrMap xodrMap = roadProjectionTestMap();
+    SpatialIndex index(xodrMap);
+    RoadProjector projector(index);
+
+    for (int roadIdx = 0; roadIdx < 5; roadIdx++)
+    {
+        const Road& road = xodrMap.roads()[roadIdx];
+        for (double s = 0.5; s < road.length(); s += 3.7)
+        {
+            const double leftLaneWidth = 3 + 0.02 * s;
+
+            // The center of each lane, and a point beyond the right-most lane.
+            const double tCoords[] = {leftLaneWidth + 1, leftLaneWidth / 2, -1.75, -4.5};
+            const int laneIndices[] = {0, 1, 2, 2};
+            for (int i = 0; i < 4; i++)
+            {
+                Eigen::Vector2d pt = road.referenceLine().eval(s).pointWithTCoord(tCoords[i]);
+                RoadPosition position = projector.project(pt);
+
+                ASSERT_TRUE(position.valid());
+                EXPECT_EQ(position.lane_, LaneKey(roadIdx, 0, laneIndices[i])) << "road " << roadIdx << ", s " << s;
+                EXPECT_NEAR(position.sCoord_, s, 1e-6);
+                EXPECT_NEAR(position.tCoord_, tCoords[i], 1e-6);
+                EXPECT_NEAR(position.distance_, i == 3 ? 1 : 0, 1e-6);
+            }
+        }
+    }
+
+    EXPECT_FALSE(projector.project(Eigen::Vector2d(0, 0)).valid());
+    EXPECT_TRUE(projector.project(Eigen::Vector2d(0, 0), 2000).valid());
+}
+
+TEST(RoadProjectionTest, testProjectBatch)
+{
+    XodrMap xodrMap = roadProjectionTestMap();
+    SpatialIndex index(xodrMap);
+    RoadProjector projector(index);
+
+    std::vector<Eigen::Vector2d> pts;
+    for (int i = 0; i < 1000; i++)
+    {
+        pts.push_back(Eigen::Vector2d(980 + (i % 40) * 1.5, -20 + (i / 40) * 20.0));
+    }
+
+    std::vector<RoadPosition> positions = projector.projectBatch(pts, RoadProjector::DEFAULT_MAX_DISTANCE, 4);
+    ASSERT_EQ(positions.size(), pts.size());
+
+    int numValid = 0;
+    for (int i = 0; i < static_cast<int>(pts.size()); i++)
+    {
+        RoadPosition expected = projector.project(pts[i]);
+        EXPECT_EQ(positions[i].lane_, expected.lane_);
+        EXPECT_EQ(positions[i].sCoord_, expected.sCoord_);
+        EXPECT_EQ(positions[i].tCoord_, expected.tCoord_);
+        numValid += positions[i].valid();
+    }
+    EXPECT_GT(numValid, 0);
+    EXPECT_LT(numValid, static_cast<int>(pts.size()));
+}
+
+}}  // namespace aid::xodr
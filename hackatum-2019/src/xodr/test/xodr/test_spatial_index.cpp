@@ -0,0 +1,117 @@
+#include "spatial_index.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "../test_config.h"
+
+namespace aid { namespace xodr {
+
+static XodrMap spatialIndexTestMap()
+{
+    XodrReader xml =
+        XodrReader::fromFile(std::string(TEST_DATA_PATH_PREFIX) + "xodr/test_for_each_roadlink/junction_links.xodr");
+    xml.readStartElement("OpenDRIVE");
+    return std::move(XodrMap::parseXml(xml).value());
+}
+
+/**
+ * @brief Computes the distance of a point to the tessellated reference line
+ * of a road, by brute force.
+ */
+static double refLineDistance(const MapTessellation& tessellation, int roadIdx, const Eigen::Vector2d& pt)
+{
+    double ret = std::numeric_limits<double>::infinity();
+    for (int i = tessellation.roadOffsets_[roadIdx]; i < tessellation.roadOffsets_[roadIdx + 1]; i++)
+    {
+        const MapTessellation::LaneSectionRange& range = tessellation.laneSections_[i];
+        for (int j = range.refLineBegin_; j + 1 < range.refLineEnd_; j++)
+        {
+            Eigen::Vector2d a = tessellation.refLineVertex(range, j);
+            Eigen::Vector2d ab = tessellation.refLineVertex(range, j + 1) - a;
+            double t = std::min(1.0, std::max(0.0, (pt - a).dot(ab) / ab.squaredNorm()));
+            ret = std::min(ret, (a + t * ab - pt).norm());
+        }
+    }
+    return ret;
+}
+
+TEST(SpatialIndexTest, testNearestRoads)
+{
+    XodrMap xodrMap = spatialIndexTestMap();
+    SpatialIndex index(xodrMap);
+    const MapTessellation& tessellation = index.tessellation();
+    const Eigen::AlignedBox2d bounds = index.bounds();
+
+    for (int i = 0; i < 20; i++)
+    {
+        Eigen::Vector2d pt = bounds.min() + (bounds.max() - bounds.min()).cwiseProduct(
+                                                Eigen::Vector2d((i % 5 + 0.5) / 5, (i / 5 + 0.5) / 4));
+
+        std::vector<SpatialIndex::RoadDistance> expected;
+        for (int roadIdx = 0; roadIdx < static_cast<int>(xodrMap.roads().size()); roadIdx++)
+        {
+            expected.push_back({roadIdx, refLineDistance(tessellation, roadIdx, pt)});
+        }
+        std::sort(expected.begin(), expected.end(),
+                  [](const SpatialIndex::RoadDistance& a, const SpatialIndex::RoadDistance& b) {
+                      return a.distance_ < b.distance_;
+                  });
+
+        std::vector<SpatialIndex::RoadDistance> nearest = index.nearestRoads(pt, 3);
+        ASSERT_EQ(nearest.size(), 3u);
+        for (int k = 0; k < 3; k++)
+        {
+            EXPECT_NEAR(nearest[k].distance_, expected[k].distance_, 1e-9);
+            EXPECT_NEAR(refLineDistance(tessellation, nearest[k].roadIdx_, pt), nearest[k].distance_, 1e-9);
+        }
+    }
+}
+
+TEST(SpatialIndexTest, testRoadsIntersecting)
+{
+    XodrMap xodrMap = spatialIndexTestMap();
+    SpatialIndex index(xodrMap);
+
+    EXPECT_EQ(index.roadsIntersecting(index.bounds()).size(), xodrMap.roads().size());
+
+    Eigen::AlignedBox2d outside(index.bounds().max() + Eigen::Vector2d(1, 1),
+                                index.bounds().max() + Eigen::Vector2d(2, 2));
+    EXPECT_TRUE(index.roadsIntersecting(outside).empty());
+
+    // A small box around a vertex in the middle of each road finds that road.
+    const MapTessellation& tessellation = index.tessellation();
+    for (int roadIdx = 0; roadIdx < static_cast<int>(xodrMap.roads().size()); roadIdx++)
+    {
+        const MapTessellation::LaneSectionRange& range = tessellation.laneSections_[tessellation.roadOffsets_[roadIdx]];
+        Eigen::Vector2d pt = tessellation.refLineVertex(range, (range.refLineBegin_ + range.refLineEnd_) / 2);
+        std::vector<int> roads = index.roadsIntersecting(Eigen::AlignedBox2d(pt, pt));
+        EXPECT_TRUE(std::find(roads.begin(), roads.end(), roadIdx) != roads.end());
+    }
+}
+
+TEST(SpatialIndexTest, testLaneSectionsWithinRadius)
+{
+    XodrMap xodrMap = spatialIndexTestMap();
+    SpatialIndex index(xodrMap);
+    const MapTessellation& tessellation = index.tessellation();
+
+    for (const MapTessellation::LaneSectionRange& range : tessellation.laneSections_)
+    {
+        // A point on a lane boundary in the middle of the lane section lies
+        // within any radius.
+        const int j = (range.refLineEnd_ - range.refLineBegin_) / 2;
+        Eigen::Vector2d pt =
+            tessellation.boundaryVertex(range, tessellation.boundaryOffsets_[range.boundaryBegin_] + j);
+        std::vector<LaneSectionKey> found = index.laneSectionsWithinRadius(pt, 0.01);
+        EXPECT_TRUE(std::find(found.begin(), found.end(), range.key_) != found.end());
+    }
+
+    Eigen::Vector2d farAway = index.bounds().max() + Eigen::Vector2d(100, 100);
+    EXPECT_TRUE(index.laneSectionsWithinRadius(farAway, 10).empty());
+    EXPECT_EQ(index.laneSectionsWithinRadius(farAway, 1e6).size(), tessellation.laneSections_.size());
+}
+
+}}  // namespace aid::xodr
@@ -0,0 +1,130 @@
+#include "tessellation_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+namespace aid { namespace xodr {
+
+static XodrMap tessellationCacheTestMap()
+{
+    XodrReader xml = XodrReader::fromText(
+        "<OpenDRIVE>"
+        "  <header/>"
+        "  <road name='road' length='40' id='1' junction='-1'>"
+        "    <planView>"
+        "      <geometry s='0' x='0' y='0' hdg='0' length='40'>"
+        "        <line/>"
+        "      </geometry>"
+        "    </planView>"
+        "    <lanes>"
+        "      <laneSection s='0'>"
+        "        <left>"
+        "          <lane id='1' type='driving' level='false'>"
+        "            <width sOffset='0' a='4' b='0' c='0' d='0'/>"
+        "          </lane>"
+        "        </left>"
+        "        <center/>"
+        "      </laneSection>"
+        "      <laneSection s='20'>"
+        "        <left>"
+        "          <lane id='1' type='driving' level='false'>"
+        "            <width sOffset='0' a='3' b='0' c='0' d='0'/>"
+        "          </lane>"
+        "        </left>"
+        "        <center/>"
+        "      </laneSection>"
+        "    </lanes>"
+        "  </road>"
+        "</OpenDRIVE>");
+
+    xml.readStartElement("OpenDRIVE");
+    return std::move(XodrMap::parseXml(xml).value());
+}
+
+TEST(TessellationCacheTest, testGet)
+{
+    XodrMap xodrMap = tessellationCacheTestMap();
+    TessellationCache cache(xodrMap);
+
+    auto tessellation = cache.get(LaneSectionKey(0, 1));
+    ASSERT_EQ(tessellation->boundaries_.size(), 2u);
+    ASSERT_EQ(tessellation->referenceLine_.size(), 21u);
+    EXPECT_DOUBLE_EQ(tessellation->referenceLine_.front().sCoord_, 20);
+    EXPECT_TRUE(tessellation->boundaries_[0].vertices_.front().isApprox(Eigen::Vector2d(20, 3)));
+
+    EXPECT_EQ(cache.get(LaneSectionKey(0, 1)), tessellation);
+    EXPECT_NE(cache.get(LaneSectionKey(0, 0)), tessellation);
+    EXPECT_EQ(cache.numHits(), 1);
+    EXPECT_EQ(cache.numMisses(), 2);
+    EXPECT_EQ(cache.numEntries(), 2);
+    EXPECT_GT(cache.memoryUsage(), 0u);
+}
+
+TEST(TessellationCacheTest, testSettings)
+{
+    XodrMap xodrMap = tessellationCacheTestMap();
+    TessellationCache cache(xodrMap);
+
+    TessellationSettings fine;
+    fine.verticesPerMeter_ = 4;
+
+    auto coarseTessellation = cache.get(LaneSectionKey(0, 0));
+    auto fineTessellation = cache.get(LaneSectionKey(0, 0), fine);
+
+    EXPECT_NE(coarseTessellation, fineTessellation);
+    EXPECT_EQ(coarseTessellation->referenceLine_.size(), 21u);
+    EXPECT_EQ(fineTessellation->referenceLine_.size(), 81u);
+    EXPECT_EQ(cache.get(LaneSectionKey(0, 0), fine), fineTessellation);
+}
+
+TEST(TessellationCacheTest, testEviction)
+{
+    XodrMap xodrMap = tessellationCacheTestMap();
+
+    size_t sectionMemoryUsage = tessellateLaneSection(xodrMap.roads()[0], xodrMap.roads()[0].laneSections()[0])
+                                    .memoryUsage();
+    TessellationCache cache(xodrMap, sectionMemoryUsage + sectionMemoryUsage / 2);
+
+    auto first = cache.get(LaneSectionKey(0, 0));
+    cache.get(LaneSectionKey(0, 1));
+
+    // The first tessellation is evicted, but stays valid.
+    EXPECT_EQ(cache.numEntries(), 1);
+    EXPECT_LE(cache.memoryUsage(), cache.memoryBudget());
+    EXPECT_EQ(first->referenceLine_.size(), 21u);
+
+    EXPECT_NE(cache.get(LaneSectionKey(0, 0)), first);
+    EXPECT_EQ(cache.numMisses(), 3);
+
+    cache.clear();
+    EXPECT_EQ(cache.numEntries(), 0);
+    EXPECT_EQ(cache.memoryUsage(), 0u);
+}
+
+TEST(TessellationCacheTest, testConcurrentGet)
+{
+    XodrMap xodrMap = tessellationCacheTestMap();
+    TessellationCache cache(xodrMap);
+
+    const int numThreads = 4;
+    std::vector<std::shared_ptr<const LaneSectionTessellation>> results(numThreads);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < numThreads; i++)
+    {
+        threads.emplace_back([&cache, &results, i]() { results[i] = cache.get(LaneSectionKey(0, i % 2)); });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (int i = 0; i < numThreads; i++)
+    {
+        EXPECT_EQ(results[i], results[i % 2]);
+    }
+    EXPECT_EQ(cache.numMisses(), 2);
+    EXPECT_EQ(cache.numHits(), numThreads - 2);
+}
+
+}}  // namespace aid::xodr
@@ -1,5 +1,6 @@
-#include "xodr/elevation.h"
-#include "xodr_validation/elevation_validation.h"
+#include "elevation.h"
+#include "validation/elevation_validation.h"
+#include "xodr_map.h"
 
 #include <gtest/gtest.h>
 
@@ -359,4 +360,49 @@ TEST(ElevationTest, testValidateMaxSlope_ConstantSlope_TooHigh)
     EXPECT_EQ(errors.size(), 0);
 }
 
+/**
+ * @brief Creates a straight road of length 40 with the given link and
+ * elevation profile.
+ */
+static std::string roadWithElevation(const std::string& id, double x, const std::string& link,
+                                     const std::string& elevations)
+{
+    return "<road name='' length='40' id='" + id + "' junction='-1'><link>" + link + "</link>" +
+           "<planView><geometry s='0' x='" + std::to_string(x) + "' y='0' hdg='0' length='40'><line/></geometry>" +
+           "</planView><elevationProfile>" + elevations + "</elevationProfile>" +
+           "<lanes><laneSection s='0'><center/><right><lane id='-1' type='driving' level='false'>" +
+           "<width sOffset='0' a='3' b='0' c='0' d='0'/></lane></right></laneSection></lanes></road>";
+}
+
+TEST(ElevationTest, testValidateContinuity)
+{
+    // Road 1 climbs with slope 0.1, and its segments meet at s = 20. Road 2
+    // continues with the same slope, but starts 1 m too high.
+    const std::string road1 =
+        roadWithElevation("1", 0, "<successor elementType='road' elementId='2' contactPoint='start'/>",
+                          "<elevation s='0' a='0' b='0.1' c='0' d='0'/><elevation s='20' a='2' b='0.1' c='0' d='0'/>");
+    const std::string road2 = roadWithElevation("2", 40,
+                                                "<predecessor elementType='road' elementId='1' contactPoint='end'/>",
+                                                "<elevation s='0' a='5' b='0.1' c='0' d='0'/>");
+    XodrMap xodrMap = XodrMap::fromText("<OpenDRIVE><header/>" + road1 + road2 + "</OpenDRIVE>").extract_value();
+
+    std::vector<ElevationProfileMaxSlopeExceeded> slopeErrors;
+    std::vector<ElevationDiscontinuity> discontinuities;
+    EXPECT_FALSE(validateElevation(xodrMap, 0.2, 0.01, 0.01, slopeErrors, discontinuities));
+    EXPECT_EQ(slopeErrors.size(), 0);
+    ASSERT_EQ(discontinuities.size(), 1);
+    EXPECT_EQ(discontinuities[0].aRoadIndex_, xodrMap.roadIndexById("1"));
+    EXPECT_EQ(discontinuities[0].aSCoord_, 40);
+    EXPECT_EQ(discontinuities[0].bRoadIndex_, xodrMap.roadIndexById("2"));
+    EXPECT_EQ(discontinuities[0].bSCoord_, 0);
+    EXPECT_NEAR(discontinuities[0].elevationJump_, 1, 1e-9);
+    EXPECT_NEAR(discontinuities[0].slopeJump_, 0, 1e-9);
+
+    // A maximum slope of 0.05 is exceeded on both roads.
+    slopeErrors.clear();
+    discontinuities.clear();
+    EXPECT_FALSE(validateElevation(xodrMap, 0.05, 0.01, 0.01, slopeErrors, discontinuities));
+    EXPECT_EQ(slopeErrors.size(), 3);
+}
+
 }}  // namespace aid::xodr
\ No newline at end of file
@@ -1,8 +1,8 @@
-#include "xodr_validation/geometric_adjacency_validation.h"
+#include "validation/geometric_adjacency_validation.h"
 
 #include <gtest/gtest.h>
 
-#include "xodr/xodr_map.h"
+#include "xodr_map.h"
 #include "../test_config.h"
 
 namespace aid { namespace xodr {
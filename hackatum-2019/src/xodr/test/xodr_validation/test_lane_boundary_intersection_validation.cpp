@@ -1,11 +1,38 @@
 #include <gtest/gtest.h>
-#include "xodr_validation/lane_boundary_intersection_validation.h"
-#include "xodr/xodr_map.h"
+#include "validation/lane_boundary_intersection_validation.h"
+#include "xodr_map.h"
 
 #include "../test_config.h"
 
 namespace aid { namespace xodr {
 
+/**
+ * @brief Creates a straight road with one lane on each side.
+ */
+static std::string straightRoad(const std::string& id, double x, double y, double hdg, const std::string& junction,
+                                double rightLaneWidthSlope = 0)
+{
+    std::ostringstream text;
+    text.precision(17);
+    text << "<road name='' length='40' id='" << id << "' junction='" << junction << "'>"
+         << "<planView><geometry s='0' x='" << x << "' y='" << y << "' hdg='" << hdg << "' length='40'>"
+         << "<line/></geometry></planView>"
+         << "<lanes><laneSection s='0'>"
+         << "<left><lane id='1' type='driving' level='false'><width sOffset='0' a='3' b='0' c='0' d='0'/></lane>"
+         << "</left><center/>"
+         << "<right><lane id='-1' type='driving' level='false'>"
+         << "<width sOffset='0' a='3' b='" << rightLaneWidthSlope << "' c='0' d='0'/></lane></right>"
+         << "</laneSection></lanes></road>";
+    return text.str();
+}
+
+static XodrMap parseMap(const std::string& content)
+{
+    XodrReader xml = XodrReader::fromText("<OpenDRIVE><header/>" + content + "</OpenDRIVE>");
+    xml.readStartElement("OpenDRIVE");
+    return std::move(XodrMap::parseXml(xml).value());
+}
+
 bool intersectingGeometryViolationEquals(const IntersectingGeometryViolation& a, const IntersectingGeometryViolation& b)
 {
     if (a.laneKeyA_ == b.laneKeyA_)
@@ -21,7 +48,8 @@ bool intersectingGeometryViolationEquals(const IntersectingGeometryViolation& a,
     return false;
 }
 
-TEST(LaneBoundaryIntersectionValidationTest, testValidateRoundabout)
+// The map of this test isn't part of the test data.
+TEST(LaneBoundaryIntersectionValidationTest, DISABLED_testValidateRoundabout)
 {
     XodrMap xodrMap =
         XodrMap::fromFile(std::string(TEST_DATA_PATH_PREFIX) + "xodr/roundabout_1lane_houses_v1.xodr").extract_value();
@@ -98,4 +126,100 @@ TEST(LaneBoundaryIntersectionValidationTest, testValidateRoundabout)
     }
 }
 
+TEST(LaneBoundaryIntersectionValidationTest, testCrossingRoads)
+{
+    XodrMap xodrMap = parseMap(straightRoad("a", 0, 0, 0, "-1") + straightRoad("b", 20.25, -20.5, M_PI / 2, "-1"));
+
+    std::vector<IntersectingGeometryViolation> errors;
+    EXPECT_FALSE(validateBoundaryIntersections(xodrMap, 0.1, errors));
+
+    // All three boundaries of one road cross all three of the other.
+    ASSERT_EQ(errors.size(), 9);
+    for (const IntersectingGeometryViolation& error : errors)
+    {
+        EXPECT_EQ(error.laneKeyA_.roadIdx_, 0);
+        EXPECT_EQ(error.laneKeyB_.roadIdx_, 1);
+        EXPECT_NEAR(error.sCoordA_, 20.25, 3 + 1e-9);
+        EXPECT_NEAR(error.sCoordB_, 20.5, 3 + 1e-9);
+        EXPECT_NEAR(error.position_.x(), error.sCoordA_, 1e-9);
+        EXPECT_NEAR(error.position_.y(), error.sCoordB_ - 20.5, 1e-9);
+    }
+    EXPECT_EQ(errors[0].description(xodrMap),
+              "The boundary of lane 1 of [road: 'a', lane section: 0] at s = 17.25 intersects the boundary of "
+              "lane 1 of [road: 'b', lane section: 0] at s = 23.5, at (17.25, 3).");
+
+    std::vector<IntersectingGeometryViolation> parallelErrors;
+    EXPECT_FALSE(validateBoundaryIntersections(xodrMap, 0.1, parallelErrors, 4));
+    ASSERT_EQ(parallelErrors.size(), errors.size());
+    for (int i = 0; i < static_cast<int>(errors.size()); i++)
+    {
+        EXPECT_EQ(parallelErrors[i].description(xodrMap), errors[i].description(xodrMap));
+    }
+}
+
+TEST(LaneBoundaryIntersectionValidationTest, testJunctionRoads)
+{
+    XodrMap xodrMap = parseMap(straightRoad("a", 0, 0, 0, "j") + straightRoad("b", 20, -20, M_PI / 2, "j") +
+                               "<junction name='' id='j'>"
+                               "  <connection id='0' incomingRoad='a' connectingRoad='b' contactPoint='start'/>"
+                               "  <connection id='1' incomingRoad='b' connectingRoad='a' contactPoint='start'/>"
+                               "</junction>");
+
+    // The connecting roads of a junction may cross each other.
+    std::vector<IntersectingGeometryViolation> errors;
+    EXPECT_TRUE(validateBoundaryIntersections(xodrMap, 0.1, errors));
+    EXPECT_EQ(errors.size(), 0);
+}
+
+TEST(LaneBoundaryIntersectionValidationTest, testJunctionRoadNegativeLaneWidth)
+{
+    // The width of the right lane of connecting road a becomes negative at
+    // s = 12.5, which is reported although road b crosses it in the junction.
+    XodrMap xodrMap = parseMap(straightRoad("a", 0, 0, 0, "j", -0.24) + straightRoad("b", 20, -20, M_PI / 2, "j") +
+                               "<junction name='' id='j'>"
+                               "  <connection id='0' incomingRoad='a' connectingRoad='b' contactPoint='start'/>"
+                               "  <connection id='1' incomingRoad='b' connectingRoad='a' contactPoint='start'/>"
+                               "</junction>");
+
+    std::vector<IntersectingGeometryViolation> errors;
+    EXPECT_FALSE(validateBoundaryIntersections(xodrMap, 0.1, errors));
+    ASSERT_EQ(errors.size(), 1);
+    EXPECT_EQ(errors[0].laneKeyA_, LaneKey(0, 0, 1));
+    EXPECT_EQ(errors[0].laneKeyB_, LaneKey(0, 0, 1));
+    EXPECT_NEAR(errors[0].sCoordA_, 12.5, 1e-9);
+}
+
+TEST(LaneBoundaryIntersectionValidationTest, testTolerance)
+{
+    // Road b starts on the reference line of road a.
+    XodrMap xodrMap = parseMap(straightRoad("a", 0, 0, 0, "-1") + straightRoad("b", 20.25, 0, M_PI / 2, "-1"));
+
+    std::vector<IntersectingGeometryViolation> errors;
+    EXPECT_FALSE(validateBoundaryIntersections(xodrMap, 0.1, errors));
+    ASSERT_EQ(errors.size(), 3);
+    for (const IntersectingGeometryViolation& error : errors)
+    {
+        EXPECT_EQ(error.laneKeyA_, LaneKey(0, 0, 0));
+        EXPECT_NEAR(error.sCoordB_, 3, 1e-9);
+    }
+
+    errors.clear();
+    EXPECT_TRUE(validateBoundaryIntersections(xodrMap, 3.5, errors));
+    EXPECT_EQ(errors.size(), 0);
+}
+
+TEST(LaneBoundaryIntersectionValidationTest, testNegativeLaneWidth)
+{
+    // The width of the right lane becomes negative at s = 12.5.
+    XodrMap xodrMap = parseMap(straightRoad("a", 0, 0, 0, "-1", -0.24));
+
+    std::vector<IntersectingGeometryViolation> errors;
+    EXPECT_FALSE(validateBoundaryIntersections(xodrMap, 0.1, errors));
+    ASSERT_EQ(errors.size(), 1);
+    EXPECT_EQ(errors[0].laneKeyA_, LaneKey(0, 0, 1));
+    EXPECT_EQ(errors[0].laneKeyB_, LaneKey(0, 0, 1));
+    EXPECT_NEAR(errors[0].sCoordA_, 12.5, 1e-9);
+    EXPECT_NEAR(errors[0].sCoordB_, 12.5, 1e-9);
+}
+
 }}  // namespace aid::xodr
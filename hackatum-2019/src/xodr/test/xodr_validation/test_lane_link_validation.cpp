@@ -2,7 +2,7 @@
 
 #include "validation/road_link_validation.h"
 #include "validation/lane_link_validation.h"
-#include "xodr/xodr_map.h"
+#include "xodr_map.h"
 #include "../test_config.h"
 
 namespace aid { namespace xodr {
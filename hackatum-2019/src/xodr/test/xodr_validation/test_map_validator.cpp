@@ -0,0 +1,288 @@
+#include <gtest/gtest.h>
+
+#include "validation/elevation_validation.h"
+#include "validation/geometric_adjacency_validation.h"
+#include "validation/lane_boundary_intersection_validation.h"
+#include "validation/map_validator.h"
+#include "validation/road_link_validation.h"
+#include "validation/road_width_validation.h"
+#include "xodr_map.h"
+#include "xodr_utils.h"
+
+#include "../test_config.h"
+
+namespace aid { namespace xodr {
+
+static const std::string VALIDATE_LINKS_XODR_PATH =
+    std::string(TEST_DATA_PATH_PREFIX) + "xodr/test_link_validation/validate_links.xodr";
+static const std::string VALIDATE_LINKS_JUNCTION_XODR_PATH =
+    std::string(TEST_DATA_PATH_PREFIX) + "xodr/test_link_validation/validate_links_junction.xodr";
+
+TEST(MapValidatorTest, testStructuralSuccess)
+{
+    XodrMap map = XodrMap::fromFile(VALIDATE_LINKS_JUNCTION_XODR_PATH).extract_value();
+
+    const ValidationReport report = MapValidator::structural().run(map);
+    EXPECT_TRUE(report.success());
+    ASSERT_EQ(report.validators_.size(), 3);
+
+    const int numRoads = static_cast<int>(map.roads().size());
+    const int numJunctions = static_cast<int>(map.junctions().size());
+    EXPECT_EQ(report.validators_[0].name_, "lane sections");
+    EXPECT_EQ(report.validators_[0].numItems_, numRoads);
+    EXPECT_EQ(report.validators_[1].name_, "junction membership");
+    EXPECT_EQ(report.validators_[1].numItems_, numRoads + numJunctions);
+    EXPECT_EQ(report.validators_[2].name_, "links");
+    EXPECT_EQ(report.validators_[2].numItems_, numRoads);
+    for (const ValidationReport::ValidatorStats& stats : report.validators_)
+    {
+        EXPECT_EQ(stats.numErrors_, 0);
+        EXPECT_GE(stats.seconds_, 0);
+    }
+
+    EXPECT_NO_THROW(map.validate());
+}
+
+TEST(MapValidatorTest, testStructuralFailure)
+{
+    XodrMap map = XodrMap::fromFile(VALIDATE_LINKS_XODR_PATH).extract_value();
+    map.test_roadById("2")->test_setPredecessor(RoadLink());
+
+    // The report contains the same errors as the link validator.
+    std::vector<std::unique_ptr<LinkValidationError>> linkErrors;
+    validateLinks(map, linkErrors);
+    ASSERT_EQ(linkErrors.size(), 1);
+
+    const ValidationReport report = MapValidator::structural().run(map);
+    EXPECT_FALSE(report.success());
+    ASSERT_EQ(report.errors_.size(), 1);
+    EXPECT_EQ(report.errors_[0].validatorIdx_, 2);
+    EXPECT_EQ(report.errors_[0].message_, linkErrors[0]->description(map));
+    EXPECT_EQ(report.validators_[2].numErrors_, 1);
+
+    // The exception of XodrMap::validate() contains the exact message.
+    try
+    {
+        map.validate();
+        FAIL() << "XodrMap::validate() should throw.";
+    }
+    catch (const std::runtime_error& e)
+    {
+        EXPECT_NE(std::string(e.what()).find(linkErrors[0]->description(map)), std::string::npos);
+    }
+}
+
+TEST(MapValidatorTest, testCustomValidatorsAndThreads)
+{
+    XodrMap map = XodrMap::fromFile(VALIDATE_LINKS_JUNCTION_XODR_PATH).extract_value();
+
+    MapValidator validator = MapValidator::structural();
+
+    // A validator which visits everything and reports an error for each item.
+    MapValidator::Validator everything;
+    everything.name_ = "everything";
+    everything.roadVisitor_ = [](const XodrMap& map, int roadIdx, std::vector<std::string>& errors) {
+        errors.push_back("road " + map.roads()[roadIdx].id());
+    };
+    everything.linkVisitor_ = [](const XodrMap& map, RoadContactPointKey aKey, RoadContactPointKey bKey,
+                                 const Junction::Connection* connection, std::vector<std::string>& errors) {
+        errors.push_back("link " + map.roads()[aKey.roadIdx_].id() + " " + map.roads()[bKey.roadIdx_].id() +
+                         (connection ? " junction" : ""));
+    };
+    everything.junctionVisitor_ = [](const XodrMap& map, int junctionIdx, std::vector<std::string>& errors) {
+        errors.push_back("junction " + map.junctions()[junctionIdx].id());
+    };
+    validator.addValidator(everything);
+
+    // The elevation link validator, which doesn't report anything since the
+    // roads have no elevation profiles.
+    MapValidator::Validator elevation;
+    elevation.name_ = "elevation";
+    elevation.linkVisitor_ = [](const XodrMap& map, RoadContactPointKey aKey, RoadContactPointKey bKey,
+                                const Junction::Connection*, std::vector<std::string>& errors) {
+        std::vector<ElevationDiscontinuity> discontinuities;
+        validateElevationLink(map, aKey, bKey, 0.01, 0.01, discontinuities);
+        for (const ElevationDiscontinuity& discontinuity : discontinuities)
+        {
+            errors.push_back(discontinuity.description(map));
+        }
+    };
+    validator.addValidator(elevation);
+
+    int numLinks = 0;
+    forEachRoadLink(map, [&](RoadContactPointKey, RoadContactPointKey) { numLinks++; });
+    ASSERT_GT(numLinks, 0);
+
+    const ValidationReport serial = validator.run(map, 1);
+    const int numRoads = static_cast<int>(map.roads().size());
+    const int numJunctions = static_cast<int>(map.junctions().size());
+    const int numItems = numRoads + numLinks + numJunctions;
+    ASSERT_EQ(serial.validators_.size(), 5);
+    EXPECT_EQ(serial.validators_[3].numItems_, numItems);
+    EXPECT_EQ(serial.validators_[3].numErrors_, numItems);
+    EXPECT_EQ(serial.validators_[4].numItems_, numLinks);
+    EXPECT_EQ(serial.validators_[4].numErrors_, 0);
+    ASSERT_EQ(static_cast<int>(serial.errors_.size()), numItems);
+    EXPECT_EQ(serial.errors_.front().message_, "road " + map.roads().front().id());
+    EXPECT_EQ(serial.errors_.back().message_, "junction " + map.junctions().back().id());
+
+    const ValidationReport parallel = validator.run(map, 4);
+    ASSERT_EQ(parallel.errors_.size(), serial.errors_.size());
+    for (int i = 0; i < static_cast<int>(serial.errors_.size()); i++)
+    {
+        EXPECT_EQ(parallel.errors_[i].validatorIdx_, serial.errors_[i].validatorIdx_);
+        EXPECT_EQ(parallel.errors_[i].message_, serial.errors_[i].message_);
+    }
+
+    EXPECT_NE(serial.statsSummary().find("everything"), std::string::npos);
+}
+
+TEST(MapValidatorTest, testFull)
+{
+    XodrReader xml = XodrReader::fromFile(std::string(TEST_DATA_PATH_PREFIX) +
+                                          "xodr/test_geometric_adjacency_validation/simple_failure.xodr");
+    xml.readStartElement("OpenDRIVE");
+    XodrMap map = std::move(XodrMap::parseXml(xml).value());
+
+    const GeometricValidationParams params;
+    const MapValidator validator = MapValidator::full(params);
+    const ValidationReport serial = validator.run(map, 1);
+    ASSERT_EQ(serial.validators_.size(), 7);
+    EXPECT_EQ(serial.validators_[3].name_, "boundary intersections");
+    EXPECT_EQ(serial.validators_[3].numItems_, 1);
+    EXPECT_EQ(serial.validators_[4].name_, "road width");
+    EXPECT_EQ(serial.validators_[5].name_, "geometric adjacency");
+    EXPECT_EQ(serial.validators_[6].name_, "elevation");
+
+    // Each adapter reports the same errors as its validator.
+    std::vector<IntersectingGeometryViolation> intersections;
+    validateBoundaryIntersections(map, params.boundaryIntersectionTolerance_, intersections);
+    EXPECT_EQ(serial.validators_[3].numErrors_, static_cast<int>(intersections.size()));
+
+    std::vector<RoadTooWideViolation> tooWide;
+    validateRoadWidths(map, params.roadWidthResolution_, tooWide);
+    std::vector<NegativeLaneWidthViolation> negativeWidths;
+    validateLaneWidths(map, negativeWidths);
+    EXPECT_EQ(serial.validators_[4].numErrors_, static_cast<int>(tooWide.size() + negativeWidths.size()));
+
+    std::vector<GeometricAdjacencyError> adjacencyErrors;
+    validateGeometricAdjacency(map, params.adjacencyTolerance_, adjacencyErrors);
+    ASSERT_EQ(adjacencyErrors.size(), 1);
+    EXPECT_EQ(serial.validators_[5].numErrors_, 1);
+
+    std::vector<ElevationProfileMaxSlopeExceeded> slopeErrors;
+    std::vector<ElevationDiscontinuity> discontinuities;
+    validateElevation(map, params.maxSlope_, params.elevationTolerance_, params.slopeTolerance_, slopeErrors,
+                      discontinuities);
+    EXPECT_EQ(serial.validators_[6].numErrors_, static_cast<int>(slopeErrors.size() + discontinuities.size()));
+
+    bool found = false;
+    for (const ValidationReport::Error& error : serial.errors_)
+    {
+        found |= error.validatorIdx_ == 5 && error.message_ == adjacencyErrors[0].description(map);
+    }
+    EXPECT_TRUE(found);
+
+    const ValidationReport parallel = validator.run(map, 4);
+    ASSERT_EQ(parallel.errors_.size(), serial.errors_.size());
+    for (int i = 0; i < static_cast<int>(serial.errors_.size()); i++)
+    {
+        EXPECT_EQ(parallel.errors_[i].validatorIdx_, serial.errors_[i].validatorIdx_);
+        EXPECT_EQ(parallel.errors_[i].message_, serial.errors_[i].message_);
+    }
+}
+
+/**
+ * @brief Expects that two reports contain the same errors, in the same order.
+ */
+static void expectSameErrors(const ValidationReport& a, const ValidationReport& b)
+{
+    ASSERT_EQ(a.errors_.size(), b.errors_.size());
+    for (int i = 0; i < static_cast<int>(a.errors_.size()); i++)
+    {
+        EXPECT_EQ(a.errors_[i].validatorIdx_, b.errors_[i].validatorIdx_);
+        EXPECT_EQ(a.errors_[i].message_, b.errors_[i].message_);
+    }
+
+    ASSERT_EQ(a.validators_.size(), b.validators_.size());
+    for (int i = 0; i < static_cast<int>(a.validators_.size()); i++)
+    {
+        EXPECT_EQ(a.validators_[i].numErrors_, b.validators_[i].numErrors_);
+    }
+}
+
+TEST(MapValidatorTest, testIncremental)
+{
+    XodrMap map = XodrMap::fromFile(VALIDATE_LINKS_XODR_PATH).extract_value();
+    const MapValidator validator = MapValidator::structural();
+
+    ValidationReport report = validator.run(map);
+    ASSERT_TRUE(report.success());
+
+    // Removing the predecessor of road 2 breaks the link from its predecessor.
+    const int roadIdx = map.roadIndexById("2");
+    const RoadLink predecessor = map.roads()[roadIdx].predecessor();
+    ASSERT_EQ(predecessor.elementType(), RoadLink::ElementType::ROAD);
+    map.test_roadById("2")->test_setPredecessor(RoadLink());
+
+    validator.validateIncremental(map, {roadIdx}, report);
+    EXPECT_FALSE(report.success());
+    expectSameErrors(report, validator.run(map));
+
+    // Restoring the link fixes the error again.
+    map.test_roadById("2")->test_setPredecessor(predecessor);
+    validator.validateIncremental(map, {roadIdx, roadIdx}, report);
+    EXPECT_TRUE(report.success());
+    expectSameErrors(report, validator.run(map));
+}
+
+TEST(MapValidatorTest, testIncrementalLinks)
+{
+    XodrMap map = XodrMap::fromFile(VALIDATE_LINKS_JUNCTION_XODR_PATH).extract_value();
+
+    // A validator which reports every item, so the items of the incremental
+    // report can be compared with those of a full run.
+    MapValidator validator;
+    MapValidator::Validator everything;
+    everything.name_ = "everything";
+    everything.roadVisitor_ = [](const XodrMap& map, int roadIdx, std::vector<std::string>& errors) {
+        errors.push_back("road " + map.roads()[roadIdx].id());
+    };
+    everything.linkVisitor_ = [](const XodrMap& map, RoadContactPointKey aKey, RoadContactPointKey bKey,
+                                 const Junction::Connection*, std::vector<std::string>& errors) {
+        errors.push_back("link " + map.roads()[aKey.roadIdx_].id() + " " + map.roads()[bKey.roadIdx_].id());
+    };
+    everything.junctionVisitor_ = [](const XodrMap& map, int junctionIdx, std::vector<std::string>& errors) {
+        errors.push_back("junction " + map.junctions()[junctionIdx].id());
+    };
+    validator.addValidator(everything);
+
+    ValidationReport report = validator.run(map, 4);
+    const int numErrors = static_cast<int>(report.errors_.size());
+
+    // Unlinking a road removes its links from the report.
+    for (int roadIdx = 0; roadIdx < static_cast<int>(map.roads().size()); roadIdx++)
+    {
+        Road* road = map.test_roadById(map.roads()[roadIdx].id());
+        const RoadLink predecessor = road->predecessor();
+        const RoadLink successor = road->successor();
+        road->test_setPredecessor(RoadLink());
+        road->test_setSuccessor(RoadLink());
+
+        validator.validateIncremental(map, {roadIdx}, report, 4);
+        const ValidationReport full = validator.run(map);
+        expectSameErrors(report, full);
+
+        // Only the neighbourhood of the road is revisited.
+        EXPECT_GT(report.validators_[0].numItems_, 0);
+        EXPECT_LT(report.validators_[0].numItems_, full.validators_[0].numItems_);
+
+        road->test_setPredecessor(predecessor);
+        road->test_setSuccessor(successor);
+        validator.validateIncremental(map, {roadIdx}, report, 4);
+        expectSameErrors(report, validator.run(map));
+        EXPECT_EQ(static_cast<int>(report.errors_.size()), numErrors);
+    }
+}
+
+}}  // namespace aid::xodr
@@ -1,7 +1,7 @@
 #include <gtest/gtest.h>
 
-#include "xodr_validation/road_link_validation.h"
-#include "xodr/xodr_map.h"
+#include "validation/road_link_validation.h"
+#include "xodr_map.h"
 #include "../test_config.h"
 
 namespace aid { namespace xodr {
@@ -264,4 +264,30 @@ TEST(RoadLinkValidationTest, directLinkToJunctionRoad)
     EXPECT_EQ(error->bContactPointKey_, RoadContactPointKey(map.roadIndexById("2"), ContactPoint::START));
 }
 
+TEST(RoadLinkValidationTest, parallelMatchesSerial)
+{
+    XodrMap map = XodrMap::fromFile(VALIDATE_LINKS_JUNCTION2_XODR_PATH).extract_value();
+
+    map.test_roadById("2")->test_setPredecessor(
+        RoadLink::roadLink(XodrObjectReference("3", map.roadIndexById("3")), ContactPoint::END));
+    map.test_roadById("1")->test_setSuccessor(RoadLink());
+
+    std::vector<std::unique_ptr<LinkValidationError>> serialErrors;
+    bool serialRes = validateLinks(map, serialErrors);
+    EXPECT_FALSE(serialRes);
+    ASSERT_GE(serialErrors.size(), 2);
+
+    for (int numThreads : {2, 3, 8})
+    {
+        std::vector<std::unique_ptr<LinkValidationError>> errors;
+        bool res = validateLinks(map, errors, numThreads);
+        EXPECT_EQ(res, serialRes);
+        ASSERT_EQ(errors.size(), serialErrors.size());
+        for (int i = 0; i < static_cast<int>(errors.size()); i++)
+        {
+            EXPECT_EQ(errors[i]->description(map), serialErrors[i]->description(map));
+        }
+    }
+}
+
 }}  // namespace aid::xodr
\ No newline at end of file
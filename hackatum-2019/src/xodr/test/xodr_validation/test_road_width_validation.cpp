@@ -1,9 +1,11 @@
 #include <gtest/gtest.h>
 
+#include <limits>
+
 #include "../test_config.h"
 
-#include "xodr_validation/road_width_validation.h"
-#include "xodr/xodr_map.h"
+#include "validation/road_width_validation.h"
+#include "xodr_map.h"
 
 namespace aid { namespace xodr {
 
@@ -177,7 +179,8 @@ TEST(RoadWidthValidationTest, testValidateParamPoly3s)
     }
 }
 
-TEST(RoadWidthValidationTest, testValidateNSUv4)
+// The map of this test isn't part of the test data.
+TEST(RoadWidthValidationTest, DISABLED_testValidateNSUv4)
 {
     XodrMap xodrMap = XodrMap::fromFile(std::string(TEST_DATA_PATH_PREFIX) + "xodr/NSU_v4.xodr").extract_value();
     std::vector<RoadTooWideViolation> errors;
@@ -204,4 +207,114 @@ TEST(RoadWidthValidationTest, testValidateNSUv4)
     }
 }
 
-}}  // namespace aid::xodr
\ No newline at end of file
+TEST(RoadWidthValidationTest, testValidateWidthAcrossGeometries)
+{
+    // The left lane widens linearly, w = s, and the reference line turns left
+    // with radius 10 after a straight piece, so the left side folds from s = 10.
+    XodrMap xodrMap =
+        XodrMap::fromText("<OpenDRIVE><header/><road name='' length='20' id='1' junction='-1'><planView>"
+                          "<geometry s='0' x='0' y='0' hdg='0' length='5'><line/></geometry>"
+                          "<geometry s='5' x='5' y='0' hdg='0' length='15'><arc curvature='0.1'/></geometry>"
+                          "</planView><lanes><laneSection s='0'><left><lane id='1' type='driving' level='false'>"
+                          "<width sOffset='0' a='0' b='1' c='0' d='0'/></lane></left><center/></laneSection>"
+                          "</lanes></road></OpenDRIVE>")
+            .extract_value();
+    roadTooWideCaseFailure(xodrMap, "1", {RoadTooWideViolation(nullptr, 9, 20, BoundaryDirection::LEFT)});
+
+    const Road* road = xodrMap.roadById("1");
+    std::vector<RoadTooWideViolation> errors;
+    RoadWidthValidator(*road, 0.01).validateRoadWidth(errors);
+    ASSERT_EQ(errors.size(), 1);
+    EXPECT_NEAR(errors[0].startS_, 10, 0.01);
+    EXPECT_NEAR(errors[0].endS_, 20, 1e-9);
+}
+
+TEST(RoadWidthValidationTest, testValidateZeroSpeedParamPoly3)
+{
+    // The reference line (u, v) = ((p - 5)^3, (p - 5)^2) stops at p = 5, where
+    // it has a cusp with the curvature -6 / (|p - 5| (9 (p - 5)^2 + 4)^1.5),
+    // so the right lane of width 3 folds for |p - 5| < 0.71.
+    XodrMap xodrMap =
+        XodrMap::fromText("<OpenDRIVE><header/><road name='' length='10' id='1' junction='-1'><planView>"
+                          "<geometry s='0' x='0' y='0' hdg='0' length='10'><paramPoly3 "
+                          "aU='-125' bU='75' cU='-15' dU='1' aV='25' bV='-10' cV='1' dV='0' pRange='arcLength'/>"
+                          "</geometry></planView><lanes><laneSection s='0'><center/><right>"
+                          "<lane id='-1' type='driving' level='false'><width sOffset='0' a='3' b='0' c='0' d='0'/>"
+                          "</lane></right></laneSection></lanes></road></OpenDRIVE>")
+            .extract_value();
+
+    const Road* road = xodrMap.roadById("1");
+    ASSERT_NE(road, nullptr);
+    const ReferenceLine::Geometry& geometry = road->referenceLine().geometry(0);
+    double minCurvature;
+    double maxCurvature;
+    geometry.evalCurvatureBounds(4, 6, minCurvature, maxCurvature);
+    EXPECT_EQ(minCurvature, -std::numeric_limits<double>::infinity());
+    EXPECT_EQ(maxCurvature, 0);
+
+    std::vector<RoadTooWideViolation> errors;
+    EXPECT_FALSE(RoadWidthValidator(*road, 0.01).validateRoadWidth(errors));
+    ASSERT_EQ(errors.size(), 1);
+    EXPECT_EQ(errors[0].direction_, BoundaryDirection::RIGHT);
+    EXPECT_NEAR(errors[0].startS_, 4.29, 0.02);
+    EXPECT_NEAR(errors[0].endS_, 5.71, 0.02);
+
+    // With the width 0.5 (s - 5)^2, the lane vanishes at the cusp faster than
+    // the curvature grows, so it doesn't fold, although the product bounds of
+    // the intervals around the cusp are NaN.
+    xodrMap = XodrMap::fromText("<OpenDRIVE><header/><road name='' length='10' id='1' junction='-1'><planView>"
+                                "<geometry s='0' x='0' y='0' hdg='0' length='10'><paramPoly3 "
+                                "aU='-125' bU='75' cU='-15' dU='1' aV='25' bV='-10' cV='1' dV='0' pRange='arcLength'/>"
+                                "</geometry></planView><lanes><laneSection s='0'><center/><right>"
+                                "<lane id='-1' type='driving' level='false'>"
+                                "<width sOffset='0' a='12.5' b='-5' c='0.5' d='0'/></lane></right>"
+                                "</laneSection></lanes></road></OpenDRIVE>")
+                  .extract_value();
+    errors.clear();
+    EXPECT_TRUE(RoadWidthValidator(*xodrMap.roadById("1"), 0.01).validateRoadWidth(errors));
+    EXPECT_EQ(errors.size(), 0);
+}
+
+TEST(RoadWidthValidationTest, testValidateLaneWidths)
+{
+    {
+        XodrMap xodrMap = XodrMap::fromFile(VALIDATE_POLY3S_XODR_PATH).extract_value();
+        std::vector<NegativeLaneWidthViolation> errors;
+        EXPECT_TRUE(validateLaneWidths(xodrMap, errors));
+        EXPECT_EQ(errors.size(), 0);
+    }
+
+    {
+        // The width of lane -1 is 3 - 0.01 s^2 in the first interval, which ends before it becomes negative.
+        XodrMap xodrMap = XodrMap::fromText(
+                              "<OpenDRIVE><header/><road name='' length='40' id='1' junction='-1'>"
+                              "<planView><geometry s='0' x='0' y='0' hdg='0' length='40'><line/></geometry></planView>"
+                              "<lanes><laneSection s='0'><left><lane id='1' type='driving' level='false'>"
+                              "<width sOffset='0' a='3' b='0' c='0' d='0'/></lane></left><center/>"
+                              "<right><lane id='-1' type='driving' level='false'>"
+                              "<width sOffset='0' a='3' b='0' c='-0.01' d='0'/>"
+                              "<width sOffset='10' a='2' b='0' c='0' d='0'/></lane></right>"
+                              "</laneSection></lanes></road></OpenDRIVE>")
+                              .extract_value();
+        std::vector<NegativeLaneWidthViolation> errors;
+        EXPECT_TRUE(validateLaneWidths(xodrMap, errors));
+
+        xodrMap = XodrMap::fromText(
+                      "<OpenDRIVE><header/><road name='' length='40' id='1' junction='-1'>"
+                      "<planView><geometry s='0' x='0' y='0' hdg='0' length='40'><line/></geometry></planView>"
+                      "<lanes><laneSection s='0'><left><lane id='1' type='driving' level='false'>"
+                      "<width sOffset='0' a='3' b='0' c='0' d='0'/></lane></left><center/>"
+                      "<right><lane id='-1' type='driving' level='false'>"
+                      "<width sOffset='0' a='3' b='0' c='-0.01' d='0'/></lane></right>"
+                      "</laneSection></lanes></road></OpenDRIVE>")
+                      .extract_value();
+        errors.clear();
+        EXPECT_FALSE(validateLaneWidths(xodrMap, errors));
+        ASSERT_EQ(errors.size(), 1);
+        EXPECT_EQ(errors[0].laneKey_, LaneKey(0, 0, 1));
+        EXPECT_EQ(errors[0].widthIdx_, 0);
+        EXPECT_NEAR(errors[0].minWidth_, -13, 1e-9);
+    }
+}
+
+}}  // namespace aid::xodr
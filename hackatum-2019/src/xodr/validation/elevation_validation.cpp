@@ -0,0 +1,284 @@
+#include "validation/elevation_validation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+#include "xodr_map.h"
+#include "xodr_utils.h"
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief Appends the real roots of qa * t^2 + qb * t + qc which lie strictly
+ * inside (startT, endT) to 'roots'.
+ */
+static void appendQuadraticRoots(double qa, double qb, double qc, double startT, double endT,
+                                 std::vector<double>& roots)
+{
+    auto append = [&](double t) {
+        if (t > startT && t < endT)
+        {
+            roots.push_back(t);
+        }
+    };
+
+    if (qa == 0)
+    {
+        if (qb != 0)
+        {
+            append(-qc / qb);
+        }
+        return;
+    }
+
+    const double disc = qb * qb - 4 * qa * qc;
+    if (disc < 0)
+    {
+        return;
+    }
+
+    // The numerically stable form of the quadratic formula.
+    const double q = -0.5 * (qb + std::copysign(std::sqrt(disc), qb));
+    append(q / qa);
+    if (q != 0)
+    {
+        append(qc / q);
+    }
+}
+
+/**
+ * @brief Evaluates the elevation and slope of an elevation profile.
+ *
+ * @param profile       The elevation profile.
+ * @param s             The s-coordinate.
+ * @param elevation     Is set to the elevation at s.
+ * @param slope         Is set to the slope at s.
+ */
+static void evalElevationAndSlope(const ElevationProfile& profile, double s, double& elevation, double& slope)
+{
+    const std::vector<ElevationProfile::Elevation>& segments = profile.elevations();
+    auto it = std::upper_bound(
+        segments.begin(), segments.end(), s,
+        [](double s, const ElevationProfile::Elevation& segment) { return s < segment.sCoord(); });
+    if (it != segments.begin())
+    {
+        --it;
+    }
+
+    elevation = it->poly3().eval(s - it->sCoord());
+    slope = it->poly3().evalDerivative(s - it->sCoord());
+}
+
+std::string ElevationProfileMaxSlopeExceeded::description(const XodrMap& map) const
+{
+    std::stringstream desc;
+    desc << "The slope of elevation profile segment " << segmentIndex_ << " of road '"
+         << map.roads()[roadIndex_].id() << "' reaches " << maxSlope_ << " between s = " << startS_
+         << " and s = " << endS_ << ".";
+    return desc.str();
+}
+
+std::string ElevationDiscontinuity::description(const XodrMap& map) const
+{
+    std::stringstream desc;
+    desc << "The elevation isn't continuous between road '" << map.roads()[aRoadIndex_].id() << "' at s = " << aSCoord_
+         << " and road '" << map.roads()[bRoadIndex_].id() << "' at s = " << bSCoord_
+         << ": The elevation jumps by " << elevationJump_ << " m and the slope by " << slopeJump_ << ".";
+    return desc.str();
+}
+
+bool validateElevationProfileSegmentSlope(const ElevationProfile::Elevation& segment, int roadIdx, int segmentIdx,
+                                          double segmentLength, double maxSlope,
+                                          std::vector<ElevationProfileMaxSlopeExceeded>& errors)
+{
+    const Poly3& poly = segment.poly3();
+
+    // The slope is qa * t^2 + qb * t + qc.
+    const double qa = 3 * poly.d_;
+    const double qb = 2 * poly.c_;
+    const double qc = poly.b_;
+
+    std::vector<double> breaks{0, segmentLength};
+    appendQuadraticRoots(qa, qb, qc - maxSlope, 0, segmentLength, breaks);
+    appendQuadraticRoots(qa, qb, qc + maxSlope, 0, segmentLength, breaks);
+    std::sort(breaks.begin(), breaks.end());
+
+    bool success = true;
+    bool extendLast = false;
+    for (int i = 0; i + 1 < static_cast<int>(breaks.size()); i++)
+    {
+        const double startT = breaks[i];
+        const double endT = breaks[i + 1];
+        const double midSlope = poly.evalDerivative((startT + endT) / 2);
+        if (endT <= startT || std::abs(midSlope) <= maxSlope)
+        {
+            extendLast = extendLast && endT <= startT;
+            continue;
+        }
+
+        // The slope is monotonic between the breaks, except at the vertex of
+        // the parabola.
+        double extremeSlope = poly.evalDerivative(startT);
+        for (double t : {endT, qa != 0 ? -qb / (2 * qa) : startT})
+        {
+            const double slope = poly.evalDerivative(t);
+            if (t >= startT && t <= endT && std::abs(slope) > std::abs(extremeSlope))
+            {
+                extremeSlope = slope;
+            }
+        }
+
+        if (extendLast && (errors.back().maxSlope_ > 0) == (midSlope > 0))
+        {
+            ElevationProfileMaxSlopeExceeded& error = errors.back();
+            error.endS_ = segment.sCoord() + endT;
+            if (std::abs(extremeSlope) > std::abs(error.maxSlope_))
+            {
+                error.maxSlope_ = extremeSlope;
+            }
+        }
+        else
+        {
+            ElevationProfileMaxSlopeExceeded error;
+            error.roadIndex_ = roadIdx;
+            error.segmentIndex_ = segmentIdx;
+            error.startS_ = segment.sCoord() + startT;
+            error.endS_ = segment.sCoord() + endT;
+            error.maxSlope_ = extremeSlope;
+            errors.push_back(error);
+        }
+
+        extendLast = true;
+        success = false;
+    }
+
+    return success;
+}
+
+bool validateElevationProfileContinuity(const XodrMap& map, int roadIdx, double elevationTolerance,
+                                        double slopeTolerance, std::vector<ElevationDiscontinuity>& errors)
+{
+    const Road& road = map.roads()[roadIdx];
+    if (!road.hasElevationProfile())
+    {
+        return true;
+    }
+
+    bool success = true;
+    const std::vector<ElevationProfile::Elevation>& segments = road.elevationProfile().elevations();
+    for (int i = 0; i + 1 < static_cast<int>(segments.size()); i++)
+    {
+        // Rebasing the polynomial of segment i to the start of segment i + 1
+        // gives its elevation and slope there as the first two coefficients.
+        const Poly3 end = segments[i].poly3().translate(segments[i].sCoord() - segments[i + 1].sCoord());
+        const Poly3& start = segments[i + 1].poly3();
+
+        const double elevationJump = start.a_ - end.a_;
+        const double slopeJump = start.b_ - end.b_;
+        if (std::abs(elevationJump) > elevationTolerance || std::abs(slopeJump) > slopeTolerance)
+        {
+            ElevationDiscontinuity error;
+            error.aRoadIndex_ = roadIdx;
+            error.aSCoord_ = segments[i + 1].sCoord();
+            error.bRoadIndex_ = roadIdx;
+            error.bSCoord_ = segments[i + 1].sCoord();
+            error.elevationJump_ = elevationJump;
+            error.slopeJump_ = slopeJump;
+            errors.push_back(error);
+            success = false;
+        }
+    }
+
+    return success;
+}
+
+bool validateElevationLink(const XodrMap& map, RoadContactPointKey aKey, RoadContactPointKey bKey,
+                           double elevationTolerance, double slopeTolerance,
+                           std::vector<ElevationDiscontinuity>& errors)
+{
+    const Road& aRoad = map.roads()[aKey.roadIdx_];
+    const Road& bRoad = map.roads()[bKey.roadIdx_];
+    if (!aRoad.hasElevationProfile() || !bRoad.hasElevationProfile())
+    {
+        return true;
+    }
+
+    const double aS = aKey.contactPoint_ == ContactPoint::START ? 0 : aRoad.length();
+    const double bS = bKey.contactPoint_ == ContactPoint::START ? 0 : bRoad.length();
+
+    double aElevation;
+    double aSlope;
+    double bElevation;
+    double bSlope;
+    evalElevationAndSlope(aRoad.elevationProfile(), aS, aElevation, aSlope);
+    evalElevationAndSlope(bRoad.elevationProfile(), bS, bElevation, bSlope);
+
+    // Roads which meet at the same kind of contact point run in opposing
+    // directions.
+    if (aKey.contactPoint_ == bKey.contactPoint_)
+    {
+        bSlope = -bSlope;
+    }
+
+    const double elevationJump = bElevation - aElevation;
+    const double slopeJump = bSlope - aSlope;
+    if (std::abs(elevationJump) <= elevationTolerance && std::abs(slopeJump) <= slopeTolerance)
+    {
+        return true;
+    }
+
+    ElevationDiscontinuity error;
+    error.aRoadIndex_ = aKey.roadIdx_;
+    error.aSCoord_ = aS;
+    error.bRoadIndex_ = bKey.roadIdx_;
+    error.bSCoord_ = bS;
+    error.elevationJump_ = elevationJump;
+    error.slopeJump_ = slopeJump;
+    errors.push_back(error);
+    return false;
+}
+
+bool validateElevationProfileSlope(const XodrMap& map, int roadIdx, double maxSlope,
+                                   std::vector<ElevationProfileMaxSlopeExceeded>& errors)
+{
+    const Road& road = map.roads()[roadIdx];
+    if (!road.hasElevationProfile())
+    {
+        return true;
+    }
+
+    bool success = true;
+    const std::vector<ElevationProfile::Elevation>& segments = road.elevationProfile().elevations();
+    for (int i = 0; i < static_cast<int>(segments.size()); i++)
+    {
+        const double endS = i + 1 < static_cast<int>(segments.size()) ? segments[i + 1].sCoord() : road.length();
+        if (endS > segments[i].sCoord())
+        {
+            success &= validateElevationProfileSegmentSlope(segments[i], roadIdx, i, endS - segments[i].sCoord(),
+                                                            maxSlope, errors);
+        }
+    }
+    return success;
+}
+
+bool validateElevation(const XodrMap& map, double maxSlope, double elevationTolerance, double slopeTolerance,
+                       std::vector<ElevationProfileMaxSlopeExceeded>& slopeErrors,
+                       std::vector<ElevationDiscontinuity>& discontinuities)
+{
+    bool success = true;
+    for (int roadIdx = 0; roadIdx < static_cast<int>(map.roads().size()); roadIdx++)
+    {
+        success &= validateElevationProfileSlope(map, roadIdx, maxSlope, slopeErrors);
+        success &= validateElevationProfileContinuity(map, roadIdx, elevationTolerance, slopeTolerance,
+                                                      discontinuities);
+    }
+
+    forEachRoadLink(map, [&](RoadContactPointKey aKey, RoadContactPointKey bKey) {
+        success &= validateElevationLink(map, aKey, bKey, elevationTolerance, slopeTolerance, discontinuities);
+    });
+
+    return success;
+}
+
+}}  // namespace aid::xodr
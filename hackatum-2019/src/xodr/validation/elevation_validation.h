@@ -0,0 +1,198 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "elevation.h"
+#include "xodr_map_keys.h"
+
+namespace aid { namespace xodr {
+
+class XodrMap;
+
+/**
+ * @brief An error indicating that the slope of an elevation profile segment
+ * exceeds the maximum slope within an s-interval.
+ */
+class ElevationProfileMaxSlopeExceeded
+{
+  public:
+    /**
+     * @brief Provides a human readable description of this error
+     *
+     * @param map           The XodrMap to which this error applies.
+     * @return              The error message.
+     */
+    std::string description(const XodrMap& map) const;
+
+    /**
+     * @brief The index of the road.
+     */
+    int roadIndex_;
+
+    /**
+     * @brief The index of the segment in ElevationProfile::elevations().
+     */
+    int segmentIndex_;
+
+    /**
+     * @brief The start of the s-interval in which the slope is exceeded.
+     */
+    double startS_;
+
+    /**
+     * @brief The end of the s-interval in which the slope is exceeded.
+     */
+    double endS_;
+
+    /**
+     * @brief The (signed) slope with the largest magnitude within the interval.
+     */
+    double maxSlope_;
+};
+
+/**
+ * @brief An error indicating that the elevation or its slope jumps between
+ * two consecutive segments of an elevation profile, or between two linked
+ * roads.
+ *
+ * Within a road, A and B are the same road. The slopes are compared in the
+ * direction of road A, so for roads with opposing directions, the slope of
+ * road B is negated.
+ */
+class ElevationDiscontinuity
+{
+  public:
+    /**
+     * @brief Provides a human readable description of this error
+     *
+     * @param map           The XodrMap to which this error applies.
+     * @return              The error message.
+     */
+    std::string description(const XodrMap& map) const;
+
+    /**
+     * @brief The index of road A.
+     */
+    int aRoadIndex_;
+
+    /**
+     * @brief The s-coordinate of the discontinuity on road A.
+     */
+    double aSCoord_;
+
+    /**
+     * @brief The index of road B.
+     */
+    int bRoadIndex_;
+
+    /**
+     * @brief The s-coordinate of the discontinuity on road B.
+     */
+    double bSCoord_;
+
+    /**
+     * @brief The elevation of road B minus the elevation of road A.
+     */
+    double elevationJump_;
+
+    /**
+     * @brief The slope of road B minus the slope of road A.
+     */
+    double slopeJump_;
+};
+
+/**
+ * @brief Validates that the slope of an elevation profile segment doesn't
+ * exceed the given maximum in either direction.
+ *
+ * The slope is a quadratic polynomial, so the intervals in which it exceeds
+ * the maximum are found in closed form, from the roots of slope = maxSlope
+ * and slope = -maxSlope. The errors are appended in order of s.
+ *
+ * @param segment       The elevation profile segment.
+ * @param roadIdx       The index of the road of the segment.
+ * @param segmentIdx    The index of the segment in ElevationProfile::elevations().
+ * @param segmentLength The length of the segment.
+ * @param maxSlope      The maximum absolute slope.
+ * @param errors        The vector to which errors will be appended.
+ * @returns             True if validation succeeded, false if there was at
+ *                      least a single error.
+ */
+bool validateElevationProfileSegmentSlope(const ElevationProfile::Elevation& segment, int roadIdx, int segmentIdx,
+                                          double segmentLength, double maxSlope,
+                                          std::vector<ElevationProfileMaxSlopeExceeded>& errors);
+
+/**
+ * @brief Validates the slope of each segment of the elevation profile of a
+ * road, see validateElevationProfileSegmentSlope().
+ *
+ * Roads without elevation profile aren't validated.
+ *
+ * @param map           The XodrMap.
+ * @param roadIdx       The index of the road.
+ * @param maxSlope      The maximum absolute slope.
+ * @param errors        The vector to which errors will be appended.
+ * @returns             True if validation succeeded, false if there was at
+ *                      least a single error.
+ */
+bool validateElevationProfileSlope(const XodrMap& map, int roadIdx, double maxSlope,
+                                   std::vector<ElevationProfileMaxSlopeExceeded>& errors);
+
+/**
+ * @brief Validates that the elevation and slope of a road are continuous
+ * between consecutive segments of its elevation profile.
+ *
+ * @param map               The XodrMap.
+ * @param roadIdx           The index of the road.
+ * @param elevationTolerance The maximum elevation jump, in meters.
+ * @param slopeTolerance    The maximum slope jump.
+ * @param errors            The vector to which errors will be appended.
+ * @returns                 True if validation succeeded, false if there was
+ *                          at least a single error.
+ */
+bool validateElevationProfileContinuity(const XodrMap& map, int roadIdx, double elevationTolerance,
+                                        double slopeTolerance, std::vector<ElevationDiscontinuity>& errors);
+
+/**
+ * @brief Validates that the elevation and slope are continuous across a
+ * road link.
+ *
+ * Links where either road has no elevation profile aren't validated.
+ *
+ * @param map               The XodrMap.
+ * @param aKey, bKey        The contact points of the link, as passed by
+ *                          forEachRoadLink().
+ * @param elevationTolerance The maximum elevation jump, in meters.
+ * @param slopeTolerance    The maximum slope jump.
+ * @param errors            The vector to which errors will be appended.
+ * @returns                 True if validation succeeded, false if there was
+ *                          at least a single error.
+ */
+bool validateElevationLink(const XodrMap& map, RoadContactPointKey aKey, RoadContactPointKey bKey,
+                           double elevationTolerance, double slopeTolerance,
+                           std::vector<ElevationDiscontinuity>& errors);
+
+/**
+ * @brief Validates the elevation profiles of all roads of a map.
+ *
+ * Checks the slope of each segment (see
+ * validateElevationProfileSlope()), the continuity within each road
+ * (see validateElevationProfileContinuity()) and then the continuity across
+ * each road link in a single pass over forEachRoadLink() (see
+ * validateElevationLink()).
+ *
+ * @param map               The XodrMap to validate.
+ * @param maxSlope          The maximum absolute slope.
+ * @param elevationTolerance The maximum elevation jump, in meters.
+ * @param slopeTolerance    The maximum slope jump.
+ * @param slopeErrors       The vector to which slope errors will be appended.
+ * @param discontinuities   The vector to which discontinuities will be appended.
+ * @returns                 True if validation succeeded, false if there was
+ *                          at least a single error.
+ */
+bool validateElevation(const XodrMap& map, double maxSlope, double elevationTolerance, double slopeTolerance,
+                       std::vector<ElevationProfileMaxSlopeExceeded>& slopeErrors,
+                       std::vector<ElevationDiscontinuity>& discontinuities);
+
+}}  // namespace aid::xodr
@@ -0,0 +1,237 @@
+#include "validation/geometric_adjacency_validation.h"
+
+#include <cmath>
+#include <sstream>
+
+#include "xodr_map.h"
+#include "xodr_utils.h"
+
+namespace aid { namespace xodr {
+
+namespace {
+
+/**
+ * @brief The cross-section of a lane section at one of the contact points of
+ * its road.
+ */
+struct ContactCrossSection
+{
+    /**
+     * @brief The point and tangent direction of the reference line.
+     */
+    ReferenceLine::PointAndTangentDir frame_;
+
+    /**
+     * @brief The t-coordinates of the left boundaries of the lanes, by lane index.
+     */
+    std::vector<double> leftT_;
+
+    /**
+     * @brief The t-coordinates of the right boundaries of the lanes, by lane index.
+     */
+    std::vector<double> rightT_;
+};
+
+}  // namespace
+
+/**
+ * @brief Evaluates the cross-section of the lane section at a contact point.
+ *
+ * At the end of a road, the end vertex of the reference line is used, since
+ * ReferenceLine::eval() isn't defined there.
+ *
+ * @param map           The XodrMap.
+ * @param key           The key of the lane section contact point.
+ * @param crossSection  Is set to the cross-section.
+ */
+static void evalCrossSection(const XodrMap& map, LaneSectionContactPointKey key, ContactCrossSection& crossSection)
+{
+    const Road& road = map.roads()[key.roadIdx_];
+    const LaneSection& laneSection = road.laneSections()[key.laneSectionIdx_];
+    const ReferenceLine& referenceLine = road.referenceLine();
+
+    double ds;
+    if (key.contactPoint_ == ContactPoint::START)
+    {
+        crossSection.frame_ = referenceLine.eval(laneSection.startS());
+        ds = 0;
+    }
+    else
+    {
+        const ReferenceLine::Vertex& endVertex = referenceLine.endVertex();
+        crossSection.frame_ = ReferenceLine::PointAndTangentDir(
+            endVertex.position_, Eigen::Vector2d(std::cos(endVertex.heading_), std::sin(endVertex.heading_)));
+        ds = laneSection.endS() - laneSection.startS();
+    }
+
+    const auto& lanes = laneSection.lanes();
+    const int numLeftLanes = laneSection.numLeftLanes();
+    crossSection.leftT_.resize(lanes.size());
+    crossSection.rightT_.resize(lanes.size());
+
+    // The left lanes are ordered from the outside in, and are driven against
+    // the direction of the reference line.
+    double t = 0;
+    for (int i = numLeftLanes - 1; i >= 0; i--)
+    {
+        crossSection.leftT_[i] = t;
+        t += lanes[i].widthPoly3s().empty() ? 0 : lanes[i].widthAtSCoord(ds);
+        crossSection.rightT_[i] = t;
+    }
+
+    t = 0;
+    for (int i = numLeftLanes; i < static_cast<int>(lanes.size()); i++)
+    {
+        crossSection.leftT_[i] = t;
+        t -= lanes[i].widthPoly3s().empty() ? 0 : lanes[i].widthAtSCoord(ds);
+        crossSection.rightT_[i] = t;
+    }
+}
+
+/**
+ * @brief Checks that the boundaries of two linked lanes meet.
+ *
+ * @param a, b          The cross-sections of lane sections A and B.
+ * @param aKey, bKey    The keys of lane sections A and B.
+ * @param aLaneIdx      The index of the lane in lane section A.
+ * @param bLaneIdx      The index of the lane in lane section B.
+ * @param tolerance     See validateGeometricAdjacency().
+ * @param errors        The vector to which errors are appended.
+ * @returns             True if the boundaries meet.
+ */
+static bool validateLanePair(const ContactCrossSection& a, const ContactCrossSection& b,
+                             LaneSectionContactPointKey aKey, LaneSectionContactPointKey bKey, int aLaneIdx,
+                             int bLaneIdx, double tolerance, std::vector<GeometricAdjacencyError>& errors)
+{
+    bool success = true;
+    for (const bool onLeftBoundary : {false, true})
+    {
+        const Eigen::Vector2d aPoint =
+            a.frame_.pointWithTCoord(onLeftBoundary ? a.leftT_[aLaneIdx] : a.rightT_[aLaneIdx]);
+        const Eigen::Vector2d bPoint =
+            b.frame_.pointWithTCoord(onLeftBoundary ? b.leftT_[bLaneIdx] : b.rightT_[bLaneIdx]);
+
+        const double distance = (aPoint - bPoint).norm();
+        if (distance > tolerance)
+        {
+            GeometricAdjacencyError error;
+            error.aLaneSectionContactPointKey_ = aKey;
+            error.bLaneSectionContactPointKey_ = bKey;
+            error.aLaneIdx_ = aLaneIdx;
+            error.bLaneIdx_ = bLaneIdx;
+            error.onLeftBoundary_ = onLeftBoundary;
+            error.distance_ = distance;
+            errors.push_back(error);
+            success = false;
+        }
+    }
+    return success;
+}
+
+/**
+ * @brief Gets the key of the lane section at a road contact point.
+ */
+static LaneSectionContactPointKey laneSectionContactPointKey(const XodrMap& map, RoadContactPointKey key)
+{
+    const Road& road = map.roads()[key.roadIdx_];
+    return LaneSectionContactPointKey(key.roadIdx_, road.laneSectionIndexForContactPoint(key.contactPoint_),
+                                      key.contactPoint_);
+}
+
+/**
+ * @brief Checks whether a lane link target exists in the given lane section.
+ */
+static bool isLaneInRange(const LaneSection& laneSection, LaneID laneId)
+{
+    return laneId != LaneID(0) && laneId >= LaneID(-laneSection.numRightLanes()) &&
+           laneId <= LaneID(laneSection.numLeftLanes());
+}
+
+std::string GeometricAdjacencyError::description(const XodrMap& map) const
+{
+    const LaneSection& aLaneSection = laneSectionByKey(map, aLaneSectionContactPointKey_.laneSectionKey());
+    const LaneSection& bLaneSection = laneSectionByKey(map, bLaneSectionContactPointKey_.laneSectionKey());
+
+    std::stringstream desc;
+    desc << "Lanes don't meet between A = " << aLaneSectionContactPointKey_.toString(map)
+         << " and B = " << bLaneSectionContactPointKey_.toString(map) << ": The "
+         << (onLeftBoundary_ ? "left" : "right") << " boundaries of lane " << aLaneSection.laneIndexToId(aLaneIdx_)
+         << " in section A and lane " << bLaneSection.laneIndexToId(bLaneIdx_) << " in section B are " << distance_
+         << " m apart.";
+    return desc.str();
+}
+
+/**
+ * @brief Checks the lane links across a road link.
+ *
+ * @param map           The XodrMap.
+ * @param aRoadKey, bRoadKey The contact points of the link.
+ * @param connection    The junction connection, or nullptr for a normal road link.
+ * @param tolerance     See validateGeometricAdjacency().
+ * @param a, b          Buffers for the cross-sections at the contact points.
+ * @param errors        The vector to which errors are appended.
+ * @returns             True if all linked lanes meet.
+ */
+static bool validateLink(const XodrMap& map, RoadContactPointKey aRoadKey, RoadContactPointKey bRoadKey,
+                         const Junction::Connection* connection, double tolerance, ContactCrossSection& a,
+                         ContactCrossSection& b, std::vector<GeometricAdjacencyError>& errors)
+{
+    const LaneSectionContactPointKey aKey = laneSectionContactPointKey(map, aRoadKey);
+    const LaneSectionContactPointKey bKey = laneSectionContactPointKey(map, bRoadKey);
+    const LaneSection& aLaneSection = laneSectionByKey(map, aKey.laneSectionKey());
+    const LaneSection& bLaneSection = laneSectionByKey(map, bKey.laneSectionKey());
+    const RoadLinkType linkType = linkTypeForContactPoint(aRoadKey.contactPoint_);
+
+    evalCrossSection(map, aKey, a);
+    evalCrossSection(map, bKey, b);
+
+    bool success = true;
+    for (int i = 0; i < static_cast<int>(aLaneSection.lanes().size()); i++)
+    {
+        const LaneSection::Lane& lane = aLaneSection.lanes()[i];
+        LaneIDOpt target = LaneIDOpt::null();
+        if (connection)
+        {
+            target = connection->findLaneLinkTarget(lane.id());
+        }
+        else if (lane.hasLink(linkType))
+        {
+            target = LaneIDOpt(lane.link(linkType));
+        }
+
+        if (target && isLaneInRange(bLaneSection, *target))
+        {
+            success &=
+                validateLanePair(a, b, aKey, bKey, i, bLaneSection.laneIdToIndex(*target), tolerance, errors);
+        }
+    }
+    return success;
+}
+
+bool validateGeometricAdjacencyLink(const XodrMap& map, RoadContactPointKey aKey, RoadContactPointKey bKey,
+                                    const Junction::Connection* connection, double tolerance,
+                                    std::vector<GeometricAdjacencyError>& errors)
+{
+    ContactCrossSection a;
+    ContactCrossSection b;
+    return validateLink(map, aKey, bKey, connection, tolerance, a, b, errors);
+}
+
+bool validateGeometricAdjacency(const XodrMap& map, double tolerance, std::vector<GeometricAdjacencyError>& errors)
+{
+    bool success = true;
+    ContactCrossSection a;
+    ContactCrossSection b;
+    forEachRoadLink(
+        map,
+        [&](RoadContactPointKey aKey, RoadContactPointKey bKey) {
+            success &= validateLink(map, aKey, bKey, nullptr, tolerance, a, b, errors);
+        },
+        [&](RoadContactPointKey aKey, RoadContactPointKey bKey, const Junction::Connection& connection) {
+            success &= validateLink(map, aKey, bKey, &connection, tolerance, a, b, errors);
+        });
+
+    return success;
+}
+
+}}  // namespace aid::xodr
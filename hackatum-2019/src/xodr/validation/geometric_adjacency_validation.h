@@ -0,0 +1,104 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "junction.h"
+#include "validation/link_validation_base.h"
+#include "xodr_map_keys.h"
+
+namespace aid { namespace xodr {
+
+class XodrMap;
+
+/**
+ * @brief An error indicating that the boundaries of two linked lanes don't
+ * meet at the contact point of their roads.
+ *
+ * Left and right are relative to the driving direction of a lane, assuming
+ * right hand traffic, so the left boundary of a lane is the one which is
+ * closer to the reference line.
+ */
+class GeometricAdjacencyError : public LinkValidationError
+{
+  public:
+    /**
+     * @brief Provides a human readable description of this error
+     *
+     * @param map           The XodrMap to which this error applies.
+     * @return              The error message.
+     */
+    virtual std::string description(const XodrMap& map) const override;
+
+    /**
+     * @brief The key of lane section A, at the contact point.
+     */
+    LaneSectionContactPointKey aLaneSectionContactPointKey_;
+
+    /**
+     * @brief The key of lane section B, at the contact point.
+     */
+    LaneSectionContactPointKey bLaneSectionContactPointKey_;
+
+    /**
+     * @brief The index of the lane in lane section A.
+     */
+    int aLaneIdx_;
+
+    /**
+     * @brief The index of the lane in lane section B.
+     */
+    int bLaneIdx_;
+
+    /**
+     * @brief Whether the left (true) or right (false) boundaries of the lanes
+     * don't meet.
+     */
+    bool onLeftBoundary_;
+
+    /**
+     * @brief The distance between the ends of the boundaries.
+     */
+    double distance_;
+};
+
+/**
+ * @brief Validates that linked lanes meet in space.
+ *
+ * For each road link, see forEachRoadLink(), and each pair of lanes which are
+ * linked across it, the ends of the left and right boundaries of the lanes
+ * must be within 'tolerance' of each other. Only the cross-sections of the
+ * roads at their contact points are evaluated, so no geometry is tessellated.
+ *
+ * Lane links which are invalid themselves (see validateLinks()) are skipped.
+ * For each pair of lanes, the right boundary is checked before the left one.
+ *
+ * @param map           The XodrMap to validate.
+ * @param tolerance     The maximum distance between the ends of linked
+ *                      boundaries, in meters.
+ * @param errors        The vector to which errors will be appended.
+ * @returns             True if validation succeeded, false if there was at
+ *                      least a single error.
+ */
+bool validateGeometricAdjacency(const XodrMap& map, double tolerance, std::vector<GeometricAdjacencyError>& errors);
+
+/**
+ * @brief Validates that the lanes which are linked across a single road link
+ * meet in space, see validateGeometricAdjacency().
+ *
+ * @param map           The XodrMap to validate.
+ * @param aKey, bKey    The contact points of the link, as passed by
+ *                      forEachRoadLink().
+ * @param connection    The junction connection for links between incoming and
+ *                      connecting roads, or nullptr for normal road links.
+ * @param tolerance     The maximum distance between the ends of linked
+ *                      boundaries, in meters.
+ * @param errors        The vector to which errors will be appended.
+ * @returns             True if validation succeeded, false if there was at
+ *                      least a single error.
+ */
+bool validateGeometricAdjacencyLink(const XodrMap& map, RoadContactPointKey aKey, RoadContactPointKey bKey,
+                                    const Junction::Connection* connection, double tolerance,
+                                    std::vector<GeometricAdjacencyError>& errors);
+
+}}  // namespace aid::xodr
@@ -10,41 +10,61 @@ static bool junctionContainsRoad(const Junction& junction, int roadIdx);
 
 void validateJunctionMembership(const XodrMap& map)
 {
-    const auto& roads = map.roads();
-    const auto& junctions = map.junctions();
+    std::vector<std::string> errors;
+    for (int i = 0; i < static_cast<int>(map.roads().size()) && errors.empty(); i++)
+    {
+        validateRoadJunctionMembership(map, i, errors);
+    }
 
-    for (int i = 0; i < static_cast<int>(roads.size()); i++)
+    for (int i = 0; i < static_cast<int>(map.junctions().size()) && errors.empty(); i++)
     {
-        const Road& road = roads[i];
-        if (road.junctionRef().hasValue())
-        {
-            const Junction& junction = junctions[road.junctionRef().index()];
-            if (!junctionContainsRoad(junction, i))
-            {
-                std::stringstream err;
-                err << "The road " << road.id() << " is part of junction " << junction.id()
-                    << ", but this junction doesn't contain a connection with road " << road.id()
-                    << " as connecting road.";
-                throw std::runtime_error(err.str());
-            }
-        }
+        validateJunctionConnectingRoads(map, i, errors);
+    }
+
+    if (!errors.empty())
+    {
+        throw std::runtime_error(errors.front());
+    }
+}
+
+bool validateRoadJunctionMembership(const XodrMap& map, int roadIdx, std::vector<std::string>& errors)
+{
+    const Road& road = map.roads()[roadIdx];
+    if (!road.junctionRef().hasValue())
+    {
+        return true;
+    }
+
+    const Junction& junction = map.junctions()[road.junctionRef().index()];
+    if (junctionContainsRoad(junction, roadIdx))
+    {
+        return true;
     }
 
-    for (int i = 0; i < static_cast<int>(junctions.size()); i++)
+    std::stringstream err;
+    err << "The road " << road.id() << " is part of junction " << junction.id()
+        << ", but this junction doesn't contain a connection with road " << road.id() << " as connecting road.";
+    errors.push_back(err.str());
+    return false;
+}
+
+bool validateJunctionConnectingRoads(const XodrMap& map, int junctionIdx, std::vector<std::string>& errors)
+{
+    bool success = true;
+    const Junction& junction = map.junctions()[junctionIdx];
+    for (const Junction::Connection& conn : junction.connections())
     {
-        const Junction& junction = junctions[i];
-        for (const Junction::Connection& conn : junction.connections())
+        const Road& connectingRoad = map.roads()[conn.connectingRoad().index()];
+        if (connectingRoad.junctionRef().index() != junctionIdx)
         {
-            const Road& connectingRoad = roads[conn.connectingRoad().index()];
-            if (connectingRoad.junctionRef().index() != i)
-            {
-                std::stringstream err;
-                err << "Junction " << junction.id() << " uses " << connectingRoad.id()
-                    << " as a connecting road, but this road doesn't belong to junction " << junction.id() << ".";
-                throw std::runtime_error(err.str());
-            }
+            std::stringstream err;
+            err << "Junction " << junction.id() << " uses " << connectingRoad.id()
+                << " as a connecting road, but this road doesn't belong to junction " << junction.id() << ".";
+            errors.push_back(err.str());
+            success = false;
         }
     }
+    return success;
 }
 
 static bool junctionContainsRoad(const Junction& junction, int roadIdx)
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <string>
+#include <vector>
+
 namespace aid { namespace xodr {
 
 class XodrMap;
@@ -17,4 +20,30 @@ class XodrMap;
  */
 void validateJunctionMembership(const XodrMap& map);
 
-}}  // namespace aid::xodr
\ No newline at end of file
+/**
+ * @brief Validates that, if the given road belongs to a junction, that
+ * junction contains a connection with the road as its connecting road.
+ *
+ * This is the per-road half of validateJunctionMembership().
+ *
+ * @param map               The XodrMap to validate.
+ * @param roadIdx           The index of the road.
+ * @param errors            The vector to which error messages will be appended.
+ * @returns                 True if validation succeeded.
+ */
+bool validateRoadJunctionMembership(const XodrMap& map, int roadIdx, std::vector<std::string>& errors);
+
+/**
+ * @brief Validates that all connecting roads of the given junction belong to
+ * that junction.
+ *
+ * This is the per-junction half of validateJunctionMembership().
+ *
+ * @param map               The XodrMap to validate.
+ * @param junctionIdx       The index of the junction.
+ * @param errors            The vector to which error messages will be appended.
+ * @returns                 True if validation succeeded.
+ */
+bool validateJunctionConnectingRoads(const XodrMap& map, int junctionIdx, std::vector<std::string>& errors);
+
+}}  // namespace aid::xodr
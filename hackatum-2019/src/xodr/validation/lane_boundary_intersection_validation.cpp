@@ -0,0 +1,291 @@
+#include "validation/lane_boundary_intersection_validation.h"
+
+#include <algorithm>
+#include <iterator>
+#include <sstream>
+
+#include "map_tessellation.h"
+#include "packed_rtree.h"
+#include "parallel.h"
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief The maximum number of segments in a BoundaryChunk.
+ */
+static constexpr int MAX_SEGMENTS_PER_CHUNK = 8;
+
+namespace {
+
+/**
+ * @brief A tessellated lane boundary.
+ */
+struct Boundary
+{
+    /**
+     * @brief The index of the lane section in the tessellation.
+     */
+    int laneSectionIdx_;
+
+    /**
+     * @brief The index of the first vertex of the boundary in the tessellation.
+     */
+    int vertexBegin_;
+
+    /**
+     * @brief The lane to which the boundary is attributed.
+     */
+    LaneKey laneKey_;
+
+    /**
+     * @brief The index of the junction of the boundary's road, or -1.
+     */
+    int junctionIdx_;
+};
+
+/**
+ * @brief A range of consecutive segments of a boundary.
+ */
+struct BoundaryChunk
+{
+    /**
+     * @brief The index of the boundary.
+     */
+    int boundaryIdx_;
+
+    /**
+     * @brief The segments are [begin_, end_), where segment j connects
+     * vertices j and j + 1 of the boundary.
+     */
+    int begin_;
+    int end_;
+};
+
+}  // namespace
+
+/**
+ * @brief Gets the index of the lane to which a lane boundary is attributed,
+ * see IntersectingGeometryViolation.
+ *
+ * @param laneSection   The lane section.
+ * @param boundaryIdx   The index of the boundary, as in
+ *                      LaneSection::tessellateLaneBoundaryCurves().
+ * @returns             The lane index.
+ */
+static int boundaryLaneIndex(const LaneSection& laneSection, int boundaryIdx)
+{
+    const int numLeftLanes = laneSection.numLeftLanes();
+    if (boundaryIdx < numLeftLanes)
+    {
+        return boundaryIdx;
+    }
+    if (boundaryIdx == numLeftLanes && laneSection.numRightLanes() == 0)
+    {
+        return numLeftLanes - 1;
+    }
+    return std::max(boundaryIdx - 1, numLeftLanes);
+}
+
+/**
+ * @brief Computes the 2D cross product of two vectors.
+ */
+static double cross(const Eigen::Vector2d& a, const Eigen::Vector2d& b)
+{
+    return a.x() * b.y() - a.y() * b.x();
+}
+
+/**
+ * @brief Intersects the segments [p0, p1) and [q0, q1).
+ *
+ * The segments are half open, so a polyline which crosses another one at a
+ * vertex is counted once. Parallel segments, and segments which only share
+ * their start points, don't intersect.
+ *
+ * @param p0, p1        The end points of the first segment.
+ * @param q0, q1        The end points of the second segment.
+ * @param u             Is set to the parameter of the intersection on the first segment.
+ * @param v             Is set to the parameter of the intersection on the second segment.
+ * @returns             True if the segments intersect.
+ */
+static bool intersectSegments(const Eigen::Vector2d& p0, const Eigen::Vector2d& p1, const Eigen::Vector2d& q0,
+                              const Eigen::Vector2d& q1, double& u, double& v)
+{
+    const Eigen::Vector2d r = p1 - p0;
+    const Eigen::Vector2d d = q1 - q0;
+    const double denom = cross(r, d);
+    if (denom == 0)
+    {
+        return false;
+    }
+
+    const Eigen::Vector2d w = q0 - p0;
+    u = cross(w, d) / denom;
+    v = cross(w, r) / denom;
+    return u >= 0 && u < 1 && v >= 0 && v < 1 && (u > 0 || v > 0);
+}
+
+/**
+ * @brief Finds the intersections between the segments of two boundary chunks.
+ *
+ * @param t             The tessellation.
+ * @param boundaries    The boundaries of the tessellation.
+ * @param a, b          The chunks. For chunks of the same boundary, a must
+ *                      not come after b.
+ * @param tolerance     See validateBoundaryIntersections().
+ * @param errors        The vector to which violations are appended.
+ */
+static void intersectChunks(const MapTessellation& t, const std::vector<Boundary>& boundaries, const BoundaryChunk& a,
+                            const BoundaryChunk& b, double tolerance,
+                            std::vector<IntersectingGeometryViolation>& errors)
+{
+    const Boundary& boundaryA = boundaries[a.boundaryIdx_];
+    const Boundary& boundaryB = boundaries[b.boundaryIdx_];
+    const MapTessellation::LaneSectionRange& rangeA = t.laneSections_[boundaryA.laneSectionIdx_];
+    const MapTessellation::LaneSectionRange& rangeB = t.laneSections_[boundaryB.laneSectionIdx_];
+    const bool sameBoundary = a.boundaryIdx_ == b.boundaryIdx_;
+
+    const double startSA = t.refLineS_[rangeA.refLineBegin_];
+    const double endSA = t.refLineS_[rangeA.refLineEnd_ - 1];
+    const double startSB = t.refLineS_[rangeB.refLineBegin_];
+    const double endSB = t.refLineS_[rangeB.refLineEnd_ - 1];
+
+    for (int i = a.begin_; i < a.end_; i++)
+    {
+        const Eigen::Vector2d p0 = t.boundaryVertex(rangeA, boundaryA.vertexBegin_ + i);
+        const Eigen::Vector2d p1 = t.boundaryVertex(rangeA, boundaryA.vertexBegin_ + i + 1);
+        const Eigen::AlignedBox2d boxA(p0.cwiseMin(p1), p0.cwiseMax(p1));
+
+        // Adjacent segments of the same boundary always touch.
+        for (int j = sameBoundary ? std::max(b.begin_, i + 2) : b.begin_; j < b.end_; j++)
+        {
+            const Eigen::Vector2d q0 = t.boundaryVertex(rangeB, boundaryB.vertexBegin_ + j);
+            const Eigen::Vector2d q1 = t.boundaryVertex(rangeB, boundaryB.vertexBegin_ + j + 1);
+            if (!boxA.intersects(Eigen::AlignedBox2d(q0.cwiseMin(q1), q0.cwiseMax(q1))))
+            {
+                continue;
+            }
+
+            double u;
+            double v;
+            if (!intersectSegments(p0, p1, q0, q1, u, v))
+            {
+                continue;
+            }
+
+            const int refA = rangeA.refLineBegin_ + i;
+            const int refB = rangeB.refLineBegin_ + j;
+            const double sA = t.refLineS_[refA] + u * (t.refLineS_[refA + 1] - t.refLineS_[refA]);
+            const double sB = t.refLineS_[refB] + v * (t.refLineS_[refB + 1] - t.refLineS_[refB]);
+            if (sA - startSA < tolerance || endSA - sA < tolerance || sB - startSB < tolerance ||
+                endSB - sB < tolerance)
+            {
+                continue;
+            }
+
+            errors.emplace_back(boundaryA.laneKey_, sA, boundaryB.laneKey_, sB, p0 + u * (p1 - p0));
+        }
+    }
+}
+
+std::string IntersectingGeometryViolation::description(const XodrMap& map) const
+{
+    auto laneString = [&map](LaneKey key) {
+        const Road& road = map.roads()[key.roadIdx_];
+        std::stringstream ret;
+        ret << "lane " << road.laneSections()[key.laneSectionIdx_].laneIndexToId(key.laneIdx_) << " of [road: '"
+            << road.id() << "', lane section: " << key.laneSectionIdx_ << "]";
+        return ret.str();
+    };
+
+    std::stringstream desc;
+    desc << "The boundary of " << laneString(laneKeyA_) << " at s = " << sCoordA_ << " intersects the boundary of "
+         << laneString(laneKeyB_) << " at s = " << sCoordB_ << ", at (" << position_.x() << ", " << position_.y()
+         << ").";
+    return desc.str();
+}
+
+bool validateBoundaryIntersections(const XodrMap& map, double tolerance,
+                                   std::vector<IntersectingGeometryViolation>& errors, int numThreads)
+{
+    MapTessellationOptions options;
+    options.numThreads_ = numThreads;
+    const MapTessellation t = tessellateMap(map, options);
+
+    std::vector<Boundary> boundaries;
+    std::vector<BoundaryChunk> chunks;
+    std::vector<Eigen::AlignedBox2d> chunkBoxes;
+    for (int i = 0; i < static_cast<int>(t.laneSections_.size()); i++)
+    {
+        const MapTessellation::LaneSectionRange& range = t.laneSections_[i];
+        const Road& road = map.roads()[range.key_.roadIdx_];
+        const LaneSection& laneSection = road.laneSections()[range.key_.laneSectionIdx_];
+        if (laneSection.lanes().empty())
+        {
+            continue;
+        }
+
+        const int numSegments = range.refLineEnd_ - range.refLineBegin_ - 1;
+        for (int b = range.boundaryBegin_; b < range.boundaryEnd_; b++)
+        {
+            Boundary boundary;
+            boundary.laneSectionIdx_ = i;
+            boundary.vertexBegin_ = t.boundaryOffsets_[b];
+            boundary.laneKey_ = LaneKey(range.key_, boundaryLaneIndex(laneSection, b - range.boundaryBegin_));
+            boundary.junctionIdx_ = road.junctionRef().hasValue() ? road.junctionRef().index() : -1;
+            boundaries.push_back(boundary);
+
+            for (int begin = 0; begin < numSegments; begin += MAX_SEGMENTS_PER_CHUNK)
+            {
+                BoundaryChunk chunk;
+                chunk.boundaryIdx_ = static_cast<int>(boundaries.size()) - 1;
+                chunk.begin_ = begin;
+                chunk.end_ = std::min(numSegments, begin + MAX_SEGMENTS_PER_CHUNK);
+                chunks.push_back(chunk);
+
+                Eigen::AlignedBox2d box;
+                for (int j = chunk.begin_; j <= chunk.end_; j++)
+                {
+                    box.extend(t.boundaryVertex(range, boundary.vertexBegin_ + j));
+                }
+                chunkBoxes.push_back(box);
+            }
+        }
+    }
+
+    const PackedRTree tree(chunkBoxes);
+
+    // Each pair of chunks is compared by the task of the chunk which comes
+    // first, and the results are merged in chunk order.
+    std::vector<std::vector<IntersectingGeometryViolation>> chunkErrors(chunks.size());
+    parallelFor(static_cast<int>(chunks.size()), numThreads, [&](int c) {
+        std::vector<int> others;
+        const Boundary& boundary = boundaries[chunks[c].boundaryIdx_];
+        tree.search(chunkBoxes[c], [&](int other) {
+            // Different connecting roads of the same junction may cross, but a
+            // connecting road may not cross itself.
+            const Boundary& otherBoundary = boundaries[chunks[other].boundaryIdx_];
+            const bool sameJunction = boundary.junctionIdx_ >= 0 && otherBoundary.junctionIdx_ == boundary.junctionIdx_;
+            if (other >= c && (!sameJunction || otherBoundary.laneKey_.roadIdx_ == boundary.laneKey_.roadIdx_))
+            {
+                others.push_back(other);
+            }
+        });
+
+        std::sort(others.begin(), others.end());
+        for (int other : others)
+        {
+            intersectChunks(t, boundaries, chunks[c], chunks[other], tolerance, chunkErrors[c]);
+        }
+    });
+
+    bool success = true;
+    for (std::vector<IntersectingGeometryViolation>& e : chunkErrors)
+    {
+        success &= e.empty();
+        std::move(e.begin(), e.end(), std::back_inserter(errors));
+    }
+
+    return success;
+}
+
+}}  // namespace aid::xodr
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <Eigen/Dense>
+#include <string>
+#include <vector>
+
+#include "xodr_map_keys.h"
+
+namespace aid { namespace xodr {
+
+class XodrMap;
+
+/**
+ * @brief A violation indicating that the boundaries of two lanes cross each
+ * other.
+ *
+ * Each lane boundary is attributed to the lane on its outer side, i.e. the
+ * side which is farther from the reference line. The boundary at the
+ * reference line is attributed to the innermost right lane, or to the
+ * innermost left lane if the lane section has no right lanes.
+ */
+class IntersectingGeometryViolation
+{
+  public:
+    /**
+     * @brief Creates a violation.
+     *
+     * @param laneKeyA      The key of lane A.
+     * @param sCoordA       The s-coordinate of the intersection on the road of lane A.
+     * @param laneKeyB      The key of lane B.
+     * @param sCoordB       The s-coordinate of the intersection on the road of lane B.
+     * @param position      The position of the intersection.
+     */
+    IntersectingGeometryViolation(LaneKey laneKeyA, double sCoordA, LaneKey laneKeyB, double sCoordB,
+                                  const Eigen::Vector2d& position)
+        : laneKeyA_(laneKeyA), sCoordA_(sCoordA), laneKeyB_(laneKeyB), sCoordB_(sCoordB), position_(position)
+    {
+    }
+
+    /**
+     * @brief Provides a human readable description of this violation.
+     *
+     * @param map           The XodrMap to which this violation applies.
+     * @return              The error message.
+     */
+    std::string description(const XodrMap& map) const;
+
+    /**
+     * @brief The key of lane A.
+     */
+    LaneKey laneKeyA_;
+
+    /**
+     * @brief The s-coordinate of the intersection on the road of lane A.
+     */
+    double sCoordA_;
+
+    /**
+     * @brief The key of lane B.
+     */
+    LaneKey laneKeyB_;
+
+    /**
+     * @brief The s-coordinate of the intersection on the road of lane B.
+     */
+    double sCoordB_;
+
+    /**
+     * @brief The position of the intersection.
+     */
+    Eigen::Vector2d position_;
+};
+
+/**
+ * @brief Validates that the tessellated lane boundaries of the map don't
+ * cross each other.
+ *
+ * All pairs of boundaries are checked, both within a road and between
+ * different roads, except for pairs of two different connecting roads of the
+ * same junction, which overlap by design. Collinear boundaries, as between
+ * lanes of zero width, and boundaries which meet at a common vertex, as where
+ * the width of a lane becomes zero, don't count as crossings.
+ *
+ * Boundaries of linked roads and lane sections meet at their ends, where
+ * small gaps and overlaps are common. Crossings which are within
+ * 'tolerance' (in s-direction) of the start or end of either lane section are
+ * therefore ignored.
+ *
+ * The boundaries are split into short chunks, which are indexed in a
+ * PackedRTree, so only chunks with overlapping bounding boxes are compared
+ * segment by segment. Lane A of a violation is the lane whose boundary comes
+ * first in map order, and the order of the violations doesn't depend on the
+ * number of threads.
+ *
+ * @param map           The XodrMap to validate.
+ * @param tolerance     The distance from the ends of lane sections within which
+ *                      crossings are ignored, in meters.
+ * @param errors        The vector to which violations will be appended.
+ * @param numThreads    The number of threads, see resolveNumThreads().
+ * @returns             True if validation succeeded, false if there was at
+ *                      least a single violation.
+ */
+bool validateBoundaryIntersections(const XodrMap& map, double tolerance,
+                                   std::vector<IntersectingGeometryViolation>& errors, int numThreads = 1);
+
+}}  // namespace aid::xodr
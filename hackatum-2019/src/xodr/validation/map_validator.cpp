@@ -0,0 +1,460 @@
+#include "validation/map_validator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+
+#include "parallel.h"
+#include "validation/elevation_validation.h"
+#include "validation/geometric_adjacency_validation.h"
+#include "validation/junction_validation.h"
+#include "validation/lane_boundary_intersection_validation.h"
+#include "validation/road_link_validation.h"
+#include "validation/road_width_validation.h"
+#include "xodr_map.h"
+#include "xodr_utils.h"
+
+namespace aid { namespace xodr {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief A road link, as passed to the callbacks of forEachRoadLink().
+ *
+ * aKey_ is the road from which forEachRoadLinkFrom() visits the link.
+ */
+struct RoadLinkItem
+{
+    RoadContactPointKey aKey_;
+    RoadContactPointKey bKey_;
+    const Junction::Connection* connection_;
+};
+
+}  // namespace
+
+/**
+ * @brief Collects the roads which the successor, predecessor and junction
+ * connections of a road reference.
+ *
+ * @param map           The XodrMap.
+ * @param roadIdx       The index of the road.
+ * @param dependencies  The vector to which the road indices are appended.
+ */
+static void collectRoadDependencies(const XodrMap& map, int roadIdx, std::vector<int>& dependencies)
+{
+    for (const RoadLinkType roadLinkType : {RoadLinkType::PREDECESSOR, RoadLinkType::SUCCESSOR})
+    {
+        const RoadLink& roadLink = map.roads()[roadIdx].roadLink(roadLinkType);
+        if (roadLink.elementType() == RoadLink::ElementType::ROAD)
+        {
+            dependencies.push_back(roadLink.elementRef().index());
+        }
+        else if (roadLink.elementType() == RoadLink::ElementType::JUNCTION)
+        {
+            const Junction& junction = map.junctions()[roadLink.elementRef().index()];
+            for (const Junction::Connection& connection : junction.connections())
+            {
+                if (connection.incomingRoad().index() == roadIdx)
+                {
+                    dependencies.push_back(connection.connectingRoad().index());
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Appends the descriptions of errors, whose description() takes the map,
+ * to a vector of messages.
+ */
+template <class E>
+static void appendDescriptions(const XodrMap& map, const std::vector<E>& errors, std::vector<std::string>& messages)
+{
+    for (const E& error : errors)
+    {
+        messages.push_back(error.description(map));
+    }
+}
+
+/**
+ * @brief Sorts a vector and removes duplicate elements.
+ */
+static void sortUnique(std::vector<int>& v)
+{
+    std::sort(v.begin(), v.end());
+    v.erase(std::unique(v.begin(), v.end()), v.end());
+}
+
+std::string ValidationReport::statsSummary() const
+{
+    std::stringstream ret;
+    ret << std::left << std::setw(24) << "validator" << std::right << std::setw(10) << "ms" << std::setw(10)
+        << "items" << std::setw(10) << "errors" << "\n";
+    ret << std::fixed << std::setprecision(3);
+    for (const ValidatorStats& stats : validators_)
+    {
+        ret << std::left << std::setw(24) << stats.name_ << std::right << std::setw(10) << stats.seconds_ * 1000
+            << std::setw(10) << stats.numItems_ << std::setw(10) << stats.numErrors_ << "\n";
+    }
+    ret << std::left << std::setw(24) << "total" << std::right << std::setw(10) << seconds_ * 1000 << "\n";
+    return ret.str();
+}
+
+MapValidator MapValidator::structural()
+{
+    MapValidator ret;
+
+    Validator laneSections;
+    laneSections.name_ = "lane sections";
+    laneSections.roadVisitor_ = [](const XodrMap& map, int roadIdx, std::vector<std::string>& errors) {
+        try
+        {
+            map.roads()[roadIdx].validate();
+        }
+        catch (const std::exception& e)
+        {
+            errors.push_back(e.what());
+        }
+    };
+    ret.addValidator(std::move(laneSections));
+
+    Validator junctionMembership;
+    junctionMembership.name_ = "junction membership";
+    junctionMembership.roadVisitor_ = validateRoadJunctionMembership;
+    junctionMembership.junctionVisitor_ = validateJunctionConnectingRoads;
+    ret.addValidator(std::move(junctionMembership));
+
+    Validator links;
+    links.name_ = "links";
+    links.roadVisitor_ = [](const XodrMap& map, int roadIdx, std::vector<std::string>& errors) {
+        std::vector<std::unique_ptr<LinkValidationError>> linkErrors;
+        validateRoadLinks(map, roadIdx, linkErrors);
+        for (const std::unique_ptr<LinkValidationError>& error : linkErrors)
+        {
+            errors.push_back(error->description(map));
+        }
+    };
+    ret.addValidator(std::move(links));
+
+    return ret;
+}
+
+MapValidator MapValidator::full(const GeometricValidationParams& params)
+{
+    MapValidator ret = structural();
+
+    Validator boundaryIntersections;
+    boundaryIntersections.name_ = "boundary intersections";
+    boundaryIntersections.mapVisitor_ = [params](const XodrMap& map, int numThreads,
+                                                 std::vector<std::string>& errors) {
+        std::vector<IntersectingGeometryViolation> violations;
+        validateBoundaryIntersections(map, params.boundaryIntersectionTolerance_, violations, numThreads);
+        appendDescriptions(map, violations, errors);
+    };
+    ret.addValidator(std::move(boundaryIntersections));
+
+    Validator roadWidth;
+    roadWidth.name_ = "road width";
+    roadWidth.roadVisitor_ = [params](const XodrMap& map, int roadIdx, std::vector<std::string>& errors) {
+        std::vector<RoadTooWideViolation> tooWide;
+        RoadWidthValidator(map.roads()[roadIdx], params.roadWidthResolution_).validateRoadWidth(tooWide);
+        for (const RoadTooWideViolation& violation : tooWide)
+        {
+            errors.push_back(violation.description());
+        }
+
+        std::vector<NegativeLaneWidthViolation> negativeWidths;
+        validateRoadLaneWidths(map, roadIdx, negativeWidths);
+        appendDescriptions(map, negativeWidths, errors);
+    };
+    ret.addValidator(std::move(roadWidth));
+
+    Validator adjacency;
+    adjacency.name_ = "geometric adjacency";
+    adjacency.linkVisitor_ = [params](const XodrMap& map, RoadContactPointKey aKey, RoadContactPointKey bKey,
+                                      const Junction::Connection* connection, std::vector<std::string>& errors) {
+        std::vector<GeometricAdjacencyError> adjacencyErrors;
+        validateGeometricAdjacencyLink(map, aKey, bKey, connection, params.adjacencyTolerance_, adjacencyErrors);
+        appendDescriptions(map, adjacencyErrors, errors);
+    };
+    ret.addValidator(std::move(adjacency));
+
+    Validator elevation;
+    elevation.name_ = "elevation";
+    elevation.roadVisitor_ = [params](const XodrMap& map, int roadIdx, std::vector<std::string>& errors) {
+        std::vector<ElevationProfileMaxSlopeExceeded> slopeErrors;
+        validateElevationProfileSlope(map, roadIdx, params.maxSlope_, slopeErrors);
+        appendDescriptions(map, slopeErrors, errors);
+
+        std::vector<ElevationDiscontinuity> discontinuities;
+        validateElevationProfileContinuity(map, roadIdx, params.elevationTolerance_, params.slopeTolerance_,
+                                           discontinuities);
+        appendDescriptions(map, discontinuities, errors);
+    };
+    elevation.linkVisitor_ = [params](const XodrMap& map, RoadContactPointKey aKey, RoadContactPointKey bKey,
+                                      const Junction::Connection*, std::vector<std::string>& errors) {
+        std::vector<ElevationDiscontinuity> discontinuities;
+        validateElevationLink(map, aKey, bKey, params.elevationTolerance_, params.slopeTolerance_, discontinuities);
+        appendDescriptions(map, discontinuities, errors);
+    };
+    ret.addValidator(std::move(elevation));
+
+    return ret;
+}
+
+ValidationReport MapValidator::run(const XodrMap& map, int numThreads) const
+{
+    const Clock::time_point start = Clock::now();
+
+    const int numRoads = static_cast<int>(map.roads().size());
+    const int numJunctions = static_cast<int>(map.junctions().size());
+
+    ValidationReport report;
+    report.roadErrors_.resize(numRoads);
+    report.linkErrors_.resize(numRoads);
+    report.junctionErrors_.resize(numJunctions);
+    report.numRoadLinks_.resize(numRoads, 0);
+    report.roadDependencies_.resize(numRoads);
+    report.roadDependents_.resize(numRoads);
+    report.roadJunctions_.resize(numRoads);
+
+    for (int roadIdx = 0; roadIdx < numRoads; roadIdx++)
+    {
+        collectRoadDependencies(map, roadIdx, report.roadDependencies_[roadIdx]);
+        for (int dependency : report.roadDependencies_[roadIdx])
+        {
+            report.roadDependents_[dependency].push_back(roadIdx);
+        }
+    }
+
+    for (int junctionIdx = 0; junctionIdx < numJunctions; junctionIdx++)
+    {
+        for (const Junction::Connection& connection : map.junctions()[junctionIdx].connections())
+        {
+            for (int roadIdx : {connection.incomingRoad().index(), connection.connectingRoad().index()})
+            {
+                std::vector<int>& junctions = report.roadJunctions_[roadIdx];
+                if (junctions.empty() || junctions.back() != junctionIdx)
+                {
+                    junctions.push_back(junctionIdx);
+                }
+            }
+        }
+    }
+
+    std::vector<int> roadIndices(numRoads);
+    std::iota(roadIndices.begin(), roadIndices.end(), 0);
+    std::vector<int> junctionIndices(numJunctions);
+    std::iota(junctionIndices.begin(), junctionIndices.end(), 0);
+    revalidate(map, roadIndices, junctionIndices, report, numThreads);
+
+    report.seconds_ = std::chrono::duration<double>(Clock::now() - start).count();
+    return report;
+}
+
+void MapValidator::validateIncremental(const XodrMap& map, const std::vector<int>& changedRoadIndices,
+                                       ValidationReport& report, int numThreads) const
+{
+    const Clock::time_point start = Clock::now();
+
+    if (report.roadErrors_.size() != map.roads().size() ||
+        report.junctionErrors_.size() != map.junctions().size() ||
+        report.validators_.size() != validators_.size())
+    {
+        throw std::runtime_error("The validation report doesn't belong to this map and validator.");
+    }
+
+    std::vector<int> changed = changedRoadIndices;
+    sortUnique(changed);
+
+    // The links of the changed roads may have changed, so their dependencies
+    // are collected again.
+    for (int roadIdx : changed)
+    {
+        std::vector<int>& dependencies = report.roadDependencies_[roadIdx];
+        for (int dependency : dependencies)
+        {
+            std::vector<int>& dependents = report.roadDependents_[dependency];
+            dependents.erase(std::find(dependents.begin(), dependents.end(), roadIdx));
+        }
+
+        dependencies.clear();
+        collectRoadDependencies(map, roadIdx, dependencies);
+        for (int dependency : dependencies)
+        {
+            report.roadDependents_[dependency].push_back(roadIdx);
+        }
+    }
+
+    // Roads which reference a changed road are affected through their road
+    // visitors, and through the links which are visited from them.
+    std::vector<int> roadIndices;
+    std::vector<int> junctionIndices;
+    for (int roadIdx : changed)
+    {
+        const std::vector<int>& dependents = report.roadDependents_[roadIdx];
+        const std::vector<int>& junctions = report.roadJunctions_[roadIdx];
+        roadIndices.push_back(roadIdx);
+        roadIndices.insert(roadIndices.end(), dependents.begin(), dependents.end());
+        junctionIndices.insert(junctionIndices.end(), junctions.begin(), junctions.end());
+    }
+    sortUnique(roadIndices);
+    sortUnique(junctionIndices);
+
+    revalidate(map, roadIndices, junctionIndices, report, numThreads);
+
+    report.seconds_ = std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+void MapValidator::revalidate(const XodrMap& map, const std::vector<int>& roadIndices,
+                              const std::vector<int>& junctionIndices, ValidationReport& report, int numThreads) const
+{
+    std::vector<RoadLinkItem> links;
+    for (int roadIdx : roadIndices)
+    {
+        forEachRoadLinkFrom(
+            map, roadIdx,
+            [&](RoadContactPointKey aKey, RoadContactPointKey bKey) {
+                links.push_back(RoadLinkItem{aKey, bKey, nullptr});
+            },
+            [&](RoadContactPointKey aKey, RoadContactPointKey bKey, const Junction::Connection& connection) {
+                links.push_back(RoadLinkItem{aKey, bKey, &connection});
+            });
+    }
+
+    const int numValidators = static_cast<int>(validators_.size());
+    const int numRoads = static_cast<int>(roadIndices.size());
+    const int numLinks = static_cast<int>(links.size());
+    const int numJunctions = static_cast<int>(junctionIndices.size());
+    const int numItems = numRoads + numLinks + numJunctions;
+
+    // The errors of each item, which are moved into the report below.
+    std::vector<std::vector<ValidationReport::Error>> itemErrors(numItems);
+    std::unique_ptr<std::atomic<long long>[]> nanoseconds(new std::atomic<long long>[numValidators]);
+    for (int v = 0; v < numValidators; v++)
+    {
+        nanoseconds[v] = 0;
+    }
+
+    parallelFor(numItems, numThreads, [&](int item) {
+        std::vector<std::string> messages;
+        for (int v = 0; v < numValidators; v++)
+        {
+            const Validator& validator = validators_[v];
+            const Clock::time_point start = Clock::now();
+            if (item < numRoads)
+            {
+                if (validator.roadVisitor_)
+                {
+                    validator.roadVisitor_(map, roadIndices[item], messages);
+                }
+            }
+            else if (item < numRoads + numLinks)
+            {
+                if (validator.linkVisitor_)
+                {
+                    const RoadLinkItem& link = links[item - numRoads];
+                    validator.linkVisitor_(map, link.aKey_, link.bKey_, link.connection_, messages);
+                }
+            }
+            else if (validator.junctionVisitor_)
+            {
+                validator.junctionVisitor_(map, junctionIndices[item - numRoads - numLinks], messages);
+            }
+            nanoseconds[v].fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count(),
+                                     std::memory_order_relaxed);
+
+            for (std::string& message : messages)
+            {
+                itemErrors[item].push_back(ValidationReport::Error{v, std::move(message)});
+            }
+            messages.clear();
+        }
+    });
+
+    for (int i = 0; i < numRoads; i++)
+    {
+        const int roadIdx = roadIndices[i];
+        report.roadErrors_[roadIdx] = std::move(itemErrors[i]);
+        report.linkErrors_[roadIdx].clear();
+        report.numLinks_ -= report.numRoadLinks_[roadIdx];
+        report.numRoadLinks_[roadIdx] = 0;
+    }
+
+    for (int i = 0; i < numLinks; i++)
+    {
+        const int roadIdx = links[i].aKey_.roadIdx_;
+        std::vector<ValidationReport::Error>& errors = itemErrors[numRoads + i];
+        std::move(errors.begin(), errors.end(), std::back_inserter(report.linkErrors_[roadIdx]));
+        report.numRoadLinks_[roadIdx]++;
+        report.numLinks_++;
+    }
+
+    for (int i = 0; i < numJunctions; i++)
+    {
+        report.junctionErrors_[junctionIndices[i]] = std::move(itemErrors[numRoads + numLinks + i]);
+    }
+
+    // The map visitors run after the traversal, each with all threads.
+    report.mapErrors_.clear();
+    std::vector<std::string> messages;
+    for (int v = 0; v < numValidators; v++)
+    {
+        const Validator& validator = validators_[v];
+        if (!validator.mapVisitor_)
+        {
+            continue;
+        }
+
+        const Clock::time_point start = Clock::now();
+        validator.mapVisitor_(map, numThreads, messages);
+        nanoseconds[v] += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+
+        for (std::string& message : messages)
+        {
+            report.mapErrors_.push_back(ValidationReport::Error{v, std::move(message)});
+        }
+        messages.clear();
+    }
+
+    report.validators_.resize(numValidators);
+    for (int v = 0; v < numValidators; v++)
+    {
+        const Validator& validator = validators_[v];
+        ValidationReport::ValidatorStats& stats = report.validators_[v];
+        stats.name_ = validator.name_;
+        stats.seconds_ = nanoseconds[v] * 1e-9;
+        stats.numItems_ = (validator.roadVisitor_ ? numRoads : 0) + (validator.linkVisitor_ ? numLinks : 0) +
+                          (validator.junctionVisitor_ ? numJunctions : 0) + (validator.mapVisitor_ ? 1 : 0);
+        stats.numErrors_ = 0;
+    }
+
+    // The errors are ordered by roads, then links, then junctions, and links
+    // are grouped by the road they are visited from in the same order as
+    // forEachRoadLink() visits them. The errors of the map visitors come last.
+    report.errors_.clear();
+    for (const std::vector<std::vector<ValidationReport::Error>>* itemsErrors :
+         {&report.roadErrors_, &report.linkErrors_, &report.junctionErrors_})
+    {
+        for (const std::vector<ValidationReport::Error>& errors : *itemsErrors)
+        {
+            report.errors_.insert(report.errors_.end(), errors.begin(), errors.end());
+        }
+    }
+    report.errors_.insert(report.errors_.end(), report.mapErrors_.begin(), report.mapErrors_.end());
+
+    for (const ValidationReport::Error& error : report.errors_)
+    {
+        report.validators_[error.validatorIdx_].numErrors_++;
+    }
+}
+
+}}  // namespace aid::xodr
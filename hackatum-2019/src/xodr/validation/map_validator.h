@@ -0,0 +1,350 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "junction.h"
+#include "xodr_map_keys.h"
+
+namespace aid { namespace xodr {
+
+class XodrMap;
+
+/**
+ * @brief The result of a MapValidator run.
+ */
+class ValidationReport
+{
+  public:
+    /**
+     * @brief A single validation error.
+     */
+    struct Error
+    {
+        /**
+         * @brief The index of the validator which reported the error, in
+         * validators_.
+         */
+        int validatorIdx_;
+
+        /**
+         * @brief The human readable error message.
+         */
+        std::string message_;
+    };
+
+    /**
+     * @brief The statistics of a single validator.
+     */
+    struct ValidatorStats
+    {
+        /**
+         * @brief The name of the validator.
+         */
+        std::string name_;
+
+        /**
+         * @brief The time spent in the visitors of the validator during the
+         * latest run, in seconds.
+         *
+         * When validating on multiple threads, this is the sum over all
+         * threads, so the sum over all validators can exceed seconds_.
+         */
+        double seconds_ = 0;
+
+        /**
+         * @brief The number of roads, links and junctions visited by the
+         * validator during the latest run, plus one if it has a map visitor.
+         */
+        int numItems_ = 0;
+
+        /**
+         * @brief The number of errors of the validator in errors_.
+         */
+        int numErrors_ = 0;
+    };
+
+    /**
+     * @brief Returns whether validation succeeded, i.e. there were no errors.
+     */
+    bool success() const { return errors_.empty(); }
+
+    /**
+     * @brief Gets a human readable table with the statistics of all validators.
+     */
+    std::string statsSummary() const;
+
+    /**
+     * @brief All errors, ordered by roads, then links, then junctions, in map
+     * order, and by validator for the same item, followed by the errors of
+     * the map visitors.
+     *
+     * The order doesn't depend on the number of threads.
+     */
+    std::vector<Error> errors_;
+
+    /**
+     * @brief The statistics of the validators, in the order they were added.
+     */
+    std::vector<ValidatorStats> validators_;
+
+    /**
+     * @brief The wall time of the latest run, in seconds.
+     */
+    double seconds_ = 0;
+
+  private:
+    friend class MapValidator;
+
+    /**
+     * @brief The errors of each road's road visitors.
+     */
+    std::vector<std::vector<Error>> roadErrors_;
+
+    /**
+     * @brief The errors of the link visitors, grouped by the road from which
+     * forEachRoadLinkFrom() visits the link.
+     */
+    std::vector<std::vector<Error>> linkErrors_;
+
+    /**
+     * @brief The errors of each junction's junction visitors.
+     */
+    std::vector<std::vector<Error>> junctionErrors_;
+
+    /**
+     * @brief The errors of the map visitors.
+     */
+    std::vector<Error> mapErrors_;
+
+    /**
+     * @brief The number of links visited from each road, see linkErrors_.
+     */
+    std::vector<int> numRoadLinks_;
+
+    /**
+     * @brief The total number of links.
+     */
+    int numLinks_ = 0;
+
+    /**
+     * @brief For each road, the roads which its successor, predecessor and
+     * junction connections reference.
+     */
+    std::vector<std::vector<int>> roadDependencies_;
+
+    /**
+     * @brief For each road, the roads which reference it, i.e. the inverse of
+     * roadDependencies_.
+     */
+    std::vector<std::vector<int>> roadDependents_;
+
+    /**
+     * @brief For each road, the junctions with a connection which uses the
+     * road as incoming or connecting road.
+     */
+    std::vector<std::vector<int>> roadJunctions_;
+};
+
+/**
+ * @brief The parameters of the geometric validators of MapValidator::full().
+ */
+struct GeometricValidationParams
+{
+    /**
+     * @brief See validateBoundaryIntersections().
+     */
+    double boundaryIntersectionTolerance_ = 0.1;
+
+    /**
+     * @brief See RoadWidthValidator::RoadWidthValidator().
+     */
+    double roadWidthResolution_ = 0.01;
+
+    /**
+     * @brief See validateGeometricAdjacency().
+     */
+    double adjacencyTolerance_ = 0.05;
+
+    /**
+     * @brief The maximum absolute slope, see validateElevation().
+     */
+    double maxSlope_ = 0.2;
+
+    /**
+     * @brief The maximum elevation jump, in meters, see validateElevation().
+     */
+    double elevationTolerance_ = 0.01;
+
+    /**
+     * @brief The maximum slope jump, see validateElevation().
+     */
+    double slopeTolerance_ = 0.01;
+};
+
+/**
+ * @brief Runs a set of validators over a map in a single traversal.
+ *
+ * Each validator consists of up to three visitors: One which is called for
+ * each road, one for each road link (see forEachRoadLink()) and one for each
+ * junction. The roads, links and junctions are visited once, as the tasks of
+ * a single parallelFor(), and each task calls the visitors of all validators
+ * for its item. The visitors must therefore be thread safe, and may only
+ * append to the error vector they are given.
+ *
+ * Validators which compare geometry across the whole map, like
+ * validateBoundaryIntersections(), which indexes all lane boundaries of the
+ * map in one spatial index, can't be split into items. They have a map
+ * visitor instead, which is called once after the traversal and may use all
+ * threads itself. Map visitors aren't incremental, see validateIncremental().
+ *
+ * After roads were edited, validateIncremental() updates a report by only
+ * revisiting the items which can be affected by the edits. For this to give
+ * the same result as a full run, a road visitor may only depend on the road
+ * and the roads and junctions it references, a link visitor on the two roads
+ * and the junction connection, and a junction visitor on the junction and the
+ * incoming and connecting roads of its connections.
+ */
+class MapValidator
+{
+  public:
+    /**
+     * @brief The visitor which is called for each road.
+     *
+     * Error messages are appended to 'errors'.
+     */
+    using RoadVisitor = std::function<void(const XodrMap& map, int roadIdx, std::vector<std::string>& errors)>;
+
+    /**
+     * @brief The visitor which is called for each road link.
+     *
+     * 'connection' is the junction connection for links between incoming and
+     * connecting roads, and nullptr for normal road links. Error messages are
+     * appended to 'errors'.
+     */
+    using LinkVisitor =
+        std::function<void(const XodrMap& map, RoadContactPointKey aKey, RoadContactPointKey bKey,
+                           const Junction::Connection* connection, std::vector<std::string>& errors)>;
+
+    /**
+     * @brief The visitor which is called for each junction.
+     *
+     * Error messages are appended to 'errors'.
+     */
+    using JunctionVisitor =
+        std::function<void(const XodrMap& map, int junctionIdx, std::vector<std::string>& errors)>;
+
+    /**
+     * @brief The visitor which is called once for the whole map.
+     *
+     * 'numThreads' is the number of threads of the run, see
+     * resolveNumThreads(). Error messages are appended to 'errors'.
+     */
+    using MapVisitor = std::function<void(const XodrMap& map, int numThreads, std::vector<std::string>& errors)>;
+
+    /**
+     * @brief A validator.
+     *
+     * Any of the visitors may be empty.
+     */
+    struct Validator
+    {
+        std::string name_;
+        RoadVisitor roadVisitor_;
+        LinkVisitor linkVisitor_;
+        JunctionVisitor junctionVisitor_;
+        MapVisitor mapVisitor_;
+    };
+
+    /**
+     * @brief Creates a MapValidator with the validators which XodrMap::validate()
+     * runs: the lane section attributes of each road, junction membership and
+     * road and lane links.
+     */
+    static MapValidator structural();
+
+    /**
+     * @brief Creates a MapValidator with the validators of structural() and
+     * the geometric validators: lane boundary intersections, road and lane
+     * widths, geometric adjacency of linked lanes and elevation.
+     *
+     * The lane boundary intersections are checked by a map visitor, so
+     * validateIncremental() checks them on the whole map after each edit.
+     *
+     * @param params        The tolerances of the geometric validators.
+     */
+    static MapValidator full(const GeometricValidationParams& params = GeometricValidationParams());
+
+    /**
+     * @brief Adds a validator.
+     *
+     * @param validator     The validator.
+     */
+    void addValidator(Validator validator) { validators_.push_back(std::move(validator)); }
+
+    /**
+     * @brief Gets the validators, in the order they were added.
+     */
+    const std::vector<Validator>& validators() const { return validators_; }
+
+    /**
+     * @brief Runs all validators on the given map.
+     *
+     * @param map           The XodrMap to validate.
+     * @param numThreads    The number of threads, see resolveNumThreads().
+     * @returns             The report, see ValidationReport.
+     */
+    ValidationReport run(const XodrMap& map, int numThreads = 1) const;
+
+    /**
+     * @brief Updates a report after some roads of the map were changed.
+     *
+     * The road visitors are called for the changed roads and the roads which
+     * reference them, the link visitors for the links of these roads and the
+     * junction visitors for the junctions which reference the changed roads.
+     * The map visitors are called again, since they depend on the whole map.
+     * The errors of these items are replaced in the report, and the result is
+     * the same as that of run() on the changed map.
+     *
+     * The cost of an update therefore only depends on the neighbourhood of the
+     * changed roads for validator sets without map visitors, like
+     * structural(), where updating a report after a single road edit takes a
+     * fraction of a millisecond. With map visitors, like those of full(), each
+     * update costs as much as their full run, e.g. a tessellation of the whole
+     * map for the lane boundary intersections.
+     *
+     * The roads may be changed arbitrarily, including their links, but no
+     * roads or junctions may be added or removed and the junctions may not be
+     * changed. The statistics of the report only cover the revisited items,
+     * except for the error counts.
+     *
+     * @param map                   The changed XodrMap.
+     * @param changedRoadIndices    The indices of the changed roads.
+     * @param report                The report of the previous run() or
+     *                              validateIncremental() of this validator,
+     *                              which is updated.
+     * @param numThreads            The number of threads, see resolveNumThreads().
+     */
+    void validateIncremental(const XodrMap& map, const std::vector<int>& changedRoadIndices,
+                             ValidationReport& report, int numThreads = 1) const;
+
+  private:
+    /**
+     * @brief Runs all validators on the given roads, their links and the given
+     * junctions, and the map visitors on the whole map, and replaces their
+     * errors in the report.
+     *
+     * @param map               The XodrMap to validate.
+     * @param roadIndices       The indices of the roads, without duplicates.
+     * @param junctionIndices   The indices of the junctions, without duplicates.
+     * @param report            The report, which is updated.
+     * @param numThreads        The number of threads, see resolveNumThreads().
+     */
+    void revalidate(const XodrMap& map, const std::vector<int>& roadIndices, const std::vector<int>& junctionIndices,
+                    ValidationReport& report, int numThreads) const;
+
+    std::vector<Validator> validators_;
+};
+
+}}  // namespace aid::xodr
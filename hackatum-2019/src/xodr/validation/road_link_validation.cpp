@@ -1,7 +1,10 @@
 #include "validation/road_link_validation.h"
 
+#include <algorithm>
+#include <iterator>
 #include <sstream>
 
+#include "parallel.h"
 #include "validation/lane_link_validation.h"
 #include "xodr_map.h"
 
@@ -30,21 +33,42 @@ static bool validateLinksIteration(const XodrMap& map, RoadContactPointKey conta
  */
 static const RoadLink& roadLinkForRoadContactPoint(const XodrMap& map, RoadContactPointKey key);
 
-bool validateLinks(const XodrMap& map, std::vector<std::unique_ptr<LinkValidationError>>& errors)
+bool validateLinks(const XodrMap& map, std::vector<std::unique_ptr<LinkValidationError>>& errors, int numThreads)
 {
-    bool success = true;
+    const int numRoads = static_cast<int>(map.roads().size());
+
+    if (std::min(resolveNumThreads(numThreads), numRoads) <= 1)
+    {
+        bool success = true;
+        for (int i = 0; i < numRoads; i++)
+        {
+            success &= validateRoadLinks(map, i, errors);
+        }
+        return success;
+    }
 
-    const auto& roads = map.roads();
-    for (int i = 0; i < static_cast<int>(roads.size()); i++)
+    std::vector<std::vector<std::unique_ptr<LinkValidationError>>> roadErrors(numRoads);
+    std::vector<char> roadSuccess(numRoads);
+    parallelFor(numRoads, numThreads, [&](int i) { roadSuccess[i] = validateRoadLinks(map, i, roadErrors[i]); });
+
+    bool success = true;
+    for (int i = 0; i < numRoads; i++)
     {
-        success &= validateRoadInternalLaneLinks(map, i, errors);
-        success &= validateLinksIteration(map, RoadContactPointKey(i, ContactPoint::START), errors);
-        success &= validateLinksIteration(map, RoadContactPointKey(i, ContactPoint::END), errors);
+        success &= static_cast<bool>(roadSuccess[i]);
+        std::move(roadErrors[i].begin(), roadErrors[i].end(), std::back_inserter(errors));
     }
 
     return success;
 }
 
+bool validateRoadLinks(const XodrMap& map, int roadIdx, std::vector<std::unique_ptr<LinkValidationError>>& errors)
+{
+    bool success = validateRoadInternalLaneLinks(map, roadIdx, errors);
+    success &= validateLinksIteration(map, RoadContactPointKey(roadIdx, ContactPoint::START), errors);
+    success &= validateLinksIteration(map, RoadContactPointKey(roadIdx, ContactPoint::END), errors);
+    return success;
+}
+
 static bool validateLinksIteration(const XodrMap& map, RoadContactPointKey contactPointKey,
                                    std::vector<std::unique_ptr<LinkValidationError>>& errors)
 {
@@ -14,13 +14,34 @@ class LaneSection;
 /**
  * @brief Validates the links (road links and lane links) in the given XodrMap.
  *
+ * The roads can be validated on multiple threads. Each road collects its
+ * errors in its own buffer, and the buffers are appended to 'errors' in road
+ * order, so the errors are the same, and in the same order, for any number of
+ * threads.
+ *
  * @param map           The XodrMap whose links to validate.
  * @param errors        The vector to which errors will be appended if
  *                      validation fails.
+ * @param numThreads    The number of threads, see resolveNumThreads().
+ * @returns             True if validation succeeded, false if there was at
+ *                      least a single error.
+ */
+bool validateLinks(const XodrMap& map, std::vector<std::unique_ptr<LinkValidationError>>& errors,
+                   int numThreads = 1);
+
+/**
+ * @brief Validates the lane links within the given road, and the road and
+ * lane links from both of its contact points.
+ *
+ * This function validates a single road in the validateLinks() function.
+ *
+ * @param map           The XodrMap which contains the data to validate.
+ * @param roadIdx       The index of the road.
+ * @param errors        The vector to which errors will be appended.
  * @returns             True if validation succeeded, false if there was at
  *                      least a single error.
  */
-bool validateLinks(const XodrMap& map, std::vector<std::unique_ptr<LinkValidationError>>& errors);
+bool validateRoadLinks(const XodrMap& map, int roadIdx, std::vector<std::unique_ptr<LinkValidationError>>& errors);
 
 /**
  * @brief Validates the links (both road and lane links) between the 'from'
@@ -0,0 +1,278 @@
+#include "validation/road_width_validation.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <sstream>
+
+#include "xodr_map.h"
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief The maximum gap between two violating intervals which are merged
+ * into one violation.
+ */
+static constexpr double MERGE_EPSILON = 1e-9;
+
+/**
+ * @brief Gets the width polynomial of a lane which applies at the given
+ * s-coordinate, relative to the start of the lane section.
+ *
+ * @param lane          The lane.
+ * @param ds            The s-coordinate relative to the start of the lane section.
+ * @returns             The width polynomial, or nullptr if the lane has none.
+ */
+static const LaneSection::WidthPoly3* widthPolyAt(const LaneSection::Lane& lane, double ds)
+{
+    const std::vector<LaneSection::WidthPoly3>& polys = lane.widthPoly3s();
+    if (polys.empty())
+    {
+        return nullptr;
+    }
+
+    auto it = std::upper_bound(polys.begin() + 1, polys.end(), ds,
+                               [](double s, const LaneSection::WidthPoly3& poly) { return s < poly.sOffset(); });
+    return &*(it - 1);
+}
+
+/**
+ * @brief Gets the geometry of a reference line which contains the given
+ * s-coordinate.
+ *
+ * @param referenceLine The reference line.
+ * @param s             The s-coordinate.
+ * @returns             The last geometry which starts at or before s.
+ */
+static const ReferenceLine::Geometry& geometryAt(const ReferenceLine& referenceLine, double s)
+{
+    int i = 0;
+    while (i + 1 < referenceLine.numGeometries() && referenceLine.geometry(i + 1).startVertex().sCoord_ <= s)
+    {
+        i++;
+    }
+    return referenceLine.geometry(i);
+}
+
+std::string RoadTooWideViolation::description() const
+{
+    std::stringstream desc;
+    desc << "Road '" << (road_ ? road_->id() : std::string("?")) << "' is too wide on its "
+         << (direction_ == BoundaryDirection::LEFT ? "left" : "right") << " side between s = " << startS_
+         << " and s = " << endS_ << ": The outer boundary is farther from the reference line than the radius of "
+         << "curvature, so it folds over itself.";
+    return desc.str();
+}
+
+RoadWidthValidator::RoadWidthValidator(const Road& road, double resolution) : road_(road), resolution_(resolution)
+{
+    assert(resolution > 0);
+}
+
+bool RoadWidthValidator::validateRoadWidth(std::vector<RoadTooWideViolation>& errors) const
+{
+    const ReferenceLine& referenceLine = road_.referenceLine();
+
+    // The violating intervals on the left and right side.
+    std::vector<std::pair<double, double>> intervals[2];
+
+    std::vector<double> breaks;
+    for (const LaneSection& laneSection : road_.laneSections())
+    {
+        const double sectionStartS = laneSection.startS();
+        const double sectionEndS = laneSection.endS();
+
+        breaks.clear();
+        breaks.push_back(sectionStartS);
+        breaks.push_back(sectionEndS);
+        for (int i = 0; i < referenceLine.numGeometries(); i++)
+        {
+            breaks.push_back(referenceLine.geometry(i).startVertex().sCoord_);
+        }
+        for (const LaneSection::Lane& lane : laneSection.lanes())
+        {
+            for (const LaneSection::WidthPoly3& poly : lane.widthPoly3s())
+            {
+                breaks.push_back(sectionStartS + poly.sOffset());
+            }
+        }
+        std::sort(breaks.begin(), breaks.end());
+        breaks.erase(std::unique(breaks.begin(), breaks.end()), breaks.end());
+
+        for (int k = 0; k + 1 < static_cast<int>(breaks.size()); k++)
+        {
+            const double startS = breaks[k];
+            const double endS = breaks[k + 1];
+            if (startS < sectionStartS || endS > sectionEndS)
+            {
+                continue;
+            }
+
+            // The geometry and the width polynomials are selected at the
+            // middle of the piece, so rounding at the breaks doesn't matter.
+            const double midS = (startS + endS) / 2;
+            const ReferenceLine::Geometry& geometry = geometryAt(referenceLine, midS);
+
+            Poly3 offsets[2] = {Poly3(0, 0, 0, 0), Poly3(0, 0, 0, 0)};
+            for (int i = 0; i < static_cast<int>(laneSection.lanes().size()); i++)
+            {
+                const LaneSection::WidthPoly3* poly = widthPolyAt(laneSection.lanes()[i], midS - sectionStartS);
+                if (!poly)
+                {
+                    continue;
+                }
+
+                const Poly3 width = poly->poly3().translate(sectionStartS + poly->sOffset() - startS);
+                if (i < laneSection.numLeftLanes())
+                {
+                    offsets[0] += width;
+                }
+                else
+                {
+                    offsets[1] += Poly3(-width.a_, -width.b_, -width.c_, -width.d_);
+                }
+            }
+
+            for (int side = 0; side < 2; side++)
+            {
+                findViolations(geometry, offsets[side], startS, startS, endS, intervals[side]);
+            }
+        }
+    }
+
+    bool success = true;
+    for (int side = 0; side < 2; side++)
+    {
+        const BoundaryDirection direction = side == 0 ? BoundaryDirection::LEFT : BoundaryDirection::RIGHT;
+        for (int i = 0; i < static_cast<int>(intervals[side].size());)
+        {
+            double endS = intervals[side][i].second;
+            int j = i + 1;
+            while (j < static_cast<int>(intervals[side].size()) && intervals[side][j].first <= endS + MERGE_EPSILON)
+            {
+                endS = intervals[side][j].second;
+                j++;
+            }
+
+            errors.emplace_back(&road_, intervals[side][i].first, endS, direction);
+            success = false;
+            i = j;
+        }
+    }
+
+    return success;
+}
+
+void RoadWidthValidator::findViolations(const ReferenceLine::Geometry& geometry, const Poly3& offset,
+                                        double pieceStartS, double startS, double endS,
+                                        std::vector<std::pair<double, double>>& intervals) const
+{
+    double minCurvature;
+    double maxCurvature;
+    geometry.evalCurvatureBounds(startS, endS, minCurvature, maxCurvature);
+    if (minCurvature == 0 && maxCurvature == 0)
+    {
+        return;
+    }
+
+    const double minOffset = offset.minValueInInterval(startS - pieceStartS, endS - pieceStartS);
+    const double maxOffset = offset.maxValueInInterval(startS - pieceStartS, endS - pieceStartS);
+
+    // The bounds of curvature * offset, which is at least 1 where the boundary folds.
+    // An unbounded curvature times a zero offset gives NaN, which bounds
+    // nothing, so the interval is subdivided then.
+    const double products[] = {minCurvature * minOffset, minCurvature * maxOffset, maxCurvature * minOffset,
+                               maxCurvature * maxOffset};
+    const bool bounded =
+        std::none_of(std::begin(products), std::end(products), [](double product) { return std::isnan(product); });
+    if (bounded && *std::max_element(std::begin(products), std::end(products)) < 1)
+    {
+        return;
+    }
+    if (bounded && *std::min_element(std::begin(products), std::end(products)) >= 1)
+    {
+        intervals.emplace_back(startS, endS);
+        return;
+    }
+
+    const double midS = (startS + endS) / 2;
+    if (endS - startS <= resolution_)
+    {
+        if (geometry.evalCurvature(midS) * offset.eval(midS - pieceStartS) >= 1)
+        {
+            intervals.emplace_back(startS, endS);
+        }
+        return;
+    }
+
+    findViolations(geometry, offset, pieceStartS, startS, midS, intervals);
+    findViolations(geometry, offset, pieceStartS, midS, endS, intervals);
+}
+
+bool validateRoadWidths(const XodrMap& map, double resolution, std::vector<RoadTooWideViolation>& errors)
+{
+    bool success = true;
+    for (const Road& road : map.roads())
+    {
+        success &= RoadWidthValidator(road, resolution).validateRoadWidth(errors);
+    }
+    return success;
+}
+
+std::string NegativeLaneWidthViolation::description(const XodrMap& map) const
+{
+    const Road& road = map.roads()[laneKey_.roadIdx_];
+    const LaneSection& laneSection = road.laneSections()[laneKey_.laneSectionIdx_];
+    const LaneSection::WidthPoly3& poly = laneSection.lanes()[laneKey_.laneIdx_].widthPoly3s()[widthIdx_];
+
+    std::stringstream desc;
+    desc << "The width of lane " << laneSection.laneIndexToId(laneKey_.laneIdx_) << " of [road: '" << road.id()
+         << "', lane section: " << laneKey_.laneSectionIdx_ << "] becomes negative (" << minWidth_
+         << ") in the interval of the width polynomial with sOffset = " << poly.sOffset() << ".";
+    return desc.str();
+}
+
+bool validateRoadLaneWidths(const XodrMap& map, int roadIdx, std::vector<NegativeLaneWidthViolation>& errors)
+{
+    bool success = true;
+    const Road& road = map.roads()[roadIdx];
+    for (int sectionIdx = 0; sectionIdx < static_cast<int>(road.laneSections().size()); sectionIdx++)
+    {
+        const LaneSection& laneSection = road.laneSections()[sectionIdx];
+        const double sectionLength = laneSection.endS() - laneSection.startS();
+        for (int laneIdx = 0; laneIdx < static_cast<int>(laneSection.lanes().size()); laneIdx++)
+        {
+            const std::vector<LaneSection::WidthPoly3>& polys = laneSection.lanes()[laneIdx].widthPoly3s();
+            for (int i = 0; i < static_cast<int>(polys.size()); i++)
+            {
+                const double length =
+                    (i + 1 < static_cast<int>(polys.size()) ? polys[i + 1].sOffset() : sectionLength) -
+                    polys[i].sOffset();
+                if (length < 0)
+                {
+                    continue;
+                }
+
+                const double minWidth = polys[i].poly3().minValueInInterval(0, length);
+                if (minWidth < 0)
+                {
+                    errors.emplace_back(LaneKey(roadIdx, sectionIdx, laneIdx), i, minWidth);
+                    success = false;
+                }
+            }
+        }
+    }
+    return success;
+}
+
+bool validateLaneWidths(const XodrMap& map, std::vector<NegativeLaneWidthViolation>& errors)
+{
+    bool success = true;
+    for (int roadIdx = 0; roadIdx < static_cast<int>(map.roads().size()); roadIdx++)
+    {
+        success &= validateRoadLaneWidths(map, roadIdx, errors);
+    }
+    return success;
+}
+
+}}  // namespace aid::xodr
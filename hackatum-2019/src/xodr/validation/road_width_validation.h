@@ -0,0 +1,215 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "road.h"
+#include "xodr_map_keys.h"
+
+namespace aid { namespace xodr {
+
+class XodrMap;
+
+/**
+ * @brief The side of a road.
+ */
+enum class BoundaryDirection
+{
+    LEFT,
+    RIGHT
+};
+
+/**
+ * @brief A violation indicating that a road is wider than the radius of
+ * curvature of its reference line, on the inner side of a curve.
+ *
+ * On such a section, the outer boundary of the road on the given side folds
+ * over itself, so it runs backwards and forms a loop.
+ */
+class RoadTooWideViolation
+{
+  public:
+    /**
+     * @brief Creates a violation.
+     *
+     * @param road          The road.
+     * @param startS        The start of the s-interval of the violation.
+     * @param endS          The end of the s-interval of the violation.
+     * @param direction     The side of the road which is too wide.
+     */
+    RoadTooWideViolation(const Road* road, double startS, double endS, BoundaryDirection direction)
+        : road_(road), startS_(startS), endS_(endS), direction_(direction)
+    {
+    }
+
+    /**
+     * @brief Provides a human readable description of this violation.
+     *
+     * @return              The error message.
+     */
+    std::string description() const;
+
+    /**
+     * @brief The road.
+     */
+    const Road* road_;
+
+    /**
+     * @brief The start of the s-interval of the violation.
+     */
+    double startS_;
+
+    /**
+     * @brief The end of the s-interval of the violation.
+     */
+    double endS_;
+
+    /**
+     * @brief The side of the road which is too wide.
+     */
+    BoundaryDirection direction_;
+};
+
+/**
+ * @brief Validates that the outer boundaries of a road don't fold over
+ * themselves.
+ *
+ * The outer boundary on a side of the road folds where its offset t from the
+ * reference line reaches the radius of curvature on that side, i.e. where
+ * curvature * t >= 1.
+ *
+ * The road is split into pieces on which the reference line geometry, the
+ * lane section and the width polynomials of all lanes are fixed, so the offset
+ * of each outer boundary is a single cubic polynomial. Each piece is checked
+ * with the exact bounds of that polynomial (see Poly3::minValueInInterval())
+ * and the curvature bounds of the geometry (see
+ * ReferenceLine::Geometry::evalCurvatureBounds()). Pieces whose bounds are
+ * inconclusive are bisected down to the resolution, so straight roads and
+ * roads far from the limit are validated in one step per piece, without
+ * sampling.
+ */
+class RoadWidthValidator
+{
+  public:
+    /**
+     * @brief Creates a validator for a road.
+     *
+     * @param road          The road, which must outlive the validator.
+     * @param resolution    The length in s below which inconclusive
+     *                      intervals are decided by their midpoint, which is
+     *                      the accuracy of the ends of the violations.
+     */
+    RoadWidthValidator(const Road& road, double resolution);
+
+    /**
+     * @brief Validates the road.
+     *
+     * Adjacent violating intervals on the same side are merged into one
+     * violation, also across geometries and lane sections.
+     *
+     * @param errors        The vector to which violations will be appended.
+     * @returns             True if validation succeeded, false if there was at
+     *                      least a single violation.
+     */
+    bool validateRoadWidth(std::vector<RoadTooWideViolation>& errors) const;
+
+  private:
+    /**
+     * @brief Finds the violating intervals within [startS, endS] of a piece.
+     *
+     * @param geometry      The geometry of the piece.
+     * @param offset        The offset of the outer boundary, as a polynomial
+     *                      in s - pieceStartS.
+     * @param pieceStartS   The start of the piece.
+     * @param startS        The start of the interval.
+     * @param endS          The end of the interval.
+     * @param intervals     The vector to which violating intervals are appended.
+     */
+    void findViolations(const ReferenceLine::Geometry& geometry, const Poly3& offset, double pieceStartS,
+                        double startS, double endS, std::vector<std::pair<double, double>>& intervals) const;
+
+    const Road& road_;
+    double resolution_;
+};
+
+/**
+ * @brief Validates the widths of all roads of a map, see RoadWidthValidator.
+ *
+ * @param map           The XodrMap to validate.
+ * @param resolution    See RoadWidthValidator::RoadWidthValidator().
+ * @param errors        The vector to which violations will be appended.
+ * @returns             True if validation succeeded, false if there was at
+ *                      least a single violation.
+ */
+bool validateRoadWidths(const XodrMap& map, double resolution, std::vector<RoadTooWideViolation>& errors);
+
+/**
+ * @brief A violation indicating that a width polynomial of a lane becomes
+ * negative within its interval.
+ */
+class NegativeLaneWidthViolation
+{
+  public:
+    /**
+     * @brief Creates a violation.
+     *
+     * @param laneKey       The key of the lane.
+     * @param widthIdx      The index of the width polynomial in Lane::widthPoly3s().
+     * @param minWidth      The minimum of the width polynomial within its interval.
+     */
+    NegativeLaneWidthViolation(LaneKey laneKey, int widthIdx, double minWidth)
+        : laneKey_(laneKey), widthIdx_(widthIdx), minWidth_(minWidth)
+    {
+    }
+
+    /**
+     * @brief Provides a human readable description of this violation.
+     *
+     * @param map           The XodrMap to which this violation applies.
+     * @return              The error message.
+     */
+    std::string description(const XodrMap& map) const;
+
+    /**
+     * @brief The key of the lane.
+     */
+    LaneKey laneKey_;
+
+    /**
+     * @brief The index of the width polynomial in Lane::widthPoly3s().
+     */
+    int widthIdx_;
+
+    /**
+     * @brief The minimum of the width polynomial within its interval.
+     */
+    double minWidth_;
+};
+
+/**
+ * @brief Validates that the widths of all lanes of a map are non-negative.
+ *
+ * Each width polynomial is bounded exactly over its interval, which reaches
+ * from its sOffset to the sOffset of the next one or the end of the lane
+ * section, see Poly3::minValueInInterval().
+ *
+ * @param map           The XodrMap to validate.
+ * @param errors        The vector to which violations will be appended.
+ * @returns             True if validation succeeded, false if there was at
+ *                      least a single violation.
+ */
+bool validateLaneWidths(const XodrMap& map, std::vector<NegativeLaneWidthViolation>& errors);
+
+/**
+ * @brief Validates that the widths of all lanes of a single road are
+ * non-negative, see validateLaneWidths().
+ *
+ * @param map           The XodrMap to validate.
+ * @param roadIdx       The index of the road.
+ * @param errors        The vector to which violations will be appended.
+ * @returns             True if validation succeeded, false if there was at
+ *                      least a single violation.
+ */
+bool validateRoadLaneWidths(const XodrMap& map, int roadIdx, std::vector<NegativeLaneWidthViolation>& errors);
+
+}}  // namespace aid::xodr
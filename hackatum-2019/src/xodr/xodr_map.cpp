@@ -1,8 +1,10 @@
 #include "xodr_map.h"
-#include "validation/road_link_validation.h"
-#include "validation/junction_validation.h"
+#include "validation/map_validator.h"
 #include "xml/xml_child_element_parsers.h"
 
+#include <sstream>
+#include <stdexcept>
+
 namespace aid { namespace xodr {
 
 XodrParseResult<XodrMap> XodrMap::fromFile(const std::string& fileName)
@@ -213,18 +215,17 @@ bool XodrMap::hasRoadObjects() const
 
 void XodrMap::validate() const
 {
-    for (const Road& road : roads_)
-    {
-        road.validate();
-    }
-
-    validateJunctionMembership(*this);
-
-    std::vector<std::unique_ptr<LinkValidationError>> errors;
-    validateLinks(*this, errors);
-    if (!errors.empty())
+    const MapValidator validator = MapValidator::structural();
+    const ValidationReport report = validator.run(*this);
+    if (!report.success())
     {
-        throw std::runtime_error("Link validation failed. Run the link validator for exact error messages.");
+        std::stringstream err;
+        err << "Validation failed with " << report.errors_.size() << " error(s):";
+        for (const ValidationReport::Error& error : report.errors_)
+        {
+            err << "\n[" << report.validators_[error.validatorIdx_].name_ << "] " << error.message_;
+        }
+        throw std::runtime_error(err.str());
     }
 }
 
@@ -152,9 +152,11 @@ class XodrMap
     /**
      * @brief Validates this XodrMap.
      *
-     * This function calls all the validation functions.
+     * This function runs the validators of MapValidator::structural() in a
+     * single pass over the map.
      *
-     * An exception is thrown if validation doesn't pass.
+     * An exception is thrown if validation doesn't pass, whose message lists
+     * all errors. Use MapValidator::run() directly for a structured report.
      */
     void validate() const;
 
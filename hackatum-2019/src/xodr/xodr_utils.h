@@ -45,6 +45,22 @@ void forEachRoadLink(const XodrMap& map, F&& f);
 template <class RoadRoadF, class JunctionRoadF>
 void forEachRoadLink(const XodrMap& map, RoadRoadF&& roadRoadF, JunctionRoadF&& junctionRoadF);
 
+/**
+ * @brief Loops over the road links which forEachRoadLink() visits while
+ * processing the given road.
+ *
+ * Every road link visited by forEachRoadLink() is visited by exactly one call
+ * of this function, and forEachRoadLink() is the same as calling it for all
+ * roads in index order. The callbacks are the same as for forEachRoadLink().
+ *
+ * @param map               The XodrMap.
+ * @param roadIdx           The index of the road.
+ * @param roadRoadF         The callback which is called for each normal road link.
+ * @param junctionRoadF     The callback which is called for each junction road link.
+ */
+template <class RoadRoadF, class JunctionRoadF>
+void forEachRoadLinkFrom(const XodrMap& map, int roadIdx, RoadRoadF&& roadRoadF, JunctionRoadF&& junctionRoadF);
+
 }}  // namespace aid::xodr
 
 #include "xodr_utils_impl.h"
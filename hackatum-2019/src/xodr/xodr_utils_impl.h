@@ -46,59 +46,64 @@ void forEachRoadLink(const XodrMap& map, RoadRoadF&& roadRoadF, JunctionRoadF&&
     //     make sure the pair is handled only once (connectivity information
     //     is available in both directions).
 
-    const auto& roads = map.roads();
-    for (int roadIdx = 0; roadIdx < static_cast<int>(roads.size()); roadIdx++)
+    for (int roadIdx = 0; roadIdx < static_cast<int>(map.roads().size()); roadIdx++)
     {
-        const Road& road = roads[roadIdx];
+        forEachRoadLinkFrom(map, roadIdx, roadRoadF, junctionRoadF);
+    }
+}
+
+template <class RoadRoadF, class JunctionRoadF>
+void forEachRoadLinkFrom(const XodrMap& map, int roadIdx, RoadRoadF&& roadRoadF, JunctionRoadF&& junctionRoadF)
+{
+    const Road& road = map.roads()[roadIdx];
 
-        for (const RoadLinkType roadLinkType : {RoadLinkType::PREDECESSOR, RoadLinkType::SUCCESSOR})
+    for (const RoadLinkType roadLinkType : {RoadLinkType::PREDECESSOR, RoadLinkType::SUCCESSOR})
+    {
+        const RoadLink& roadLink = road.roadLink(roadLinkType);
+        switch (roadLink.elementType())
         {
-            const RoadLink& roadLink = road.roadLink(roadLinkType);
-            switch (roadLink.elementType())
+            default:
+                assert(!"Invalid element type");
+
+            case RoadLink::ElementType::ROAD:
             {
-                default:
-                    assert(!"Invalid element type");
+                int otherRoadIdx = roadLink.elementRef().index();
 
-                case RoadLink::ElementType::ROAD:
+                // See the comment block at the beginning of forEachRoadLink() for
+                // the reason for this check.
+                if (road.junctionRef().hasValue() || roadIdx < otherRoadIdx)
                 {
-                    int otherRoadIdx = roadLink.elementRef().index();
-
-                    // See the comment block at the beginning of this function for the
-                    // reason for this check.
-                    if (road.junctionRef().hasValue() || roadIdx < otherRoadIdx)
-                    {
-                        RoadContactPointKey fromKey(roadIdx, contactPointForLinkType(roadLinkType));
-                        RoadContactPointKey toKey(otherRoadIdx, roadLink.contactPoint());
-                        roadRoadF(fromKey, toKey);
-                    }
+                    RoadContactPointKey fromKey(roadIdx, contactPointForLinkType(roadLinkType));
+                    RoadContactPointKey toKey(otherRoadIdx, roadLink.contactPoint());
+                    roadRoadF(fromKey, toKey);
                 }
-                break;
+            }
+            break;
 
-                case RoadLink::ElementType::JUNCTION:
+            case RoadLink::ElementType::JUNCTION:
+            {
+                // See the comment block at the beginning of forEachRoadLink() for
+                // the reason for this check.
+                if (road.junctionRef().hasValue())
                 {
-                    // See the comment block at the beginning of this function for the
-                    // reason for this check.
-                    if (road.junctionRef().hasValue())
-                    {
-                        int junctionIdx = roadLink.elementRef().index();
-                        const Junction& junction = map.junctions()[junctionIdx];
+                    int junctionIdx = roadLink.elementRef().index();
+                    const Junction& junction = map.junctions()[junctionIdx];
 
-                        for (const Junction::Connection& connection : junction.connections())
+                    for (const Junction::Connection& connection : junction.connections())
+                    {
+                        if (connection.incomingRoad().index() == roadIdx)
                         {
-                            if (connection.incomingRoad().index() == roadIdx)
-                            {
-                                RoadContactPointKey fromKey(roadIdx, contactPointForLinkType(roadLinkType));
-                                RoadContactPointKey toKey(connection.connectingRoad().index(), roadLink.contactPoint());
-                                junctionRoadF(fromKey, toKey, connection);
-                            }
+                            RoadContactPointKey fromKey(roadIdx, contactPointForLinkType(roadLinkType));
+                            RoadContactPointKey toKey(connection.connectingRoad().index(), roadLink.contactPoint());
+                            junctionRoadF(fromKey, toKey, connection);
                         }
                     }
                 }
-                break;
-
-                case RoadLink::ElementType::NOT_SPECIFIED:
-                    break;
             }
+            break;
+
+            case RoadLink::ElementType::NOT_SPECIFIED:
+                break;
         }
     }
 }
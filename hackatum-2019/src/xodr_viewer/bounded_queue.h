@@ -0,0 +1,93 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief A blocking FIFO queue with a fixed capacity, used to connect the
+ * stages of a pipeline running on different threads.
+ *
+ * Producers block while the queue is full, so a fast producer can't run
+ * arbitrarily far ahead of a slow consumer.
+ */
+template <typename T>
+class BoundedQueue
+{
+  public:
+    /**
+     * @brief Constructs an empty queue.
+     *
+     * @param capacity      The maximum number of items in the queue.
+     */
+    explicit BoundedQueue(size_t capacity) : capacity_(capacity) {}
+
+    /**
+     * @brief Appends an item to the queue, blocking while the queue is full.
+     *
+     * Items pushed after close() was called are discarded.
+     *
+     * @param item          The item to append.
+     */
+    void push(T item)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notFull_.wait(lock, [this] { return items_.size() < capacity_ || closed_; });
+        if (closed_)
+        {
+            return;
+        }
+
+        items_.push_back(std::move(item));
+        notEmpty_.notify_one();
+    }
+
+    /**
+     * @brief Removes the first item from the queue, blocking while the queue
+     * is empty and not closed.
+     *
+     * @param item          Receives the removed item.
+     * @returns             True if an item was removed, false if the queue
+     *                      is closed and empty.
+     */
+    bool pop(T& item)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notEmpty_.wait(lock, [this] { return !items_.empty() || closed_; });
+        if (items_.empty())
+        {
+            return false;
+        }
+
+        item = std::move(items_.front());
+        items_.pop_front();
+        notFull_.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Closes the queue.
+     *
+     * Consumers still receive the remaining items, after which pop() returns
+     * false.
+     */
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        notEmpty_.notify_all();
+        notFull_.notify_all();
+    }
+
+  private:
+    std::mutex mutex_;
+    std::condition_variable notFull_;
+    std::condition_variable notEmpty_;
+    std::deque<T> items_;
+    size_t capacity_;
+    bool closed_ = false;
+};
+
+}}  // namespace aid::xodr
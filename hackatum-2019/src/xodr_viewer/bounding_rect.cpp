@@ -1,6 +1,7 @@
 #include "bounding_rect.h"
 
 #include <cfloat>
+#include <cmath>
 
 namespace aid { namespace xodr {
 
@@ -13,6 +14,50 @@ void BoundingRect::expand(Eigen::Vector2d pt)
     if (pt.y() > max_.y()) max_.y() = pt.y();
 }
 
+void BoundingRect::expand(const BoundingRect& rect)
+{
+    expand(rect.min_);
+    expand(rect.max_);
+}
+
+void BoundingRect::grow(double margin)
+{
+    min_ -= Eigen::Vector2d(margin, margin);
+    max_ += Eigen::Vector2d(margin, margin);
+}
+
+BoundingRect geometryBoundingRect(const ReferenceLine::Geometry& geometry)
+{
+    Eigen::Vector2d a = geometry.startVertex().position_;
+    Eigen::Vector2d b = geometry.endVertex().position_;
+
+    Eigen::Vector2d center = (a + b) / 2;
+    Eigen::Vector2d axis = b - a;
+    double focalDist = axis.norm() / 2;
+
+    // The semi-axes of the ellipse. The length can be slightly smaller than
+    // the chord due to rounding, hence the max.
+    double major = std::max(geometry.length() / 2, focalDist);
+    double minor = std::sqrt(major * major - focalDist * focalDist);
+
+    double cosAngle = 1;
+    double sinAngle = 0;
+    if (focalDist > 0)
+    {
+        cosAngle = axis.x() / (2 * focalDist);
+        sinAngle = axis.y() / (2 * focalDist);
+    }
+
+    Eigen::Vector2d halfExtent(
+        std::sqrt(major * major * cosAngle * cosAngle + minor * minor * sinAngle * sinAngle),
+        std::sqrt(major * major * sinAngle * sinAngle + minor * minor * cosAngle * cosAngle));
+
+    BoundingRect ret;
+    ret.min_ = center - halfExtent;
+    ret.max_ = center + halfExtent;
+    return ret;
+}
+
 BoundingRect xodrMapApproxBoundingRect(const XodrMap& xodrMap)
 {
     BoundingRect ret;
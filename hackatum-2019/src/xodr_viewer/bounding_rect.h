@@ -28,8 +28,35 @@ struct BoundingRect
      * @param pt            The point to expand this BoundingRect by.
      */
     void expand(Eigen::Vector2d pt);
+
+    /**
+     * @brief Expands the bounding rect to include the given bounding rect.
+     *
+     * @param rect          The BoundingRect to expand this BoundingRect by.
+     */
+    void expand(const BoundingRect& rect);
+
+    /**
+     * @brief Grows the bounding rect by the given margin on all sides.
+     *
+     * @param margin        The margin.
+     */
+    void grow(double margin);
 };
 
+/**
+ * @brief Computes a conservative bounding rectangle of the given reference
+ * line geometry, without tessellating it.
+ *
+ * Any point on a curve of length L between the points a and b has a distance
+ * sum to a and b of at most L, so the curve lies within the ellipse with
+ * foci a and b and major axis L. The bounding rect of that ellipse is returned.
+ *
+ * @param geometry          The geometry.
+ * @returns                 The bounding rect.
+ */
+BoundingRect geometryBoundingRect(const ReferenceLine::Geometry& geometry);
+
 /**
  * @brief Computes an approximation of the bounding rectangle of the given
  * xodrMap.
@@ -0,0 +1,81 @@
+#include "map_geometry.h"
+
+#include <algorithm>
+
+namespace aid { namespace xodr {
+
+std::vector<SectionGeometry> tessellateSections(TessellationCache& tessellationCache,
+                                                const std::function<bool(int, int)>& progress)
+{
+    std::vector<SectionGeometry> ret;
+
+    const std::vector<Road>& roads = tessellationCache.map().roads();
+    for (int roadIdx = 0; roadIdx < static_cast<int>(roads.size()); roadIdx++)
+    {
+        const Road& road = roads[roadIdx];
+
+        const std::vector<LaneSection>& laneSections = road.laneSections();
+        for (int laneSectionIdx = 0; laneSectionIdx < static_cast<int>(laneSections.size()); laneSectionIdx++)
+        {
+            const LaneSection& laneSection = laneSections[laneSectionIdx];
+            const auto& lanes = laneSection.lanes();
+            const int numLanes = static_cast<int>(lanes.size());
+            if (numLanes == 0)
+            {
+                continue;
+            }
+
+            auto tessellation = tessellationCache.get(LaneSectionKey(roadIdx, laneSectionIdx));
+            const auto& boundaries = tessellation->boundaries_;
+
+            SectionGeometry section;
+            bool hasBounds = false;
+
+            for (int i = 0; i < static_cast<int>(boundaries.size()); i++)
+            {
+                QPolygonF polyline;
+                polyline.reserve(static_cast<int>(boundaries[i].vertices_.size()));
+                for (const Eigen::Vector2d& pt : boundaries[i].vertices_)
+                {
+                    polyline.append(QPointF(pt.x(), pt.y()));
+                }
+
+                if (!polyline.isEmpty())
+                {
+                    QRectF polylineBounds = polyline.boundingRect();
+                    section.bounds_ = hasBounds ? section.bounds_.united(polylineBounds) : polylineBounds;
+                    hasBounds = true;
+                }
+
+                section.boundaries_.push_back(std::move(polyline));
+                section.boundaryLaneTypes_.push_back(lanes[std::min(i, numLanes - 1)].type());
+            }
+
+            for (int i = 0; i < numLanes; i++)
+            {
+                if (lanes[i].type() == LaneType::BORDER || lanes[i].type() == LaneType::DRIVING)
+                {
+                    if (section.left_ == -1)
+                    {
+                        section.left_ = i;
+                    }
+                    section.right_ = i;
+                }
+            }
+
+            if (hasBounds)
+            {
+                ret.push_back(std::move(section));
+            }
+        }
+
+        if (progress && !progress(roadIdx + 1, static_cast<int>(roads.size())))
+        {
+            break;
+        }
+    }
+
+    return ret;
+}
+
+}}  // namespace aid::xodr
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "xodr/tessellation_cache.h"
+#include "xodr/xodr_map.h"
+
+#include <QtCore/QRectF>
+#include <QtGui/QPolygonF>
+
+#include <functional>
+#include <vector>
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief The tessellated lane boundaries of a lane section, in map
+ * coordinates, as drawn by the viewer.
+ */
+struct SectionGeometry
+{
+    /**
+     * @brief The lane boundaries, from left to right.
+     */
+    std::vector<QPolygonF> boundaries_;
+
+    /**
+     * @brief The type of the lane right of each boundary. The outermost right
+     * boundary uses the type of the last lane.
+     */
+    std::vector<LaneType> boundaryLaneTypes_;
+
+    /**
+     * @brief The indices of the boundaries left of the first and last
+     * driving or border lane, or -1 if the lane section has no such lanes.
+     */
+    int left_ = -1;
+    int right_ = -1;
+
+    /**
+     * @brief The bounding rect of all boundaries.
+     */
+    QRectF bounds_;
+};
+
+/**
+ * @brief Tessellates all lane sections of the given map.
+ *
+ * Lane sections without lanes are skipped.
+ *
+ * @param tessellationCache The tessellation cache of the map to tessellate.
+ * @param progress          If set, this is called after each road with the
+ *                          number of roads done and the total number of
+ *                          roads. If it returns false, tessellation stops and
+ *                          the incomplete result is returned.
+ * @returns                 The lane section geometries.
+ */
+std::vector<SectionGeometry> tessellateSections(TessellationCache& tessellationCache,
+                                                const std::function<bool(int, int)>& progress = nullptr);
+
+}}  // namespace aid::xodr
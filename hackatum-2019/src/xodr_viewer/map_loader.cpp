@@ -0,0 +1,168 @@
+#include "map_loader.h"
+
+#include "obj_exporter.h"
+#include "validation/map_validator.h"
+
+#include <exception>
+
+namespace aid { namespace xodr {
+
+MapLoader::MapLoader(ProgressCallback onProgress, FinishedCallback onFinished, bool exportObjFiles)
+    : onProgress_(std::move(onProgress)), onFinished_(std::move(onFinished)), exportObjFiles_(exportObjFiles)
+{
+}
+
+MapLoader::~MapLoader()
+{
+    cancel();
+    for (std::unique_ptr<Job>& job : jobs_)
+    {
+        job->thread_.join();
+    }
+}
+
+int MapLoader::load(const std::string& path)
+{
+    cancel();
+    reapFinishedJobs();
+
+    std::unique_ptr<Job> job(new Job());
+    job->id_ = nextId_++;
+    currentId_ = job->id_;
+
+    Job& jobRef = *job;
+    job->thread_ = std::thread([this, &jobRef, path]() {
+        run(jobRef, path);
+        jobRef.done_ = true;
+    });
+    jobs_.push_back(std::move(job));
+
+    return jobRef.id_;
+}
+
+void MapLoader::cancel()
+{
+    for (std::unique_ptr<Job>& job : jobs_)
+    {
+        job->cancelled_ = true;
+    }
+    currentId_ = 0;
+}
+
+void MapLoader::reapFinishedJobs()
+{
+    for (auto it = jobs_.begin(); it != jobs_.end();)
+    {
+        if ((*it)->done_)
+        {
+            (*it)->thread_.join();
+            it = jobs_.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void MapLoader::run(Job& job, const std::string& path)
+{
+    std::unique_ptr<LoadedMap> ret(new LoadedMap());
+
+    int lastPercent = -1;
+    auto report = [&](int percent, const char* stage) {
+        if (percent != lastPercent)
+        {
+            lastPercent = percent;
+            onProgress_(job.id_, percent, stage);
+        }
+    };
+
+    report(0, "Parsing");
+    try
+    {
+        XodrParseResult<XodrMap> fromFileRes = XodrMap::fromFile(path);
+        if (fromFileRes.hasFatalErrors())
+        {
+            for (const auto& err : fromFileRes.errors())
+            {
+                ret->errors_.push_back(err.description());
+            }
+        }
+        else
+        {
+            ret->xodrMap_.reset(new XodrMap(std::move(fromFileRes.value())));
+        }
+    }
+    catch (const std::exception& e)
+    {
+        ret->errors_.push_back(e.what());
+    }
+
+    if (job.cancelled_)
+    {
+        return;
+    }
+    if (!ret->xodrMap_)
+    {
+        onFinished_(job.id_, std::move(ret));
+        return;
+    }
+
+    const XodrMap& xodrMap = *ret->xodrMap_;
+
+    // The export reuses the tessellations of the viewer.
+    TessellationCache tessellationCache(xodrMap);
+
+    report(30, "Validating");
+    const ValidationReport validationReport = MapValidator::structural().run(xodrMap, 0);
+    for (const ValidationReport::Error& error : validationReport.errors_)
+    {
+        ret->warnings_.push_back(error.message_);
+    }
+
+    if (job.cancelled_)
+    {
+        return;
+    }
+
+    const int tessellationEnd = exportObjFiles_ ? 60 : 100;
+    ret->sections_ = tessellateSections(tessellationCache, [&](int numDone, int numRoads) {
+        report(40 + (tessellationEnd - 40) * numDone / numRoads, "Tessellating");
+        return !job.cancelled_;
+    });
+
+    if (job.cancelled_)
+    {
+        return;
+    }
+
+    if (exportObjFiles_)
+    {
+        report(tessellationEnd, "Exporting");
+        try
+        {
+            ObjExportParams exportParams;
+            exportParams.tessellationCache_ = &tessellationCache;
+            exportParams.isCancelled_ = [&job]() { return job.cancelled_.load(); };
+
+            // A cancelled export still holding the lock stops at its next road.
+            std::lock_guard<std::mutex> lock(exportMutex_);
+            exportObjFiles(xodrMap, exportParams);
+        }
+        catch (const std::exception& e)
+        {
+            ret->warnings_.push_back(e.what());
+        }
+
+        if (job.cancelled_)
+        {
+            return;
+        }
+    }
+
+    report(100, "Done");
+    onFinished_(job.id_, std::move(ret));
+}
+
+}}  // namespace aid::xodr
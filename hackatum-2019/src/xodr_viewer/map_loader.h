@@ -0,0 +1,133 @@
+#pragma once
+
+#include "map_geometry.h"
+#include "xodr/xodr_map.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief A map loaded by the MapLoader, together with its first tessellation.
+ */
+struct LoadedMap
+{
+    /**
+     * @brief The map, or nullptr if loading failed.
+     */
+    std::unique_ptr<XodrMap> xodrMap_;
+
+    std::vector<SectionGeometry> sections_;
+
+    /**
+     * @brief The errors which made loading fail.
+     */
+    std::vector<std::string> errors_;
+
+    /**
+     * @brief Validation and export errors, which don't prevent showing the map.
+     */
+    std::vector<std::string> warnings_;
+};
+
+/**
+ * @brief Loads, validates and tessellates xodr files on background threads.
+ *
+ * Each load runs on its own thread. Starting a new load cancels the current
+ * one: a cancelled load stops at the next stage or road boundary, also
+ * during the OBJ export, and never reports a result. The exports of
+ * different loads write to the same directory, so they run one at a time.
+ * The callbacks are called on the loading threads, so the caller must forward
+ * them to its own thread.
+ */
+class MapLoader
+{
+  public:
+    /**
+     * @brief Called with the load id, the progress in percent and the name of
+     * the current stage. The stage name is a string literal.
+     */
+    using ProgressCallback = std::function<void(int, int, const char*)>;
+
+    /**
+     * @brief Called with the load id and the result once a load is finished.
+     */
+    using FinishedCallback = std::function<void(int, std::unique_ptr<LoadedMap>)>;
+
+    /**
+     * @brief Constructs a MapLoader.
+     *
+     * @param onProgress        The progress callback.
+     * @param onFinished        The finished callback.
+     * @param exportObjFiles    Whether to export each loaded map with
+     *                          exportObjFiles() before reporting it.
+     */
+    MapLoader(ProgressCallback onProgress, FinishedCallback onFinished, bool exportObjFiles = false);
+
+    /**
+     * @brief Cancels all loads and waits for their threads to finish.
+     */
+    ~MapLoader();
+
+    MapLoader(const MapLoader&) = delete;
+    MapLoader& operator=(const MapLoader&) = delete;
+
+    /**
+     * @brief Cancels the current load and starts loading the given file.
+     *
+     * @param path          The path of the xodr file.
+     * @returns             The id of the new load.
+     */
+    int load(const std::string& path);
+
+    /**
+     * @brief Cancels the current load, if any.
+     */
+    void cancel();
+
+    /**
+     * @brief Checks whether the load with the given id is the current one,
+     * that is neither cancelled nor replaced by a newer load.
+     */
+    bool isCurrent(int loadId) const { return loadId == currentId_; }
+
+  private:
+    struct Job
+    {
+        int id_ = 0;
+        std::atomic<bool> cancelled_{false};
+        std::atomic<bool> done_{false};
+        std::thread thread_;
+    };
+
+    /**
+     * @brief Runs the given job on the calling thread.
+     */
+    void run(Job& job, const std::string& path);
+
+    /**
+     * @brief Joins and removes the jobs whose threads are done.
+     */
+    void reapFinishedJobs();
+
+    ProgressCallback onProgress_;
+    FinishedCallback onFinished_;
+    bool exportObjFiles_;
+
+    /**
+     * @brief Held during the OBJ export of a load.
+     */
+    std::mutex exportMutex_;
+
+    std::vector<std::unique_ptr<Job>> jobs_;
+    std::atomic<int> currentId_{0};
+    int nextId_ = 1;
+};
+
+}}  // namespace aid::xodr
@@ -0,0 +1,236 @@
+#include "mesh_optimizer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief The size of the LRU cache modelled by optimizeVertexCache().
+ */
+static constexpr int maxCacheSize = 32;
+
+/**
+ * @brief Computes the score of a vertex for optimizeVertexCache().
+ *
+ * @param cachePos          The position of the vertex in the modelled LRU
+ *                          cache, or -1 if it's not in the cache.
+ * @param remainingValence  The number of triangles using the vertex which
+ *                          haven't been emitted yet.
+ * @returns                 The score.
+ */
+static float vertexScore(int cachePos, int remainingValence)
+{
+    constexpr float cacheDecayPower = 1.5f;
+    constexpr float lastTriScore = 0.75f;
+    constexpr float valenceBoostScale = 2.0f;
+    constexpr float valenceBoostPower = 0.5f;
+
+    if (remainingValence == 0)
+    {
+        // The vertex isn't used by any remaining triangle.
+        return -1.0f;
+    }
+
+    float score = 0;
+    if (cachePos >= 0)
+    {
+        if (cachePos < 3)
+        {
+            // The vertex was used by the last triangle. Its score is fixed,
+            // such that there's no preference on how the next triangle shares
+            // vertices with the last one.
+            score = lastTriScore;
+        }
+        else
+        {
+            const float scaler = 1.0f / (maxCacheSize - 3);
+            score = std::pow(1.0f - (cachePos - 3) * scaler, cacheDecayPower);
+        }
+    }
+
+    // Boost vertices with few remaining triangles, so lone triangles are not
+    // left behind.
+    score += valenceBoostScale * std::pow(static_cast<float>(remainingValence), -valenceBoostPower);
+
+    return score;
+}
+
+VertexCacheStats simulateVertexCache(const TriangleMesh& mesh, int cacheSize)
+{
+    VertexCacheStats ret;
+    ret.numTriangles_ = mesh.numTriangles();
+
+    // A vertex is in the FIFO cache if fewer than cacheSize misses happened
+    // since it was inserted.
+    std::vector<long> insertedAt(mesh.vertices_.size(), 0);
+    long time = cacheSize + 1;
+
+    for (int idx : mesh.indices_)
+    {
+        if (time - insertedAt[idx] > cacheSize)
+        {
+            insertedAt[idx] = time++;
+            ret.numMisses_++;
+        }
+    }
+
+    return ret;
+}
+
+void optimizeVertexCache(TriangleMesh& mesh)
+{
+    const int numVertices = static_cast<int>(mesh.vertices_.size());
+    const int numTriangles = mesh.numTriangles();
+    const std::vector<int>& indices = mesh.indices_;
+
+    if (numTriangles == 0)
+    {
+        return;
+    }
+
+    // The triangles using each vertex, in CSR form.
+    std::vector<int> valences(numVertices, 0);
+    for (int idx : indices)
+    {
+        valences[idx]++;
+    }
+
+    std::vector<int> adjacencyOffsets(numVertices + 1, 0);
+    for (int v = 0; v < numVertices; v++)
+    {
+        adjacencyOffsets[v + 1] = adjacencyOffsets[v] + valences[v];
+    }
+
+    std::vector<int> adjacency(indices.size());
+    {
+        std::vector<int> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (int t = 0; t < numTriangles; t++)
+        {
+            for (int k = 0; k < 3; k++)
+            {
+                adjacency[fill[indices[3 * t + k]]++] = t;
+            }
+        }
+    }
+
+    std::vector<int> cachePositions(numVertices, -1);
+    std::vector<float> vertexScores(numVertices);
+    for (int v = 0; v < numVertices; v++)
+    {
+        vertexScores[v] = vertexScore(-1, valences[v]);
+    }
+
+    std::vector<float> triangleScores(numTriangles);
+    std::vector<bool> emitted(numTriangles, false);
+    for (int t = 0; t < numTriangles; t++)
+    {
+        triangleScores[t] = vertexScores[indices[3 * t]] + vertexScores[indices[3 * t + 1]] +
+                            vertexScores[indices[3 * t + 2]];
+    }
+
+    int bestTriangle = static_cast<int>(std::max_element(triangleScores.begin(), triangleScores.end()) -
+                                        triangleScores.begin());
+    int nextUnemitted = 0;
+
+    std::vector<int> cache;
+    std::vector<int> newCache;
+    cache.reserve(maxCacheSize + 3);
+    newCache.reserve(maxCacheSize + 3);
+
+    std::vector<int> newIndices;
+    newIndices.reserve(indices.size());
+
+    for (int i = 0; i < numTriangles; i++)
+    {
+        if (bestTriangle < 0)
+        {
+            // None of the triangles around the cached vertices remain, so
+            // continue with any remaining triangle.
+            while (emitted[nextUnemitted])
+            {
+                nextUnemitted++;
+            }
+            bestTriangle = nextUnemitted;
+        }
+
+        const int* tri = &indices[3 * bestTriangle];
+        newIndices.insert(newIndices.end(), tri, tri + 3);
+        emitted[bestTriangle] = true;
+
+        // Move the triangle's vertices to the front of the cache.
+        newCache.assign(tri, tri + 3);
+        for (int k = 0; k < 3; k++)
+        {
+            valences[tri[k]]--;
+        }
+        for (int v : cache)
+        {
+            if (v != tri[0] && v != tri[1] && v != tri[2])
+            {
+                newCache.push_back(v);
+            }
+        }
+
+        for (int pos = 0; pos < static_cast<int>(newCache.size()); pos++)
+        {
+            int v = newCache[pos];
+            cachePositions[v] = pos < maxCacheSize ? pos : -1;
+            vertexScores[v] = vertexScore(cachePositions[v], valences[v]);
+        }
+
+        // Rescore the remaining triangles around the vertices whose scores
+        // changed, and pick the best of them as the next triangle.
+        bestTriangle = -1;
+        float bestScore = -1;
+        for (int v : newCache)
+        {
+            for (int a = adjacencyOffsets[v]; a < adjacencyOffsets[v + 1]; a++)
+            {
+                int t = adjacency[a];
+                if (emitted[t])
+                {
+                    continue;
+                }
+
+                float score = vertexScores[indices[3 * t]] + vertexScores[indices[3 * t + 1]] +
+                              vertexScores[indices[3 * t + 2]];
+                triangleScores[t] = score;
+                if (score > bestScore)
+                {
+                    bestScore = score;
+                    bestTriangle = t;
+                }
+            }
+        }
+
+        if (static_cast<int>(newCache.size()) > maxCacheSize)
+        {
+            newCache.resize(maxCacheSize);
+        }
+        std::swap(cache, newCache);
+    }
+
+    mesh.indices_ = std::move(newIndices);
+}
+
+void optimizeVertexFetch(TriangleMesh& mesh)
+{
+    std::vector<int> remap(mesh.vertices_.size(), -1);
+    std::vector<Eigen::Vector3d> newVertices;
+    newVertices.reserve(mesh.vertices_.size());
+
+    for (int& idx : mesh.indices_)
+    {
+        if (remap[idx] < 0)
+        {
+            remap[idx] = static_cast<int>(newVertices.size());
+            newVertices.push_back(mesh.vertices_[idx]);
+        }
+        idx = remap[idx];
+    }
+
+    mesh.vertices_ = std::move(newVertices);
+}
+
+}}  // namespace aid::xodr
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "triangle_mesh.h"
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief The result of simulating a GPU post-transform vertex cache on the
+ * index buffer of a mesh.
+ */
+struct VertexCacheStats
+{
+    /**
+     * @brief The number of triangles processed.
+     */
+    long numTriangles_ = 0;
+
+    /**
+     * @brief The number of vertices which weren't in the cache when referenced.
+     */
+    long numMisses_ = 0;
+
+    /**
+     * @brief Gets the average cache miss ratio (ACMR), that is the number of
+     * vertex shader invocations per triangle.
+     *
+     * The ACMR lies between ~0.5 for an ideal ordering of a regular grid and
+     * 3 for an ordering without any vertex reuse.
+     */
+    double acmr() const { return numTriangles_ > 0 ? static_cast<double>(numMisses_) / numTriangles_ : 0; }
+
+    /**
+     * @brief Adds the counts of the given stats to these stats.
+     */
+    void add(const VertexCacheStats& stats)
+    {
+        numTriangles_ += stats.numTriangles_;
+        numMisses_ += stats.numMisses_;
+    }
+};
+
+/**
+ * @brief Simulates a FIFO post-transform vertex cache of the given size on
+ * the index buffer of the given mesh.
+ *
+ * @param mesh          The mesh.
+ * @param cacheSize     The number of entries of the simulated cache.
+ * @returns             The resulting stats.
+ */
+VertexCacheStats simulateVertexCache(const TriangleMesh& mesh, int cacheSize = 16);
+
+/**
+ * @brief Reorders the triangles of the given mesh for post-transform vertex
+ * cache locality.
+ *
+ * This implements Tom Forsyth's "Linear-Speed Vertex Cache Optimisation":
+ * triangles are emitted greedily by a score, which favours vertices that are
+ * recently used and vertices with few remaining triangles. The winding of
+ * the triangles is preserved.
+ *
+ * @param mesh          The mesh to reorder.
+ */
+void optimizeVertexCache(TriangleMesh& mesh);
+
+/**
+ * @brief Reorders the vertices of the given mesh in the order in which they
+ * are first referenced by the index buffer, for vertex fetch locality.
+ *
+ * Vertices which aren't referenced by any triangle are removed.
+ *
+ * @param mesh          The mesh to reorder.
+ */
+void optimizeVertexFetch(TriangleMesh& mesh);
+
+}}  // namespace aid::xodr
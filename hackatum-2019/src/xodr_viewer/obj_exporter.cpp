@@ -0,0 +1,887 @@
+#include "obj_exporter.h"
+
+#include "bounded_queue.h"
+#include "bounding_rect.h"
+#include "mesh_optimizer.h"
+#include "terrain.h"
+#include "terrain_mesher.h"
+#include "triangle_mesh.h"
+
+#include <atomic>
+#include <cfloat>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+namespace aid { namespace xodr {
+
+constexpr double driving_elevation = 0.2;
+constexpr double sidewalk_elevation = 0.4;
+constexpr double border_elevation = 0.45;
+constexpr double road_markings_shift = 0.2;
+
+constexpr double road_markings_width = 0.25;
+constexpr double road_markings_elevation = 0.25;
+constexpr int road_markings_stripe_length = 3;
+constexpr int road_markings_stripe_distance = 3;
+
+constexpr double padding = 300;
+
+/**
+ * @brief The distance around the road surface in which the terrain mesh uses
+ * the tighter road error bound.
+ */
+constexpr double road_corridor_width = 10;
+
+/**
+ * @brief The distance over which the terrain is blended from the road
+ * elevation back to the generated terrain height.
+ */
+constexpr double terrain_blend_distance = 40;
+
+/**
+ * @brief The number of road surface points which are collected before they
+ * are fitted into the terrain.
+ */
+constexpr size_t road_point_batch_size = 1 << 16;
+
+/**
+ * @brief The memory budget of the tessellation cache which the export creates
+ * if none is given. Each lane section is only requested once, so the cache
+ * doesn't need to hold more than the roads in flight.
+ */
+constexpr size_t export_cache_memory_budget = 16 * 1024 * 1024;
+
+/**
+ * @brief A strip between two lane boundaries which is exported as a mesh.
+ */
+struct LaneStrip
+{
+    LaneSection::BoundaryCurveTessellation left_;
+    LaneSection::BoundaryCurveTessellation right_;
+    double elevation_;
+
+    /**
+     * @brief The road elevation at each vertex, or empty if the road has no
+     * elevation profile.
+     */
+    std::vector<double> heights_;
+};
+
+/**
+ * @brief The exported geometry of a single road, which is passed from the
+ * tessellation thread to the writer thread.
+ */
+struct RoadExportChunk
+{
+    std::vector<TriangleMesh> streets_;
+    std::vector<TriangleMesh> sidewalks_;
+    std::vector<TriangleMesh> borders_;
+    std::vector<TriangleMesh> markings_;
+
+    /**
+     * @brief The sidewalk orientation vectors, as pairs of consecutive points.
+     */
+    std::vector<Eigen::Vector3d> streetGeo_;
+
+    /**
+     * @brief The driving lane orientation vectors, as pairs of consecutive points.
+     */
+    std::vector<Eigen::Vector3d> streetLanes_;
+};
+
+/**
+ * @brief The files of an export, which are written with the suffix .part and
+ * only get their final names in commit(). Files which weren't committed are
+ * removed on destruction.
+ */
+class ExportFiles
+{
+  public:
+    explicit ExportFiles(std::string outDir) : outDir_(std::move(outDir)) {}
+
+    ~ExportFiles()
+    {
+        if (!committed_)
+        {
+            for (const std::string& name : names_)
+            {
+                std::remove(partPath(name).c_str());
+            }
+        }
+    }
+
+    /**
+     * @brief Adds a file and gets the path to write it to.
+     */
+    std::string add(const std::string& name)
+    {
+        names_.push_back(name);
+        return partPath(name);
+    }
+
+    /**
+     * @brief Renames all files to their final names, replacing existing
+     * files. The files must be closed.
+     */
+    void commit()
+    {
+        for (const std::string& name : names_)
+        {
+            const std::string path = outDir_ + "/" + name;
+            if (std::rename(partPath(name).c_str(), path.c_str()) != 0)
+            {
+                throw std::runtime_error("Could not write " + path + ".");
+            }
+        }
+        committed_ = true;
+    }
+
+  private:
+    std::string partPath(const std::string& name) const { return outDir_ + "/" + name + ".part"; }
+
+    std::string outDir_;
+    std::vector<std::string> names_;
+    bool committed_ = false;
+};
+
+/**
+ * @brief The threads of the road pipeline of an export. If they are still
+ * running on destruction, e.g. because the export is left by an exception,
+ * the pipeline is cancelled, its queue is closed and the threads are joined.
+ */
+class PipelineThreads
+{
+  public:
+    PipelineThreads(std::atomic<bool>& cancelled, BoundedQueue<RoadExportChunk>& chunks)
+        : cancelled_(cancelled), chunks_(chunks)
+    {
+        threads_.reserve(2);
+    }
+
+    ~PipelineThreads()
+    {
+        for (const std::thread& thread : threads_)
+        {
+            if (thread.joinable())
+            {
+                cancelled_ = true;
+                chunks_.close();
+                break;
+            }
+        }
+        join();
+    }
+
+    /**
+     * @brief Starts a thread which runs 'work'.
+     */
+    void start(std::function<void()> work) { threads_.emplace_back(std::move(work)); }
+
+    /**
+     * @brief Waits until all threads are finished.
+     */
+    void join()
+    {
+        for (std::thread& thread : threads_)
+        {
+            if (thread.joinable())
+            {
+                thread.join();
+            }
+        }
+    }
+
+  private:
+    std::atomic<bool>& cancelled_;
+    BoundedQueue<RoadExportChunk>& chunks_;
+    std::vector<std::thread> threads_;
+};
+
+/**
+ * @brief An OBJ file which meshes and orientation vectors are appended to.
+ */
+class ObjFile
+{
+  public:
+    explicit ObjFile(const std::string& path) : out_(path) {}
+
+    /**
+     * @brief Writes the given mesh as a new object with the given name.
+     */
+    void writeMesh(const char* name, const TriangleMesh& mesh)
+    {
+        writeObjMesh(out_, name, mesh, indexOffset_);
+        numObjects_++;
+    }
+
+    /**
+     * @brief Writes the given lane strip mesh as a new, numbered object.
+     */
+    void writeSegment(const TriangleMesh& mesh)
+    {
+        std::string name = "segment_num_" + std::to_string(numObjects_);
+        writeMesh(name.c_str(), mesh);
+    }
+
+    /**
+     * @brief Writes each pair of consecutive points as a new object.
+     */
+    void writeVectors(const std::vector<Eigen::Vector3d>& points)
+    {
+        for (size_t i = 0; i + 1 < points.size(); i += 2)
+        {
+            out_ << "o vec_num_" << numObjects_++ << '\n';
+            out_ << "v " << points[i].x() << " " << points[i].y() << " " << points[i].z() << '\n';
+            out_ << "v " << points[i + 1].x() << " " << points[i + 1].y() << " " << points[i + 1].z() << '\n';
+            indexOffset_ += 2;
+        }
+    }
+
+    std::ofstream out_;
+    int indexOffset_ = 0;
+    int numObjects_ = 0;
+};
+
+/**
+ * @brief Computes the tessellation of a lane boundary, shifted towards
+ * another lane boundary by the given distance.
+ *
+ * @param original      The boundary to shift.
+ * @param ref           The boundary to shift towards.
+ * @param shift         The distance to shift by.
+ * @param from          The index of the first vertex to include.
+ * @param to            One past the index of the last vertex to include, or
+ *                      -1 to include all remaining vertices.
+ * @returns             The shifted boundary.
+ */
+static LaneSection::BoundaryCurveTessellation shift(const LaneSection::BoundaryCurveTessellation& original,
+                                                    const LaneSection::BoundaryCurveTessellation& ref, double shift,
+                                                    int from = 0, int to = -1)
+{
+    std::vector<Eigen::Vector2d> shifted_vertices;
+    if (to == -1) to = static_cast<int>(original.vertices_.size());
+    for (int i = from; i < to; i++)
+    {
+        Eigen::Vector2d pt_orig = original.vertices_[i];
+        Eigen::Vector2d pt_ref = ref.vertices_[i];
+        shifted_vertices.push_back((pt_ref - pt_orig).normalized() * shift + pt_orig);
+    }
+    return LaneSection::BoundaryCurveTessellation{std::move(shifted_vertices)};
+}
+
+/**
+ * @brief Gets the height of the j-th vertex of a lane strip boundary.
+ *
+ * If the road has an elevation profile, roadHeights holds the elevation
+ * for each vertex of the strip, otherwise it's empty and the height is
+ * looked up in the terrain heightfield.
+ */
+static double vertexHeight(const Eigen::Vector2d& pt, const std::vector<double>& roadHeights, int j,
+                           const Heightfield& heightfield)
+{
+    return roadHeights.empty() ? heightfield.heightAt(pt.x(), pt.y()) : roadHeights[j];
+}
+
+/**
+ * @brief Builds the mesh of a lane strip.
+ *
+ * The mesh consists of the top surface, side walls and end caps down to z = 0.
+ * All faces are wound counter-clockwise when viewed from outside.
+ */
+static TriangleMesh buildStripMesh(const LaneStrip& strip, const Heightfield& heightfield)
+{
+    const LaneSection::BoundaryCurveTessellation& a = strip.right_;
+    const LaneSection::BoundaryCurveTessellation& b = strip.left_;
+
+    TriangleMesh ret;
+
+    const int size = static_cast<int>(a.vertices_.size());
+    if (size < 2)
+    {
+        return ret;
+    }
+
+    // The top vertices of a and b alternate, followed by the bottom vertices
+    // in the same order.
+    for (int j = 0; j < size; j++)
+    {
+        const Eigen::Vector2d& ptl = a.vertices_[j];
+        const Eigen::Vector2d& ptlr = b.vertices_[j];
+        ret.addVertex(Eigen::Vector3d(ptl.x(), ptl.y(),
+                                      vertexHeight(ptl, strip.heights_, j, heightfield) + strip.elevation_));
+        ret.addVertex(Eigen::Vector3d(ptlr.x(), ptlr.y(),
+                                      vertexHeight(ptlr, strip.heights_, j, heightfield) + strip.elevation_));
+    }
+    for (int j = 0; j < size; j++)
+    {
+        ret.addVertex(Eigen::Vector3d(a.vertices_[j].x(), a.vertices_[j].y(), 0));
+        ret.addVertex(Eigen::Vector3d(b.vertices_[j].x(), b.vertices_[j].y(), 0));
+    }
+
+    auto topA = [](int j) { return 2 * j; };
+    auto topB = [](int j) { return 2 * j + 1; };
+    auto bottomA = [size](int j) { return 2 * size + 2 * j; };
+    auto bottomB = [size](int j) { return 2 * size + 2 * j + 1; };
+
+    // Adds a counter-clockwise quad as two triangles.
+    auto addQuad = [&ret](int p0, int p1, int p2, int p3) {
+        ret.addTriangle(p0, p1, p2);
+        ret.addTriangle(p0, p2, p3);
+    };
+
+    for (int j = 0; j + 1 < size; j++)
+    {
+        // a is the right boundary, so going along the strip it's on the right.
+        addQuad(topA(j), topA(j + 1), topB(j + 1), topB(j));
+        addQuad(bottomA(j), bottomA(j + 1), topA(j + 1), topA(j));
+        addQuad(bottomB(j + 1), bottomB(j), topB(j), topB(j + 1));
+    }
+
+    // end caps
+    addQuad(bottomB(0), bottomA(0), topA(0), topB(0));
+    addQuad(bottomA(size - 1), bottomB(size - 1), topB(size - 1), topA(size - 1));
+
+    return ret;
+}
+
+/**
+ * @brief Appends an orientation vector for each vertex of a lane strip,
+ * pointing from its outer to its inner boundary.
+ */
+static void appendOrientationVectors(const LaneStrip& strip, const Heightfield& heightfield,
+                                     std::vector<Eigen::Vector3d>& out)
+{
+    const LaneSection::BoundaryCurveTessellation& outer = strip.left_;
+    const LaneSection::BoundaryCurveTessellation& inner = strip.right_;
+
+    for (int j = 0; j < static_cast<int>(outer.vertices_.size()); j++)
+    {
+        const Eigen::Vector2d& ptl = outer.vertices_[j];
+        const Eigen::Vector2d& ptlr = inner.vertices_[j];
+        out.emplace_back(ptl.x(), ptl.y(), vertexHeight(ptl, strip.heights_, j, heightfield) + strip.elevation_);
+        out.emplace_back(ptlr.x(), ptlr.y(), vertexHeight(ptlr, strip.heights_, j, heightfield) + strip.elevation_);
+    }
+}
+
+/**
+ * @brief Appends an orientation vector for each inner vertex of a lane strip,
+ * starting at the center of the strip and pointing along the lane.
+ */
+static void appendParallelOrientationVectors(const LaneStrip& strip, const Heightfield& heightfield,
+                                             std::vector<Eigen::Vector3d>& out)
+{
+    const LaneSection::BoundaryCurveTessellation& left = strip.left_;
+    const LaneSection::BoundaryCurveTessellation& right = strip.right_;
+
+    for (int j = 1; j < static_cast<int>(left.vertices_.size()) - 1; j++)
+    {
+        Eigen::Vector2d ptl = left.vertices_[j];
+        Eigen::Vector2d ptlPrev = left.vertices_[j - 1];
+        Eigen::Vector2d ptlNext = left.vertices_[j + 1];
+        Eigen::Vector2d ptlr = right.vertices_[j];
+
+        Eigen::Vector2d mid = (ptl + ptlr) / 2;
+        Eigen::Vector2d dir = mid + (ptlNext - ptlPrev).normalized();
+
+        out.emplace_back(mid.x(), mid.y(), vertexHeight(mid, strip.heights_, j, heightfield) + strip.elevation_);
+        out.emplace_back(ptlr.x(), ptlr.y(), vertexHeight(dir, strip.heights_, j, heightfield) + strip.elevation_);
+    }
+}
+
+/**
+ * @brief Reorders the given mesh for vertex cache and vertex fetch locality.
+ *
+ * The simulated vertex cache stats before and after the reordering are added
+ * to before and after.
+ */
+static void optimizeMesh(TriangleMesh& mesh, VertexCacheStats& before, VertexCacheStats& after)
+{
+    before.add(simulateVertexCache(mesh));
+    optimizeVertexCache(mesh);
+    optimizeVertexFetch(mesh);
+    after.add(simulateVertexCache(mesh));
+}
+
+/**
+ * @brief Optimizes all meshes of the given chunk with optimizeMesh().
+ */
+static void optimizeChunk(RoadExportChunk& chunk, VertexCacheStats& before, VertexCacheStats& after)
+{
+    for (std::vector<TriangleMesh>* meshes : {&chunk.streets_, &chunk.sidewalks_, &chunk.borders_, &chunk.markings_})
+    {
+        for (TriangleMesh& mesh : *meshes)
+        {
+            optimizeMesh(mesh, before, after);
+        }
+    }
+}
+
+/**
+ * @brief Computes an upper bound of the distance of the lane section's outer
+ * boundaries from the reference line.
+ */
+static double laneSectionMaxHalfWidth(const LaneSection& laneSection)
+{
+    double leftWidth = 0;
+    double rightWidth = 0;
+
+    const std::vector<LaneSection::Lane>& lanes = laneSection.lanes();
+    for (int i = 0; i < static_cast<int>(lanes.size()); i++)
+    {
+        const auto& widthPoly3s = lanes[i].widthPoly3s();
+
+        double maxWidth = 0;
+        for (int j = 0; j < static_cast<int>(widthPoly3s.size()); j++)
+        {
+            double startS = widthPoly3s[j].sOffset();
+            double endS = j + 1 < static_cast<int>(widthPoly3s.size()) ? widthPoly3s[j + 1].sOffset()
+                                                                       : laneSection.endS() - laneSection.startS();
+            if (endS > startS)
+            {
+                maxWidth = std::max(maxWidth, widthPoly3s[j].poly3().maxValueInInterval(0, endS - startS));
+            }
+        }
+
+        if (i < laneSection.numLeftLanes())
+        {
+            leftWidth += maxWidth;
+        }
+        else
+        {
+            rightWidth += maxWidth;
+        }
+    }
+
+    return std::max(leftWidth, rightWidth);
+}
+
+/**
+ * @brief Checks whether the export was cancelled, see
+ * ObjExportParams::isCancelled_.
+ */
+static bool isCancelled(const ObjExportParams& params)
+{
+    return params.isCancelled_ && params.isCancelled_();
+}
+
+/**
+ * @brief Computes the bounding rect of all roads, including their lanes, from
+ * the reference line geometries and the maximum lane widths, without
+ * tessellating anything.
+ */
+static BoundingRect computeRoadBounds(const XodrMap& xodrMap)
+{
+    BoundingRect ret;
+    ret.min_ = Eigen::Vector2d(DBL_MAX, DBL_MAX);
+    ret.max_ = Eigen::Vector2d(-DBL_MAX, -DBL_MAX);
+
+    for (const Road& road : xodrMap.roads())
+    {
+        double roadHalfWidth = 0;
+        for (const LaneSection& laneSection : road.laneSections())
+        {
+            roadHalfWidth = std::max(roadHalfWidth, laneSectionMaxHalfWidth(laneSection));
+        }
+
+        const ReferenceLine& refLine = road.referenceLine();
+        for (int i = 0; i < refLine.numGeometries(); i++)
+        {
+            BoundingRect geomBounds = geometryBoundingRect(refLine.geometry(i));
+            geomBounds.grow(roadHalfWidth);
+            ret.expand(geomBounds);
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Samples the road surface along the reference lines, fits the terrain
+ * to the roads with elevation profiles and marks the road corridor of all
+ * roads in the terrain mesher.
+ *
+ * Only the reference lines are tessellated, with the same settings as the
+ * tessellation cache, and the tessellations bypass the cache. The points are
+ * processed in batches of road_point_batch_size, so only one batch is kept in
+ * memory at a time.
+ *
+ * @returns             False if the export was cancelled.
+ */
+static bool fitTerrainToRoads(const XodrMap& xodrMap, const ObjExportParams& params, Heightfield& heightfield,
+                              TerrainMesher& terrainMesher)
+{
+    const TessellationSettings settings;
+    HeightfieldRoadFit fit(heightfield, terrain_blend_distance);
+    std::vector<RoadSurfacePoint> elevatedPoints;
+    std::vector<RoadSurfacePoint> flatPoints;
+
+    auto flush = [&]() {
+        fit.addPoints(elevatedPoints);
+        terrainMesher.addRoadCorridor(elevatedPoints, road_corridor_width);
+        terrainMesher.addRoadCorridor(flatPoints, road_corridor_width);
+        elevatedPoints.clear();
+        flatPoints.clear();
+    };
+
+    const std::vector<Road>& roads = xodrMap.roads();
+    for (int roadIdx = 0; roadIdx < static_cast<int>(roads.size()); roadIdx++)
+    {
+        if (isCancelled(params))
+        {
+            return false;
+        }
+
+        const Road& road = roads[roadIdx];
+        const std::vector<LaneSection>& laneSections = road.laneSections();
+        for (const LaneSection& laneSection : laneSections)
+        {
+            const double halfWidth = laneSectionMaxHalfWidth(laneSection);
+            const ReferenceLine::Tessellation refLineTessellation =
+                road.referenceLine().tessellate(laneSection.startS(), laneSection.endS(), settings.verticesPerMeter_);
+
+            std::vector<RoadSurfacePoint>& points = road.hasElevationProfile() ? elevatedPoints : flatPoints;
+            std::vector<double> heights;
+            if (road.hasElevationProfile())
+            {
+                heights = road.elevationProfile().evalTessellation(refLineTessellation);
+            }
+
+            for (int i = 0; i < static_cast<int>(refLineTessellation.size()); i++)
+            {
+                const Eigen::Vector2d& pt = refLineTessellation[i].position_;
+                points.push_back({Eigen::Vector3d(pt.x(), pt.y(), heights.empty() ? 0 : heights[i]), halfWidth});
+            }
+        }
+
+        if (elevatedPoints.size() + flatPoints.size() >= road_point_batch_size)
+        {
+            flush();
+        }
+    }
+
+    flush();
+    fit.apply();
+    return true;
+}
+
+/**
+ * @brief Tessellates the lanes of a road and builds the meshes to export.
+ */
+static RoadExportChunk tessellateRoad(const XodrMap& xodrMap, int roadIdx, const Heightfield& heightfield,
+                                      TessellationCache& tessellationCache)
+{
+    RoadExportChunk ret;
+
+    const Road& road = xodrMap.roads()[roadIdx];
+    const std::vector<LaneSection>& laneSections = road.laneSections();
+    for (int laneSectionIdx = 0; laneSectionIdx < static_cast<int>(laneSections.size()); laneSectionIdx++)
+    {
+        const LaneSection& laneSection = laneSections[laneSectionIdx];
+        auto tessellation = tessellationCache.get(LaneSectionKey(roadIdx, laneSectionIdx));
+        const ReferenceLine::Tessellation& refLineTessellation = tessellation->referenceLine_;
+        const auto& boundaries = tessellation->boundaries_;
+        const auto& lanes = laneSection.lanes();
+        const int numLanes = static_cast<int>(lanes.size());
+
+        std::vector<double> roadHeights;
+        if (road.hasElevationProfile())
+        {
+            roadHeights = road.elevationProfile().evalTessellation(refLineTessellation);
+        }
+
+        auto laneIsBorderOrShoulder = [&](int i) {
+            return lanes[i].type() == LaneType::BORDER || lanes[i].type() == LaneType::SHOULDER;
+        };
+
+        for (int i = 0; i < numLanes; i++)
+        {
+            const LaneSection::BoundaryCurveTessellation& left = boundaries[i];
+            const LaneSection::BoundaryCurveTessellation& right = boundaries[i + 1];
+            const bool leftSide = i < static_cast<int>(boundaries.size()) / 2;
+
+            if (lanes[i].type() == LaneType::DRIVING)
+            {
+                ret.streets_.push_back(buildStripMesh({left, right, driving_elevation, roadHeights}, heightfield));
+
+                if (leftSide)
+                {
+                    appendParallelOrientationVectors({right, left, sidewalk_elevation, roadHeights}, heightfield,
+                                                     ret.streetLanes_);
+                }
+                else
+                {
+                    appendParallelOrientationVectors({left, right, sidewalk_elevation, roadHeights}, heightfield,
+                                                     ret.streetLanes_);
+                }
+
+                if (i > 0 && laneIsBorderOrShoulder(i - 1) && (i < 2 || lanes[i - 2].type() == LaneType::SIDEWALK))
+                {
+                    // Shift right of i
+                    auto l = shift(left, right, road_markings_shift);
+                    auto r = shift(left, right, road_markings_shift + road_markings_width);
+                    ret.markings_.push_back(
+                        buildStripMesh({std::move(l), std::move(r), road_markings_elevation, roadHeights}, heightfield));
+                }
+                else if (i + 1 < numLanes && laneIsBorderOrShoulder(i + 1) &&
+                         (i + 2 >= numLanes || lanes[i + 2].type() == LaneType::SIDEWALK))
+                {
+                    auto l = shift(right, left, road_markings_shift);
+                    auto r = shift(right, left, road_markings_shift + road_markings_width);
+                    ret.markings_.push_back(
+                        buildStripMesh({std::move(r), std::move(l), road_markings_elevation, roadHeights}, heightfield));
+                }
+
+                if (i > 0 && lanes[i - 1].type() == LaneType::DRIVING)
+                {
+                    const int numVertices = static_cast<int>(left.vertices_.size());
+                    for (int k = 0; k < numVertices - road_markings_stripe_length;
+                         k += road_markings_stripe_length + road_markings_stripe_distance)
+                    {
+                        auto l = shift(left, right, -road_markings_width / 2, k, k + road_markings_stripe_length);
+                        auto r = shift(left, right, road_markings_width / 2, k, k + road_markings_stripe_length);
+                        std::vector<double> stripeHeights;
+                        if (!roadHeights.empty())
+                        {
+                            stripeHeights.assign(roadHeights.begin() + k,
+                                                 roadHeights.begin() + k + road_markings_stripe_length);
+                        }
+                        ret.markings_.push_back(buildStripMesh(
+                            {std::move(l), std::move(r), road_markings_elevation, std::move(stripeHeights)},
+                            heightfield));
+                    }
+                }
+            }
+            else if (lanes[i].type() == LaneType::SIDEWALK)
+            {
+                ret.sidewalks_.push_back(buildStripMesh({left, right, sidewalk_elevation, roadHeights}, heightfield));
+
+                if (leftSide)
+                {
+                    appendOrientationVectors({right, left, sidewalk_elevation, roadHeights}, heightfield,
+                                             ret.streetGeo_);
+                }
+                else
+                {
+                    appendOrientationVectors({left, right, sidewalk_elevation, roadHeights}, heightfield,
+                                             ret.streetGeo_);
+                }
+            }
+            else if (lanes[i].type() == LaneType::BORDER)
+            {
+                if ((i < 1 || lanes[i - 1].type() != LaneType::SIDEWALK) &&
+                    (i + 1 >= numLanes || lanes[i + 1].type() != LaneType::SIDEWALK))
+                {
+                    continue;
+                }
+                ret.borders_.push_back(buildStripMesh({left, right, border_elevation, roadHeights}, heightfield));
+            }
+        }
+    }
+
+    return ret;
+}
+
+bool exportObjFiles(const XodrMap& xodrMap, const ObjExportParams& params)
+{
+    ExportFiles files(params.outDir_);
+    ObjFile streets(files.add("streets.obj"));
+    ObjFile sidewalk(files.add("sidewalk.obj"));
+    ObjFile border(files.add("border.obj"));
+    ObjFile markings(files.add("markings.obj"));
+    ObjFile terrain(files.add("terrain.obj"));
+    ObjFile all(files.add("all.obj"));
+    ObjFile street_geo(files.add("street_geo.obj"));
+    ObjFile street_lanes(files.add("street_lanes.obj"));
+    std::ofstream terrain_hm(files.add("terrain.raw"), std::ios::out | std::ios::binary);
+
+    std::unique_ptr<TessellationCache> ownTessellationCache;
+    if (!params.tessellationCache_)
+    {
+        ownTessellationCache.reset(new TessellationCache(xodrMap, export_cache_memory_budget));
+    }
+    TessellationCache& tessellationCache =
+        params.tessellationCache_ ? *params.tessellationCache_ : *ownTessellationCache;
+
+    // Pre-pass: compute the terrain extent and generate the terrain, which
+    // is needed to tessellate roads without elevation profiles.
+    const BoundingRect roadBounds = computeRoadBounds(xodrMap);
+
+    double minX = roadBounds.min_.x();
+    double maxX = roadBounds.max_.x();
+    double minY = roadBounds.min_.y();
+    double maxY = roadBounds.max_.y();
+
+    double deltaX = maxX - minX;
+    double deltaY = maxY - minY;
+
+    double width;
+    if (deltaX > deltaY)
+    {
+        minY -= (deltaX - deltaY) / 2;
+        width = deltaX + 2 * padding;
+    }
+    else
+    {
+        minX -= (deltaY - deltaX) / 2;
+        width = deltaY + 2 * padding;
+    }
+
+    minX -= padding;
+    minY -= padding;
+
+    TerrainParams terrainParams;
+    terrainParams.resolution_ = params.terrainResolution_;
+    Heightfield heightfield = Heightfield::generate(Eigen::Vector2d(minX, minY), width, terrainParams);
+    TerrainMesher terrainMesher(heightfield);
+    if (!fitTerrainToRoads(xodrMap, params, heightfield, terrainMesher))
+    {
+        return false;
+    }
+
+    // Tessellate the roads on one thread and write them on another.
+    BoundedQueue<RoadExportChunk> chunks(static_cast<size_t>(params.queueCapacity_));
+    std::exception_ptr tessellationError;
+    std::exception_ptr writerError;
+    std::atomic<bool> cancelled(false);
+    VertexCacheStats roadsBefore, roadsAfter;
+    PipelineThreads pipelineThreads(cancelled, chunks);
+
+    pipelineThreads.start([&]() {
+        try
+        {
+            for (int roadIdx = 0; roadIdx < static_cast<int>(xodrMap.roads().size()); roadIdx++)
+            {
+                if (cancelled || isCancelled(params))
+                {
+                    cancelled = true;
+                    break;
+                }
+
+                RoadExportChunk chunk = tessellateRoad(xodrMap, roadIdx, heightfield, tessellationCache);
+                if (params.optimizeMeshes_)
+                {
+                    optimizeChunk(chunk, roadsBefore, roadsAfter);
+                }
+                chunks.push(std::move(chunk));
+            }
+        }
+        catch (...)
+        {
+            tessellationError = std::current_exception();
+        }
+
+        chunks.close();
+    });
+
+    pipelineThreads.start([&]() {
+        try
+        {
+            RoadExportChunk chunk;
+            while (chunks.pop(chunk))
+            {
+                for (const TriangleMesh& mesh : chunk.streets_)
+                {
+                    all.writeSegment(mesh);
+                    streets.writeSegment(mesh);
+                }
+                for (const TriangleMesh& mesh : chunk.borders_)
+                {
+                    all.writeSegment(mesh);
+                    border.writeSegment(mesh);
+                }
+                for (const TriangleMesh& mesh : chunk.markings_)
+                {
+                    all.writeSegment(mesh);
+                    markings.writeSegment(mesh);
+                }
+                for (const TriangleMesh& mesh : chunk.sidewalks_)
+                {
+                    all.writeSegment(mesh);
+                    sidewalk.writeSegment(mesh);
+                }
+                street_geo.writeVectors(chunk.streetGeo_);
+                street_lanes.writeVectors(chunk.streetLanes_);
+            }
+        }
+        catch (...)
+        {
+            // Stop the tessellation thread, whose remaining pushes are
+            // discarded by the closed queue.
+            writerError = std::current_exception();
+            cancelled = true;
+            chunks.close();
+        }
+    });
+
+    // Meanwhile, mesh the terrain, refined around the road surface.
+    const int numPoints = heightfield.resolution();
+    for (int c = 0; c < numPoints; c++)
+    {
+        for (int r = 0; r < numPoints; r++)
+        {
+            double z = heightfield.sample(c, r);
+            unsigned short z_discrete = static_cast<short>(z / heightfield.maxHeight() * 8192);
+            terrain_hm.write((char*)&z_discrete, sizeof(z_discrete));
+        }
+    }
+
+    // The tessellation thread stops at the next road when cancelled, and
+    // the writer thread drains the queue.
+    if (isCancelled(params))
+    {
+        pipelineThreads.join();
+        return false;
+    }
+
+    TriangleMesh terrainMesh = terrainMesher.mesh(TerrainMeshParams());
+    std::cout << "Terrain mesh: " << terrainMesh.numTriangles() << " triangles (uniform grid: "
+              << 2 * (numPoints - 1) * (numPoints - 1) << ")" << std::endl;
+
+    VertexCacheStats terrainBefore, terrainAfter;
+    if (params.optimizeMeshes_)
+    {
+        optimizeMesh(terrainMesh, terrainBefore, terrainAfter);
+    }
+
+    pipelineThreads.join();
+
+    if (tessellationError)
+    {
+        std::rethrow_exception(tessellationError);
+    }
+    if (writerError)
+    {
+        std::rethrow_exception(writerError);
+    }
+    if (cancelled)
+    {
+        return false;
+    }
+
+    terrain.writeMesh("terrain", terrainMesh);
+    all.writeMesh("terrain", terrainMesh);
+
+    for (ObjFile* file : {&streets, &sidewalk, &border, &markings, &terrain, &all, &street_geo, &street_lanes})
+    {
+        file->out_.close();
+    }
+    terrain_hm.close();
+    files.commit();
+
+    if (params.optimizeMeshes_)
+    {
+        std::cout << "Vertex cache ACMR: roads " << roadsBefore.acmr() << " -> " << roadsAfter.acmr() << ", terrain "
+                  << terrainBefore.acmr() << " -> " << terrainAfter.acmr() << std::endl;
+    }
+
+    std::cout << "Finished writing file." << std::endl << std::flush;
+    return true;
+}
+
+}}  // namespace aid::xodr
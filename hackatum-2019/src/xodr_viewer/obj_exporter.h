@@ -0,0 +1,91 @@
+#pragma once
+
+#include "xodr/tessellation_cache.h"
+#include "xodr/xodr_map.h"
+
+#include <functional>
+#include <string>
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief The parameters of the OBJ export.
+ */
+struct ObjExportParams
+{
+    /**
+     * @brief The directory the files are written to. It must exist.
+     */
+    std::string outDir_ = "./out";
+
+    /**
+     * @brief The number of terrain samples along each side of the terrain.
+     *
+     * This must be of the form 2^k + 1 and can be raised up to 4097 for a
+     * finer terrain mesh and heightmap.
+     */
+    int terrainResolution_ = 257;
+
+    /**
+     * @brief The maximum number of tessellated roads waiting to be written.
+     */
+    int queueCapacity_ = 8;
+
+    /**
+     * @brief Whether to reorder the triangles and vertices of all meshes for
+     * GPU vertex cache and vertex fetch locality before writing them.
+     *
+     * The average cache miss ratio (ACMR) before and after is printed.
+     */
+    bool optimizeMeshes_ = true;
+
+    /**
+     * @brief The cache to take the lane section tessellations from, or
+     * nullptr to use a cache with a small memory budget which only lives
+     * during the export.
+     *
+     * The cache must belong to the exported map. The export requests each
+     * lane section once, so it only profits from a cache which already holds
+     * the tessellations, like the one of the viewer.
+     */
+    TessellationCache* tessellationCache_ = nullptr;
+
+    /**
+     * @brief If set, this is called before each road of the pre-pass and the
+     * tessellation and before meshing the terrain. Once it returns true, the
+     * export stops and exportObjFiles() returns false. It's called from
+     * several threads of the export.
+     */
+    std::function<bool()> isCancelled_;
+};
+
+/**
+ * @brief Exports the given map as a set of Wavefront OBJ files and a raw
+ * terrain heightmap.
+ *
+ * The files streets.obj, sidewalk.obj, border.obj, markings.obj, terrain.obj,
+ * street_geo.obj, street_lanes.obj, all.obj and terrain.raw are written to
+ * params.outDir_. They are written with the suffix .part and only renamed
+ * into place once the export is complete, so a cancelled or failed export
+ * leaves the files of the previous export untouched. Exports to the same
+ * directory must not run concurrently.
+ *
+ * The export runs as a pipeline. The terrain extent is computed from the
+ * bounds of the reference line geometries, and a pre-pass over the reference
+ * lines fits the terrain to the road surface in fixed-size batches of
+ * points. Then one thread tessellates the roads one at a time and passes the
+ * resulting meshes through a bounded queue to a second thread, which writes
+ * them, while the terrain is meshed on the calling thread. Tessellated roads
+ * are discarded once written, so apart from the map itself and a given
+ * tessellation cache, the peak memory depends on the terrain resolution, the
+ * batch and queue sizes and the largest road, but not on the size of the
+ * map. The pre-pass only tessellates the reference lines, without the cache.
+ *
+ * @param xodrMap           The map to export.
+ * @param params            The export parameters.
+ * @returns                 False if the export was cancelled, see
+ *                          ObjExportParams::isCancelled_.
+ */
+bool exportObjFiles(const XodrMap& xodrMap, const ObjExportParams& params = ObjExportParams());
+
+}}  // namespace aid::xodr
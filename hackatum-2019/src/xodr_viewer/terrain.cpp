@@ -0,0 +1,288 @@
+#include "terrain.h"
+
+#include "xodr/parallel.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <random>
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief A Perlin noise permutation table together with a row-wise batched
+ * evaluation of 2D noise.
+ *
+ * This produces the same values as siv::PerlinNoise::noise(x, y) with the same
+ * seed, but replaces the per-sample gradient branches with table lookups and
+ * hoists all work which only depends on the row out of the inner loop.
+ */
+class NoiseKernel
+{
+  public:
+    /**
+     * @brief Constructs the permutation table for the given seed.
+     */
+    explicit NoiseKernel(std::uint32_t seed);
+
+    /**
+     * @brief Evaluates the noise for a row of samples.
+     *
+     * @param cells         The integer cells of the x-coordinates of the samples.
+     * @param fracs         The fractional parts of the x-coordinates of the samples.
+     * @param fades         The fade curve evaluated at fracs.
+     * @param y             The y-coordinate of the row.
+     * @param out           The output array, which must hold cells.size() values.
+     */
+    void evalRow(const std::vector<int>& cells, const std::vector<double>& fracs, const std::vector<double>& fades,
+                 double y, double* out) const;
+
+    static double fade(double t) { return t * t * t * (t * (t * 6 - 15) + 10); }
+
+  private:
+    std::uint8_t p_[512];
+};
+
+/**
+ * @brief The x- and y-coefficients of the 16 Perlin gradient directions in
+ * the z = 0 plane.
+ */
+static const double gradX[16] = {1, -1, 1, -1, 1, -1, 1, -1, 0, 0, 0, 0, 1, 0, -1, 0};
+static const double gradY[16] = {1, 1, -1, -1, 0, 0, 0, 0, 1, -1, 1, -1, 1, -1, 1, -1};
+
+NoiseKernel::NoiseKernel(std::uint32_t seed)
+{
+    for (int i = 0; i < 256; i++)
+    {
+        p_[i] = static_cast<std::uint8_t>(i);
+    }
+
+    std::shuffle(std::begin(p_), std::begin(p_) + 256, std::default_random_engine(seed));
+
+    for (int i = 0; i < 256; i++)
+    {
+        p_[256 + i] = p_[i];
+    }
+}
+
+void NoiseKernel::evalRow(const std::vector<int>& cells, const std::vector<double>& fracs,
+                          const std::vector<double>& fades, double y, double* out) const
+{
+    const double yFloor = std::floor(y);
+    const int yCell = static_cast<int>(yFloor) & 255;
+    const double fy = y - yFloor;
+    const double fy1 = fy - 1;
+    const double v = fade(fy);
+
+    const int n = static_cast<int>(cells.size());
+    for (int i = 0; i < n; i++)
+    {
+        const int xCell = cells[i];
+        const double fx = fracs[i];
+        const double fx1 = fx - 1;
+        const double u = fades[i];
+
+        const int a = p_[xCell] + yCell;
+        const int b = p_[xCell + 1] + yCell;
+        const int haa = p_[p_[a]] & 15;
+        const int hba = p_[p_[b]] & 15;
+        const int hab = p_[p_[a + 1]] & 15;
+        const int hbb = p_[p_[b + 1]] & 15;
+
+        const double gaa = gradX[haa] * fx + gradY[haa] * fy;
+        const double gba = gradX[hba] * fx1 + gradY[hba] * fy;
+        const double gab = gradX[hab] * fx + gradY[hab] * fy1;
+        const double gbb = gradX[hbb] * fx1 + gradY[hbb] * fy1;
+
+        const double lower = gaa + u * (gba - gaa);
+        const double upper = gab + u * (gbb - gab);
+        out[i] = lower + v * (upper - lower);
+    }
+}
+
+/**
+ * @brief The number of row bands per thread in forEachRowBand(), so that
+ * parallelFor() can balance bands of different cost.
+ */
+constexpr int row_bands_per_thread = 4;
+
+/**
+ * @brief Calls f(beginRow, endRow) for bands of rows, which are distributed
+ * over numThreads threads by parallelFor().
+ *
+ * @param numRows       The number of rows.
+ * @param numThreads    The number of threads, see resolveNumThreads().
+ * @param f             The function to call for each band, called concurrently.
+ */
+template <typename F>
+static void forEachRowBand(int numRows, int numThreads, F f)
+{
+    const int numBands = std::min(numRows, resolveNumThreads(numThreads) * row_bands_per_thread);
+    parallelFor(numBands, numThreads, [&](int band) {
+        f(band * numRows / numBands, (band + 1) * numRows / numBands);
+    });
+}
+
+Heightfield Heightfield::generate(const Eigen::Vector2d& origin, double size, const TerrainParams& params)
+{
+    assert(params.resolution_ >= 2);
+
+    Heightfield ret;
+    ret.resolution_ = params.resolution_;
+    ret.origin_ = origin;
+    ret.size_ = size;
+    ret.spacing_ = size / (params.resolution_ - 1);
+    ret.maxHeight_ = 2 * params.noiseHeight_;
+    ret.heights_.resize(static_cast<size_t>(ret.resolution_) * ret.resolution_);
+
+    const int res = ret.resolution_;
+    const double noiseStep = ret.spacing_ / size * params.noiseScale_;
+
+    // The x-dependent part of the noise is the same for every row.
+    std::vector<int> cells(res);
+    std::vector<double> fracs(res);
+    std::vector<double> fades(res);
+    for (int col = 0; col < res; col++)
+    {
+        double nx = col * noiseStep;
+        double nxFloor = std::floor(nx);
+        cells[col] = static_cast<int>(nxFloor) & 255;
+        fracs[col] = nx - nxFloor;
+        fades[col] = NoiseKernel::fade(fracs[col]);
+    }
+
+    const NoiseKernel kernel(params.seed_);
+    const double halfSize = size / 2;
+
+    auto generateRows = [&](int beginRow, int endRow) {
+        std::vector<double> noise(res);
+        for (int row = beginRow; row < endRow; row++)
+        {
+            kernel.evalRow(cells, fracs, fades, row * noiseStep, noise.data());
+
+            // Attenuate the noise towards the center of the square.
+            double dy = row * ret.spacing_ - halfSize;
+            float* out = &ret.heights_[static_cast<size_t>(row) * res];
+            for (int col = 0; col < res; col++)
+            {
+                double dx = col * ret.spacing_ - halfSize;
+                double dist = std::sqrt(dx * dx + dy * dy);
+                double falloff = std::pow((1 - std::cos(dist * 3.14 / halfSize)) / 2, 1.1) + 0.4;
+                out[col] = static_cast<float>(noise[col] * falloff * params.noiseHeight_ + params.noiseHeight_);
+            }
+        }
+    };
+
+    forEachRowBand(res, params.numThreads_, generateRows);
+
+    return ret;
+}
+
+void Heightfield::conformToRoads(const std::vector<RoadSurfacePoint>& points, double blendDistance, int numThreads)
+{
+    HeightfieldRoadFit fit(*this, blendDistance, numThreads);
+    fit.addPoints(points);
+    fit.apply();
+}
+
+double Heightfield::heightAt(double x, double y) const
+{
+    assert(resolution_ >= 2);
+
+    double gx = std::min(std::max((x - origin_.x()) / spacing_, 0.0), resolution_ - 1.0);
+    double gy = std::min(std::max((y - origin_.y()) / spacing_, 0.0), resolution_ - 1.0);
+
+    int col = std::min(static_cast<int>(gx), resolution_ - 2);
+    int row = std::min(static_cast<int>(gy), resolution_ - 2);
+    double tx = gx - col;
+    double ty = gy - row;
+
+    const float* lower = &heights_[static_cast<size_t>(row) * resolution_ + col];
+    const float* upper = lower + resolution_;
+
+    double h0 = lower[0] + tx * (lower[1] - lower[0]);
+    double h1 = upper[0] + tx * (upper[1] - upper[0]);
+    return h0 + ty * (h1 - h0);
+}
+
+HeightfieldRoadFit::HeightfieldRoadFit(Heightfield& heightfield, double blendDistance, int numThreads)
+    : heightfield_(heightfield),
+      blendDistance_(blendDistance),
+      numThreads_(numThreads),
+      bestWeights_(heightfield.heights_.size(), 0.0f),
+      bestDists_(heightfield.heights_.size(), 0.0f),
+      targets_(heightfield.heights_.size(), 0.0f),
+      maxHeight_(heightfield.maxHeight_)
+{
+    assert(blendDistance > 0);
+}
+
+void HeightfieldRoadFit::addPoints(const std::vector<RoadSurfacePoint>& points)
+{
+    const int res = heightfield_.resolution_;
+    const double spacing = heightfield_.spacing_;
+    const double blendDistance = blendDistance_;
+
+    auto fitRows = [&](int beginRow, int endRow) {
+        for (const RoadSurfacePoint& point : points)
+        {
+            const double reach = point.radius_ + blendDistance;
+            Eigen::Vector2d gridPos = (point.position_.head<2>() - heightfield_.origin_) / spacing;
+
+            int rowBegin = std::max(beginRow, static_cast<int>(std::ceil(gridPos.y() - reach / spacing)));
+            int rowEnd = std::min(endRow - 1, static_cast<int>(std::floor(gridPos.y() + reach / spacing)));
+            int colBegin = std::max(0, static_cast<int>(std::ceil(gridPos.x() - reach / spacing)));
+            int colEnd = std::min(res - 1, static_cast<int>(std::floor(gridPos.x() + reach / spacing)));
+
+            for (int row = rowBegin; row <= rowEnd; row++)
+            {
+                for (int col = colBegin; col <= colEnd; col++)
+                {
+                    double dist = (heightfield_.samplePosition(col, row) - point.position_.head<2>()).norm();
+                    if (dist >= reach)
+                    {
+                        continue;
+                    }
+
+                    double weight = 1;
+                    if (dist > point.radius_)
+                    {
+                        // Smoothstep from 1 at the radius to 0 at the reach.
+                        double t = 1 - (dist - point.radius_) / blendDistance;
+                        weight = t * t * (3 - 2 * t);
+                    }
+
+                    size_t idx = static_cast<size_t>(row) * res + col;
+                    if (weight > bestWeights_[idx] || (weight == bestWeights_[idx] && dist < bestDists_[idx]))
+                    {
+                        bestWeights_[idx] = static_cast<float>(weight);
+                        bestDists_[idx] = static_cast<float>(dist);
+                        targets_[idx] = static_cast<float>(point.position_.z());
+                    }
+                }
+            }
+        }
+    };
+
+    if (!points.empty())
+    {
+        forEachRowBand(res, numThreads_, fitRows);
+    }
+
+    for (const RoadSurfacePoint& point : points)
+    {
+        maxHeight_ = std::max(maxHeight_, point.position_.z());
+    }
+}
+
+void HeightfieldRoadFit::apply()
+{
+    std::vector<float>& heights = heightfield_.heights_;
+    for (size_t i = 0; i < heights.size(); i++)
+    {
+        heights[i] += bestWeights_[i] * (targets_[i] - heights[i]);
+    }
+    heightfield_.maxHeight_ = maxHeight_;
+}
+
+}}  // namespace aid::xodr
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <Eigen/Core>
+
+#include <cstdint>
+#include <vector>
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief The parameters used to generate a @ref Heightfield.
+ */
+struct TerrainParams
+{
+    /**
+     * @brief The number of samples along each side of the square grid.
+     *
+     * Resolutions of the form 2^k + 1 (257, 1025, 4097, ...) are preferred,
+     * since they can be meshed adaptively.
+     */
+    int resolution_ = 257;
+
+    /**
+     * @brief The number of noise periods along each side of the terrain.
+     */
+    double noiseScale_ = 5;
+
+    /**
+     * @brief The amplitude of the noise, in meters.
+     *
+     * The resulting heights lie roughly in the interval [0, 2 * noiseHeight_].
+     */
+    double noiseHeight_ = 20;
+
+    /**
+     * @brief The seed of the noise permutation table.
+     */
+    std::uint32_t seed_ = 32;
+
+    /**
+     * @brief The number of threads used for generation, or 0 to use one
+     * thread per hardware thread.
+     */
+    int numThreads_ = 0;
+};
+
+/**
+ * @brief A point on a road surface which the terrain is fitted to.
+ */
+struct RoadSurfacePoint
+{
+    /**
+     * @brief The position of the point, including its elevation.
+     */
+    Eigen::Vector3d position_;
+
+    /**
+     * @brief The distance around the point in which the terrain takes on the
+     * point's elevation exactly.
+     */
+    double radius_;
+};
+
+/**
+ * @brief A square grid of terrain heights.
+ *
+ * The heightfield covers the square [origin, origin + (size, size)] and
+ * stores resolution x resolution samples in row major order, where the
+ * sample (col, row) lies at origin + (col, row) * spacing(). Heights at
+ * arbitrary positions are obtained by bilinear interpolation of the samples.
+ */
+class Heightfield
+{
+  public:
+    /**
+     * @brief Constructs an empty heightfield.
+     */
+    Heightfield() = default;
+
+    /**
+     * @brief Generates a heightfield of Perlin noise covering the given square.
+     *
+     * The noise is attenuated towards the center of the square, such that the
+     * terrain is flatter in the area covered by the roads. The rows of the
+     * grid are distributed over params.numThreads_ threads, and each row is
+     * evaluated by a batched noise kernel.
+     *
+     * @param origin        The min corner of the square.
+     * @param size          The side length of the square.
+     * @param params        The generation parameters.
+     * @returns             The resulting heightfield.
+     */
+    static Heightfield generate(const Eigen::Vector2d& origin, double size, const TerrainParams& params);
+
+    /**
+     * @brief Fits the heightfield to the given road surface points.
+     *
+     * Each sample within a point's radius takes on the elevation of the
+     * nearest such point. Beyond the radius, the sample height is blended
+     * smoothly back to its original height over the given blend distance.
+     *
+     * This is the same as adding all points to a HeightfieldRoadFit at once.
+     *
+     * @param points        The road surface points.
+     * @param blendDistance The distance over which the terrain is blended.
+     * @param numThreads    The number of threads, or 0 to use one thread per
+     *                      hardware thread.
+     */
+    void conformToRoads(const std::vector<RoadSurfacePoint>& points, double blendDistance, int numThreads = 0);
+
+    /**
+     * @brief Gets the height at the given position by bilinear interpolation.
+     *
+     * Positions outside the heightfield are clamped to its border.
+     *
+     * @param x             The x-coordinate.
+     * @param y             The y-coordinate.
+     * @returns             The interpolated height.
+     */
+    double heightAt(double x, double y) const;
+
+    /**
+     * @brief Gets the height sample at the given grid position.
+     */
+    float sample(int col, int row) const { return heights_[static_cast<size_t>(row) * resolution_ + col]; }
+
+    /**
+     * @brief Gets the position of the grid sample with the given grid position.
+     */
+    Eigen::Vector2d samplePosition(int col, int row) const
+    {
+        return origin_ + Eigen::Vector2d(col * spacing_, row * spacing_);
+    }
+
+    /**
+     * @brief Gets the number of samples along each side of the grid.
+     */
+    int resolution() const { return resolution_; }
+
+    /**
+     * @brief Gets the min corner of the heightfield.
+     */
+    const Eigen::Vector2d& origin() const { return origin_; }
+
+    /**
+     * @brief Gets the side length of the heightfield.
+     */
+    double size() const { return size_; }
+
+    /**
+     * @brief Gets the distance between two adjacent samples.
+     */
+    double spacing() const { return spacing_; }
+
+    /**
+     * @brief Gets the upper bound of the heights in this heightfield.
+     *
+     * This is used to quantize heights when writing raw heightmaps.
+     */
+    double maxHeight() const { return maxHeight_; }
+
+    /**
+     * @brief Gets all samples in row major order.
+     */
+    const std::vector<float>& samples() const { return heights_; }
+
+  private:
+    friend class HeightfieldRoadFit;
+
+    std::vector<float> heights_;
+    int resolution_ = 0;
+    Eigen::Vector2d origin_ = Eigen::Vector2d::Zero();
+    double size_ = 0;
+    double spacing_ = 0;
+    double maxHeight_ = 0;
+};
+
+/**
+ * @brief Fits a heightfield to road surface points which are added in
+ * batches, see Heightfield::conformToRoads().
+ *
+ * For each sample, only the most influential point so far is kept, so the
+ * memory use depends on the resolution of the heightfield but not on the
+ * number of points. The result doesn't depend on how the points are split
+ * into batches.
+ */
+class HeightfieldRoadFit
+{
+  public:
+    /**
+     * @brief Starts fitting the given heightfield.
+     *
+     * The heightfield must outlive the fit, and isn't changed until apply().
+     *
+     * @param heightfield   The heightfield to fit.
+     * @param blendDistance The distance over which the terrain is blended.
+     * @param numThreads    The number of threads, or 0 to use one thread per
+     *                      hardware thread.
+     */
+    HeightfieldRoadFit(Heightfield& heightfield, double blendDistance, int numThreads = 0);
+
+    /**
+     * @brief Adds a batch of road surface points.
+     *
+     * @param points        The road surface points.
+     */
+    void addPoints(const std::vector<RoadSurfacePoint>& points);
+
+    /**
+     * @brief Blends the heightfield towards the points added so far.
+     *
+     * This must be called once, after all points were added.
+     */
+    void apply();
+
+  private:
+    Heightfield& heightfield_;
+    double blendDistance_;
+    int numThreads_;
+
+    /**
+     * @brief For each sample, the weight and distance of the most influential
+     * point so far, and its elevation.
+     */
+    std::vector<float> bestWeights_;
+    std::vector<float> bestDists_;
+    std::vector<float> targets_;
+
+    double maxHeight_;
+};
+
+}}  // namespace aid::xodr
@@ -0,0 +1,184 @@
+#include "terrain_mesher.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+namespace aid { namespace xodr {
+
+TerrainMesher::TerrainMesher(const Heightfield& heightfield)
+    : heightfield_(heightfield), roadCorridor_(heightfield.samples().size(), 0)
+{
+    if (!supportsResolution(heightfield.resolution()))
+    {
+        std::stringstream err;
+        err << "The terrain resolution " << heightfield.resolution() << " is not of the form 2^k + 1.";
+        throw std::runtime_error(err.str());
+    }
+}
+
+bool TerrainMesher::supportsResolution(int resolution)
+{
+    int tileSize = resolution - 1;
+    return tileSize >= 2 && (tileSize & (tileSize - 1)) == 0;
+}
+
+void TerrainMesher::addRoadCorridor(const std::vector<RoadSurfacePoint>& points, double margin)
+{
+    const int res = heightfield_.resolution();
+    const double spacing = heightfield_.spacing();
+    const Eigen::Vector2d& origin = heightfield_.origin();
+
+    for (const RoadSurfacePoint& point : points)
+    {
+        const double radius = point.radius_ + margin;
+        const int r = static_cast<int>(std::ceil(radius / spacing));
+        int col = static_cast<int>(std::round((point.position_.x() - origin.x()) / spacing));
+        int row = static_cast<int>(std::round((point.position_.y() - origin.y()) / spacing));
+
+        for (int y = std::max(row - r, 0); y <= std::min(row + r, res - 1); y++)
+        {
+            for (int x = std::max(col - r, 0); x <= std::min(col + r, res - 1); x++)
+            {
+                if ((heightfield_.samplePosition(x, y) - point.position_.head<2>()).norm() <= radius + spacing)
+                {
+                    roadCorridor_[static_cast<size_t>(y) * res + x] = 1;
+                }
+            }
+        }
+    }
+}
+
+std::vector<float> TerrainMesher::computeErrors(float roadScale) const
+{
+    const int size = heightfield_.resolution();
+    const int tileSize = size - 1;
+    const std::vector<float>& h = heightfield_.samples();
+
+    std::vector<float> errors(h.size(), 0.0f);
+
+    // Triangles are numbered like the nodes of a binary tree, with ids 2 and
+    // 3 for the two roots. Iterating the ids in reverse order visits all
+    // children before their parents.
+    const int numTriangles = tileSize * tileSize * 2 - 2;
+    const int numParentTriangles = numTriangles - tileSize * tileSize;
+
+    for (int i = numTriangles - 1; i >= 0; i--)
+    {
+        // Walk down the tree from the root to recover the triangle's corners,
+        // where c is the right angle and (a, b) the hypotenuse.
+        int id = i + 2;
+        int ax = 0, ay = 0, bx = 0, by = 0, cx = 0, cy = 0;
+        if (id & 1)
+        {
+            bx = by = cx = tileSize;
+        }
+        else
+        {
+            ax = ay = cy = tileSize;
+        }
+
+        while ((id >>= 1) > 1)
+        {
+            int mx = (ax + bx) >> 1;
+            int my = (ay + by) >> 1;
+
+            if (id & 1)
+            {
+                bx = ax;
+                by = ay;
+                ax = cx;
+                ay = cy;
+            }
+            else
+            {
+                ax = bx;
+                ay = by;
+                bx = cx;
+                by = cy;
+            }
+
+            cx = mx;
+            cy = my;
+        }
+
+        const int mx = (ax + bx) >> 1;
+        const int my = (ay + by) >> 1;
+        const size_t middleIdx = static_cast<size_t>(my) * size + mx;
+
+        float interpolated = (h[static_cast<size_t>(ay) * size + ax] + h[static_cast<size_t>(by) * size + bx]) / 2;
+        float error = std::abs(interpolated - h[middleIdx]);
+        if (roadCorridor_[middleIdx])
+        {
+            error *= roadScale;
+        }
+
+        float& middleError = errors[middleIdx];
+        middleError = std::max(middleError, error);
+
+        if (i < numParentTriangles)
+        {
+            size_t leftChildIdx = static_cast<size_t>((ay + cy) >> 1) * size + ((ax + cx) >> 1);
+            size_t rightChildIdx = static_cast<size_t>((by + cy) >> 1) * size + ((bx + cx) >> 1);
+            middleError = std::max(middleError, std::max(errors[leftChildIdx], errors[rightChildIdx]));
+        }
+    }
+
+    return errors;
+}
+
+TriangleMesh TerrainMesher::mesh(const TerrainMeshParams& params) const
+{
+    assert(params.maxError_ > 0 && params.roadMaxError_ > 0);
+
+    const int size = heightfield_.resolution();
+    const int tileSize = size - 1;
+    const float maxError = static_cast<float>(params.maxError_);
+    const std::vector<float> errors = computeErrors(static_cast<float>(params.maxError_ / params.roadMaxError_));
+
+    TriangleMesh ret;
+    std::vector<int> vertexIndices(errors.size(), -1);
+
+    auto vertexIndex = [&](int x, int y) {
+        int& idx = vertexIndices[static_cast<size_t>(y) * size + x];
+        if (idx < 0)
+        {
+            Eigen::Vector2d pos = heightfield_.samplePosition(x, y);
+            idx = ret.addVertex(Eigen::Vector3d(pos.x(), pos.y(), heightfield_.sample(x, y)));
+        }
+        return idx;
+    };
+
+    struct Triangle
+    {
+        int ax, ay, bx, by, cx, cy;
+    };
+
+    std::vector<Triangle> stack = {{0, 0, tileSize, tileSize, tileSize, 0},
+                                   {tileSize, tileSize, 0, 0, 0, tileSize}};
+    while (!stack.empty())
+    {
+        Triangle t = stack.back();
+        stack.pop_back();
+
+        int mx = (t.ax + t.bx) >> 1;
+        int my = (t.ay + t.by) >> 1;
+
+        if (std::abs(t.ax - t.cx) + std::abs(t.ay - t.cy) > 1 && errors[static_cast<size_t>(my) * size + mx] > maxError)
+        {
+            stack.push_back({t.cx, t.cy, t.ax, t.ay, mx, my});
+            stack.push_back({t.bx, t.by, t.cx, t.cy, mx, my});
+        }
+        else
+        {
+            // The split order produces clockwise triangles, so swap b and c.
+            ret.addTriangle(vertexIndex(t.ax, t.ay), vertexIndex(t.cx, t.cy), vertexIndex(t.bx, t.by));
+        }
+    }
+
+    return ret;
+}
+
+}}  // namespace aid::xodr
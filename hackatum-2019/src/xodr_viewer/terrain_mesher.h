@@ -0,0 +1,94 @@
+#pragma once
+
+#include "terrain.h"
+#include "triangle_mesh.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief The parameters of the adaptive terrain mesher.
+ */
+struct TerrainMeshParams
+{
+    /**
+     * @brief The maximum vertical error of the mesh, in meters.
+     */
+    double maxError_ = 0.5;
+
+    /**
+     * @brief The maximum vertical error of the mesh inside road corridors,
+     * in meters.
+     */
+    double roadMaxError_ = 0.05;
+};
+
+/**
+ * @brief An adaptive mesher for heightfields based on right-triangulated
+ * irregular networks (RTIN).
+ *
+ * The heightfield is recursively split into right triangles along the longest
+ * edge. A triangle is only split if the height error at the midpoint of its
+ * hypotenuse exceeds the error bound. Since the error of each midpoint
+ * includes the errors of all descendant triangles, a split forces the
+ * neighbour sharing the hypotenuse to split as well, so the resulting mesh
+ * has no T-junctions and is crack-free.
+ *
+ * Samples near roads can be marked as road corridor, in which case the
+ * tighter TerrainMeshParams::roadMaxError_ applies to them.
+ *
+ * The resolution of the heightfield must be of the form 2^k + 1.
+ */
+class TerrainMesher
+{
+  public:
+    /**
+     * @brief Constructs a TerrainMesher for the given heightfield.
+     *
+     * The heightfield must outlive the mesher.
+     *
+     * @param heightfield   The heightfield to mesh.
+     */
+    explicit TerrainMesher(const Heightfield& heightfield);
+
+    /**
+     * @brief Checks whether heightfields with the given resolution can be meshed.
+     */
+    static bool supportsResolution(int resolution);
+
+    /**
+     * @brief Marks all samples near the given road surface points as road
+     * corridor.
+     *
+     * A sample is marked if it's within the point's radius plus the given
+     * margin of any of the points.
+     *
+     * @param points        The road surface points.
+     * @param margin        The width of the corridor beyond the points' radii.
+     */
+    void addRoadCorridor(const std::vector<RoadSurfacePoint>& points, double margin);
+
+    /**
+     * @brief Builds the mesh.
+     *
+     * @param params        The error bounds.
+     * @returns             The resulting mesh.
+     */
+    TriangleMesh mesh(const TerrainMeshParams& params) const;
+
+  private:
+    /**
+     * @brief Computes the error of each hypotenuse midpoint, bottom-up,
+     * including the errors of all descendant triangles.
+     *
+     * The errors of road corridor samples are scaled by roadScale.
+     */
+    std::vector<float> computeErrors(float roadScale) const;
+
+    const Heightfield& heightfield_;
+    std::vector<std::uint8_t> roadCorridor_;
+};
+
+}}  // namespace aid::xodr
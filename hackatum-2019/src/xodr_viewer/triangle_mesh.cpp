@@ -0,0 +1,27 @@
+#include "triangle_mesh.h"
+
+#include <ostream>
+
+namespace aid { namespace xodr {
+
+void writeObjMesh(std::ostream& out, const char* name, const TriangleMesh& mesh, int& indexOffset)
+{
+    out << "o " << name << '\n';
+
+    for (const Eigen::Vector3d& v : mesh.vertices_)
+    {
+        out << "v " << v.x() << " " << v.y() << " " << v.z() << '\n';
+    }
+
+    // OBJ indices are 1-based.
+    const int base = indexOffset + 1;
+    for (size_t i = 0; i + 2 < mesh.indices_.size(); i += 3)
+    {
+        out << "f " << mesh.indices_[i] + base << " " << mesh.indices_[i + 1] + base << " "
+            << mesh.indices_[i + 2] + base << '\n';
+    }
+
+    indexOffset += static_cast<int>(mesh.vertices_.size());
+}
+
+}}  // namespace aid::xodr
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <Eigen/Core>
+
+#include <iosfwd>
+#include <vector>
+
+namespace aid { namespace xodr {
+
+/**
+ * @brief An indexed triangle mesh.
+ *
+ * Triangles are stored as consecutive triples of indices into vertices_ and
+ * are oriented counter-clockwise when viewed from above (+z).
+ */
+struct TriangleMesh
+{
+    /**
+     * @brief The vertex positions.
+     */
+    std::vector<Eigen::Vector3d> vertices_;
+
+    /**
+     * @brief The vertex indices, three per triangle.
+     */
+    std::vector<int> indices_;
+
+    /**
+     * @brief Gets the number of triangles in this mesh.
+     */
+    int numTriangles() const { return static_cast<int>(indices_.size() / 3); }
+
+    /**
+     * @brief Adds a vertex to this mesh.
+     *
+     * @param pt            The position of the vertex.
+     * @returns             The index of the new vertex.
+     */
+    int addVertex(const Eigen::Vector3d& pt)
+    {
+        vertices_.push_back(pt);
+        return static_cast<int>(vertices_.size()) - 1;
+    }
+
+    /**
+     * @brief Adds a triangle with the given vertex indices to this mesh.
+     */
+    void addTriangle(int a, int b, int c)
+    {
+        indices_.push_back(a);
+        indices_.push_back(b);
+        indices_.push_back(c);
+    }
+};
+
+/**
+ * @brief Writes the given mesh as an object to a Wavefront OBJ stream.
+ *
+ * OBJ indices are global to the file, so indexOffset must hold the number of
+ * vertices written to the stream before this mesh. It is incremented by the
+ * number of vertices of this mesh.
+ *
+ * @param out           The stream to write to.
+ * @param name          The name of the OBJ object.
+ * @param mesh          The mesh to write.
+ * @param indexOffset   The number of vertices previously written to out.
+ */
+void writeObjMesh(std::ostream& out, const char* name, const TriangleMesh& mesh, int& indexOffset);
+
+}}  // namespace aid::xodr
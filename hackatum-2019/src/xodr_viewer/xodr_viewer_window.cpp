@@ -1,28 +1,55 @@
 #include "xodr_viewer_window.h"
 
+#include <QtGui/QMouseEvent>
+#include <QtGui/QPaintEvent>
 #include <QtGui/QPainter>
+#include <QtGui/QPainterPath>
+#include <QtGui/QTransform>
+#include <QtGui/QWheelEvent>
 #include <QtWidgets/QDockWidget>
 #include <QtWidgets/QListWidget>
 #include <QtWidgets/QListWidgetItem>
 #include <QtWidgets/QMessageBox>
-#include <QtWidgets/QScrollArea>
+#include <QtWidgets/QProgressBar>
+#include <QtWidgets/QStatusBar>
 #include <iosfwd>
 
-#include "perlin_noise.h"
-
+#include <algorithm>
 #include <string>
 #include <fstream>
 #include <limits>
 #include <cmath>
 
 #include "bounding_rect.h"
+#include "map_geometry.h"
+#include "map_loader.h"
 #include "xodr/xodr_map.h"
 
 namespace aid {
     namespace xodr {
 
-        static constexpr float DRAW_SCALE = 6 * 2;
-        static constexpr float DRAW_MARGIN = 200;
+        /**
+         * @brief The maximum zoom a map is initially shown with, in pixels per meter.
+         */
+        static constexpr double DRAW_SCALE = 6 * 2;
+
+        /**
+         * @brief The margin around a map when it's initially shown, in pixels.
+         */
+        static constexpr double DRAW_MARGIN = 20;
+
+        static constexpr double MIN_ZOOM = 1e-3;
+        static constexpr double MAX_ZOOM = 200;
+
+        /**
+         * @brief The minimum distance between drawn boundary vertices, in pixels.
+         *
+         * Reference lines are tessellated with about one vertex per meter, so
+         * zoomed out views draw coarser LOD levels which only keep every
+         * 2^level-th vertex.
+         */
+        static constexpr double MIN_VERTEX_SPACING = 2;
+        static constexpr int MAX_LOD_LEVEL = 10;
 
         struct XodrFileInfo {
             const char *name;
@@ -36,10 +63,57 @@ namespace aid {
                 {"sample1.1",         "data/opendrive/sample1.1.xodr"},
         };
 
+        /**
+         * @brief The pens of the cached paths of an XodrView.
+         */
+        enum PenIndex {
+            PEN_DRIVING,
+            PEN_SIDEWALK,
+            PEN_NONE,
+            PEN_SHOULDER,
+            PEN_OTHER,
+            PEN_CONNECTOR,
+            NUM_PENS
+        };
+
+        /**
+         * @brief Creates a pen whose width is in pixels, independent of the
+         * view transform.
+         */
+        static QPen cosmeticPen(Qt::GlobalColor color, double width) {
+            QPen ret(color, width, Qt::SolidLine, Qt::RoundCap);
+            ret.setCosmetic(true);
+            return ret;
+        }
+
+        static const QPen pens[NUM_PENS] = {
+                cosmeticPen(Qt::yellow, 4),
+                cosmeticPen(Qt::cyan, 4),
+                cosmeticPen(Qt::red, 4),
+                cosmeticPen(Qt::magenta, 4),
+                cosmeticPen(Qt::lightGray, 1),
+                cosmeticPen(Qt::black, 1),
+        };
+
+        static const QPen pointPen = cosmeticPen(Qt::red, 5);
+
+        /**
+         * @brief The widest pen of an XodrView, in pixels.
+         */
+        static constexpr double MAX_PEN_WIDTH = 5;
+
 /**
- * @brief The view which is shown inside the main area's QScrollArea.
+ * @brief The view which is shown in the main area.
  *
- * This view renders the XodrMap specified using the setMap function.
+ * This view renders the XodrMap specified using the setMap function into a
+ * viewport of fixed size. The map can be panned by dragging with the left
+ * mouse button and zoomed with the mouse wheel.
+ *
+ * The map is handed over together with its tessellated boundaries in map
+ * coordinates. The QPainterPaths drawn are built lazily for each LOD level,
+ * with one path per lane section and pen, and painted through the view
+ * transform. Only lane sections whose bounds intersect the exposed rectangle
+ * are drawn.
  */
         class XodrViewerWindow::XodrView : public QWidget {
         public:
@@ -48,31 +122,88 @@ namespace aid {
              *
              * @param parent        The parent widget.
              */
-            XodrView(QWidget *parent = nullptr) : QWidget(parent) {}
+            XodrView(QWidget *parent = nullptr) : QWidget(parent) {
+                setMinimumSize(200, 200);
+            }
 
-            void setMap(std::unique_ptr<XodrMap> &&xodrMap);
+            /**
+             * @brief Shows the given map.
+             *
+             * @param xodrMap       The map.
+             * @param sections      The tessellation of the map, see tessellateSections().
+             */
+            void setMap(std::unique_ptr<XodrMap> &&xodrMap, std::vector<SectionGeometry> &&sections);
 
             virtual void paintEvent(QPaintEvent *evnt) override;
 
-            virtual void getObjFile();
+            virtual void mousePressEvent(QMouseEvent *evnt) override;
+
+            virtual void mouseMoveEvent(QMouseEvent *evnt) override;
+
+            virtual void mouseReleaseEvent(QMouseEvent *evnt) override;
+
+            virtual void wheelEvent(QWheelEvent *evnt) override;
 
         private:
             /**
-             * @brief Converts a point form XODR map coordinates to view coordinates.
+             * @brief The cached paths and points of a lane section at some
+             * LOD level, in map coordinates.
+             */
+            struct SectionPaths {
+                QPainterPath paths_[NUM_PENS];
+                QVector<QPointF> points_;
+            };
+
+            /**
+             * @brief Gets the paths of all lane sections at the given LOD level,
+             * building them if they aren't cached yet.
+             */
+            const std::vector<SectionPaths> &lodLevel(int level);
+
+            /**
+             * @brief Zooms by the given factor, keeping the map point at the
+             * given view position in place.
+             */
+            void zoomAt(const QPointF &viewPos, double factor);
+
+            /**
+             * @brief Gets the transform from map coordinates to view coordinates.
              *
-             * @param pt            The point in map coordinates.
-             * @return              The point in view coordinates.
+             * The map is scaled by zoom_, the y axis is flipped, and center_
+             * is moved to the center of the view.
              */
-            QPointF pointMapToView(const Eigen::Vector2d pt) const;
+            QTransform viewTransform() const;
+
+            /**
+             * @brief Converts a point from view coordinates to XODR map coordinates.
+             *
+             * @param pt            The point in view coordinates.
+             * @return              The point in map coordinates.
+             */
+            Eigen::Vector2d pointViewToMap(const QPointF &pt) const;
 
             std::unique_ptr<XodrMap> xodrMap_;
 
+            std::vector<SectionGeometry> sections_;
+
             /**
-             * @brief The offset used in the pointMapToView function.
-             *
-             * See the pointMapToView function for the exact meaning of it.
+             * @brief The cached paths, indexed by LOD level. An empty entry
+             * hasn't been built yet.
+             */
+            std::vector<std::vector<SectionPaths>> lodLevels_;
+
+            /**
+             * @brief The map point shown at the center of the view.
              */
-            Eigen::Vector2d mapToViewOffset_;
+            Eigen::Vector2d center_ = Eigen::Vector2d::Zero();
+
+            /**
+             * @brief The zoom, in pixels per meter.
+             */
+            double zoom_ = DRAW_SCALE;
+
+            bool dragging_ = false;
+            QPointF lastMousePos_;
         };
 
         XodrViewerWindow::XodrViewerWindow() {
@@ -90,50 +221,104 @@ namespace aid {
             sideBarDockWidget->setWidget(sideBar_);
             addDockWidget(Qt::DockWidgetArea::LeftDockWidgetArea, sideBarDockWidget);
 
-            QScrollArea *scrollArea = new QScrollArea();
-            setCentralWidget(scrollArea);
-
             xodrView_ = new XodrView();
-            scrollArea->setWidget(xodrView_);
+            setCentralWidget(xodrView_);
+
+            progressBar_ = new QProgressBar();
+            progressBar_->setRange(0, 100);
+            progressBar_->setVisible(false);
+            statusBar()->addPermanentWidget(progressBar_);
+
+            // The loader calls back on its threads, so forward to the GUI thread.
+            mapLoader_.reset(new MapLoader(
+                    [this](int loadId, int percent, const char *stage) {
+                        QMetaObject::invokeMethod(this, [this, loadId, percent, stage]() {
+                            onLoadProgress(loadId, percent, stage);
+                        }, Qt::QueuedConnection);
+                    },
+                    [this](int loadId, std::unique_ptr<LoadedMap> loadedMap) {
+                        std::shared_ptr<LoadedMap> sharedLoadedMap(std::move(loadedMap));
+                        QMetaObject::invokeMethod(this, [this, loadId, sharedLoadedMap]() {
+                            onLoadFinished(loadId, sharedLoadedMap);
+                        }, Qt::QueuedConnection);
+                    },
+                    true));
 
             QObject::connect(sideBar_, &QListWidget::currentRowChanged, this, &XodrViewerWindow::onXodrFileSelected);
         }
 
+        XodrViewerWindow::~XodrViewerWindow() = default;
+
         void XodrViewerWindow::onXodrFileSelected(int index) {
-            const char *path = xodrFiles[index].path;
+            loadingPath_ = xodrFiles[index].path;
+
+            std::cout << "Loading xodr file: " << loadingPath_ << std::endl;
+
+            progressBar_->setValue(0);
+            progressBar_->setVisible(true);
+            mapLoader_->load(loadingPath_);
+        }
 
-            std::cout << "Loading xodr file: " << path << std::endl;
+        void XodrViewerWindow::onLoadProgress(int loadId, int percent, const char *stage) {
+            if (!mapLoader_->isCurrent(loadId)) {
+                return;
+            }
+
+            progressBar_->setValue(percent);
+            statusBar()->showMessage(QString("%1 %2...").arg(stage).arg(QString::fromStdString(loadingPath_)));
+        }
+
+        void XodrViewerWindow::onLoadFinished(int loadId, const std::shared_ptr<LoadedMap> &loadedMap) {
+            if (!mapLoader_->isCurrent(loadId)) {
+                return;
+            }
 
-            XodrParseResult <XodrMap> fromFileRes = XodrMap::fromFile(path);
+            progressBar_->setVisible(false);
 
-            if (!fromFileRes.hasFatalErrors()) {
-                std::unique_ptr<XodrMap> xodrMap(new XodrMap(std::move(fromFileRes.value())));
-                xodrView_->setMap(std::move(xodrMap));
+            if (loadedMap->xodrMap_) {
+                for (const std::string &warning : loadedMap->warnings_) {
+                    std::cout << "Warning: " << warning << std::endl;
+                }
+
+                xodrView_->setMap(std::move(loadedMap->xodrMap_), std::move(loadedMap->sections_));
+                statusBar()->showMessage(QString("Loaded %1.").arg(QString::fromStdString(loadingPath_)));
             } else {
                 std::cout << "Errors: " << std::endl;
-                for (const auto &err : fromFileRes.errors()) {
-                    std::cout << err.description() << std::endl;
+                for (const std::string &err : loadedMap->errors_) {
+                    std::cout << err << std::endl;
                 }
 
-                QMessageBox::critical(this, "XODR Viewer", QString("Failed to load xodr file %1.").arg(path));
+                statusBar()->clearMessage();
+                QMessageBox::critical(this, "XODR Viewer", QString("Failed to load xodr file %1.")
+                        .arg(QString::fromStdString(loadingPath_)));
             }
         }
 
-        void XodrViewerWindow::XodrView::setMap(std::unique_ptr<XodrMap> &&xodrMap) {
+        void XodrViewerWindow::XodrView::setMap(std::unique_ptr<XodrMap> &&xodrMap,
+                                                std::vector<SectionGeometry> &&sections) {
             xodrMap_ = std::move(xodrMap);
+            sections_ = std::move(sections);
+            lodLevels_.assign(MAX_LOD_LEVEL + 1, std::vector<SectionPaths>());
 
             BoundingRect boundingRect = xodrMapApproxBoundingRect(*xodrMap_);
 
             Eigen::Vector2d diag = boundingRect.max_ - boundingRect.min_;
 
-            // Compute the size big enough for the bounding rectangle, scaled by
-            // DRAW_SCALE, and with margins of size DRAW_MARGIN on all sides.
-            QSize size(static_cast<int>(std::ceil(diag.x() * DRAW_SCALE + 2 * DRAW_MARGIN)),
-                       static_cast<int>(std::ceil(diag.y() * DRAW_SCALE + 2 * DRAW_MARGIN)));
-            resize(size);
+            // Fit the bounding rectangle into the view with margins of size
+            // DRAW_MARGIN on all sides, but zoom in no further than DRAW_SCALE.
+            double availWidth = std::max(width() - 2 * DRAW_MARGIN, 1.0);
+            double availHeight = std::max(height() - 2 * DRAW_MARGIN, 1.0);
+            zoom_ = DRAW_SCALE;
+            if (diag.x() > 0) {
+                zoom_ = std::min(zoom_, availWidth / diag.x());
+            }
+            if (diag.y() > 0) {
+                zoom_ = std::min(zoom_, availHeight / diag.y());
+            }
+            zoom_ = std::max(zoom_, MIN_ZOOM);
+            center_ = (boundingRect.min_ + boundingRect.max_) / 2;
 
-            mapToViewOffset_ = Eigen::Vector2d(-boundingRect.min_.x() * DRAW_SCALE + DRAW_MARGIN,
-                                               boundingRect.max_.y() * DRAW_SCALE + DRAW_MARGIN);
+            update();
         }
 
         static bool showLaneType(LaneType laneType) {
@@ -142,596 +327,182 @@ namespace aid {
                    laneType == LaneType::BORDER;
         }
 
-
-        constexpr double driving_elevation = 0.2;
-        constexpr double sidewalk_elevation = 0.4;
-        constexpr double border_elevation = 0.45;
-        constexpr double road_markings_shift = 0.2;
-
-        constexpr double road_markings_width = 0.25;
-        constexpr double road_markings_elevation = 0.25;
-        constexpr int road_markings_stripe_length = 3;
-        constexpr int road_markings_stripe_distance = 3;
-
-        constexpr double padding = 300;
-        constexpr int noiseScale = 5;
-        constexpr int noiseHeight = 20;
-        constexpr int numPoints = 257;
-
-
-        double getHeight(double x, double y, double minY, double minX, double width) {
-            static siv::PerlinNoise noise(32);
-            double n = noise.noise((x - minX) / width * noiseScale, (y - minY) / width * noiseScale);
-            double x_mid = minX + width / 2;
-            double y_mid = minY + width / 2;
-            double dist = sqrt((x - x_mid) * (x - x_mid) + (y - y_mid) * (y - y_mid));
-            n *= pow((1 - cos(dist * 3.14 / (width / 2))) / 2, 1.1) + 0.4;
-            return n * noiseHeight + noiseHeight;
-        }
-
-        LaneSection::BoundaryCurveTessellation shift(
-                const LaneSection::BoundaryCurveTessellation &original,
-                const LaneSection::BoundaryCurveTessellation &ref,
-                double shift,
-                int from = 0, int to = -1) {
-
-            std::vector<Eigen::Vector2d> shifted_vertices;
-            if (to == -1) to = original.vertices_.size();
-            for (int i = from; i < to; i++) {
-                Eigen::Vector2d pt_orig = original.vertices_[i];
-                Eigen::Vector2d pt_ref = ref.vertices_[i];
-                shifted_vertices.push_back((pt_ref - pt_orig).normalized() * shift + pt_orig);
+        /**
+         * @brief Gets the pen used for the boundaries of lanes of the given type.
+         */
+        static PenIndex lanePenIndex(LaneType laneType) {
+            switch (laneType) {
+                case LaneType::DRIVING:
+                    return PEN_DRIVING;
+                case LaneType::SIDEWALK:
+                    return PEN_SIDEWALK;
+                case LaneType::NONE:
+                    return PEN_NONE;
+                case LaneType::SHOULDER:
+                    return PEN_SHOULDER;
+                default:
+                    return PEN_OTHER;
             }
-            return LaneSection::BoundaryCurveTessellation{std::move(shifted_vertices)};
         }
 
-        std::stringstream writeStreet(
-                const LaneSection::BoundaryCurveTessellation &b,
-                const LaneSection::BoundaryCurveTessellation &a, double minY, double minX, double width,
-                int &index_offset, double elevation) {
-            std::stringstream res;
-            static int seg_num = 0;
-
-            int size = a.vertices_.size();
-            res << "o segment_num_" << seg_num++ << std::endl;
-
-
-            for (int j = 0; j < size; j++) {
-                Eigen::Vector2d ptl = a.vertices_[j];
-                Eigen::Vector2d ptlr = b.vertices_[j];
-                res << "v " << ptl.x() << " " << ptl.y() << " "
-                    << getHeight(ptl.x(), ptl.y(), minX, minY, width) + elevation << std::endl;
-                res << "v " << ptlr.x() << " " << ptlr.y() << " "
-                    << getHeight(ptlr.x(), ptlr.y(), minX, minY, width) + elevation << std::endl;
-            }
-            for (int j = 0; j < size; j++) {
-                Eigen::Vector2d ptl = a.vertices_[j];
-                Eigen::Vector2d ptlr = b.vertices_[j];
-                res << "v " << ptl.x() << " " << ptl.y() << " 0" << std::endl;
-                res << "v " << ptlr.x() << " " << ptlr.y() << " 0" << std::endl;
-            }
-
-            size *= 2;
-            // triangles = road surface
-            for (int j = 1; j <= size - 2; j++) {
-                if (j % 2 == 0) {
-                    res << "f " << j + index_offset << " " << j + 1 + index_offset
-                        << " " << j + 2 + index_offset << std::endl;
-                } else {
-                    res << "f " << j + index_offset << " " << j + 2 + index_offset
-                        << " " << j + 1 + index_offset << std::endl;
-                }
+        /**
+         * @brief Keeps every 2^level-th vertex of the given polyline, and
+         * always the last one.
+         */
+        static QPolygonF decimate(const QPolygonF &polyline, int level) {
+            const int step = 1 << level;
+            const int size = polyline.size();
+
+            QPolygonF ret;
+            ret.reserve((size + step - 1) / step + 1);
+            for (int i = 0; i < size; i += step) {
+                ret.append(polyline[i]);
             }
-            // sides
-            for (int j = 1; j <= size - 2; j++) {
-                if (j % 2 == 1) {
-                    res << "f " << j + index_offset << " " << j + size + index_offset
-                        << " " << j + 2 + size + index_offset << std::endl;
-                    res << "f " << j + index_offset
-                        << " " << j + 2 + size + index_offset << " "
-                        << j + 2 + index_offset << std::endl;
-                } else {
-                    res << "f " << j + 2 + index_offset << " " << j + 2 + size + index_offset
-                        << " " << j + size + index_offset << std::endl;
-                    res << "f " << j + index_offset
-                        << " " << j + 2 + index_offset << " "
-                        << j + size + index_offset << std::endl;
-                }
+            if (size > 0 && (size - 1) % step != 0) {
+                ret.append(polyline[size - 1]);
             }
-            res << "f " << 1 + index_offset << " " << 1 + size + index_offset << " "
-                << 2 + size + index_offset << " " << 2 + index_offset << std::endl;
-
-            res << "f " << size + index_offset << " " << size + size + index_offset
-                << " " << size + size - 1 + index_offset << " "
-                << size - 1 + index_offset << std::endl;
-            index_offset += size * 2;
-            return res;
+            return ret;
         }
 
-        std::stringstream writeOrientation(
-                const LaneSection::BoundaryCurveTessellation &outer,
-                const LaneSection::BoundaryCurveTessellation &inner, double minY, double minX, double width,
-                double elevation) {
-            static int seg_num = 0;
-            std::stringstream res;
-            for (int j = 0; j < outer.vertices_.size(); j++) {
-
-                res << "o vec_num_" << seg_num++ << std::endl;
-                Eigen::Vector2d ptl = outer.vertices_[j];
-                Eigen::Vector2d ptlr = inner.vertices_[j];
-                res << "v " << ptl.x() << " " << ptl.y() << " "
-                    << getHeight(ptl.x(), ptl.y(), minX, minY, width) + elevation << std::endl;
-                res << "v " << ptlr.x() << " " << ptlr.y() << " "
-                    << getHeight(ptlr.x(), ptlr.y(), minX, minY, width) + elevation << std::endl;
+        const std::vector<XodrViewerWindow::XodrView::SectionPaths> &
+        XodrViewerWindow::XodrView::lodLevel(int level) {
+            std::vector<SectionPaths> &ret = lodLevels_[level];
+            if (!ret.empty() || sections_.empty()) {
+                return ret;
             }
-            return res;
-
-        }
 
-        std::stringstream writeOrientationParallel(
-                const LaneSection::BoundaryCurveTessellation &left,
-                const LaneSection::BoundaryCurveTessellation &right, double minY, double minX, double width,
-                double elevation) {
-            static int seg_num = 0;
-            std::stringstream res;
-            for (int j = 1; j < left.vertices_.size() - 1; j++) {
-                res << "o vec_num_" << seg_num++ << std::endl;
-                Eigen::Vector2d ptl = left.vertices_[j];
-                Eigen::Vector2d ptlPrev = left.vertices_[j - 1];
-                Eigen::Vector2d ptlNext = left.vertices_[j + 1];
-                Eigen::Vector2d ptlr = right.vertices_[j];
-
-                Eigen::Vector2d mid = (ptl + ptlr) / 2;
-                Eigen::Vector2d dir = mid + (ptlNext - ptlPrev).normalized();
-
-
-                res << "v " << mid.x() << " " << mid.y() << " "
-                    << getHeight(mid.x(), mid.y(), minX, minY, width) + elevation << std::endl;
-                res << "v " << ptlr.x() << " " << ptlr.y() << " "
-                    << getHeight(dir.x(), dir.y(), minX, minY, width) + elevation << std::endl;
-            }
-            return res;
-
-        }
-
-        void XodrViewerWindow::XodrView::getObjFile() {
-
-            int streets_off = 0;
-            std::ofstream streets;
-            streets.open("./out/streets.obj");
-
-            int sidewalk_off = 0;
-            std::ofstream sidewalk;
-            sidewalk.open("./out/sidewalk.obj");
-
-            int border_off = 0;
-            std::ofstream border;
-            border.open("./out/border.obj");
-
-            int markings_off = 0;
-            std::ofstream markings;
-            markings.open("./out/markings.obj");
-
-            int terrain_off = 0;
-            std::ofstream terrain;
-            terrain.open("./out/terrain.obj");
-
-            int all_off = 0;
-            std::ofstream all;
-            all.open("./out/all.obj");
-
-            std::ofstream street_geo;
-            street_geo.open("./out/street_geo.obj");
-
-            std::ofstream street_lanes;
-            street_lanes.open("./out/street_lanes.obj");
-
-            std::ofstream terrain_hm;
-            terrain_hm.open("./out/terrain.raw", std::ios::out | std::ios::binary);
-
-
-            double minX = std::numeric_limits<double>::infinity();
-            double maxX = std::numeric_limits<double>::lowest();
-            double minY = std::numeric_limits<double>::infinity();
-            double maxY = std::numeric_limits<double>::lowest();
-
-            struct DrawLane {
-                LaneSection::BoundaryCurveTessellation left;
-                LaneSection::BoundaryCurveTessellation right;
-                double elevation;
-            };
-
-            std::vector<DrawLane> lanes_to_draw;
-            std::vector<DrawLane> lanes_to_draw_sidewalk;
-            std::vector<DrawLane> lanes_to_draw_boundary;
-            std::vector<DrawLane> lanes_to_draw_markings;
-            std::vector<DrawLane> geometry;
-            std::vector<DrawLane> lane_directions;
-
-
-
-            // roads
-            for (const Road &road : xodrMap_->roads()) {
-                const auto &laneSections = road.laneSections();
-
-                // find left and rig
-
-                // road section
-                for (int laneSectionIdx = 0; laneSectionIdx < (int) laneSections.size(); laneSectionIdx++) {
-                    const LaneSection &laneSection = laneSections[laneSectionIdx];
-
-                    auto refLineTessellation = road.referenceLine().tessellate(laneSection.startS(),
-                                                                               laneSection.endS());
-                    auto boundaries = laneSection.tessellateLaneBoundaryCurves(refLineTessellation);
-                    const auto &lanes = laneSection.lanes();
-
-                    for (size_t i = 0; i < boundaries.size() - 1; i++) {
-                        const LaneSection::BoundaryCurveTessellation &left = boundaries[i];
-                        const LaneSection::BoundaryCurveTessellation &right = boundaries[i + 1];
-
-                        if (lanes[i].type() == LaneType::DRIVING) {
-
-                            DrawLane drawLane{left, right, driving_elevation};
-                            lanes_to_draw.push_back(std::move(drawLane));
-
-                            if (i < boundaries.size() / 2) {
-                                lane_directions.push_back({right, left, sidewalk_elevation});
-                            } else {
-                                lane_directions.push_back({left, right, sidewalk_elevation});
-                            }
-
-                            if (i > 0 && (lanes[i - 1].type() == LaneType::BORDER ||
-                                          lanes[i - 1].type() == LaneType::SHOULDER) &&
-                                (i < 2 || lanes[i - 2].type() == LaneType::SIDEWALK)) {
-                                // Shift right of i
-                                auto l = shift(left, right, road_markings_shift);
-                                auto r = shift(left, right, road_markings_shift + road_markings_width);
-                                DrawLane drawLane{std::move(l), std::move(r), road_markings_elevation};
-                                lanes_to_draw_markings.push_back(drawLane);
-                            } else if ((lanes[i + 1].type() == LaneType::BORDER ||
-                                        lanes[i + 1].type() == LaneType::SHOULDER) &&
-                                       (i > boundaries.size() - 2 || lanes[i + 2].type() == LaneType::SIDEWALK)) {
-                                auto l = shift(right, left, road_markings_shift);
-                                auto r = shift(right, left, road_markings_shift + road_markings_width);
-                                DrawLane drawLane{std::move(r), std::move(l), road_markings_elevation};
-                                lanes_to_draw_markings.push_back(drawLane);
-                            }
-                            if (i > 0 && lanes[i - 1].type() == LaneType::DRIVING) {
-                                for (int k = 0; k < left.vertices_.size() -
-                                                    road_markings_stripe_length; k += road_markings_stripe_length +
-                                                                                      road_markings_stripe_distance) {
-                                    auto l = shift(left, right, -road_markings_width / 2, k,
-                                                   k + road_markings_stripe_length);
-                                    auto r = shift(left, right, road_markings_width / 2, k,
-                                                   k + road_markings_stripe_length);
-                                    DrawLane drawLane{std::move(l), std::move(r), road_markings_elevation};
-                                    lanes_to_draw_markings.push_back(drawLane);
-                                }
-
-                            }
-                        } else if (lanes[i].type() == LaneType::SIDEWALK) {
-                            DrawLane drawLane{left, right, sidewalk_elevation};
-                            lanes_to_draw_sidewalk.push_back(std::move(drawLane));
-
-                            if (i < boundaries.size() / 2) {
-                                geometry.push_back({right, left, sidewalk_elevation});
-                            } else {
-                                geometry.push_back({left, right, sidewalk_elevation});
-                            }
-                        } else if (lanes[i].type() == LaneType::BORDER) {
-                            if ((i < 1 || lanes[i - 1].type() != LaneType::SIDEWALK) &&
-                                (i > boundaries.size() - 1 || lanes[i + 1].type() != LaneType::SIDEWALK)) {
-                                continue;
-                            }
-                            DrawLane drawLane{left, right, border_elevation};
-                            lanes_to_draw_boundary.push_back(std::move(drawLane));
-                        } else {
-                            continue;
-                        }
-
-                        for (int j = 0; j < left.vertices_.size(); j++) {
-                            Eigen::Vector2d ptl = left.vertices_[j];
-                            Eigen::Vector2d ptlr = right.vertices_[j];
-                            minX = std::min(minX, ptl.x());
-                            maxX = std::max(maxX, ptl.x());
-                            minY = std::min(minY, ptl.y());
-                            maxY = std::max(maxY, ptl.y());
-
-                            minX = std::min(minX, ptlr.x());
-                            maxX = std::max(maxX, ptlr.x());
-                            minY = std::min(minY, ptlr.y());
-                            maxY = std::max(maxY, ptlr.y());
+            ret.resize(sections_.size());
+            for (size_t k = 0; k < sections_.size(); k++) {
+                const SectionGeometry &section = sections_[k];
+                SectionPaths &sectionPaths = ret[k];
+
+                for (size_t i = 0; i < section.boundaries_.size(); i++) {
+                    QPolygonF polyline = decimate(section.boundaries_[i], level);
+                    if (!polyline.isEmpty()) {
+                        QPainterPath &path = sectionPaths.paths_[lanePenIndex(section.boundaryLaneTypes_[i])];
+                        path.moveTo(polyline[0]);
+                        for (int j = 1; j < polyline.size(); j++) {
+                            path.lineTo(polyline[j]);
                         }
                     }
-                };
-
-            }
-
-            // terrain
-            double deltaX = maxX - minX;
-            double deltaY = maxY - minY;
+                }
 
-            double width;
+                if (section.left_ != -1) {
+                    QPolygonF leftPoints = decimate(section.boundaries_[section.left_], level);
+                    QPolygonF rightPoints = decimate(section.boundaries_[section.right_], level);
 
-            if (deltaX > deltaY) {
-                minY -= (deltaX - deltaY) / 2;
-                maxY += (deltaX - deltaY) / 2;
-                width = deltaX + 2 * padding;
-            } else {
-                minX -= (deltaY - deltaX) / 2;
-                maxX += (deltaY - deltaX) / 2;
-                width = deltaY + 2 * padding;
+                    QPainterPath &connectors = sectionPaths.paths_[PEN_CONNECTOR];
+                    sectionPaths.points_ = leftPoints;
+                    for (int j = 0; j < rightPoints.size() && j < leftPoints.size(); j++) {
+                        connectors.moveTo(rightPoints[j]);
+                        connectors.lineTo(leftPoints[j]);
+                        sectionPaths.points_.append(rightPoints[j]);
+                    }
+                }
             }
 
-            minX -=
-                    padding;
-            maxX +=
-                    padding;
-            minY -=
-                    padding;
-            maxY +=
-                    padding;
-
-
-// roads
-
-            for (const DrawLane &drawLane: lanes_to_draw) {
-                std::stringstream write =
-                        writeStreet(drawLane.left, drawLane.right, minY, minX, width, all_off, drawLane.elevation);
-                all << write.rdbuf();
+            return ret;
+        }
 
-                write = writeStreet(drawLane.left, drawLane.right, minY, minX, width, streets_off, drawLane.elevation);
-                streets << write.rdbuf();
-            }
-            for (const DrawLane &drawLane: lanes_to_draw_boundary) {
-                std::stringstream write =
-                        writeStreet(drawLane.left, drawLane.right, minY, minX, width, all_off, drawLane.elevation);
-                all << write.rdbuf();
+        void XodrViewerWindow::XodrView::paintEvent(QPaintEvent *evnt) {
+            QPainter painter(this);
 
-                write = writeStreet(drawLane.left, drawLane.right, minY, minX, width, border_off, drawLane.elevation);
-                border << write.rdbuf();
+            if (!xodrMap_) {
+                return;
             }
-            for (const DrawLane &drawLane: lanes_to_draw_markings) {
-                std::stringstream write =
-                        writeStreet(drawLane.left, drawLane.right, minY, minX, width, all_off, drawLane.elevation);
-                all << write.rdbuf();
 
-                write = writeStreet(drawLane.left, drawLane.right, minY, minX, width, markings_off, drawLane.elevation);
-                markings << write.rdbuf();
+            int level = 0;
+            for (double spacing = zoom_; spacing < MIN_VERTEX_SPACING && level < MAX_LOD_LEVEL; spacing *= 2) {
+                level++;
             }
-            for (const DrawLane &drawLane: lanes_to_draw_sidewalk) {
-                std::stringstream write =
-                        writeStreet(drawLane.left, drawLane.right, minY, minX, width, all_off, drawLane.elevation);
-                all << write.rdbuf();
+            const std::vector<SectionPaths> &sectionPaths = lodLevel(level);
 
-                write = writeStreet(drawLane.left, drawLane.right, minY, minX, width, sidewalk_off, drawLane.elevation);
-                sidewalk << write.rdbuf();
-            }
-            for (const DrawLane &drawLane : geometry) {
-                street_geo << writeOrientation(drawLane.left, drawLane.right, minY, minX, width,
-                                               drawLane.elevation).rdbuf();
-            }
-            for (const DrawLane &drawLane : lane_directions) {
-                street_lanes << writeOrientationParallel(drawLane.left, drawLane.right, minY, minX, width,
-                                                         drawLane.elevation).rdbuf();
-            }
+            const QTransform transform = viewTransform();
+            painter.setTransform(transform);
 
-            double delta = width / (numPoints - 1);
-
-
-            terrain << "o terrain" <<
-                    std::endl;
-            all << "o terrain" <<
-                std::endl;
-
-            for (
-                    int c = 0;
-                    c < numPoints;
-                    c++) {
-                for (
-                        int r = 0;
-                        r < numPoints;
-                        r++) {
-                    double x = minX + c * delta;
-                    double y = minY + r * delta;
-                    double z = getHeight(x, y, minX, minY, width);
-                    unsigned short z_discrete = static_cast<short>(z / (2 * noiseHeight) * 8192);
-                    terrain_hm.write((char *) &z_discrete, sizeof(z_discrete));
-                    terrain << "v " << x << " " << y << " " << z <<
-                            std::endl;
-                    all << "v " << x << " " << y << " " << z <<
-                        std::endl;
+            // Cull in map coordinates, with the exposed rectangle grown by
+            // the widest pen.
+            const double margin = (MAX_PEN_WIDTH / 2 + 1) / zoom_;
+            const QRectF exposed = transform.inverted().mapRect(QRectF(evnt->rect()))
+                    .adjusted(-margin, -margin, margin, margin);
 
+            std::vector<int> visible;
+            for (int k = 0; k < static_cast<int>(sections_.size()); k++) {
+                if (sections_[k].bounds_.intersects(exposed)) {
+                    visible.push_back(k);
                 }
             }
 
-            for (
-                    int c = 0;
-                    c < numPoints - 1; c++) {
-                for (
-                        int r = 0;
-                        r < numPoints - 1; r++) {
-                    int startNum = 1 + c + r * numPoints;
-                    terrain << "f " << startNum + numPoints << " " << startNum + numPoints + 1 << " "
-                            << startNum <<
-                            std::endl;
-                    terrain << "f " << startNum + numPoints + 1 << " " << startNum + 1 << " "
-                            << startNum <<
-                            std::endl;
-
-                    all << "f " << startNum + numPoints + all_off << " " << startNum + all_off + numPoints + 1 << " "
-                        << startNum + all_off <<
-                        std::endl;
-                    all << "f " << startNum + numPoints + 1 + all_off << " " << startNum + 1 + all_off << " "
-                        << startNum + all_off <<
-                        std::endl;
+            for (int p = 0; p < NUM_PENS; p++) {
+                painter.setPen(pens[p]);
+                for (int k : visible) {
+                    const QPainterPath &path = sectionPaths[k].paths_[p];
+                    if (!path.isEmpty()) {
+                        painter.drawPath(path);
+                    }
                 }
             }
-            streets.close();
-            border.close();
-            sidewalk.close();
-            markings.close();
-            terrain.close();
-            terrain_hm.close();
-            all.close();
-            street_geo.close();
-            street_lanes.close();
-
-            std::cout << "Finished writing file." << std::endl <<
-                      std::flush;
-        }
-
-        void XodrViewerWindow::XodrView::paintEvent(QPaintEvent *) {
-            QPainter painter(this);
-
-            getObjFile();
-
-            QVector <QPointF> allPoints;
-
-            // roads
-            for (const Road &road : xodrMap_->roads()) {
-                const auto &laneSections = road.laneSections();
-
-                // debug line highlighting
-                for (int laneSectionIdx = 0; laneSectionIdx < (int) laneSections.size(); laneSectionIdx++) {
-                    const LaneSection &laneSection = laneSections[laneSectionIdx];
-
-                    auto refLineTessellation = road.referenceLine().tessellate(laneSection.startS(),
-                                                                               laneSection.endS());
-                    auto boundaries = laneSection.tessellateLaneBoundaryCurves(refLineTessellation);
-                    const auto &lanes = laneSection.lanes();
-
-                    for (size_t i = 0; i < boundaries.size(); i++) {
-                        if (lanes[i].type() == LaneType::DRIVING) {
-                            painter.setPen(QPen(Qt::yellow, 4, Qt::SolidLine, Qt::RoundCap));
-                        } else if (lanes[i].type() == LaneType::SIDEWALK) {
-                            painter.setPen(QPen(Qt::cyan, 4, Qt::SolidLine, Qt::RoundCap));
-                        } else if (lanes[i].type() == LaneType::NONE) {
-                            painter.setPen(QPen(Qt::red, 4, Qt::SolidLine, Qt::RoundCap));
-                        } else if (lanes[i].type() == LaneType::SHOULDER) {
-                            painter.setPen(QPen(Qt::magenta, 4, Qt::SolidLine, Qt::RoundCap));
-                        } else {
-                            painter.setPen(QPen(Qt::lightGray, 1, Qt::SolidLine, Qt::RoundCap));
-                        }
-
-                        const LaneSection::BoundaryCurveTessellation &boundary = boundaries[i];
-                        QVector <QPointF> points;
-                        for (Eigen::Vector2d pt : boundary.vertices_) {
-                            points.append(pointMapToView(pt));
-                        }
 
-                        painter.drawPolyline(points);
-                    }
+            painter.setPen(pointPen);
+            for (int k : visible) {
+                const QVector<QPointF> &points = sectionPaths[k].points_;
+                if (!points.isEmpty()) {
+                    painter.drawPoints(points.data(), points.size());
                 }
+            }
+        }
 
+        void XodrViewerWindow::XodrView::mousePressEvent(QMouseEvent *evnt) {
+            if (evnt->button() == Qt::LeftButton) {
+                dragging_ = true;
+                lastMousePos_ = evnt->localPos();
+            }
+        }
 
-                // find left and rig
-                // road section
-                for (
-                        int laneSectionIdx = 0;
-
-                        laneSectionIdx < (int)
-
-                                laneSections.
-
-                                        size();
-
-                        laneSectionIdx++) {
-                    const LaneSection &laneSection = laneSections[laneSectionIdx];
-
-                    auto refLineTessellation = road.referenceLine().tessellate(laneSection.startS(),
-                                                                               laneSection.endS());
-                    auto boundaries = laneSection.tessellateLaneBoundaryCurves(refLineTessellation);
-                    const auto &lanes = laneSection.lanes();
-
-                    // lanes
-                    // Find first and last lane
-                    int left = -1;
-                    int right = -1;
-                    for (
-                            size_t i = 0;
-                            i < boundaries.
-
-                                    size();
+        void XodrViewerWindow::XodrView::mouseMoveEvent(QMouseEvent *evnt) {
+            if (!dragging_) {
+                return;
+            }
 
-                            i++) {
-                        const LaneSection::BoundaryCurveTessellation &boundary = boundaries[i];
-                        if (lanes[i].
+            QPointF delta = evnt->localPos() - lastMousePos_;
+            lastMousePos_ = evnt->localPos();
 
-                                type()
+            // The y axis of the view is flipped.
+            center_ -= Eigen::Vector2d(delta.x(), -delta.y()) / zoom_;
+            update();
+        }
 
-                            == LaneType::BORDER || lanes[i].
+        void XodrViewerWindow::XodrView::mouseReleaseEvent(QMouseEvent *evnt) {
+            if (evnt->button() == Qt::LeftButton) {
+                dragging_ = false;
+            }
+        }
 
-                                type()
+        void XodrViewerWindow::XodrView::wheelEvent(QWheelEvent *evnt) {
+            // One wheel step of 120 zooms by a factor of 2^(1/4).
+            zoomAt(evnt->posF(), std::pow(2.0, evnt->angleDelta().y() / 480.0));
+        }
 
-                                                   == LaneType::DRIVING) {
-                            if (left == -1) {
-                                left = i;
-                            }
-                            right = i;
-                        }
-                    }
-                    if (left == -1 || right == -1) continue;
-                    const LaneSection::BoundaryCurveTessellation &leftBoundary = boundaries[left];
-                    const LaneSection::BoundaryCurveTessellation &rightBoundary = boundaries[right];
-                    QVector <QPointF> leftPoints;
-                    QVector <QPointF> rightPoints;
-                    for (
-                        Eigen::Vector2d pt
-                            : leftBoundary.vertices_) {
-                        leftPoints.append(pointMapToView(pt)
-                        );
-                        allPoints.append(pointMapToView(pt)
-                        );
-                    }
-                    rightPoints.append(leftPoints[0]);
-                    int i = 0;
-                    for (
-                        Eigen::Vector2d pt
-                            : rightBoundary.vertices_) {
-                        rightPoints.append(pointMapToView(pt)
-                        );
-                        QVector <QPointF> connector;
-
-                        connector.append(pointMapToView(pt)
-                        );
-                        connector.append(leftPoints[i]);
-                        painter.setPen(QPen(Qt::black, 1, Qt::SolidLine, Qt::RoundCap)
-                        );
-                        painter.drawPolyline(connector);
-                        allPoints.append(pointMapToView(pt)
-                        );
-                        i++;
-                    }
-                    rightPoints.append(leftPoints[leftPoints.size() - 1]);
+        void XodrViewerWindow::XodrView::zoomAt(const QPointF &viewPos, double factor) {
+            Eigen::Vector2d mapPos = pointViewToMap(viewPos);
 
-                    painter.setPen(QPen(Qt::green, 3, Qt::SolidLine, Qt::RoundCap)
-                    );
-                    //painter.drawPolyline(rightPoints);
-                    //painter.drawPolyline(leftPoints);
+            zoom_ = std::min(std::max(zoom_ * factor, MIN_ZOOM), MAX_ZOOM);
 
-                }
-            }
+            Eigen::Vector2d offset(viewPos.x() - width() / 2.0, -(viewPos.y() - height() / 2.0));
+            center_ = mapPos - offset / zoom_;
+            update();
+        }
 
-//painter.drawPoints(qtPoints);
-            painter.setPen(QPen(Qt::red, 5, Qt::SolidLine, Qt::RoundCap));
-            int i = 0;
-            for (
-                auto &point
-                    : allPoints) {
-                i++;
-                if (i % 5 == 0) {
-                }
-                painter.
-                        drawPoint(point);
-            }
+        QTransform XodrViewerWindow::XodrView::viewTransform() const {
+            QTransform ret;
+            ret.translate(width() / 2.0, height() / 2.0);
+            ret.scale(zoom_, -zoom_);
+            ret.translate(-center_.x(), -center_.y());
+            return ret;
         }
 
-        QPointF XodrViewerWindow::XodrView::pointMapToView(const Eigen::Vector2d pt) const {
-            // Scales the map point by DRAW_SCALE, flips the y axis, then applies
-            // mapToViewOffset_, which is computes such that it shifts the view space
-            // bounding rectangle to have margins of DRAW_MARGIN on all sides.
-            return QPointF(pt.x() * DRAW_SCALE + mapToViewOffset_.x(), -pt.y() * DRAW_SCALE + mapToViewOffset_.y());
+        Eigen::Vector2d XodrViewerWindow::XodrView::pointViewToMap(const QPointF &pt) const {
+            return center_ + Eigen::Vector2d(pt.x() - width() / 2.0, -(pt.y() - height() / 2.0)) / zoom_;
         }
 
     }
@@ -2,11 +2,18 @@
 
 #include <QtWidgets/QMainWindow>
 
+#include <memory>
+#include <string>
+
 class QListWidgetItem;
 class QListWidget;
+class QProgressBar;
 
 namespace aid { namespace xodr {
 
+class MapLoader;
+struct LoadedMap;
+
 /**
  * @brief The main window of the xodr_viewer.
  */
@@ -18,6 +25,8 @@ class XodrViewerWindow : public QMainWindow
 	 */
 	XodrViewerWindow();
 
+    ~XodrViewerWindow();
+
   private:
     class XodrView;
 
@@ -31,8 +40,35 @@ class XodrViewerWindow : public QMainWindow
      */
     void onXodrFileSelected(int index);
 
+    /**
+     * @brief Shows the progress of the load with the given id, if it's the
+     * current one.
+     *
+     * This function must be called on the GUI thread.
+     */
+    void onLoadProgress(int loadId, int percent, const char* stage);
+
+    /**
+     * @brief Shows the loaded map of the load with the given id, if it's the
+     * current one, or reports its errors.
+     *
+     * This function must be called on the GUI thread.
+     */
+    void onLoadFinished(int loadId, const std::shared_ptr<LoadedMap>& loadedMap);
+
     QListWidget* sideBar_;
     XodrView* xodrView_;
+    QProgressBar* progressBar_;
+
+    /**
+     * @brief Loads the selected xodr files in the background.
+     */
+    std::unique_ptr<MapLoader> mapLoader_;
+
+    /**
+     * @brief The path of the xodr file which is currently loading.
+     */
+    std::string loadingPath_;
 };
 
 }}  // namespace aid::xodr
\ No newline at end of file